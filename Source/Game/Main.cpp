@@ -12,14 +12,15 @@
 #include "Common.h"
 
 #include <cstdio>
-#include <fstream>
 #include <memory>
 
 #include "Game/Game.h"
 #include "Light/RotatingPointLight.h"
 #include "Model/Model.h"
+#include "Scene/Scene.h"
 #include "Scene/Voxel.h"
 #include "Shader/SkinningVertexShader.h"
+#include "Texture/BlockCompressor.h"
 
 /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   Function: wWinMain
@@ -71,6 +72,12 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
 
+    std::shared_ptr<library::VertexShader> voxelMeshVertexShader = std::make_shared<library::VertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxelMesh", "vs_5_0");
+    if (FAILED(game->GetRenderer()->AddVertexShader(L"VoxelMeshShader", voxelMeshVertexShader)))
+    {
+        return 0;
+    }
+
     std::shared_ptr<library::PixelShader> phongSkinningPixelShader = std::make_shared<library::PixelShader>(L"Shaders/SkinningShaders.fxh", "PSPhong", "ps_5_0");
     if (FAILED(game->GetRenderer()->AddPixelShader(L"PhongSkinningShader", phongSkinningPixelShader)))
     {
@@ -89,6 +96,9 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
 
+    // Textures that cannot be compressed keep loading from their source images
+    library::BlockCompressor::CompressDirectory(L"Content/BobLampClean");
+
     std::shared_ptr<library::Model> warrior = std::make_shared<library::Model>(L"Content/BobLampClean/boblampclean.md5mesh");
     warrior->RotateX(XM_PIDIV2);
     warrior->Scale(0.1f, 0.1f, 0.1f);
@@ -130,11 +140,6 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
 
-    std::ofstream sceneFile;
-    sceneFile.open("HeightMap.txt");
-    constexpr const UINT MAP_WIDTH = 256u;
-    constexpr const UINT MAP_HEIGHT = 32u;
-    constexpr const UINT MAP_DEPTH = 256u;
     XMFLOAT4 aColors[] =
     {
         XMFLOAT4(0.0f,      0.666f, 0.0f,   1.0f),  // GRASSLAND
@@ -154,144 +159,27 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         XMFLOAT4(0.15f,     0.372f, 0.15f,  1.0f),  // TROPICAL_RAIN_FOREST
     };
 
-    sceneFile << MAP_WIDTH << " " << MAP_HEIGHT << " " << MAP_DEPTH << ' ' << ARRAYSIZE(aColors) << '\n';
-
-    for (UINT colorIdx = 0; colorIdx < ARRAYSIZE(aColors); ++colorIdx)
-    {
-        sceneFile << aColors[colorIdx].x << ' ' <<
-            aColors[colorIdx].y << ' ' <<
-            aColors[colorIdx].z << '\n';
-    }
-
-    for (UINT z = 0u; z < MAP_DEPTH; ++z)
-    {
-        for (UINT x = 0u; x < MAP_WIDTH; ++x)
-        {
-            FLOAT height = 0.0f;
-
-            FLOAT frequencySum = 0.0f;
-            for (UINT i = 0; i < 4; ++i)
-            {
-                FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
-                frequencySum += 1.0f / frequency;
-                height += library::Scene::GetPerlin2d(frequency * static_cast<FLOAT>(x), frequency * static_cast<FLOAT>(z), 0.1f, 4u) / frequency;
-            }
-            height /= frequencySum;
-            height = pow(height * 1.2f, 1.25f);
-
-            assert(height >= 0.0f);
-
-            FLOAT moisture = 0.0f;
-
-            frequencySum = 0.0f;
-            for (UINT i = 0; i < 4; ++i)
-            {
-                FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
-                frequencySum += 1.0f / frequency;
-                moisture += library::Scene::GetPerlin2d(frequency * static_cast<FLOAT>(x), frequency * static_cast<FLOAT>(z), 0.1f, 4u) / frequency;
-            }
-            moisture /= frequencySum;
-            moisture = pow(moisture * 1.2f, 1.25f);
-
-            library::eBlockType blockType = library::eBlockType::GRASSLAND;
-
-            if (height < 0.1f)
-            {
-                blockType = library::eBlockType::OCEAN;
-            }
-            else if (height < 0.12f)
-            {
-                blockType = library::eBlockType::SAND;
-            }
-            else if (height > 0.8f)
-            {
-                if (moisture < 0.1f)
-                {
-                    blockType = library::eBlockType::SCORCHED;
-                }
-                else if (moisture < 0.2f)
-                {
-                    blockType = library::eBlockType::BARE;
-                }
-                else if (moisture < 0.5f)
-                {
-                    blockType = library::eBlockType::TUNDRA;
-                }
-                else
-                {
-                    blockType = library::eBlockType::SNOW;
-                }
-            }
-            else if (height > 0.6f)
-            {
-                if (moisture < 0.33f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DESERT;
-                }
-                else if (moisture < 0.66f)
-                {
-                    blockType = library::eBlockType::SHRUBLAND;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TAIGA;
-                }
-            }
-            else if (height > 0.3f)
-            {
-                if (moisture < 0.16f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DESERT;
-                }
-                else if (moisture < 0.5f)
-                {
-                    blockType = library::eBlockType::GRASSLAND;
-                }
-                else if (moisture < 0.83f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DECIDUOUS_FOREST;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TEMPERATE_RAIN_FOREST;
-                }
-            }
-            else
-            {
-
-                if (moisture < 0.16f)
-                {
-                    blockType = library::eBlockType::SUBTROPICAL_DESERT;
-                }
-                else if (moisture < 0.33f)
-                {
-                    blockType = library::eBlockType::GRASSLAND;
-                }
-                else if (moisture < 0.66f)
-                {
-                    blockType = library::eBlockType::TROPICAL_SEASONAL_FOREST;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TROPICAL_RAIN_FOREST;
-                }
-            }
-
-            sceneFile << static_cast<CHAR>(blockType);
-
-            sceneFile << height << ' ';
-        }
-        sceneFile << '\n';
-    }
-    sceneFile << std::endl;
-    sceneFile.close();
-
-    if (FAILED(game->GetRenderer()->AddScene(L"VoxelMap", L"HeightMap.txt")))
+    // Chunks around the camera are generated on every core but the one rendering
+    UINT uNumThreads = std::max<UINT>(std::thread::hardware_concurrency(), 2u) - 1u;
+
+    // Same placement as the 256 x 32 x 256 map the terrain was first generated in, and the same terrain over it
+    std::shared_ptr<library::Scene> voxelMap = std::make_shared<library::Scene>(
+        std::make_unique<library::TerrainStreamer>(
+            library::TerrainStreamer::DEFAULT_RADIUS,
+            library::TerrainStreamer::DEFAULT_MAX_CHUNKS,
+            library::TerrainStreamer::DEFAULT_CHUNK_HEIGHT,
+            uNumThreads
+            ),
+        std::vector<XMFLOAT4>(aColors, aColors + ARRAYSIZE(aColors)),
+        XMFLOAT3(-256.0f, -40.0f, -256.0f),
+        library::eVoxelMesher::GREEDY
+        );
+    if (FAILED(game->GetRenderer()->AddScene(L"VoxelMap", voxelMap)))
     {
         return 0;
     }
 
-    if (FAILED(game->GetRenderer()->SetVertexShaderOfScene(L"VoxelMap", L"VoxelShader")))
+    if (FAILED(game->GetRenderer()->SetVertexShaderOfScene(L"VoxelMap", L"VoxelMeshShader")))
     {
         return 0;
     }
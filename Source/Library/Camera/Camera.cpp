@@ -1,5 +1,7 @@
 #include "Camera/Camera.h"
 
+#include "Scene/Scene.h"
+
 namespace library
 {
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -7,13 +9,15 @@ namespace library
 
 	  Summary:  Constructor
 
-	  Modifies: [m_yaw, m_pitch, m_moveLeftRight, m_moveBackForward,
-				 m_moveUpDown, m_travelSpeed, m_rotationSpeed,
-				 m_padding, m_cameraForward, m_cameraRight, m_cameraUp,
-				 m_eye, m_at, m_up, m_rotation, m_view].
+	  Modifies: [m_collisionScene, m_yaw, m_pitch, m_moveLeftRight,
+				 m_moveBackForward, m_moveUpDown, m_travelSpeed,
+				 m_rotationSpeed, m_padding, m_cameraForward,
+				 m_cameraRight, m_cameraUp, m_eye, m_at, m_up,
+				 m_rotation, m_view].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	Camera::Camera(_In_ const XMVECTOR& position) :
 		m_cbChangeOnCameraMovement(),
+		m_collisionScene(),
 		m_yaw(0.0f),
 		m_pitch(0.0f),
 		m_moveLeftRight(),
@@ -97,6 +101,22 @@ namespace library
 		return m_cbChangeOnCameraMovement;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Camera::SetCollisionScene
+
+	  Summary:  Sets the scene whose blocks stop the camera, nullptr to
+				move freely
+
+	  Args:     const std::shared_ptr<Scene>& scene
+				  Scene the camera collides with
+
+	  Modifies: [m_collisionScene].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Camera::SetCollisionScene(_In_ const std::shared_ptr<Scene>& scene)
+	{
+		m_collisionScene = scene;
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Camera::HandleInput
 
@@ -221,9 +241,26 @@ namespace library
 		m_cameraUp = XMVector3TransformCoord(DEFAULT_UP, yawRot);
 		m_cameraForward = XMVector3TransformCoord(DEFAULT_FORWARD, yawRot);
 
-		m_eye += m_moveLeftRight * m_cameraRight;
-		m_eye += m_moveUpDown * m_cameraUp;
-		m_eye += m_moveBackForward * m_cameraForward;
+		XMVECTOR movement = m_moveLeftRight * m_cameraRight;
+		movement += m_moveUpDown * m_cameraUp;
+		movement += m_moveBackForward * m_cameraForward;
+
+		// Slide along the blocks of the scene and climb steps of a block
+		if (m_collisionScene)
+		{
+			BoundingBox box;
+			XMStoreFloat3(&box.Center, m_eye);
+			box.Extents = COLLISION_EXTENTS;
+
+			XMFLOAT3 move;
+			XMStoreFloat3(&move, movement);
+
+			VoxelMove voxelMove;
+			m_collisionScene->MoveBox(box, move, STEP_HEIGHT, voxelMove);
+			movement = XMLoadFloat3(&voxelMove.movement);
+		}
+
+		m_eye += movement;
 
 		m_at = m_eye + XMVector3TransformCoord(DEFAULT_FORWARD, m_rotation);
 		m_up = XMVector3TransformCoord(DEFAULT_UP, m_rotation);
@@ -17,6 +17,8 @@
 
 namespace library
 {
+	class Scene;
+
 	/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
 	  Class:    Camera
 
@@ -33,6 +35,8 @@ namespace library
 				  Getter for the view transform matrix
 				GetConstantBuffer
 				  Get the constant buffer containing the view transform
+				SetCollisionScene
+				  Set the scene the camera collides with
 				HandleInput
 				  Handles the keyboard / mouse input
 				Initialize
@@ -60,6 +64,7 @@ namespace library
 		const XMVECTOR& GetUp() const;
 		const XMMATRIX& GetView() const;
 		ComPtr<ID3D11Buffer>& GetConstantBuffer();
+		void SetCollisionScene(_In_ const std::shared_ptr<Scene>& scene);
 
 		virtual void HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime);
 		virtual HRESULT Initialize(_In_ ID3D11Device* device);
@@ -68,8 +73,11 @@ namespace library
 		static constexpr const XMVECTORF32 DEFAULT_FORWARD = { 0.0f, 0.0f, 1.0f, 0.0f };
 		static constexpr const XMVECTORF32 DEFAULT_RIGHT = { 1.0f, 0.0f, 0.0f, 0.0f };
 		static constexpr const XMVECTORF32 DEFAULT_UP = { 0.0f, 1.0f, 0.0f, 0.0f };
+		static constexpr const XMFLOAT3 COLLISION_EXTENTS = XMFLOAT3(0.5f, 0.5f, 0.5f);
+		static constexpr const FLOAT STEP_HEIGHT = 2.0f;
 
 		ComPtr<ID3D11Buffer> m_cbChangeOnCameraMovement;
+		std::shared_ptr<Scene> m_collisionScene;
 
 		FLOAT m_yaw;
 		FLOAT m_pitch;
@@ -81,7 +89,7 @@ namespace library
 		FLOAT m_travelSpeed;
 		FLOAT m_rotationSpeed;
 
-		BYTE m_padding[12]; // struct alignment
+		BYTE m_padding[4]; // struct alignment
 
 		XMVECTOR m_cameraForward;
 		XMVECTOR m_cameraRight;
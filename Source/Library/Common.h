@@ -11,15 +11,9 @@
 ===================================================================+*/
 #pragma once
 
-#ifndef  UNICODE
-#define UNICODE
-#endif // ! UNICODE
+#include "Platform.h"
 
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif // ! WIN32_LEAN_AND_MEAN
-
-#include <windows.h>
+#ifdef _WIN32
 #include <wincodec.h>
 #include <wrl.h>
 
@@ -29,16 +23,31 @@
 
 #include <d3d11_4.h>
 #include <d3dcompiler.h>
+#include <directxcollision.h>
 #include <directxcolors.h>
 
 #define _CRTDBG_MAP_ALLOC
 #include <stdlib.h>
 #include <crtdbg.h>
+#else // _WIN32
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#endif // _WIN32
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <execution>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <span>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -47,7 +56,9 @@
 
 constexpr LPCWSTR PSZ_COURSE_TITLE = L"Game Graphics Programming";
 
+#ifdef _WIN32
 using namespace Microsoft::WRL;
+#endif // _WIN32
 using namespace DirectX;
 
 #define ASSIMP_LOAD_FLAGS (aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_ConvertToLeftHanded)
@@ -87,6 +98,7 @@ namespace library
     E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
     enum class eBlockType : CHAR
     {
+        AIR = 0,
         GRASSLAND = 21,
         SNOW,
         OCEAN,
@@ -14,6 +14,7 @@ namespace library
         : Renderable(outputColor)
         , m_instanceBuffer()
         , m_aInstanceData(std::vector<InstanceData>())
+        , m_uInstanceCapacity(0u)
         , m_padding()
     {}
 
@@ -27,12 +28,13 @@ namespace library
                 const XMFLOAT4& outputColor
                   Default color of the renderable
 
-      Modifies: [m_instanceBuffer, m_aInstanceData].
+      Modifies: [m_instanceBuffer, m_aInstanceData, m_uInstanceCapacity].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     InstancedRenderable::InstancedRenderable(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor)
         : Renderable(outputColor)
         , m_instanceBuffer()
         , m_aInstanceData(aInstanceData)
+        , m_uInstanceCapacity(0u)
         , m_padding()
     {}
 
@@ -51,6 +53,89 @@ namespace library
         m_aInstanceData = aInstanceData;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::UpdateInstanceData
+
+      Summary:  Sets the instance data and writes the range of instances
+                that changed into the instance buffer. A buffer too
+                small is created again with room for a quarter more
+                instances, since edits tend to come in series
+
+      Args:     ID3D11Device* pDevice
+                  Pointer to a Direct3D 11 device
+                ID3D11DeviceContext* pImmediateContext
+                  Pointer to the immediate context
+                std::vector<InstanceData>&& aInstanceData
+                  Instance data
+
+      Modifies: [m_instanceBuffer, m_aInstanceData, m_uInstanceCapacity].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT InstancedRenderable::UpdateInstanceData(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ std::vector<InstanceData>&& aInstanceData
+    )
+    {
+        size_t uFirst = 0u;
+        size_t uEnd = aInstanceData.size();
+
+        if (!m_instanceBuffer || aInstanceData.size() > m_uInstanceCapacity)
+        {
+            UINT uCapacity = std::max<UINT>(static_cast<UINT>(aInstanceData.size() + aInstanceData.size() / 4u), 1u);
+
+            D3D11_BUFFER_DESC bd = {
+                .ByteWidth = uCapacity * sizeof(InstanceData),
+                .Usage = D3D11_USAGE_DEFAULT,
+                .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+                .CPUAccessFlags = 0,
+                .MiscFlags = 0,
+                .StructureByteStride = 0
+            };
+
+            ComPtr<ID3D11Buffer> instanceBuffer;
+            HRESULT hr = pDevice->CreateBuffer(&bd, nullptr, instanceBuffer.GetAddressOf());
+            if (FAILED(hr))
+                return hr;
+
+            m_instanceBuffer = instanceBuffer;
+            m_uInstanceCapacity = uCapacity;
+        }
+        else
+        {
+            // Instances before the first change and, when the count is the same, after the last one are kept
+            size_t uNumCommon = std::min<size_t>(m_aInstanceData.size(), aInstanceData.size());
+            while (uFirst < uNumCommon && std::memcmp(&m_aInstanceData[uFirst], &aInstanceData[uFirst], sizeof(InstanceData)) == 0)
+                ++uFirst;
+
+            if (m_aInstanceData.size() == aInstanceData.size())
+            {
+                while (uEnd > uFirst && std::memcmp(&m_aInstanceData[uEnd - 1u], &aInstanceData[uEnd - 1u], sizeof(InstanceData)) == 0)
+                    --uEnd;
+            }
+        }
+
+        m_aInstanceData = std::move(aInstanceData);
+
+        if (uFirst < uEnd)
+        {
+            D3D11_BOX box = {
+                .left = static_cast<UINT>(uFirst * sizeof(InstanceData)),
+                .top = 0u,
+                .front = 0u,
+                .right = static_cast<UINT>(uEnd * sizeof(InstanceData)),
+                .bottom = 1u,
+                .back = 1u
+            };
+
+            pImmediateContext->UpdateSubresource(m_instanceBuffer.Get(), 0u, &box, m_aInstanceData.data() + uFirst, 0u, 0u);
+        }
+
+        return S_OK;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   InstancedRenderable::GetInstanceBuffer
 
@@ -85,7 +170,7 @@ namespace library
       Args:     ID3D11Device* pDevice
                   Pointer to a Direct3D 11 device
 
-      Modifies: [m_instanceBuffer].
+      Modifies: [m_instanceBuffer, m_uInstanceCapacity].
 
       Returns:  HRESULT
                   Status code
@@ -113,6 +198,8 @@ namespace library
         if (FAILED(hr))
             return hr;
 
+        m_uInstanceCapacity = GetNumInstances();
+
         return hr;
     }
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Model/MeshMerger.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshMerger::CanAppend
+
+      Summary:  Returns whether an index range directly follows the
+                previous one in the index buffer, its vertices do not
+                come before the base vertex of the previous one, and its
+                largest index rebased onto that base vertex fits in a
+                WORD
+
+      Args:     const IndexRange& previous
+                  Index range of the previous draw
+                const IndexRange& range
+                  Index range to append
+                const std::vector<WORD>& aIndices
+                  Index buffer of both ranges
+
+      Returns:  BOOL
+                  TRUE if the range can be appended
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL MeshMerger::CanAppend(_In_ const IndexRange& previous, _In_ const IndexRange& range, _In_ const std::vector<WORD>& aIndices)
+    {
+        if (static_cast<UINT64>(previous.uBaseIndex) + previous.uNumIndices != range.uBaseIndex
+            || static_cast<UINT64>(range.uBaseIndex) + range.uNumIndices > aIndices.size()
+            || range.uBaseVertex < previous.uBaseVertex)
+            return FALSE;
+
+        if (range.uNumIndices == 0u)
+            return TRUE;
+
+        // Computed in 64 bits, so a far away base vertex cannot wrap back under the limit
+        auto begin = aIndices.begin() + range.uBaseIndex;
+        UINT64 uMaxIndex = *std::max_element(begin, begin + range.uNumIndices);
+        return uMaxIndex + (range.uBaseVertex - previous.uBaseVertex) <= MAX_INDEX;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshMerger::Append
+
+      Summary:  Rebases the indices of a range onto the base vertex of
+                the previous range and extends the previous range over
+                them. Nothing is changed if the range cannot be appended
+
+      Args:     IndexRange& previous
+                  Index range of the previous draw
+                const IndexRange& range
+                  Index range to append
+                std::vector<WORD>& aIndices
+                  Index buffer of both ranges
+
+      Modifies: [previous, aIndices].
+
+      Returns:  BOOL
+                  TRUE if the range was appended
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL MeshMerger::Append(_Inout_ IndexRange& previous, _In_ const IndexRange& range, _Inout_ std::vector<WORD>& aIndices)
+    {
+        if (!CanAppend(previous, range, aIndices))
+            return FALSE;
+
+        WORD delta = static_cast<WORD>(range.uBaseVertex - previous.uBaseVertex);
+        auto begin = aIndices.begin() + range.uBaseIndex;
+        std::for_each(begin, begin + range.uNumIndices,
+            [delta](WORD& index)
+            {
+                index = static_cast<WORD>(index + delta);
+            }
+        );
+
+        previous.uNumIndices += range.uNumIndices;
+        return TRUE;
+    }
+}
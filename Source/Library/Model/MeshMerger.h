@@ -0,0 +1,62 @@
+/*+===================================================================
+  File:      MESHMERGER.H
+
+  Summary:   MeshMerger header file contains declaration of class
+             MeshMerger used to join the 16-bit index ranges of
+             consecutive meshes into single draws.
+
+  Classes:  MeshMerger
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   IndexRange
+
+        Summary:  Indices of one draw, each one relative to uBaseVertex
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct IndexRange
+    {
+        UINT uNumIndices;
+        UINT uBaseVertex;
+        UINT uBaseIndex;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshMerger
+
+      Summary:  Appends the index range of a mesh to the range of the
+                draw before it. The indices of the appended mesh are
+                rebased onto the base vertex of the draw, which is only
+                done when every rebased index still fits in a WORD
+
+      Methods:  Append
+                  Joins an index range onto the previous one
+                CanAppend
+                  Returns whether an index range can be joined
+                MeshMerger
+                  Constructor.
+                ~MeshMerger
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshMerger final
+    {
+    public:
+        static constexpr const UINT MAX_INDEX = 0xFFFFu;
+
+        MeshMerger() = delete;
+        MeshMerger(const MeshMerger& other) = delete;
+        MeshMerger(MeshMerger&& other) = delete;
+        MeshMerger& operator=(const MeshMerger& other) = delete;
+        MeshMerger& operator=(MeshMerger&& other) = delete;
+        ~MeshMerger() = default;
+
+        static BOOL CanAppend(_In_ const IndexRange& previous, _In_ const IndexRange& range, _In_ const std::vector<WORD>& aIndices);
+        static BOOL Append(_Inout_ IndexRange& previous, _In_ const IndexRange& range, _Inout_ std::vector<WORD>& aIndices);
+    };
+}
@@ -1,5 +1,7 @@
 #include "Model/Model.h"
 
+#include "Model/MeshMerger.h"
+
 #include "assimp/Importer.hpp"
 #include "assimp/scene.h"		
 #include "assimp/postprocess.h"
@@ -62,6 +64,8 @@ namespace library
     }
 
     std::unique_ptr<Assimp::Importer> Model::sm_pImporter = std::make_unique<Assimp::Importer>();
+    std::unique_ptr<TextureCache<Texture>> Model::sm_pTextureCache = std::make_unique<TextureCache<Texture>>();
+    BOOL Model::sm_bParallelLoading = TRUE;
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Model
@@ -75,7 +79,8 @@ namespace library
                  m_skinningConstantBuffer, m_aVertices, m_aAnimationData,
                  m_aIndices, m_aBoneData, m_aBoneInfo, m_aTransforms,
                  m_aBoneInfo, m_aTransforms, m_boneNameToIndexMap,
-                 m_pScene, m_timeSinceLoaded, m_globalInverseTransform].
+                 m_pTextureAtlas, m_pScene, m_timeSinceLoaded,
+                 m_globalInverseTransform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Model::Model(_In_ const std::filesystem::path& filePath)
         : Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f))
@@ -89,6 +94,7 @@ namespace library
         , m_aBoneInfo()
         , m_aTransforms()
         , m_boneNameToIndexMap()
+        , m_pTextureAtlas()
         , m_pScene()
         , m_timeSinceLoaded()
         , m_globalInverseTransform()
@@ -282,6 +288,36 @@ namespace library
         return m_boneNameToIndexMap;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetTextureCache
+
+        Summary:  Returns the texture cache shared by every model
+
+        Returns:  TextureCache<Texture>&
+
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureCache<Texture>& Model::GetTextureCache()
+    {
+        return *sm_pTextureCache;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SetParallelLoading
+
+        Summary:  Sets whether the models initialized next convert their
+                  meshes and decode their textures in parallel, the
+                  default, or one after the other
+
+        Args:     BOOL bParallelLoading
+                    TRUE to load in parallel
+
+        Modifies: [sm_bParallelLoading].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetParallelLoading(_In_ BOOL bParallelLoading)
+    {
+        sm_bParallelLoading = bParallelLoading;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
         Method:   Model::countVerticesAndIndices
 
@@ -461,6 +497,49 @@ namespace library
     }
 
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getTexturePath
+
+      Summary:  Returns the path to the first texture of the given type
+
+      Args:     const std::filesystem::path& parentDirectory
+                  Parent path to the model
+                const aiMaterial* pMaterial
+                  Pointer to an assimp material object
+                UINT uTextureType
+                  aiTextureType of the texture
+                std::filesystem::path& outPath
+                  Path to the texture
+
+      Returns:  BOOL
+                  TRUE if the material has a texture of the type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Model::getTexturePath(
+        _In_ const std::filesystem::path& parentDirectory,
+        _In_ const aiMaterial* pMaterial,
+        _In_ UINT uTextureType,
+        _Out_ std::filesystem::path& outPath
+    )
+    {
+        aiTextureType textureType = static_cast<aiTextureType>(uTextureType);
+        if (pMaterial->GetTextureCount(textureType) == 0u)
+            return FALSE;
+
+        aiString aiPath;
+        if (pMaterial->GetTexture(textureType, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) != AI_SUCCESS)
+            return FALSE;
+
+        std::string szPath(aiPath.data);
+
+        if (szPath.substr(0ull, 2ull) == ".\\")
+        {
+            szPath = szPath.substr(2ull, szPath.size() - 2ull);
+        }
+
+        outPath = parentDirectory / szPath;
+        return TRUE;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::getVertices
 
@@ -496,11 +575,53 @@ namespace library
                   Assimp scene
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Model::initAllMeshes(_In_ const aiScene* pScene)
+    {
+        // Bone ids are shared by every mesh, so they are assigned up front
+        initBoneInfos(pScene);
+
+        // Each mesh writes only to its own [uBaseVertex, uBaseIndex] ranges
+        std::vector<UINT> aMeshIndices(m_aMeshes.size());
+        std::iota(aMeshIndices.begin(), aMeshIndices.end(), 0u);
+
+        auto initMesh = [this, pScene](UINT uMeshIndex)
+        {
+            initSingleMesh(uMeshIndex, pScene->mMeshes[uMeshIndex]);
+        };
+
+        if (sm_bParallelLoading)
+            std::for_each(std::execution::par, aMeshIndices.begin(), aMeshIndices.end(), initMesh);
+        else
+            std::for_each(aMeshIndices.begin(), aMeshIndices.end(), initMesh);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initBoneInfos
+
+      Summary:  Assign an index to every bone in a given assimp scene
+                and store its offset matrix
+
+      Args:     const aiScene* pScene
+                  Assimp scene
+
+      Modifies: [m_boneNameToIndexMap, m_aBoneInfo].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initBoneInfos(_In_ const aiScene* pScene)
     {
         for (UINT i = 0u; i < m_aMeshes.size(); ++i)
         {
             const aiMesh* pMesh = pScene->mMeshes[i];
-            initSingleMesh(i, pMesh);
+
+            for (UINT j = 0u; j < pMesh->mNumBones; ++j)
+            {
+                const aiBone* pBone = pMesh->mBones[j];
+                UINT uBoneId = getBoneId(pBone);
+
+                if (uBoneId == m_aBoneInfo.size())
+                {
+                    BoneInfo boneInfo(ConvertMatrix(pBone->mOffsetMatrix));
+                    m_aBoneInfo.push_back(boneInfo);
+                }
+            }
         }
     }
 
@@ -542,16 +663,20 @@ namespace library
         if (FAILED(hr))
             return hr;
 
+        mergeMeshes();
+
         // Create AnimationData for the vertex
-        for (auto it : m_aBoneData)
-        {
-            AnimationData animdata = 
+        m_aAnimationData.resize(m_aBoneData.size());
+        std::transform(std::execution::par_unseq, m_aBoneData.begin(), m_aBoneData.end(), m_aAnimationData.begin(),
+            [](const VertexBoneData& boneData)
             {
-                .aBoneIndices = static_cast<XMUINT4>(it.aBoneIds),
-                .aBoneWeights = static_cast<XMFLOAT4>(it.aWeights)
-            };
-            m_aAnimationData.push_back(animdata);
-        }
+                return AnimationData
+                {
+                    .aBoneIndices = static_cast<XMUINT4>(boneData.aBoneIds),
+                    .aBoneWeights = static_cast<XMFLOAT4>(boneData.aWeights)
+                };
+            }
+        );
 
         hr = initialize(pDevice, pImmediateContext);
         if (FAILED(hr))
@@ -563,7 +688,11 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::initMaterials
 
-      Summary:  Initialize all materials in a given assimp scene
+      Summary:  Initialize all materials in a given assimp scene. The
+                small diffuse textures of materials without a specular
+                texture and sampled only inside [0, 1] are packed into
+                one atlas, and the texture coordinates of their meshes
+                are remapped into it
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
@@ -574,6 +703,8 @@ namespace library
                 const std::filesystem::path& filePath
                   Path to the model
 
+      Modifies: [m_aMaterials, m_aVertices, m_pTextureAtlas].
+
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -589,14 +720,111 @@ namespace library
         // Extract the directory part from the file name
         std::filesystem::path parentDirectory = filePath.parent_path();
 
-        // Initialize the materials
+        // Gather the texture files of every material
+        std::vector<std::filesystem::path> aDiffusePaths(pScene->mNumMaterials);
+        std::vector<std::filesystem::path> aSpecularPaths(pScene->mNumMaterials);
+        std::vector<std::filesystem::path> aAtlasPaths;
+        std::vector<UINT> aAtlasMaterials;
+
         for (UINT i = 0u; i < pScene->mNumMaterials; ++i)
         {
             const aiMaterial* pMaterial = pScene->mMaterials[i];
 
-            loadTextures(pDevice, pImmediateContext, parentDirectory, pMaterial, i);
+            m_aMaterials[i].pDiffuse = nullptr;
+            m_aMaterials[i].pSpecular = nullptr;
+
+            BOOL bHasDiffuse = getTexturePath(parentDirectory, pMaterial, aiTextureType_DIFFUSE, aDiffusePaths[i]);
+            BOOL bHasSpecular = getTexturePath(parentDirectory, pMaterial, aiTextureType_SHININESS, aSpecularPaths[i]);
+
+            // The specular texture keeps the source texture coordinates, so only lone diffuse textures are packed
+            if (bHasDiffuse && !bHasSpecular && isTexCoordInUnitSquare(pScene, i))
+            {
+                aAtlasPaths.push_back(aDiffusePaths[i]);
+                aAtlasMaterials.push_back(i);
+            }
         }
 
+        if (aAtlasPaths.size() > 1u)
+        {
+            // The atlas only lives in memory, it is named after the model
+            m_pTextureAtlas = std::make_shared<TextureAtlas>();
+            hr = m_pTextureAtlas->Build(filePath, aAtlasPaths);
+            if (hr == S_OK)
+                hr = m_pTextureAtlas->GetTexture()->Initialize(pDevice, pImmediateContext);
+
+            // Without an atlas every texture is loaded on its own
+            if (hr != S_OK)
+                m_pTextureAtlas.reset();
+            else
+            {
+                OutputDebugString(L"Packed texture atlas of \"");
+                OutputDebugString(filePath.c_str());
+                OutputDebugString(L"\"\n");
+            }
+
+            hr = S_OK;
+        }
+
+        if (m_pTextureAtlas)
+        {
+            for (UINT uMaterialIndex : aAtlasMaterials)
+            {
+                AtlasRegion region;
+                if (!m_pTextureAtlas->GetRegion(aDiffusePaths[uMaterialIndex], region))
+                    continue;
+
+                m_aMaterials[uMaterialIndex].pDiffuse = m_pTextureAtlas->GetTexture();
+                remapTexCoords(pScene, uMaterialIndex, region);
+                aDiffusePaths[uMaterialIndex].clear();
+            }
+        }
+
+        std::vector<std::filesystem::path> aTexturePaths;
+        std::vector<std::shared_ptr<Texture>*> apTextureSlots;
+        aTexturePaths.reserve(static_cast<size_t>(pScene->mNumMaterials) * 2u);
+        apTextureSlots.reserve(static_cast<size_t>(pScene->mNumMaterials) * 2u);
+
+        for (UINT i = 0u; i < pScene->mNumMaterials; ++i)
+        {
+            if (!aDiffusePaths[i].empty())
+            {
+                aTexturePaths.push_back(aDiffusePaths[i]);
+                apTextureSlots.push_back(&m_aMaterials[i].pDiffuse);
+            }
+
+            if (!aSpecularPaths[i].empty())
+            {
+                aTexturePaths.push_back(aSpecularPaths[i]);
+                apTextureSlots.push_back(&m_aMaterials[i].pSpecular);
+            }
+        }
+
+        // Decode in parallel, then upload, a texture that fails to load is left empty
+        std::vector<std::shared_ptr<Texture>> apTextures;
+        if (sm_bParallelLoading)
+            sm_pTextureCache->GetOrLoadBatch(pDevice, pImmediateContext, aTexturePaths, apTextures);
+        else
+        {
+            apTextures.resize(aTexturePaths.size());
+            for (size_t i = 0u; i < aTexturePaths.size(); ++i)
+                sm_pTextureCache->GetOrLoad(pDevice, pImmediateContext, aTexturePaths[i], apTextures[i]);
+        }
+
+        for (size_t i = 0u; i < apTextures.size(); ++i)
+        {
+            *apTextureSlots[i] = apTextures[i];
+
+            OutputDebugString(apTextures[i] ? L"Loaded texture \"" : L"Error loading texture \"");
+            OutputDebugString(aTexturePaths[i].c_str());
+            OutputDebugString(L"\"\n");
+        }
+
+        WCHAR szDebugMessage[128];
+        swprintf_s(szDebugMessage, L"Texture cache: %u hits, %u misses, %u evictions, %zu bytes\n",
+            sm_pTextureCache->GetNumHits(), sm_pTextureCache->GetNumMisses(), sm_pTextureCache->GetNumEvictions(),
+            sm_pTextureCache->GetMemoryUsage());
+        OutputDebugString(szDebugMessage);
+
         return hr;
     }
 
@@ -618,20 +846,16 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::initMeshSingleBone
 
-      Summary:  Initialize a single bone of the mesh
+      Summary:  Initialize the vertex weights of a single bone of the
+                mesh. The bone must have been registered by
+                initBoneInfos
 
       Args:     const aiScene* pScene
                   Assimp scene
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Model::initMeshSingleBone(_In_ UINT uMeshIndex, _In_ const aiBone* pBone)
     {
-        UINT uBoneId = getBoneId(pBone);
-
-        if (uBoneId == m_aBoneInfo.size())
-        {
-            BoneInfo boneInfo(ConvertMatrix(pBone->mOffsetMatrix));
-            m_aBoneInfo.push_back(boneInfo);
-        }
+        UINT uBoneId = m_boneNameToIndexMap.at(pBone->mName.C_Str());
 
         for (UINT i = 0u; i < pBone->mNumWeights; ++i)
         {
@@ -653,6 +877,7 @@ namespace library
     void Model::initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh)
     {
         const aiVector3D zero3d(0.0f, 0.0f, 0.0f);
+        const BasicMeshEntry& mesh = m_aMeshes[uMeshIndex];
 
         for (UINT i = 0u; i < pMesh->mNumVertices; ++i)
         {
@@ -667,7 +892,7 @@ namespace library
                 .Normal = XMFLOAT3(normal.x, normal.y, normal.z)
             };
 
-            m_aVertices.push_back(vertex);
+            m_aVertices[static_cast<size_t>(mesh.uBaseVertex) + i] = vertex;
         }
 
         for (UINT i = 0u; i < pMesh->mNumFaces; ++i)
@@ -675,16 +900,10 @@ namespace library
             const aiFace& face = pMesh->mFaces[i];
             assert(face.mNumIndices == 3);
 
-            WORD aIndices[3] =
-            {
-                static_cast<WORD>(face.mIndices[0]),
-                static_cast<WORD>(face.mIndices[1]),
-                static_cast<WORD>(face.mIndices[2])
-            };
-
-            m_aIndices.push_back(aIndices[0]);
-            m_aIndices.push_back(aIndices[1]);
-            m_aIndices.push_back(aIndices[2]);
+            WORD* pIndices = &m_aIndices[static_cast<size_t>(mesh.uBaseIndex) + static_cast<size_t>(i) * 3u];
+            pIndices[0] = static_cast<WORD>(face.mIndices[0]);
+            pIndices[1] = static_cast<WORD>(face.mIndices[1]);
+            pIndices[2] = static_cast<WORD>(face.mIndices[2]);
         }
 
         initMeshBones(uMeshIndex, pMesh);
@@ -798,169 +1017,94 @@ namespace library
 
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::loadDiffuseTexture
+      Method:   Model::isTexCoordInUnitSquare
 
-      Summary:  Load a diffuse texture from given path
+      Summary:  Check whether every mesh using the given material only
+                samples inside [0, 1], so that its texture can be placed
+                in an atlas without wrapping
 
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
-                  Parent path to the model
-                const aiMaterial* pMaterial
-                  Pointer to an assimp material object
-                UINT uIndex
-                  Index to a material
+      Args:     const aiScene* pScene
+                  Assimp scene
+                UINT uMaterialIndex
+                  Index of the material
+
+      Returns:  BOOL
+                  True if all texture coordinates lie in the unit square
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadDiffuseTexture(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
-        _In_ UINT uIndex
-    )
+    BOOL Model::isTexCoordInUnitSquare(_In_ const aiScene* pScene, _In_ UINT uMaterialIndex) const
     {
-        HRESULT hr = S_OK;
-        m_aMaterials[uIndex].pDiffuse = nullptr;
+        constexpr const FLOAT EPSILON = 1.0e-4f;
 
-        if (pMaterial->GetTextureCount(aiTextureType_DIFFUSE) > 0)
+        for (UINT i = 0u; i < pScene->mNumMeshes; ++i)
         {
-            aiString aiPath;
+            if (m_aMeshes[i].uMaterialIndex != uMaterialIndex)
+                continue;
 
-            if (pMaterial->GetTexture(aiTextureType_DIFFUSE, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
-            {
-                std::string szPath(aiPath.data);
+            auto begin = m_aVertices.begin() + m_aMeshes[i].uBaseVertex;
+            auto end = begin + pScene->mMeshes[i]->mNumVertices;
 
-                if (szPath.substr(0ull, 2ull) == ".\\")
+            BOOL bIsInside = std::all_of(begin, end,
+                [EPSILON](const SimpleVertex& vertex)
                 {
-                    szPath = szPath.substr(2ull, szPath.size() - 2ull);
+                    return vertex.TexCoord.x >= -EPSILON && vertex.TexCoord.x <= 1.0f + EPSILON
+                        && vertex.TexCoord.y >= -EPSILON && vertex.TexCoord.y <= 1.0f + EPSILON;
                 }
-
-                std::filesystem::path fullPath = parentDirectory / szPath;
-
-                m_aMaterials[uIndex].pDiffuse = std::make_shared<Texture>(fullPath);
-
-                hr = m_aMaterials[uIndex].pDiffuse->Initialize(pDevice, pImmediateContext);
-                if (FAILED(hr))
-                {
-                    OutputDebugString(L"Error loading diffuse texture \"");
-                    OutputDebugString(fullPath.c_str());
-                    OutputDebugString(L"\"\n");
-
-                    return hr;
-                }
-
-                OutputDebugString(L"Loaded diffuse texture \"");
-                OutputDebugString(fullPath.c_str());
-                OutputDebugString(L"\"\n");
-            }
+            );
+            if (!bIsInside)
+                return FALSE;
         }
 
-        return hr;
+        return TRUE;
     }
 
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-       Method:   Model::loadSpecularTexture
-
-       Summary:  Load a specular texture from given path
-
-       Args:     ID3D11Device* pDevice
-                   The Direct3D device to create the buffers
-                 ID3D11DeviceContext* pImmediateContext
-                   The Direct3D context to set buffers
-                 const std::filesystem::path& parentDirectory
-                   Parent path to the model
-                 const aiMaterial* pMaterial
-                   Pointer to an assimp material object
-                 UINT uIndex
-                   Index to a material
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadSpecularTexture(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
-        _In_ UINT uIndex
-    )
-    {
-        HRESULT hr = S_OK;
-        m_aMaterials[uIndex].pSpecular = nullptr;
-
-        if (pMaterial->GetTextureCount(aiTextureType_SHININESS) > 0)
-        {
-            aiString aiPath;
+      Method:   Model::mergeMeshes
 
-            if (pMaterial->GetTexture(aiTextureType_SHININESS, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
-            {
-                std::string szPath(aiPath.data);
-
-                if (szPath.substr(0ull, 2ull) == ".\\")
-                {
-                    szPath = szPath.substr(2ull, szPath.size() - 2ull);
-                }
+      Summary:  Merge consecutive meshes binding the same textures into
+                one draw with MeshMerger. A mesh whose rebased indices
+                would pass the 16-bit limit starts a new draw instead
 
-                std::filesystem::path fullPath = parentDirectory / szPath;
+      Modifies: [m_aMeshes, m_aIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::mergeMeshes()
+    {
+        if (m_aMeshes.size() < 2u)
+            return;
 
-                m_aMaterials[uIndex].pSpecular = std::make_shared<Texture>(fullPath);
+        std::vector<BasicMeshEntry> aMergedMeshes;
+        aMergedMeshes.reserve(m_aMeshes.size());
+        aMergedMeshes.push_back(m_aMeshes[0]);
 
-                hr = m_aMaterials[uIndex].pSpecular->Initialize(pDevice, pImmediateContext);
-                if (FAILED(hr))
-                {
-                    OutputDebugString(L"Error loading specular texture \"");
-                    OutputDebugString(fullPath.c_str());
-                    OutputDebugString(L"\"\n");
+        for (size_t i = 1u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            BasicMeshEntry& last = aMergedMeshes.back();
 
-                    return hr;
-                }
+            BOOL bSameTextures = mesh.uMaterialIndex != INVALID_MATERIAL
+                && last.uMaterialIndex != INVALID_MATERIAL
+                && m_aMaterials[mesh.uMaterialIndex].pDiffuse == m_aMaterials[last.uMaterialIndex].pDiffuse
+                && m_aMaterials[mesh.uMaterialIndex].pSpecular == m_aMaterials[last.uMaterialIndex].pSpecular;
 
-                OutputDebugString(L"Loaded specular texture \"");
-                OutputDebugString(fullPath.c_str());
-                OutputDebugString(L"\"\n");
+            IndexRange lastRange = { .uNumIndices = last.uNumIndices, .uBaseVertex = last.uBaseVertex, .uBaseIndex = last.uBaseIndex };
+            IndexRange range = { .uNumIndices = mesh.uNumIndices, .uBaseVertex = mesh.uBaseVertex, .uBaseIndex = mesh.uBaseIndex };
+            if (!bSameTextures || !MeshMerger::Append(lastRange, range, m_aIndices))
+            {
+                aMergedMeshes.push_back(mesh);
+                continue;
             }
-        }
-
-        return hr;
-    }
-
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::loadTextures
-
-      Summary:  Load a specular texture from given path
 
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
-                  Parent path to the model
-                const aiMaterial* pMaterial
-                  Pointer to an assimp material object
-                UINT uIndex
-                  Index to a material
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadTextures(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
-        _In_ UINT uIndex
-    )
-    {
-        HRESULT hr = loadDiffuseTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
-        if (FAILED(hr))
-        {
-            return hr;
+            last.uNumIndices = lastRange.uNumIndices;
         }
 
-        hr = loadSpecularTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
-        if (FAILED(hr))
+        if (aMergedMeshes.size() != m_aMeshes.size())
         {
-            return hr;
+            WCHAR szDebugMessage[64];
+            swprintf_s(szDebugMessage, L"Merged %zu meshes into %zu draws\n", m_aMeshes.size(), aMergedMeshes.size());
+            OutputDebugString(szDebugMessage);
         }
 
-        return hr;
+        m_aMeshes = std::move(aMergedMeshes);
     }
 
 
@@ -1016,10 +1160,46 @@ namespace library
             readNodeHierarchy(animationTimeTicks, pNode->mChildren[i], globalTransformation);
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::remapTexCoords
+
+      Summary:  Map the texture coordinates of every mesh using the given
+                material into its region of the texture atlas
+
+      Args:     const aiScene* pScene
+                  Assimp scene
+                UINT uMaterialIndex
+                  Index of the material
+                const AtlasRegion& region
+                  Region of the material texture in the atlas
+
+      Modifies: [m_aVertices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::remapTexCoords(_In_ const aiScene* pScene, _In_ UINT uMaterialIndex, _In_ const AtlasRegion& region)
+    {
+        for (UINT i = 0u; i < pScene->mNumMeshes; ++i)
+        {
+            if (m_aMeshes[i].uMaterialIndex != uMaterialIndex)
+                continue;
+
+            auto begin = m_aVertices.begin() + m_aMeshes[i].uBaseVertex;
+            auto end = begin + pScene->mMeshes[i]->mNumVertices;
+
+            std::for_each(begin, end,
+                [&region](SimpleVertex& vertex)
+                {
+                    vertex.TexCoord = AtlasPacker::RemapTexCoord(region, vertex.TexCoord);
+                }
+            );
+        }
+    }
+
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::reserveSpace
 
-      Summary:  Reserve space for vertices and indices vectors
+      Summary:  Allocate vertices and indices vectors so that meshes can
+                be written directly into their ranges
 
       Args:     UINT uNumVertices
                   Number of vertices
@@ -1028,8 +1208,8 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Model::reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices)
     {
-        m_aVertices.reserve(uNumVertices);
-        m_aIndices.reserve(uNumIndices);
+        m_aVertices.resize(uNumVertices);
+        m_aIndices.resize(uNumIndices);
         m_aBoneData.resize(uNumVertices);
     }
 }
\ No newline at end of file
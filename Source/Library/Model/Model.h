@@ -18,6 +18,8 @@
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Texture/Material.h"
+#include "Texture/TextureAtlas.h"
+#include "Texture/TextureCache.h"
 
 struct aiScene;
 struct aiMesh;
@@ -60,6 +62,11 @@ namespace library
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                GetTextureCache
+                  Returns the texture cache shared by every model
+                SetParallelLoading
+                  Sets whether the models initialized next convert
+                  their meshes and load their textures in parallel
                 Model
                   Constructor.
                 ~Model
@@ -88,6 +95,9 @@ namespace library
         std::vector<XMMATRIX>& GetBoneTransforms();
         const std::unordered_map<std::string, UINT>& GetBoneNameToIndexMap() const;
 
+        static TextureCache<Texture>& GetTextureCache();
+        static void SetParallelLoading(_In_ BOOL bParallelLoading);
+
     protected:
         struct VertexBoneData
         {
@@ -106,11 +116,6 @@ namespace library
 
                 aBoneIds[uNumBones] = uBoneId;
                 aWeights[uNumBones] = weight;
-
-                static CHAR szDebugMessage[256];
-                sprintf_s(szDebugMessage, "\t\t\tBone %d, weight: %f, index %u\n", uBoneId, weight, uNumBones);
-                OutputDebugStringA(szDebugMessage);
-
                 ++uNumBones;
             }
 
@@ -138,9 +143,16 @@ namespace library
         UINT findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         UINT findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         UINT getBoneId(_In_ const aiBone* pBone);
+        BOOL getTexturePath(
+            _In_ const std::filesystem::path& parentDirectory,
+            _In_ const aiMaterial* pMaterial,
+            _In_ UINT uTextureType,
+            _Out_ std::filesystem::path& outPath
+        );
         const virtual SimpleVertex* getVertices() const override;
         virtual const WORD* getIndices() const override;
         void initAllMeshes(_In_ const aiScene* pScene);
+        void initBoneInfos(_In_ const aiScene* pScene);
         HRESULT initFromScene(
             _In_ ID3D11Device* pDevice,
             _In_ ID3D11DeviceContext* pImmediateContext,
@@ -159,32 +171,16 @@ namespace library
         void interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         void interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         void interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        HRESULT loadDiffuseTexture(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
-        );
-        HRESULT loadSpecularTexture(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
-        );
-        HRESULT loadTextures(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
-        );
+        BOOL isTexCoordInUnitSquare(_In_ const aiScene* pScene, _In_ UINT uMaterialIndex) const;
+        void mergeMeshes();
         void readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform);
+        void remapTexCoords(_In_ const aiScene* pScene, _In_ UINT uMaterialIndex, _In_ const AtlasRegion& region);
         void reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices);
 
     protected:
         static std::unique_ptr<Assimp::Importer> sm_pImporter;
+        static std::unique_ptr<TextureCache<Texture>> sm_pTextureCache;
+        static BOOL sm_bParallelLoading;
 
     protected:
         std::filesystem::path m_filePath;
@@ -199,6 +195,7 @@ namespace library
         std::vector<BoneInfo> m_aBoneInfo;
         std::vector<XMMATRIX> m_aTransforms;
         std::unordered_map<std::string, UINT> m_boneNameToIndexMap;
+        std::shared_ptr<TextureAtlas> m_pTextureAtlas;
 
         const aiScene* m_pScene;
 
@@ -0,0 +1,128 @@
+/*+===================================================================
+  File:      PLATFORM.H
+
+  Summary:   Platform header file that contains the Windows types and
+             macros used by the parts of the Library project that do
+             not touch the graphics API, so that they also build
+             outside of Windows.
+
+  Functions:
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#ifdef _WIN32
+
+#ifndef  UNICODE
+#define UNICODE
+#endif // ! UNICODE
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // ! WIN32_LEAN_AND_MEAN
+
+#include <windows.h>
+
+#else // _WIN32
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cwchar>
+
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef char CHAR;
+typedef unsigned short WORD;
+typedef unsigned long DWORD;
+typedef int INT;
+typedef unsigned int UINT;
+typedef std::int32_t LONG;
+typedef std::uint32_t ULONG;
+typedef std::int64_t INT64;
+typedef std::uint64_t UINT64;
+typedef std::uint32_t UINT32;
+typedef std::size_t SIZE_T;
+typedef float FLOAT;
+typedef void* LPVOID;
+typedef const wchar_t* LPCWSTR;
+typedef wchar_t WCHAR;
+typedef std::int32_t HRESULT;
+
+#ifndef TRUE
+#define TRUE 1
+#endif // ! TRUE
+
+#ifndef FALSE
+#define FALSE 0
+#endif // ! FALSE
+
+#define S_OK                        ((HRESULT)0L)
+#define S_FALSE                     ((HRESULT)1L)
+#define E_FAIL                      ((HRESULT)0x80004005L)
+#define E_POINTER                   ((HRESULT)0x80004003L)
+#define E_INVALIDARG                ((HRESULT)0x80070057L)
+#define E_OUTOFMEMORY               ((HRESULT)0x8007000EL)
+#define E_NOT_SUFFICIENT_BUFFER     ((HRESULT)0x8007007AL)
+
+#define ERROR_FILE_NOT_FOUND        2L
+#define ERROR_PATH_NOT_FOUND        3L
+#define ERROR_INVALID_DATA          13L
+#define ERROR_WRITE_FAULT           29L
+#define ERROR_READ_FAULT            30L
+#define ERROR_HANDLE_EOF            38L
+#define ERROR_NOT_SUPPORTED         50L
+#define ERROR_CANNOT_MAKE           82L
+#define ERROR_ARITHMETIC_OVERFLOW   534L
+
+#define SUCCEEDED(hr)               (((HRESULT)(hr)) >= 0)
+#define FAILED(hr)                  (((HRESULT)(hr)) < 0)
+#define HRESULT_FROM_WIN32(x)       ((HRESULT)(x) <= 0 ? (HRESULT)(x) : (HRESULT)(((x) & 0x0000FFFF) | (7 << 16) | 0x80000000))
+
+#define UNREFERENCED_PARAMETER(P)   (void)(P)
+#define ARRAYSIZE(A)                (sizeof(A) / sizeof((A)[0]))
+
+// Debug output goes to the standard error stream when there is no debugger to send it to
+inline void OutputDebugStringW(const wchar_t* pszOutputString)
+{
+    std::fputws(pszOutputString, stderr);
+}
+
+#define OutputDebugString OutputDebugStringW
+
+#if __has_include(<sal.h>)
+#include <sal.h>
+#else
+#define _In_
+#define _In_opt_
+#define _In_z_
+#define _In_reads_(size)
+#define _In_reads_bytes_(size)
+#define _In_reads_opt_(size)
+#define _Inout_
+#define _Inout_updates_(size)
+#define _Out_
+#define _Out_opt_
+#define _Out_writes_(size)
+#define _Out_writes_opt_(size)
+#define _Out_writes_bytes_(size)
+#define _Outptr_
+#define _Outptr_opt_
+#define _Use_decl_annotations_
+#define _Analysis_assume_(expr)
+#endif // __has_include(<sal.h>)
+
+#endif // _WIN32
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
@@ -0,0 +1,769 @@
+#include "Renderer/BoundingVolumeHierarchy.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::BoundingVolumeHierarchy
+
+      Summary:  Constructor
+
+      Modifies: [m_aNodes, m_aItemBounds, m_aItemOrder, m_aItemLeaves].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+        : m_aNodes()
+        , m_aItemBounds()
+        , m_aItemOrder()
+        , m_aItemLeaves()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::Build
+
+      Summary:  Builds the tree over the boxes of the items, top down.
+                Nodes of more than MAX_LEAF_SIZE items are split where
+                the surface area heuristic, evaluated at the borders of
+                NUM_BINS bins of the item centers along each axis, is
+                the lowest
+
+      Args:     const BoundingBox* aBoxes
+                  Box of each item
+                UINT uNumItems
+                  Number of items
+
+      Modifies: [m_aNodes, m_aItemBounds, m_aItemOrder, m_aItemLeaves].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BoundingVolumeHierarchy::Build(_In_reads_(uNumItems) const BoundingBox* aBoxes, _In_ UINT uNumItems)
+    {
+        Clear();
+
+        m_aItemBounds.resize(uNumItems);
+        for (UINT i = 0u; i < uNumItems; ++i)
+            m_aItemBounds[i] = getBounds(aBoxes[i]);
+
+        m_aItemOrder.resize(uNumItems);
+        std::iota(m_aItemOrder.begin(), m_aItemOrder.end(), 0u);
+
+        m_aItemLeaves.assign(uNumItems, INVALID_INDEX);
+
+        if (uNumItems == 0u)
+            return;
+
+        m_aNodes.reserve(static_cast<size_t>(uNumItems) * 2u);
+        m_aNodes.push_back(Node
+            {
+                .bounds = Bounds(),
+                .uParent = INVALID_INDEX,
+                .uFirst = 0u,
+                .uNumItems = uNumItems
+            }
+        );
+
+        // Node and depth
+        std::vector<XMUINT2> aStack;
+        aStack.push_back(XMUINT2(0u, 0u));
+
+        while (!aStack.empty())
+        {
+            XMUINT2 entry = aStack.back();
+            aStack.pop_back();
+
+            // Bounded by its items while it is still a leaf
+            Node node = m_aNodes[entry.x];
+            m_aNodes[entry.x].bounds = getNodeBounds(node);
+
+            if (node.uNumItems <= MAX_LEAF_SIZE || entry.y + 1u >= MAX_DEPTH)
+            {
+                for (UINT i = node.uFirst; i < node.uFirst + node.uNumItems; ++i)
+                    m_aItemLeaves[m_aItemOrder[i]] = entry.x;
+
+                continue;
+            }
+
+            UINT uNumLeft = splitNode(node);
+            UINT uLeft = static_cast<UINT>(m_aNodes.size());
+
+            m_aNodes.push_back(Node
+                {
+                    .bounds = Bounds(),
+                    .uParent = entry.x,
+                    .uFirst = node.uFirst,
+                    .uNumItems = uNumLeft
+                }
+            );
+            m_aNodes.push_back(Node
+                {
+                    .bounds = Bounds(),
+                    .uParent = entry.x,
+                    .uFirst = node.uFirst + uNumLeft,
+                    .uNumItems = node.uNumItems - uNumLeft
+                }
+            );
+
+            m_aNodes[entry.x].uFirst = uLeft;
+            m_aNodes[entry.x].uNumItems = 0u;
+
+            aStack.push_back(XMUINT2(uLeft + 1u, entry.y + 1u));
+            aStack.push_back(XMUINT2(uLeft, entry.y + 1u));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::Clear
+
+      Summary:  Removes every item
+
+      Modifies: [m_aNodes, m_aItemBounds, m_aItemOrder, m_aItemLeaves].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BoundingVolumeHierarchy::Clear()
+    {
+        m_aNodes.clear();
+        m_aItemBounds.clear();
+        m_aItemOrder.clear();
+        m_aItemLeaves.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::Refit
+
+      Summary:  Moves the box of an item and refits the nodes above it,
+                stopping at the first node whose box does not change.
+                Items that did not move cost a comparison
+
+      Args:     UINT uItem
+                  Index of the item
+                const BoundingBox& box
+                  New box of the item
+
+      Modifies: [m_aNodes, m_aItemBounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BoundingVolumeHierarchy::Refit(_In_ UINT uItem, _In_ const BoundingBox& box)
+    {
+        if (uItem >= m_aItemBounds.size())
+            return;
+
+        Bounds bounds = getBounds(box);
+        if (isEqual(bounds, m_aItemBounds[uItem]))
+            return;
+
+        m_aItemBounds[uItem] = bounds;
+
+        for (UINT uNode = m_aItemLeaves[uItem]; uNode != INVALID_INDEX; uNode = m_aNodes[uNode].uParent)
+        {
+            Bounds nodeBounds = getNodeBounds(m_aNodes[uNode]);
+            if (isEqual(nodeBounds, m_aNodes[uNode].bounds))
+                break;
+
+            m_aNodes[uNode].bounds = nodeBounds;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::QueryFrustum
+
+      Summary:  Returns the items whose boxes are inside or cross a
+                frustum, skipping the subtrees outside of it
+
+      Args:     const Frustum& frustum
+                  Frustum to test against
+                std::vector<UINT>& aOutItems
+                  Indices of the items
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BoundingVolumeHierarchy::QueryFrustum(_In_ const Frustum& frustum, _Out_ std::vector<UINT>& aOutItems) const
+    {
+        aOutItems.clear();
+
+        if (m_aNodes.empty())
+            return;
+
+        UINT auStack[MAX_DEPTH];
+        UINT uStackSize = 0u;
+        auStack[uStackSize++] = 0u;
+
+        while (uStackSize > 0u)
+        {
+            const Node& node = m_aNodes[auStack[--uStackSize]];
+
+            if (!frustum.Intersects(getBoundingBox(node.bounds)))
+                continue;
+
+            if (node.uNumItems == 0u)
+            {
+                auStack[uStackSize++] = node.uFirst + 1u;
+                auStack[uStackSize++] = node.uFirst;
+                continue;
+            }
+
+            for (UINT i = node.uFirst; i < node.uFirst + node.uNumItems; ++i)
+            {
+                UINT uItem = m_aItemOrder[i];
+                if (node.uNumItems == 1u || frustum.Intersects(getBoundingBox(m_aItemBounds[uItem])))
+                    aOutItems.push_back(uItem);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::QueryBox
+
+      Summary:  Returns the items whose boxes overlap a box
+
+      Args:     const BoundingBox& box
+                  Box in world space
+                std::vector<UINT>& aOutItems
+                  Indices of the items
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BoundingVolumeHierarchy::QueryBox(_In_ const BoundingBox& box, _Out_ std::vector<UINT>& aOutItems) const
+    {
+        aOutItems.clear();
+
+        if (m_aNodes.empty())
+            return;
+
+        Bounds bounds = getBounds(box);
+
+        UINT auStack[MAX_DEPTH];
+        UINT uStackSize = 0u;
+        auStack[uStackSize++] = 0u;
+
+        while (uStackSize > 0u)
+        {
+            const Node& node = m_aNodes[auStack[--uStackSize]];
+
+            if (!overlaps(node.bounds, bounds))
+                continue;
+
+            if (node.uNumItems == 0u)
+            {
+                auStack[uStackSize++] = node.uFirst + 1u;
+                auStack[uStackSize++] = node.uFirst;
+                continue;
+            }
+
+            for (UINT i = node.uFirst; i < node.uFirst + node.uNumItems; ++i)
+            {
+                UINT uItem = m_aItemOrder[i];
+                if (overlaps(m_aItemBounds[uItem], bounds))
+                    aOutItems.push_back(uItem);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::QuerySphere
+
+      Summary:  Returns the items whose boxes overlap a sphere, as used
+                to find the objects in the range of a light
+
+      Args:     const BoundingSphere& sphere
+                  Sphere in world space
+                std::vector<UINT>& aOutItems
+                  Indices of the items
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BoundingVolumeHierarchy::QuerySphere(_In_ const BoundingSphere& sphere, _Out_ std::vector<UINT>& aOutItems) const
+    {
+        aOutItems.clear();
+
+        if (m_aNodes.empty())
+            return;
+
+        UINT auStack[MAX_DEPTH];
+        UINT uStackSize = 0u;
+        auStack[uStackSize++] = 0u;
+
+        while (uStackSize > 0u)
+        {
+            const Node& node = m_aNodes[auStack[--uStackSize]];
+
+            if (!overlaps(node.bounds, sphere))
+                continue;
+
+            if (node.uNumItems == 0u)
+            {
+                auStack[uStackSize++] = node.uFirst + 1u;
+                auStack[uStackSize++] = node.uFirst;
+                continue;
+            }
+
+            for (UINT i = node.uFirst; i < node.uFirst + node.uNumItems; ++i)
+            {
+                UINT uItem = m_aItemOrder[i];
+                if (overlaps(m_aItemBounds[uItem], sphere))
+                    aOutItems.push_back(uItem);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::CastRay
+
+      Summary:  Returns the item whose box a ray enters first. The
+                nearer child is visited first and subtrees farther than
+                the nearest hit so far are skipped
+
+      Args:     FXMVECTOR origin
+                  Origin of the ray
+                FXMVECTOR direction
+                  Normalized direction of the ray
+                FLOAT maxDistance
+                  Length of the ray
+                UINT& outItem
+                  Index of the item hit, INVALID_INDEX if none
+                FLOAT& outDistance
+                  Distance along the ray to the box of the item
+
+      Returns:  BOOL
+                  TRUE if an item was hit
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL XM_CALLCONV BoundingVolumeHierarchy::CastRay(
+        _In_ FXMVECTOR origin,
+        _In_ FXMVECTOR direction,
+        _In_ FLOAT maxDistance,
+        _Out_ UINT& outItem,
+        _Out_ FLOAT& outDistance
+    ) const
+    {
+        outItem = INVALID_INDEX;
+        outDistance = maxDistance;
+
+        if (m_aNodes.empty())
+            return FALSE;
+
+        XMFLOAT3 rayOrigin;
+        XMFLOAT3 inverseDirection;
+        XMStoreFloat3(&rayOrigin, origin);
+        XMStoreFloat3(&inverseDirection, XMVectorReciprocal(direction));
+
+        const FLOAT* aOrigin = &rayOrigin.x;
+        const FLOAT* aInverseDirection = &inverseDirection.x;
+
+        FLOAT distance;
+        if (!intersectsRay(m_aNodes[0].bounds, aOrigin, aInverseDirection, outDistance, distance))
+            return FALSE;
+
+        UINT auStack[MAX_DEPTH];
+        UINT uStackSize = 0u;
+        auStack[uStackSize++] = 0u;
+
+        while (uStackSize > 0u)
+        {
+            const Node& node = m_aNodes[auStack[--uStackSize]];
+
+            // The nearest hit may have moved closer since the node was pushed
+            if (!intersectsRay(node.bounds, aOrigin, aInverseDirection, outDistance, distance))
+                continue;
+
+            if (node.uNumItems > 0u)
+            {
+                for (UINT i = node.uFirst; i < node.uFirst + node.uNumItems; ++i)
+                {
+                    UINT uItem = m_aItemOrder[i];
+                    if (intersectsRay(m_aItemBounds[uItem], aOrigin, aInverseDirection, outDistance, distance))
+                    {
+                        outItem = uItem;
+                        outDistance = distance;
+                    }
+                }
+
+                continue;
+            }
+
+            FLOAT leftDistance;
+            FLOAT rightDistance;
+            BOOL bHitLeft = intersectsRay(m_aNodes[node.uFirst].bounds, aOrigin, aInverseDirection, outDistance, leftDistance);
+            BOOL bHitRight = intersectsRay(m_aNodes[node.uFirst + 1u].bounds, aOrigin, aInverseDirection, outDistance, rightDistance);
+
+            if (bHitLeft && bHitRight)
+            {
+                BOOL bLeftFirst = leftDistance <= rightDistance;
+                auStack[uStackSize++] = bLeftFirst ? node.uFirst + 1u : node.uFirst;
+                auStack[uStackSize++] = bLeftFirst ? node.uFirst : node.uFirst + 1u;
+            }
+            else if (bHitLeft)
+                auStack[uStackSize++] = node.uFirst;
+            else if (bHitRight)
+                auStack[uStackSize++] = node.uFirst + 1u;
+        }
+
+        return outItem != INVALID_INDEX;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::GetNumItems
+
+      Summary:  Returns the number of items
+
+      Returns:  UINT
+                  Number of items
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT BoundingVolumeHierarchy::GetNumItems() const
+    {
+        return static_cast<UINT>(m_aItemBounds.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::GetNumNodes
+
+      Summary:  Returns the number of nodes
+
+      Returns:  UINT
+                  Number of nodes, leaves included
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT BoundingVolumeHierarchy::GetNumNodes() const
+    {
+        return static_cast<UINT>(m_aNodes.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::getBounds
+
+      Summary:  Returns the corners of a box
+
+      Args:     const BoundingBox& box
+                  Box as its center and extents
+
+      Returns:  Bounds
+                  Box as its corners
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingVolumeHierarchy::Bounds BoundingVolumeHierarchy::getBounds(_In_ const BoundingBox& box)
+    {
+        return Bounds
+        {
+            .min = XMFLOAT3(box.Center.x - box.Extents.x, box.Center.y - box.Extents.y, box.Center.z - box.Extents.z),
+            .max = XMFLOAT3(box.Center.x + box.Extents.x, box.Center.y + box.Extents.y, box.Center.z + box.Extents.z)
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::getBoundingBox
+
+      Summary:  Returns the center and extents of a box
+
+      Args:     const Bounds& bounds
+                  Box as its corners
+
+      Returns:  BoundingBox
+                  Box as its center and extents
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingBox BoundingVolumeHierarchy::getBoundingBox(_In_ const Bounds& bounds)
+    {
+        return BoundingBox(
+            XMFLOAT3(
+                (bounds.min.x + bounds.max.x) * 0.5f,
+                (bounds.min.y + bounds.max.y) * 0.5f,
+                (bounds.min.z + bounds.max.z) * 0.5f
+            ),
+            XMFLOAT3(
+                (bounds.max.x - bounds.min.x) * 0.5f,
+                (bounds.max.y - bounds.min.y) * 0.5f,
+                (bounds.max.z - bounds.min.z) * 0.5f
+            )
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::grow
+
+      Summary:  Grows a box to hold another box
+
+      Args:     Bounds& bounds
+                  Box to grow
+                const Bounds& other
+                  Box to hold
+
+      Modifies: [bounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BoundingVolumeHierarchy::grow(_Inout_ Bounds& bounds, _In_ const Bounds& other)
+    {
+        bounds.min.x = std::min<FLOAT>(bounds.min.x, other.min.x);
+        bounds.min.y = std::min<FLOAT>(bounds.min.y, other.min.y);
+        bounds.min.z = std::min<FLOAT>(bounds.min.z, other.min.z);
+        bounds.max.x = std::max<FLOAT>(bounds.max.x, other.max.x);
+        bounds.max.y = std::max<FLOAT>(bounds.max.y, other.max.y);
+        bounds.max.z = std::max<FLOAT>(bounds.max.z, other.max.z);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::getSurfaceArea
+
+      Summary:  Returns half of the surface area of a box, which is
+                all the surface area heuristic needs
+
+      Args:     const Bounds& bounds
+                  Box
+
+      Returns:  FLOAT
+                  Half of the surface area
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT BoundingVolumeHierarchy::getSurfaceArea(_In_ const Bounds& bounds)
+    {
+        FLOAT x = bounds.max.x - bounds.min.x;
+        FLOAT y = bounds.max.y - bounds.min.y;
+        FLOAT z = bounds.max.z - bounds.min.z;
+
+        return x * y + y * z + z * x;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::isEqual
+
+      Summary:  Returns whether two boxes are the same
+
+      Args:     const Bounds& bounds, other
+                  Boxes to compare
+
+      Returns:  BOOL
+                  TRUE if every corner coordinate is equal
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL BoundingVolumeHierarchy::isEqual(_In_ const Bounds& bounds, _In_ const Bounds& other)
+    {
+        return bounds.min.x == other.min.x && bounds.min.y == other.min.y && bounds.min.z == other.min.z &&
+            bounds.max.x == other.max.x && bounds.max.y == other.max.y && bounds.max.z == other.max.z;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::overlaps
+
+      Summary:  Returns whether two boxes overlap
+
+      Args:     const Bounds& bounds, other
+                  Boxes to test
+
+      Returns:  BOOL
+                  TRUE if the boxes overlap or touch
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL BoundingVolumeHierarchy::overlaps(_In_ const Bounds& bounds, _In_ const Bounds& other)
+    {
+        return bounds.min.x <= other.max.x && bounds.max.x >= other.min.x &&
+            bounds.min.y <= other.max.y && bounds.max.y >= other.min.y &&
+            bounds.min.z <= other.max.z && bounds.max.z >= other.min.z;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::overlaps
+
+      Summary:  Returns whether a box and a sphere overlap, comparing
+                the distance from the center of the sphere to the
+                nearest point of the box with the radius
+
+      Args:     const Bounds& bounds
+                  Box to test
+                const BoundingSphere& sphere
+                  Sphere to test
+
+      Returns:  BOOL
+                  TRUE if the box and the sphere overlap or touch
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL BoundingVolumeHierarchy::overlaps(_In_ const Bounds& bounds, _In_ const BoundingSphere& sphere)
+    {
+        FLOAT x = sphere.Center.x - std::clamp<FLOAT>(sphere.Center.x, bounds.min.x, bounds.max.x);
+        FLOAT y = sphere.Center.y - std::clamp<FLOAT>(sphere.Center.y, bounds.min.y, bounds.max.y);
+        FLOAT z = sphere.Center.z - std::clamp<FLOAT>(sphere.Center.z, bounds.min.z, bounds.max.z);
+
+        return x * x + y * y + z * z <= sphere.Radius * sphere.Radius;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::intersectsRay
+
+      Summary:  Returns where a ray enters a box, clipping it against
+                the slab of each axis
+
+      Args:     const Bounds& bounds
+                  Box to test
+                const FLOAT* aOrigin
+                  Origin of the ray
+                const FLOAT* aInverseDirection
+                  Reciprocal of each component of the direction
+                FLOAT length
+                  Length of the ray
+                FLOAT& outDistance
+                  Distance along the ray to the box, 0 from inside
+
+      Returns:  BOOL
+                  TRUE if the ray enters the box within its length
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL BoundingVolumeHierarchy::intersectsRay(
+        _In_ const Bounds& bounds,
+        _In_reads_(3) const FLOAT* aOrigin,
+        _In_reads_(3) const FLOAT* aInverseDirection,
+        _In_ FLOAT length,
+        _Out_ FLOAT& outDistance
+    )
+    {
+        const FLOAT* aMin = &bounds.min.x;
+        const FLOAT* aMax = &bounds.max.x;
+
+        FLOAT entry = 0.0f;
+        FLOAT exit = length;
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            FLOAT minDistance = (aMin[i] - aOrigin[i]) * aInverseDirection[i];
+            FLOAT maxDistance = (aMax[i] - aOrigin[i]) * aInverseDirection[i];
+
+            entry = std::max<FLOAT>(entry, std::min<FLOAT>(minDistance, maxDistance));
+            exit = std::min<FLOAT>(exit, std::max<FLOAT>(minDistance, maxDistance));
+        }
+
+        outDistance = entry;
+
+        return entry <= exit;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::getNodeBounds
+
+      Summary:  Returns the box holding the items of a leaf or the two
+                children of a node
+
+      Args:     const Node& node
+                  Node to bound
+
+      Returns:  Bounds
+                  Box of the node
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingVolumeHierarchy::Bounds BoundingVolumeHierarchy::getNodeBounds(_In_ const Node& node) const
+    {
+        if (node.uNumItems == 0u)
+        {
+            Bounds bounds = m_aNodes[node.uFirst].bounds;
+            grow(bounds, m_aNodes[node.uFirst + 1u].bounds);
+
+            return bounds;
+        }
+
+        Bounds bounds = m_aItemBounds[m_aItemOrder[node.uFirst]];
+        for (UINT i = node.uFirst + 1u; i < node.uFirst + node.uNumItems; ++i)
+            grow(bounds, m_aItemBounds[m_aItemOrder[i]]);
+
+        return bounds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BoundingVolumeHierarchy::splitNode
+
+      Summary:  Orders the items of a node so that the ones going to
+                the left child come first. The centers of the items are
+                put in NUM_BINS bins along each axis, and the border
+                between bins with the lowest surface area heuristic is
+                chosen. Items whose centers coincide are split in half
+
+      Args:     const Node& node
+                  Node holding more than MAX_LEAF_SIZE items
+
+      Modifies: [m_aItemOrder].
+
+      Returns:  UINT
+                  Number of items going to the left child, at least one
+                  and less than those of the node
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT BoundingVolumeHierarchy::splitNode(_In_ const Node& node)
+    {
+        auto first = m_aItemOrder.begin() + node.uFirst;
+        auto last = first + node.uNumItems;
+
+        auto getCenter = [this](UINT uItem, UINT uAxis)
+        {
+            return ((&m_aItemBounds[uItem].min.x)[uAxis] + (&m_aItemBounds[uItem].max.x)[uAxis]) * 0.5f;
+        };
+
+        FLOAT aCenterMin[3];
+        FLOAT aCenterMax[3];
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            aCenterMin[uAxis] = getCenter(*first, uAxis);
+            aCenterMax[uAxis] = aCenterMin[uAxis];
+            for (auto it = first + 1; it != last; ++it)
+            {
+                aCenterMin[uAxis] = std::min<FLOAT>(aCenterMin[uAxis], getCenter(*it, uAxis));
+                aCenterMax[uAxis] = std::max<FLOAT>(aCenterMax[uAxis], getCenter(*it, uAxis));
+            }
+        }
+
+        auto getBin = [&](UINT uItem, UINT uAxis)
+        {
+            FLOAT scale = static_cast<FLOAT>(NUM_BINS) / (aCenterMax[uAxis] - aCenterMin[uAxis]);
+            return std::min<UINT>(static_cast<UINT>((getCenter(uItem, uAxis) - aCenterMin[uAxis]) * scale), NUM_BINS - 1u);
+        };
+
+        FLOAT bestCost = (std::numeric_limits<FLOAT>::max)();
+        UINT uBestAxis = 0u;
+        UINT uBestBin = NUM_BINS;
+
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            if (aCenterMax[uAxis] <= aCenterMin[uAxis])
+                continue;
+
+            UINT auBinCounts[NUM_BINS] = {};
+            Bounds aBinBounds[NUM_BINS];
+            for (auto it = first; it != last; ++it)
+            {
+                UINT uBin = getBin(*it, uAxis);
+                if (auBinCounts[uBin]++ == 0u)
+                    aBinBounds[uBin] = m_aItemBounds[*it];
+                else
+                    grow(aBinBounds[uBin], m_aItemBounds[*it]);
+            }
+
+            // Area and count of the bins right of each border, swept from the right
+            FLOAT aRightAreas[NUM_BINS];
+            UINT auRightCounts[NUM_BINS];
+            Bounds rightBounds = Bounds();
+            UINT uRightCount = 0u;
+            for (UINT uBin = NUM_BINS - 1u; uBin > 0u; --uBin)
+            {
+                if (auBinCounts[uBin] > 0u)
+                {
+                    if (uRightCount == 0u)
+                        rightBounds = aBinBounds[uBin];
+                    else
+                        grow(rightBounds, aBinBounds[uBin]);
+
+                    uRightCount += auBinCounts[uBin];
+                }
+
+                aRightAreas[uBin] = uRightCount > 0u ? getSurfaceArea(rightBounds) : 0.0f;
+                auRightCounts[uBin] = uRightCount;
+            }
+
+            Bounds leftBounds = Bounds();
+            UINT uLeftCount = 0u;
+            for (UINT uBin = 0u; uBin < NUM_BINS - 1u; ++uBin)
+            {
+                if (auBinCounts[uBin] > 0u)
+                {
+                    if (uLeftCount == 0u)
+                        leftBounds = aBinBounds[uBin];
+                    else
+                        grow(leftBounds, aBinBounds[uBin]);
+
+                    uLeftCount += auBinCounts[uBin];
+                }
+
+                if (uLeftCount == 0u || auRightCounts[uBin + 1u] == 0u)
+                    continue;
+
+                FLOAT cost = getSurfaceArea(leftBounds) * static_cast<FLOAT>(uLeftCount) +
+                    aRightAreas[uBin + 1u] * static_cast<FLOAT>(auRightCounts[uBin + 1u]);
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    uBestAxis = uAxis;
+                    uBestBin = uBin;
+                }
+            }
+        }
+
+        if (uBestBin == NUM_BINS)
+            return node.uNumItems / 2u;
+
+        auto middle = std::partition(first, last, [&](UINT uItem)
+            {
+                return getBin(uItem, uBestAxis) <= uBestBin;
+            }
+        );
+
+        return static_cast<UINT>(middle - first);
+    }
+}
@@ -0,0 +1,138 @@
+/*+===================================================================
+  File:      BOUNDINGVOLUMEHIERARCHY.H
+
+  Summary:   BoundingVolumeHierarchy header file contains declaration
+             of class BoundingVolumeHierarchy used for spatial queries
+             over the objects of a scene.
+
+  Classes:  BoundingVolumeHierarchy
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/Frustum.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BoundingVolumeHierarchy
+
+      Summary:  Binary tree of axis-aligned boxes over items numbered
+                from 0, built with the surface area heuristic. Items
+                that move are refitted in place, growing or shrinking
+                the boxes up to the root, which keeps the tree valid
+                but not as tight as a new build. Queries return the
+                indices of the items and allocate nothing but the
+                results
+
+      Methods:  Build
+                  Builds the tree over the boxes of the items
+                Clear
+                  Removes every item
+                Refit
+                  Moves the box of an item
+                QueryFrustum
+                  Returns the items inside or crossing a frustum
+                QueryBox
+                  Returns the items overlapping a box
+                QuerySphere
+                  Returns the items overlapping a sphere
+                CastRay
+                  Returns the nearest item hit by a ray
+                GetNumItems
+                  Returns the number of items
+                GetNumNodes
+                  Returns the number of nodes
+                BoundingVolumeHierarchy
+                  Constructor.
+                ~BoundingVolumeHierarchy
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BoundingVolumeHierarchy final
+    {
+    public:
+        static constexpr const UINT INVALID_INDEX = 0xFFFFFFFFu;
+        static constexpr const UINT MAX_LEAF_SIZE = 4u;
+        static constexpr const UINT MAX_DEPTH = 64u;
+        static constexpr const UINT NUM_BINS = 16u;
+
+        BoundingVolumeHierarchy();
+        BoundingVolumeHierarchy(const BoundingVolumeHierarchy& other) = delete;
+        BoundingVolumeHierarchy(BoundingVolumeHierarchy&& other) = delete;
+        BoundingVolumeHierarchy& operator=(const BoundingVolumeHierarchy& other) = delete;
+        BoundingVolumeHierarchy& operator=(BoundingVolumeHierarchy&& other) = delete;
+        ~BoundingVolumeHierarchy() = default;
+
+        void Build(_In_reads_(uNumItems) const BoundingBox* aBoxes, _In_ UINT uNumItems);
+        void Clear();
+        void Refit(_In_ UINT uItem, _In_ const BoundingBox& box);
+
+        void QueryFrustum(_In_ const Frustum& frustum, _Out_ std::vector<UINT>& aOutItems) const;
+        void QueryBox(_In_ const BoundingBox& box, _Out_ std::vector<UINT>& aOutItems) const;
+        void QuerySphere(_In_ const BoundingSphere& sphere, _Out_ std::vector<UINT>& aOutItems) const;
+        BOOL XM_CALLCONV CastRay(
+            _In_ FXMVECTOR origin,
+            _In_ FXMVECTOR direction,
+            _In_ FLOAT maxDistance,
+            _Out_ UINT& outItem,
+            _Out_ FLOAT& outDistance
+        ) const;
+
+        UINT GetNumItems() const;
+        UINT GetNumNodes() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Bounds
+
+            Summary:  Axis-aligned box as its corners
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Bounds
+        {
+            XMFLOAT3 min;
+            XMFLOAT3 max;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Node
+
+            Summary:  Node of the tree. A leaf holds uNumItems items
+                      starting at uFirst in the item order, any other
+                      node has its two children at uFirst and uFirst + 1
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Node
+        {
+            Bounds bounds;
+            UINT uParent;
+            UINT uFirst;
+            UINT uNumItems;
+        };
+
+        static Bounds getBounds(_In_ const BoundingBox& box);
+        static BoundingBox getBoundingBox(_In_ const Bounds& bounds);
+        static void grow(_Inout_ Bounds& bounds, _In_ const Bounds& other);
+        static FLOAT getSurfaceArea(_In_ const Bounds& bounds);
+        static BOOL isEqual(_In_ const Bounds& bounds, _In_ const Bounds& other);
+        static BOOL overlaps(_In_ const Bounds& bounds, _In_ const Bounds& other);
+        static BOOL overlaps(_In_ const Bounds& bounds, _In_ const BoundingSphere& sphere);
+        static BOOL intersectsRay(
+            _In_ const Bounds& bounds,
+            _In_reads_(3) const FLOAT* aOrigin,
+            _In_reads_(3) const FLOAT* aInverseDirection,
+            _In_ FLOAT length,
+            _Out_ FLOAT& outDistance
+        );
+
+        Bounds getNodeBounds(_In_ const Node& node) const;
+        UINT splitNode(_In_ const Node& node);
+
+    private:
+        std::vector<Node> m_aNodes;
+        std::vector<Bounds> m_aItemBounds;
+        std::vector<UINT> m_aItemOrder;
+        std::vector<UINT> m_aItemLeaves;
+    };
+}
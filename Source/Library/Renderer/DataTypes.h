@@ -7,6 +7,7 @@ namespace library
 #define NUM_LIGHTS (2)
 #define MAX_NUM_BONES (256)
 #define MAX_NUM_BONES_PER_VERTEX (16)
+#define NUM_BLOCK_COLORS (16)
 
     struct SimpleVertex
     {
@@ -15,9 +16,13 @@ namespace library
         XMFLOAT3 Normal;
     };
 
+    // Block coordinates in the chunk and palette index of a voxel, expanded in VSVoxel
     struct InstanceData
     {
-        XMMATRIX Transformation;
+        WORD X;
+        WORD Y;
+        WORD Z;
+        WORD BlockType;
     };
 
     struct AnimationData
@@ -54,4 +59,9 @@ namespace library
         XMFLOAT4 LightColors[NUM_LIGHTS];
     };
 
+    struct CBBlockColors
+    {
+        XMFLOAT4 BlockColors[NUM_BLOCK_COLORS];
+    };
+
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "Renderer/DrawList.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawList::MakeKey
+
+      Summary:  Returns the sort key of a draw. The bits of a depth
+                that is not negative grow with its value, so they are
+                used as they are, and flipped for blended draws
+
+      Args:     eDrawPass pass
+                  Pass of the draw
+                UINT uShader
+                  Index of the shaders of the draw, below MAX_SHADERS
+                UINT uMaterial
+                  Index of the material of the draw, below
+                  MAX_MATERIALS
+                FLOAT depth
+                  View depth of the draw, negative depths sort as 0
+
+      Returns:  UINT64
+                  Sort key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 DrawList::MakeKey(_In_ eDrawPass pass, _In_ UINT uShader, _In_ UINT uMaterial, _In_ FLOAT depth)
+    {
+        assert(uShader < MAX_SHADERS);
+        assert(uMaterial < MAX_MATERIALS);
+
+        // Also turns NaN into 0
+        FLOAT clampedDepth = depth > 0.0f ? depth : 0.0f;
+
+        UINT uDepth = 0u;
+        std::memcpy(&uDepth, &clampedDepth, sizeof(uDepth));
+        if (pass == eDrawPass::BLENDED)
+            uDepth = ~uDepth;
+
+        return (static_cast<UINT64>(pass) << (NUM_SHADER_BITS + NUM_MATERIAL_BITS + NUM_DEPTH_BITS))
+            | (static_cast<UINT64>(uShader & (MAX_SHADERS - 1u)) << (NUM_MATERIAL_BITS + NUM_DEPTH_BITS))
+            | (static_cast<UINT64>(uMaterial & (MAX_MATERIALS - 1u)) << NUM_DEPTH_BITS)
+            | static_cast<UINT64>(uDepth);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawList::DrawList
+
+      Summary:  Constructor
+
+      Modifies: [m_aDraws, m_aSortedDraws].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DrawList::DrawList()
+        : m_aDraws()
+        , m_aSortedDraws()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawList::Clear
+
+      Summary:  Removes every draw, keeping the memory for the next
+                frame
+
+      Modifies: [m_aDraws].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DrawList::Clear()
+    {
+        m_aDraws.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawList::Add
+
+      Summary:  Adds a draw
+
+      Args:     UINT64 uKey
+                  Sort key made with MakeKey
+                UINT uItem
+                  Index of the draw in the caller's records
+
+      Modifies: [m_aDraws].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DrawList::Add(_In_ UINT64 uKey, _In_ UINT uItem)
+    {
+        m_aDraws.push_back({ .uKey = uKey, .uItem = uItem });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawList::Sort
+
+      Summary:  Sorts the draws by their keys with a least significant
+                digit radix sort, keeping the order of equal keys. The
+                counts of every digit are taken in a single pass, and
+                a digit all the keys share is skipped, which is the
+                case of the pass bits in most frames
+
+      Modifies: [m_aDraws, m_aSortedDraws].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DrawList::Sort()
+    {
+        UINT uNumDraws = static_cast<UINT>(m_aDraws.size());
+        if (uNumDraws < 2u)
+            return;
+
+        UINT auCounts[NUM_DIGITS][NUM_BUCKETS] = { };
+        for (const DrawCommand& draw : m_aDraws)
+        {
+            for (UINT uDigit = 0u; uDigit < NUM_DIGITS; ++uDigit)
+                ++auCounts[uDigit][(draw.uKey >> (uDigit * RADIX_BITS)) & (NUM_BUCKETS - 1u)];
+        }
+
+        m_aSortedDraws.resize(m_aDraws.size());
+
+        for (UINT uDigit = 0u; uDigit < NUM_DIGITS; ++uDigit)
+        {
+            UINT* auBucketCounts = auCounts[uDigit];
+            UINT uShift = uDigit * RADIX_BITS;
+
+            if (auBucketCounts[(m_aDraws.front().uKey >> uShift) & (NUM_BUCKETS - 1u)] == uNumDraws)
+                continue;
+
+            // Counts become the first index of each bucket
+            UINT uOffset = 0u;
+            for (UINT uBucket = 0u; uBucket < NUM_BUCKETS; ++uBucket)
+            {
+                UINT uCount = auBucketCounts[uBucket];
+                auBucketCounts[uBucket] = uOffset;
+                uOffset += uCount;
+            }
+
+            for (const DrawCommand& draw : m_aDraws)
+                m_aSortedDraws[auBucketCounts[(draw.uKey >> uShift) & (NUM_BUCKETS - 1u)]++] = draw;
+
+            m_aDraws.swap(m_aSortedDraws);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawList::GetNumDraws
+
+      Summary:  Returns the number of draws
+
+      Returns:  UINT
+                  Number of draws added since Clear
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT DrawList::GetNumDraws() const
+    {
+        return static_cast<UINT>(m_aDraws.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawList::GetDraw
+
+      Summary:  Returns a draw, in sorted order after Sort and in the
+                order of Add before
+
+      Args:     UINT uIndex
+                  Index of the draw
+
+      Returns:  const DrawCommand&
+                  Key and item of the draw
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const DrawCommand& DrawList::GetDraw(_In_ UINT uIndex) const
+    {
+        return m_aDraws[uIndex];
+    }
+}
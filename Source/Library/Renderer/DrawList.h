@@ -0,0 +1,108 @@
+/*+===================================================================
+  File:      DRAWLIST.H
+
+  Summary:   DrawList header file contains declaration of class
+             DrawList used to order the draws of a frame.
+
+  Classes:  DrawList
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eDrawPass
+
+        Summary:  Enumeration of the passes of a frame, in the order
+                  they are drawn
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eDrawPass : UINT
+    {
+        SOLID,
+        BLENDED,
+        COUNT,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   DrawCommand
+
+        Summary:  Sort key of a draw and the index of the draw in the
+                  caller's own records
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DrawCommand
+    {
+        UINT64 uKey;
+        UINT uItem;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DrawList
+
+      Summary:  List of the draws of a frame, sorted by 64-bit keys so
+                that draws sharing a state are submitted together.
+                From the highest bits down, a key holds the pass, the
+                shader, the material and the view depth, front to back
+                for solid draws and back to front for blended ones.
+                Keys are sorted with a radix sort, and the list knows
+                nothing of the graphics API
+
+      Methods:  MakeKey
+                  Returns the sort key of a draw
+                Clear
+                  Removes every draw
+                Add
+                  Adds a draw
+                Sort
+                  Sorts the draws by their keys
+                GetNumDraws
+                  Returns the number of draws
+                GetDraw
+                  Returns a draw in sorted order after Sort
+                DrawList
+                  Constructor.
+                ~DrawList
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DrawList final
+    {
+    public:
+        static constexpr const UINT NUM_PASS_BITS = 4u;
+        static constexpr const UINT NUM_SHADER_BITS = 12u;
+        static constexpr const UINT NUM_MATERIAL_BITS = 16u;
+        static constexpr const UINT NUM_DEPTH_BITS = 32u;
+        static_assert(NUM_PASS_BITS + NUM_SHADER_BITS + NUM_MATERIAL_BITS + NUM_DEPTH_BITS == 64u, "Keys have to fill 64 bits");
+        static_assert(static_cast<UINT>(eDrawPass::COUNT) <= (1u << NUM_PASS_BITS), "Every pass needs a key");
+
+        static constexpr const UINT MAX_SHADERS = 1u << NUM_SHADER_BITS;
+        static constexpr const UINT MAX_MATERIALS = 1u << NUM_MATERIAL_BITS;
+
+        static UINT64 MakeKey(_In_ eDrawPass pass, _In_ UINT uShader, _In_ UINT uMaterial, _In_ FLOAT depth);
+
+        DrawList();
+        DrawList(const DrawList& other) = delete;
+        DrawList(DrawList&& other) = delete;
+        DrawList& operator=(const DrawList& other) = delete;
+        DrawList& operator=(DrawList&& other) = delete;
+        ~DrawList() = default;
+
+        void Clear();
+        void Add(_In_ UINT64 uKey, _In_ UINT uItem);
+        void Sort();
+
+        UINT GetNumDraws() const;
+        const DrawCommand& GetDraw(_In_ UINT uIndex) const;
+
+    private:
+        static constexpr const UINT RADIX_BITS = 8u;
+        static constexpr const UINT NUM_BUCKETS = 1u << RADIX_BITS;
+        static constexpr const UINT NUM_DIGITS = 64u / RADIX_BITS;
+
+    private:
+        std::vector<DrawCommand> m_aDraws;
+        std::vector<DrawCommand> m_aSortedDraws;
+    };
+}
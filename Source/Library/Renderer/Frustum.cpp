@@ -0,0 +1,266 @@
+#include "Renderer/Frustum.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Frustum::Frustum
+
+      Summary:  Constructor
+
+      Modifies: [m_aPlaneX, m_aPlaneY, m_aPlaneZ, m_aPlaneW,
+                 m_uNumTested, m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Frustum::Frustum()
+        : m_aPlaneX()
+        , m_aPlaneY()
+        , m_aPlaneZ()
+        , m_aPlaneW()
+        , m_uNumTested(0u)
+        , m_uNumVisible(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Frustum::Update
+
+      Summary:  Extracts the planes of the frustum from the columns of
+                the view projection matrix (Gribb and Hartmann, Fast
+                Extraction of Viewing Frustum Planes from the
+                World-View-Projection Matrix), with their normals
+                pointing inside, and resets the counts
+
+      Args:     FXMMATRIX view
+                  View matrix
+                CXMMATRIX projection
+                  Projection matrix, with depth from 0 to 1
+
+      Modifies: [m_aPlaneX, m_aPlaneY, m_aPlaneZ, m_aPlaneW,
+                 m_uNumTested, m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void XM_CALLCONV Frustum::Update(_In_ FXMMATRIX view, _In_ CXMMATRIX projection)
+    {
+        // Rows of the transpose are the columns of the matrix
+        XMMATRIX columns = XMMatrixTranspose(XMMatrixMultiply(view, projection));
+
+        const XMVECTOR aPlanes[NUM_PLANES] =
+        {
+            XMVectorAdd(columns.r[3], columns.r[0]),        // left
+            XMVectorSubtract(columns.r[3], columns.r[0]),   // right
+            XMVectorAdd(columns.r[3], columns.r[1]),        // bottom
+            XMVectorSubtract(columns.r[3], columns.r[1]),   // top
+            columns.r[2],                                   // near
+            XMVectorSubtract(columns.r[3], columns.r[2]),   // far
+        };
+
+        for (UINT i = 0u; i < NUM_PLANES; ++i)
+        {
+            XMVECTOR plane = XMPlaneNormalize(aPlanes[i]);
+
+            m_aPlaneX[i] = XMVectorSplatX(plane);
+            m_aPlaneY[i] = XMVectorSplatY(plane);
+            m_aPlaneZ[i] = XMVectorSplatZ(plane);
+            m_aPlaneW[i] = XMVectorSplatW(plane);
+        }
+
+        m_uNumTested = 0u;
+        m_uNumVisible = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Frustum::Intersects
+
+      Summary:  Returns whether a box is inside or crosses the frustum.
+                Boxes near a corner of the frustum may be reported as
+                visible when they are not
+
+      Args:     const BoundingBox& box
+                  Box in world space
+
+      Returns:  BOOL
+                  TRUE if the box is not outside of a plane
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Frustum::Intersects(_In_ const BoundingBox& box) const
+    {
+        XMVECTOR center = XMLoadFloat3(&box.Center);
+        XMVECTOR extents = XMLoadFloat3(&box.Extents);
+
+        for (UINT i = 0u; i < NUM_PLANES; ++i)
+        {
+            XMVECTOR normal = XMVectorSet(XMVectorGetX(m_aPlaneX[i]), XMVectorGetX(m_aPlaneY[i]), XMVectorGetX(m_aPlaneZ[i]), 0.0f);
+
+            FLOAT distance = XMVectorGetX(XMVector3Dot(center, normal)) + XMVectorGetX(m_aPlaneW[i]);
+            FLOAT radius = XMVectorGetX(XMVector3Dot(extents, XMVectorAbs(normal)));
+
+            if (distance + radius < 0.0f)
+                return FALSE;
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Frustum::CullBoxes
+
+      Summary:  Returns the indices of the boxes inside or crossing the
+                frustum. Each batch of four boxes is tested against a
+                plane at once, comparing the distance of the centers
+                with the extents projected on the normal
+
+      Args:     const BoundingBox* aBoxes
+                  Boxes in world space
+                UINT uNumBoxes
+                  Number of boxes
+                std::vector<UINT>& aOutVisible
+                  Indices of the visible boxes, in order
+
+      Modifies: [m_uNumTested, m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Frustum::CullBoxes(_In_reads_(uNumBoxes) const BoundingBox* aBoxes, _In_ UINT uNumBoxes, _Out_ std::vector<UINT>& aOutVisible)
+    {
+        aOutVisible.clear();
+
+        for (UINT uFirst = 0u; uFirst < uNumBoxes; uFirst += BATCH_SIZE)
+        {
+            UINT uNumInBatch = std::min<UINT>(uNumBoxes - uFirst, BATCH_SIZE);
+
+            // The last box fills the lanes past the end
+            const BoundingBox& box0 = aBoxes[uFirst];
+            const BoundingBox& box1 = aBoxes[uFirst + std::min<UINT>(1u, uNumInBatch - 1u)];
+            const BoundingBox& box2 = aBoxes[uFirst + std::min<UINT>(2u, uNumInBatch - 1u)];
+            const BoundingBox& box3 = aBoxes[uFirst + std::min<UINT>(3u, uNumInBatch - 1u)];
+
+            XMVECTOR centerX = XMVectorSet(box0.Center.x, box1.Center.x, box2.Center.x, box3.Center.x);
+            XMVECTOR centerY = XMVectorSet(box0.Center.y, box1.Center.y, box2.Center.y, box3.Center.y);
+            XMVECTOR centerZ = XMVectorSet(box0.Center.z, box1.Center.z, box2.Center.z, box3.Center.z);
+            XMVECTOR extentsX = XMVectorSet(box0.Extents.x, box1.Extents.x, box2.Extents.x, box3.Extents.x);
+            XMVECTOR extentsY = XMVectorSet(box0.Extents.y, box1.Extents.y, box2.Extents.y, box3.Extents.y);
+            XMVECTOR extentsZ = XMVectorSet(box0.Extents.z, box1.Extents.z, box2.Extents.z, box3.Extents.z);
+
+            XMVECTOR outside = XMVectorFalseInt();
+            for (UINT i = 0u; i < NUM_PLANES; ++i)
+            {
+                XMVECTOR distance = XMVectorMultiplyAdd(centerX, m_aPlaneX[i], m_aPlaneW[i]);
+                distance = XMVectorMultiplyAdd(centerY, m_aPlaneY[i], distance);
+                distance = XMVectorMultiplyAdd(centerZ, m_aPlaneZ[i], distance);
+
+                XMVECTOR radius = XMVectorMultiply(extentsX, XMVectorAbs(m_aPlaneX[i]));
+                radius = XMVectorMultiplyAdd(extentsY, XMVectorAbs(m_aPlaneY[i]), radius);
+                radius = XMVectorMultiplyAdd(extentsZ, XMVectorAbs(m_aPlaneZ[i]), radius);
+
+                outside = XMVectorOrInt(outside, XMVectorLess(XMVectorAdd(distance, radius), XMVectorZero()));
+            }
+
+            appendVisible(outside, uFirst, uNumInBatch, aOutVisible);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Frustum::CullSpheres
+
+      Summary:  Returns the indices of the spheres inside or crossing
+                the frustum, testing four spheres against a plane at
+                once
+
+      Args:     const BoundingSphere* aSpheres
+                  Spheres in world space
+                UINT uNumSpheres
+                  Number of spheres
+                std::vector<UINT>& aOutVisible
+                  Indices of the visible spheres, in order
+
+      Modifies: [m_uNumTested, m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Frustum::CullSpheres(_In_reads_(uNumSpheres) const BoundingSphere* aSpheres, _In_ UINT uNumSpheres, _Out_ std::vector<UINT>& aOutVisible)
+    {
+        aOutVisible.clear();
+
+        for (UINT uFirst = 0u; uFirst < uNumSpheres; uFirst += BATCH_SIZE)
+        {
+            UINT uNumInBatch = std::min<UINT>(uNumSpheres - uFirst, BATCH_SIZE);
+
+            // The last sphere fills the lanes past the end
+            const BoundingSphere& sphere0 = aSpheres[uFirst];
+            const BoundingSphere& sphere1 = aSpheres[uFirst + std::min<UINT>(1u, uNumInBatch - 1u)];
+            const BoundingSphere& sphere2 = aSpheres[uFirst + std::min<UINT>(2u, uNumInBatch - 1u)];
+            const BoundingSphere& sphere3 = aSpheres[uFirst + std::min<UINT>(3u, uNumInBatch - 1u)];
+
+            XMVECTOR centerX = XMVectorSet(sphere0.Center.x, sphere1.Center.x, sphere2.Center.x, sphere3.Center.x);
+            XMVECTOR centerY = XMVectorSet(sphere0.Center.y, sphere1.Center.y, sphere2.Center.y, sphere3.Center.y);
+            XMVECTOR centerZ = XMVectorSet(sphere0.Center.z, sphere1.Center.z, sphere2.Center.z, sphere3.Center.z);
+            XMVECTOR negativeRadius = XMVectorNegate(XMVectorSet(sphere0.Radius, sphere1.Radius, sphere2.Radius, sphere3.Radius));
+
+            XMVECTOR outside = XMVectorFalseInt();
+            for (UINT i = 0u; i < NUM_PLANES; ++i)
+            {
+                XMVECTOR distance = XMVectorMultiplyAdd(centerX, m_aPlaneX[i], m_aPlaneW[i]);
+                distance = XMVectorMultiplyAdd(centerY, m_aPlaneY[i], distance);
+                distance = XMVectorMultiplyAdd(centerZ, m_aPlaneZ[i], distance);
+
+                outside = XMVectorOrInt(outside, XMVectorLess(distance, negativeRadius));
+            }
+
+            appendVisible(outside, uFirst, uNumInBatch, aOutVisible);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Frustum::GetNumTested
+
+      Summary:  Returns the number of objects tested since the update
+
+      Returns:  UINT
+                  Number of boxes and spheres tested
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Frustum::GetNumTested() const
+    {
+        return m_uNumTested;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Frustum::GetNumVisible
+
+      Summary:  Returns the number of objects visible since the update
+
+      Returns:  UINT
+                  Number of boxes and spheres inside or crossing the
+                  frustum
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Frustum::GetNumVisible() const
+    {
+        return m_uNumVisible;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Frustum::appendVisible
+
+      Summary:  Appends the indices of the lanes of a batch that are
+                not outside of a plane
+
+      Args:     FXMVECTOR outside
+                  All bits set in the lanes outside of a plane
+                UINT uFirst
+                  Index of the first object of the batch
+                UINT uNumInBatch
+                  Number of lanes holding objects
+                std::vector<UINT>& aOutVisible
+                  Indices of the visible objects
+
+      Modifies: [m_uNumTested, m_uNumVisible].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void XM_CALLCONV Frustum::appendVisible(_In_ FXMVECTOR outside, _In_ UINT uFirst, _In_ UINT uNumInBatch, _Inout_ std::vector<UINT>& aOutVisible)
+    {
+        UINT auOutside[BATCH_SIZE];
+        XMStoreInt4(auOutside, outside);
+
+        for (UINT i = 0u; i < uNumInBatch; ++i)
+        {
+            if (auOutside[i])
+                continue;
+
+            aOutVisible.push_back(uFirst + i);
+            ++m_uNumVisible;
+        }
+
+        m_uNumTested += uNumInBatch;
+    }
+}
@@ -0,0 +1,80 @@
+/*+===================================================================
+  File:      FRUSTUM.H
+
+  Summary:   Frustum header file contains declaration of class Frustum
+             used to cull objects outside of the view.
+
+  Classes:  Frustum
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Frustum
+
+      Summary:  View frustum extracted from the view and projection
+                matrices. Boxes and spheres are tested four at a time,
+                one per lane, against each plane, and the indices of
+                the ones inside or crossing the frustum are returned.
+                Counts of tested and visible objects are kept from one
+                update to the next
+
+      Methods:  Update
+                  Extracts the planes of the frustum
+                Intersects
+                  Returns whether a box is inside or crosses the
+                  frustum
+                CullBoxes
+                  Returns the indices of the visible boxes
+                CullSpheres
+                  Returns the indices of the visible spheres
+                GetNumTested
+                  Returns the number of objects tested since the update
+                GetNumVisible
+                  Returns the number of objects visible since the update
+                Frustum
+                  Constructor.
+                ~Frustum
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class Frustum final
+    {
+    public:
+        static constexpr const UINT NUM_PLANES = 6u;
+        static constexpr const UINT BATCH_SIZE = 4u;
+
+        Frustum();
+        Frustum(const Frustum& other) = delete;
+        Frustum(Frustum&& other) = delete;
+        Frustum& operator=(const Frustum& other) = delete;
+        Frustum& operator=(Frustum&& other) = delete;
+        ~Frustum() = default;
+
+        void XM_CALLCONV Update(_In_ FXMMATRIX view, _In_ CXMMATRIX projection);
+
+        BOOL Intersects(_In_ const BoundingBox& box) const;
+        void CullBoxes(_In_reads_(uNumBoxes) const BoundingBox* aBoxes, _In_ UINT uNumBoxes, _Out_ std::vector<UINT>& aOutVisible);
+        void CullSpheres(_In_reads_(uNumSpheres) const BoundingSphere* aSpheres, _In_ UINT uNumSpheres, _Out_ std::vector<UINT>& aOutVisible);
+
+        UINT GetNumTested() const;
+        UINT GetNumVisible() const;
+
+    private:
+        void XM_CALLCONV appendVisible(_In_ FXMVECTOR outside, _In_ UINT uFirst, _In_ UINT uNumInBatch, _Inout_ std::vector<UINT>& aOutVisible);
+
+    private:
+        // Components of each plane, replicated across the lanes
+        XMVECTOR m_aPlaneX[NUM_PLANES];
+        XMVECTOR m_aPlaneY[NUM_PLANES];
+        XMVECTOR m_aPlaneZ[NUM_PLANES];
+        XMVECTOR m_aPlaneW[NUM_PLANES];
+
+        UINT m_uNumTested;
+        UINT m_uNumVisible;
+    };
+}
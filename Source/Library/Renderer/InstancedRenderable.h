@@ -25,6 +25,9 @@ namespace library
 
       Methods:  SetInstanceData
                   Sets the instance data
+                UpdateInstanceData
+                  Sets the instance data and writes the instances that
+                  changed into the instance buffer
                 GetInstanceBuffer
                   Returns a instance buffer
                 GetNumInstances
@@ -51,6 +54,11 @@ namespace library
         virtual void Update(_In_ FLOAT deltaTime) override = 0;
 
         void SetInstanceData(_In_ std::vector<InstanceData>&& aInstanceData);
+        HRESULT UpdateInstanceData(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ std::vector<InstanceData>&& aInstanceData
+        );
 
         virtual ComPtr<ID3D11Buffer>& GetInstanceBuffer();
         virtual UINT GetNumInstances() const;
@@ -67,6 +75,7 @@ namespace library
     protected:
         ComPtr<ID3D11Buffer> m_instanceBuffer;
         std::vector<InstanceData> m_aInstanceData;
+        UINT m_uInstanceCapacity;
 
     private:
         BYTE m_padding[8];
@@ -0,0 +1,377 @@
+#include "Renderer/OcclusionCuller.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::OcclusionCuller
+
+      Summary:  Constructor
+
+      Modifies: [m_viewProjection, m_aDepths, m_aTriangles,
+                 m_uNumOccluders, m_uNumTested, m_uNumOccluded].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionCuller::OcclusionCuller()
+        : m_viewProjection(XMMatrixIdentity())
+        , m_aDepths(static_cast<size_t>(WIDTH) * HEIGHT, 1.0f)
+        , m_aTriangles()
+        , m_uNumOccluders(0u)
+        , m_uNumTested(0u)
+        , m_uNumOccluded(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::Begin
+
+      Summary:  Clears the depth buffer to the far plane and removes the
+                occluders of the last frame
+
+      Args:     FXMMATRIX viewProjection
+                  View projection matrix of the frame
+
+      Modifies: [m_viewProjection, m_aDepths, m_aTriangles,
+                 m_uNumOccluders, m_uNumTested, m_uNumOccluded].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void XM_CALLCONV OcclusionCuller::Begin(_In_ FXMMATRIX viewProjection)
+    {
+        m_viewProjection = viewProjection;
+        std::fill(m_aDepths.begin(), m_aDepths.end(), 1.0f);
+        m_aTriangles.clear();
+
+        m_uNumOccluders = 0u;
+        m_uNumTested = 0u;
+        m_uNumOccluded = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::AddOccluder
+
+      Summary:  Projects an occluder box and sets up the triangles of
+                its faces. Boxes crossing the plane of the eye are left
+                out, which only lets more through
+
+      Args:     const BoundingBox& box
+                  Box in world space, solid all the way through
+
+      Modifies: [m_aTriangles, m_uNumOccluders].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::AddOccluder(_In_ const BoundingBox& box)
+    {
+        // Corners of each face, in the order of BoundingBox::GetCorners
+        constexpr const UINT FACES[6][4] =
+        {
+            { 0u, 1u, 2u, 3u },
+            { 4u, 5u, 6u, 7u },
+            { 0u, 3u, 7u, 4u },
+            { 1u, 2u, 6u, 5u },
+            { 0u, 1u, 5u, 4u },
+            { 3u, 2u, 6u, 7u },
+        };
+
+        XMFLOAT3 aCorners[BoundingBox::CORNER_COUNT];
+        if (!projectBox(box, aCorners))
+            return;
+
+        for (const UINT* auFace : FACES)
+        {
+            addTriangle(aCorners[auFace[0]], aCorners[auFace[1]], aCorners[auFace[2]]);
+            addTriangle(aCorners[auFace[0]], aCorners[auFace[2]], aCorners[auFace[3]]);
+        }
+
+        ++m_uNumOccluders;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::Rasterize
+
+      Summary:  Rasterizes the occluders into the depth buffer, one band
+                of rows per task, so no two threads write a pixel
+
+      Modifies: [m_aDepths].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::Rasterize()
+    {
+        UINT auBands[NUM_BANDS];
+        std::iota(auBands, auBands + NUM_BANDS, 0u);
+
+        std::for_each(
+            std::execution::par,
+            auBands,
+            auBands + NUM_BANDS,
+            [this](UINT uBand)
+            {
+                rasterizeBand(uBand);
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::TestBox
+
+      Summary:  Returns whether a box may be visible. The box is
+                occluded when the depth buffer is nearer than its
+                nearest corner over every pixel its corners span
+
+      Args:     const BoundingBox& box
+                  Box in world space
+
+      Modifies: [m_uNumTested, m_uNumOccluded].
+
+      Returns:  BOOL
+                  FALSE if the box is hidden by the occluders
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL OcclusionCuller::TestBox(_In_ const BoundingBox& box)
+    {
+        ++m_uNumTested;
+
+        XMFLOAT3 aCorners[BoundingBox::CORNER_COUNT];
+        if (!projectBox(box, aCorners))
+            return TRUE;
+
+        XMFLOAT3 minCorner = aCorners[0];
+        XMFLOAT3 maxCorner = aCorners[0];
+        for (UINT i = 1u; i < BoundingBox::CORNER_COUNT; ++i)
+        {
+            minCorner.x = std::min<FLOAT>(minCorner.x, aCorners[i].x);
+            minCorner.y = std::min<FLOAT>(minCorner.y, aCorners[i].y);
+            minCorner.z = std::min<FLOAT>(minCorner.z, aCorners[i].z);
+            maxCorner.x = std::max<FLOAT>(maxCorner.x, aCorners[i].x);
+            maxCorner.y = std::max<FLOAT>(maxCorner.y, aCorners[i].y);
+        }
+
+        INT iMinX = std::max<INT>(static_cast<INT>(std::floor(minCorner.x)), 0);
+        INT iMinY = std::max<INT>(static_cast<INT>(std::floor(minCorner.y)), 0);
+        INT iMaxX = std::min<INT>(static_cast<INT>(std::ceil(maxCorner.x)), static_cast<INT>(WIDTH) - 1);
+        INT iMaxY = std::min<INT>(static_cast<INT>(std::ceil(maxCorner.y)), static_cast<INT>(HEIGHT) - 1);
+
+        if (iMinX > iMaxX || iMinY > iMaxY)
+            return TRUE;
+
+        const XMVECTOR laneIndices = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+        XMVECTOR nearestDepth = XMVectorReplicate(minCorner.z);
+        XMVECTOR minX = XMVectorReplicate(static_cast<FLOAT>(iMinX));
+        XMVECTOR maxX = XMVectorReplicate(static_cast<FLOAT>(iMaxX));
+
+        for (INT y = iMinY; y <= iMaxY; ++y)
+        {
+            for (INT x = iMinX & ~3; x <= iMaxX; x += 4)
+            {
+                XMVECTOR pixelX = XMVectorAdd(XMVectorReplicate(static_cast<FLOAT>(x)), laneIndices);
+                XMVECTOR inRect = XMVectorAndInt(XMVectorGreaterOrEqual(pixelX, minX), XMVectorLessOrEqual(pixelX, maxX));
+
+                XMVECTOR depths = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_aDepths[static_cast<size_t>(y) * WIDTH + static_cast<size_t>(x)]));
+                XMVECTOR visible = XMVectorAndInt(inRect, XMVectorGreaterOrEqual(depths, nearestDepth));
+
+                if (!XMVector4EqualInt(visible, XMVectorFalseInt()))
+                    return TRUE;
+            }
+        }
+
+        ++m_uNumOccluded;
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumOccluders
+
+      Summary:  Returns the number of occluders rasterized
+
+      Returns:  UINT
+                  Number of occluder boxes added since Begin
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT OcclusionCuller::GetNumOccluders() const
+    {
+        return m_uNumOccluders;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumTested
+
+      Summary:  Returns the number of boxes tested since Begin
+
+      Returns:  UINT
+                  Number of boxes tested
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT OcclusionCuller::GetNumTested() const
+    {
+        return m_uNumTested;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumOccluded
+
+      Summary:  Returns the number of boxes occluded since Begin
+
+      Returns:  UINT
+                  Number of boxes found hidden
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT OcclusionCuller::GetNumOccluded() const
+    {
+        return m_uNumOccluded;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::projectBox
+
+      Summary:  Projects the corners of a box to pixel coordinates and
+                depth
+
+      Args:     const BoundingBox& box
+                  Box in world space
+                XMFLOAT3* aOutCorners
+                  Pixel x, pixel y and depth of each corner
+
+      Returns:  BOOL
+                  FALSE if a corner is not in front of the eye
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL OcclusionCuller::projectBox(_In_ const BoundingBox& box, _Out_writes_(8) XMFLOAT3* aOutCorners) const
+    {
+        XMFLOAT3 aCorners[BoundingBox::CORNER_COUNT];
+        box.GetCorners(aCorners);
+
+        for (UINT i = 0u; i < BoundingBox::CORNER_COUNT; ++i)
+        {
+            XMFLOAT4 clip;
+            XMStoreFloat4(&clip, XMVector3Transform(XMLoadFloat3(&aCorners[i]), m_viewProjection));
+
+            if (clip.w < MIN_W)
+                return FALSE;
+
+            FLOAT inverseW = 1.0f / clip.w;
+            aOutCorners[i] = XMFLOAT3(
+                (clip.x * inverseW * 0.5f + 0.5f) * static_cast<FLOAT>(WIDTH),
+                (0.5f - clip.y * inverseW * 0.5f) * static_cast<FLOAT>(HEIGHT),
+                clip.z * inverseW
+            );
+        }
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::addTriangle
+
+      Summary:  Sets up a triangle in pixel coordinates, turning it
+                counterclockwise on the screen so the edge functions
+                are positive inside whatever way it faces
+
+      Args:     const XMFLOAT3& a, b, c
+                  Pixel x, pixel y and depth of the vertices
+
+      Modifies: [m_aTriangles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::addTriangle(_In_ const XMFLOAT3& a, _In_ const XMFLOAT3& b, _In_ const XMFLOAT3& c)
+    {
+        FLOAT area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (std::abs(area) < 0.0001f)
+            return;
+
+        const XMFLOAT3* apVertices[3] = { &a, &b, &c };
+        if (area < 0.0f)
+        {
+            std::swap(apVertices[1], apVertices[2]);
+            area = -area;
+        }
+
+        Triangle triangle;
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            const XMFLOAT3& from = *apVertices[i];
+            const XMFLOAT3& to = *apVertices[(i + 1u) % 3u];
+
+            triangle.aEdgeX[i] = from.y - to.y;
+            triangle.aEdgeY[i] = to.x - from.x;
+            triangle.aEdgeConstant[i] = -(triangle.aEdgeX[i] * from.x + triangle.aEdgeY[i] * from.y);
+        }
+
+        const XMFLOAT3& v0 = *apVertices[0];
+        const XMFLOAT3& v1 = *apVertices[1];
+        const XMFLOAT3& v2 = *apVertices[2];
+
+        triangle.depthX = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+        triangle.depthY = ((v1.x - v0.x) * (v2.z - v0.z) - (v2.x - v0.x) * (v1.z - v0.z)) / area;
+        triangle.depthConstant = v0.z - triangle.depthX * v0.x - triangle.depthY * v0.y;
+
+        triangle.iMinX = std::max<INT>(static_cast<INT>(std::floor(std::min<FLOAT>(std::min<FLOAT>(v0.x, v1.x), v2.x))), 0);
+        triangle.iMinY = std::max<INT>(static_cast<INT>(std::floor(std::min<FLOAT>(std::min<FLOAT>(v0.y, v1.y), v2.y))), 0);
+        triangle.iMaxX = std::min<INT>(static_cast<INT>(std::ceil(std::max<FLOAT>(std::max<FLOAT>(v0.x, v1.x), v2.x))), static_cast<INT>(WIDTH) - 1);
+        triangle.iMaxY = std::min<INT>(static_cast<INT>(std::ceil(std::max<FLOAT>(std::max<FLOAT>(v0.y, v1.y), v2.y))), static_cast<INT>(HEIGHT) - 1);
+
+        if (triangle.iMinX > triangle.iMaxX || triangle.iMinY > triangle.iMaxY)
+            return;
+
+        m_aTriangles.push_back(triangle);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::rasterizeBand
+
+      Summary:  Rasterizes the triangles overlapping a band of rows,
+                evaluating the edge functions and the depth plane at
+                the centers of four pixels at once and keeping the
+                nearest depth of the pixels inside
+
+      Args:     UINT uBand
+                  Index of the band
+
+      Modifies: [m_aDepths].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::rasterizeBand(_In_ UINT uBand)
+    {
+        constexpr const INT BAND_HEIGHT = static_cast<INT>(HEIGHT / NUM_BANDS);
+
+        const XMVECTOR laneIndices = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+        const XMVECTOR laneCenters = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+
+        INT iBandMinY = static_cast<INT>(uBand) * BAND_HEIGHT;
+        INT iBandMaxY = iBandMinY + BAND_HEIGHT - 1;
+
+        for (const Triangle& triangle : m_aTriangles)
+        {
+            if (triangle.iMaxY < iBandMinY || triangle.iMinY > iBandMaxY)
+                continue;
+
+            XMVECTOR aEdgeX[3];
+            for (UINT i = 0u; i < 3u; ++i)
+                aEdgeX[i] = XMVectorReplicate(triangle.aEdgeX[i]);
+
+            XMVECTOR depthX = XMVectorReplicate(triangle.depthX);
+            XMVECTOR minX = XMVectorReplicate(static_cast<FLOAT>(triangle.iMinX));
+            XMVECTOR maxX = XMVectorReplicate(static_cast<FLOAT>(triangle.iMaxX));
+
+            INT iMinY = std::max<INT>(triangle.iMinY, iBandMinY);
+            INT iMaxY = std::min<INT>(triangle.iMaxY, iBandMaxY);
+
+            for (INT y = iMinY; y <= iMaxY; ++y)
+            {
+                FLOAT centerY = static_cast<FLOAT>(y) + 0.5f;
+
+                XMVECTOR aEdgeRow[3];
+                for (UINT i = 0u; i < 3u; ++i)
+                    aEdgeRow[i] = XMVectorReplicate(triangle.aEdgeY[i] * centerY + triangle.aEdgeConstant[i]);
+
+                XMVECTOR depthRow = XMVectorReplicate(triangle.depthY * centerY + triangle.depthConstant);
+
+                for (INT x = triangle.iMinX & ~3; x <= triangle.iMaxX; x += 4)
+                {
+                    XMVECTOR pixelX = XMVectorAdd(XMVectorReplicate(static_cast<FLOAT>(x)), laneIndices);
+                    XMVECTOR centerX = XMVectorAdd(XMVectorReplicate(static_cast<FLOAT>(x)), laneCenters);
+
+                    XMVECTOR inside = XMVectorAndInt(XMVectorGreaterOrEqual(pixelX, minX), XMVectorLessOrEqual(pixelX, maxX));
+                    for (UINT i = 0u; i < 3u; ++i)
+                        inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(XMVectorMultiplyAdd(aEdgeX[i], centerX, aEdgeRow[i]), XMVectorZero()));
+
+                    if (XMVector4EqualInt(inside, XMVectorFalseInt()))
+                        continue;
+
+                    XMFLOAT4* pDepths = reinterpret_cast<XMFLOAT4*>(&m_aDepths[static_cast<size_t>(y) * WIDTH + static_cast<size_t>(x)]);
+                    XMVECTOR depths = XMLoadFloat4(pDepths);
+                    XMVECTOR depth = XMVectorMultiplyAdd(depthX, centerX, depthRow);
+
+                    XMStoreFloat4(pDepths, XMVectorSelect(depths, XMVectorMin(depths, depth), inside));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLER.H
+
+  Summary:   OcclusionCuller header file contains declaration of class
+             OcclusionCuller used to cull objects hidden behind
+             others on the CPU.
+
+  Classes:  OcclusionCuller
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    OcclusionCuller
+
+      Summary:  Software rasterizer of occluder boxes into a coarse
+                depth buffer, against which the bounding boxes of
+                objects are tested. Each frame the occluders are set
+                up on the calling thread, then rasterized in bands of
+                rows in parallel, four pixels at a time. A box is
+                occluded when the nearest depth of its corners lies
+                behind the depth buffer over all of its screen
+                rectangle. Occluders have to be solid all the way
+                through, the test is conservative otherwise
+
+      Methods:  Begin
+                  Clears the depth buffer for a view projection
+                AddOccluder
+                  Adds the triangles of an occluder box
+                Rasterize
+                  Rasterizes the occluders into the depth buffer
+                TestBox
+                  Returns whether a box may be visible
+                GetNumOccluders
+                  Returns the number of occluders rasterized
+                GetNumTested
+                  Returns the number of boxes tested since Begin
+                GetNumOccluded
+                  Returns the number of boxes occluded since Begin
+                OcclusionCuller
+                  Constructor.
+                ~OcclusionCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class OcclusionCuller final
+    {
+    public:
+        static constexpr const UINT WIDTH = 256u;
+        static constexpr const UINT HEIGHT = 144u;
+        static constexpr const UINT NUM_BANDS = 8u;
+        static_assert(WIDTH % 4u == 0u, "Rows are rasterized four pixels at a time");
+        static_assert(HEIGHT % NUM_BANDS == 0u, "Bands have to cover the depth buffer");
+
+        OcclusionCuller();
+        OcclusionCuller(const OcclusionCuller& other) = delete;
+        OcclusionCuller(OcclusionCuller&& other) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller& other) = delete;
+        OcclusionCuller& operator=(OcclusionCuller&& other) = delete;
+        ~OcclusionCuller() = default;
+
+        void XM_CALLCONV Begin(_In_ FXMMATRIX viewProjection);
+        void AddOccluder(_In_ const BoundingBox& box);
+        void Rasterize();
+        BOOL TestBox(_In_ const BoundingBox& box);
+
+        UINT GetNumOccluders() const;
+        UINT GetNumTested() const;
+        UINT GetNumOccluded() const;
+
+    private:
+        static constexpr const FLOAT MIN_W = 0.0001f;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   Triangle
+
+            Summary:  Triangle set up for rasterization, as the edge
+                      functions, positive inside, and the depth plane
+                      over pixel coordinates, with its pixel rectangle
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Triangle
+        {
+            FLOAT aEdgeX[3];
+            FLOAT aEdgeY[3];
+            FLOAT aEdgeConstant[3];
+            FLOAT depthX;
+            FLOAT depthY;
+            FLOAT depthConstant;
+            INT iMinX;
+            INT iMinY;
+            INT iMaxX;
+            INT iMaxY;
+        };
+
+        BOOL projectBox(_In_ const BoundingBox& box, _Out_writes_(8) XMFLOAT3* aOutCorners) const;
+        void addTriangle(_In_ const XMFLOAT3& a, _In_ const XMFLOAT3& b, _In_ const XMFLOAT3& c);
+        void rasterizeBand(_In_ UINT uBand);
+
+    private:
+        XMMATRIX m_viewProjection;
+        std::vector<FLOAT> m_aDepths;
+        std::vector<Triangle> m_aTriangles;
+        UINT m_uNumOccluders;
+        UINT m_uNumTested;
+        UINT m_uNumOccluded;
+    };
+}
@@ -17,7 +17,7 @@ namespace library
       Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer, 
                  m_textureRV, m_samplerLinear, m_vertexShader, 
                  m_pixelShader, m_textureFilePath, m_outputColor,
-                 m_world].
+                 m_world, m_boundingRadius].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Renderable::Renderable(_In_ const XMFLOAT4& outputColor)
         : m_vertexBuffer()
@@ -33,6 +33,7 @@ namespace library
         , m_outputColor(outputColor)
         , m_padding()
         , m_world(XMMatrixIdentity())
+        , m_boundingRadius(0.0f)
     {}
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -45,7 +46,8 @@ namespace library
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
 
-      Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer].
+      Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
+                 m_boundingRadius].
 
       Returns:  HRESULT
                   Status code
@@ -117,6 +119,11 @@ namespace library
         if (FAILED(hr))
             return hr;
 
+        // Radius of the sphere centered on the local origin enclosing every vertex
+        m_boundingRadius = 0.0f;
+        for (UINT i = 0u; i < GetNumVertices(); ++i)
+            m_boundingRadius = std::max<FLOAT>(m_boundingRadius, XMVectorGetX(XMVector3Length(XMLoadFloat3(&getVertices()[i].Position))));
+
         return S_OK;
     }
 
@@ -243,6 +250,19 @@ namespace library
         return m_world;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetBoundingRadius
+
+      Summary:  Returns the radius of the bounding sphere in local space
+
+      Returns:  FLOAT
+                  Bounding radius, 0 before initialization
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT Renderable::GetBoundingRadius() const
+    {
+        return m_boundingRadius;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetOutputColor
 
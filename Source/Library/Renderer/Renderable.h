@@ -92,6 +92,7 @@ namespace library
 
         const XMMATRIX& GetWorldMatrix() const;
         const XMFLOAT4& GetOutputColor() const;
+        FLOAT GetBoundingRadius() const;
         BOOL HasTexture() const;
         const Material& GetMaterial(UINT uIndex) const;
         const BasicMeshEntry& GetMesh(UINT uIndex) const;
@@ -130,5 +131,6 @@ namespace library
         XMFLOAT4 m_outputColor;
         BYTE m_padding[8];
         XMMATRIX m_world;
+        FLOAT m_boundingRadius;
     };
 }
\ No newline at end of file
@@ -8,15 +8,24 @@ namespace library
 
       Summary:  Constructor
 
-      Modifies: [m_driverType, m_featureLevel, m_d3dDevice, m_d3dDevice1,
-                 m_immediateContext, m_immediateContext1, m_swapChain,
-                 m_swapChain1, m_renderTargetView, m_depthStencil,
-                 m_depthStencilView, m_cbChangeOnResize, m_camera,
-                 m_projection, m_renderables, m_vertexShaders,
-                 m_pixelShaders].
+      Modifies: [m_comApartment, m_driverType, m_featureLevel,
+                 m_d3dDevice, m_d3dDevice1, m_immediateContext,
+                 m_immediateContext1, m_swapChain, m_swapChain1,
+                 m_renderTargetView, m_depthStencil, m_depthStencilView,
+                 m_cbChangeOnResize, m_camera, m_projection,
+                 m_pBoundTextureRV, m_uBoundSamplerHandle,
+                 m_pBoundRenderable, m_pBoundVertexShader,
+                 m_pBoundPixelShader, m_pBoundVertexLayout, m_frustum,
+                 m_occlusionCuller, m_objectHierarchy,
+                 m_apHierarchyRenderables, m_apHierarchyModels,
+                 m_bObjectHierarchyDirty, m_aBoundingBoxes,
+                 m_aVisibleIndices, m_aVisibleObjects, m_drawList,
+                 m_aDrawRecords, m_aShaderPairs, m_materialIds,
+                 m_renderables, m_vertexShaders, m_pixelShaders].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Renderer::Renderer()
-        : m_driverType(D3D_DRIVER_TYPE_HARDWARE)
+        : m_comApartment()
+        , m_driverType(D3D_DRIVER_TYPE_HARDWARE)
         , m_featureLevel(D3D_FEATURE_LEVEL_11_1)
         , m_d3dDevice()
         , m_d3dDevice1()
@@ -33,6 +42,27 @@ namespace library
         , m_padding()
         , m_camera(XMVectorSet(1.0f, 5.0f, -8.0f, 1.0f))
         , m_projection()
+        , m_viewportHeight(0.0f)
+        , m_textureStreamer()
+        , m_pBoundTextureRV(nullptr)
+        , m_uBoundSamplerHandle(INVALID_SAMPLER)
+        , m_pBoundRenderable(nullptr)
+        , m_pBoundVertexShader(nullptr)
+        , m_pBoundPixelShader(nullptr)
+        , m_pBoundVertexLayout(nullptr)
+        , m_frustum()
+        , m_occlusionCuller()
+        , m_objectHierarchy()
+        , m_apHierarchyRenderables()
+        , m_apHierarchyModels()
+        , m_bObjectHierarchyDirty(TRUE)
+        , m_aBoundingBoxes()
+        , m_aVisibleIndices()
+        , m_aVisibleObjects()
+        , m_drawList()
+        , m_aDrawRecords()
+        , m_aShaderPairs()
+        , m_materialIds()
 
         , m_renderables()
         , m_models() // added at lab08
@@ -42,6 +72,25 @@ namespace library
         , m_scenes()
     {}
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::~Renderer
+
+      Summary:  Destructor. Releases the cached sampler states and
+                textures, which outlive the renderer otherwise, before
+                the device
+
+      Modifies: [m_immediateContext, m_uBoundSamplerHandle].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Renderer::~Renderer()
+    {
+        if (m_immediateContext)
+            m_immediateContext->ClearState();
+
+        m_uBoundSamplerHandle = INVALID_SAMPLER;
+        SamplerCache::Clear();
+        Model::GetTextureCache().Clear();
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Initialize
 
@@ -248,6 +297,8 @@ namespace library
 
         m_immediateContext->RSSetViewports(1, &vp);
 
+        m_viewportHeight = static_cast<FLOAT>(height);
+
         // Initialize the projection matrix
         m_projection = XMMatrixPerspectiveFovLH(XM_PIDIV2, width / (FLOAT)height, 0.01f, 100.0f);
 
@@ -271,6 +322,11 @@ namespace library
 
         m_immediateContext->UpdateSubresource(m_cbChangeOnResize.Get(), 0, nullptr, &cbChangeOnResize, 0, 0);
 
+        // Create the constant buffer of camera, updated every frame
+        hr = m_camera.Initialize(m_d3dDevice.Get());
+        if (FAILED(hr))
+            return hr;
+
         // Create the constant buffer of light
         D3D11_BUFFER_DESC bdLight =
         {
@@ -299,17 +355,21 @@ namespace library
         for (auto renderablesElem : m_renderables)
             renderablesElem.second->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
 
-        // Initialize the voxels
+        // Initialize the voxels and the block colors of the scenes
         for (auto voxelElem : m_scenes)
-        {
-            for (int i = 0; i < voxelElem.second->GetVoxels().size(); ++i)
-                voxelElem.second->GetVoxels()[i]->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
-        }
+            voxelElem.second->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
 
         // Initialize the models
         for (auto modelElem : m_models)
             modelElem.second->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
 
+        // Stream the mips of the material textures from now on
+        for (auto renderablesElem : m_renderables)
+            registerStreamedTextures(*renderablesElem.second);
+
+        for (auto modelElem : m_models)
+            registerStreamedTextures(*modelElem.second);
+
         return hr;
     }
 
@@ -320,7 +380,7 @@ namespace library
                  Key of the renderable object
                const std::shared_ptr<Renderable>& renderable
                  Shared pointer to the renderable object
-     Modifies: [m_renderables].
+     Modifies: [m_renderables, m_bObjectHierarchyDirty].
      Returns:  HRESULT
                  Status code.
    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -330,6 +390,7 @@ namespace library
             return E_FAIL;
 
         m_renderables.insert({ pszRenderableName, renderable });
+        m_bObjectHierarchyDirty = TRUE;
 
         return S_OK;
     }
@@ -344,7 +405,7 @@ namespace library
                 const std::shared_ptr<Model>& pModel
                   Shared pointer to the model object
 
-      Modifies: [m_models].
+      Modifies: [m_models, m_bObjectHierarchyDirty].
 
       Returns:  HRESULT
                   Status code.
@@ -355,6 +416,7 @@ namespace library
             return E_FAIL;
 
         m_models[pszModelName] = pModel;
+        m_bObjectHierarchyDirty = TRUE;
 
         return S_OK;
     }
@@ -428,26 +490,73 @@ namespace library
                   Key of a scene
                 const std::filesystem::path& sceneFilePath
                   File path to initialize a scene
+                eVoxelMesher mesher
+                  Way the scene turns its chunks into GPU data
+      Modifies: [m_scenes].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderer::AddScene(_In_ PCWSTR pszSceneName, const std::filesystem::path& sceneFilePath, _In_ eVoxelMesher mesher)
+    {
+        if (m_scenes.count(pszSceneName) > 0)
+            return E_FAIL;
+
+        m_scenes.insert({ pszSceneName, std::make_shared<Scene>(sceneFilePath, mesher) });
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::AddScene
+      Summary:  Add a scene
+      Args:     PCWSTR pszSceneName
+                  Key of a scene
+                const SceneData& sceneData
+                  Columns of the scene, used without going through a
+                  scene file
+                eVoxelMesher mesher
+                  Way the scene turns its chunks into GPU data
+      Modifies: [m_scenes].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderer::AddScene(_In_ PCWSTR pszSceneName, _In_ const SceneData& sceneData, _In_ eVoxelMesher mesher)
+    {
+        if (m_scenes.count(pszSceneName) > 0)
+            return E_FAIL;
+
+        m_scenes.insert({ pszSceneName, std::make_shared<Scene>(sceneData, mesher) });
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::AddScene
+      Summary:  Add a scene
+      Args:     PCWSTR pszSceneName
+                  Key of a scene
+                const std::shared_ptr<Scene>& scene
+                  Scene to add, such as one streaming its chunks
       Modifies: [m_scenes].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Renderer::AddScene(_In_ PCWSTR pszSceneName, const std::filesystem::path& sceneFilePath)
+    HRESULT Renderer::AddScene(_In_ PCWSTR pszSceneName, _In_ const std::shared_ptr<Scene>& scene)
     {
         if (m_scenes.count(pszSceneName) > 0)
             return E_FAIL;
 
-        m_scenes.insert({ pszSceneName, std::make_shared<Scene>(sceneFilePath) });
+        m_scenes.insert({ pszSceneName, scene });
 
         return S_OK;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::SetMainScene
-      Summary:  Set the main scene
+      Summary:  Set the main scene, which the camera collides with
       Args:     PCWSTR pszSceneName
                   Name of the scene to set as the main scene
-      Modifies: [m_pszMainSceneName].
+      Modifies: [m_pszMainSceneName, m_camera].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -457,6 +566,7 @@ namespace library
             return E_FAIL;
 
         m_pszMainSceneName = pszSceneName;
+        m_camera.SetCollisionScene(m_scenes[pszSceneName]);
 
         return S_OK;
     }
@@ -478,7 +588,7 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Update
 
-      Summary:  Update the renderables and models each frame
+      Summary:  Update the renderables, models and scenes each frame
 
       Args:     FLOAT deltaTime
                   Time difference of a frame
@@ -494,13 +604,22 @@ namespace library
         for (auto& model : m_models)
             model.second->Update(deltaTime);
 
+        updateObjectHierarchy();
+
         m_camera.Update(deltaTime);
+
+        // Streaming scenes follow the camera
+        for (auto& scene : m_scenes)
+            scene.second->Update(m_d3dDevice.Get(), m_immediateContext.Get(), m_camera.GetEye());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Render
 
-      Summary:  Render the frame
+      Summary:  Render the frame. Renderables, chunks and models
+                outside of the view frustum or hidden behind the
+                terrain are not drawn, and the others are drawn sorted
+                by shaders, texture and depth
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderer::Render()
     {
@@ -510,8 +629,7 @@ namespace library
         // Clear the depth buffer to 1.0 (max depth)
         m_immediateContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
 
-        // Create camera constant buffer and update 
-        m_camera.Initialize(m_d3dDevice.Get());
+        // Update camera constant buffer
         CBChangeOnCameraMovement cbChangeOnCameraMovement =
         {
             .View = XMMatrixTranspose(m_camera.GetView())
@@ -519,15 +637,12 @@ namespace library
         XMStoreFloat4(&cbChangeOnCameraMovement.CameraPosition, m_camera.GetEye());
         m_immediateContext->UpdateSubresource(m_camera.GetConstantBuffer().Get(), 0, nullptr, &cbChangeOnCameraMovement, 0, 0);
 
-        D3D11_BUFFER_DESC bd =
-        {
-            .ByteWidth = sizeof(CBLights),
-            .Usage = D3D11_USAGE_DEFAULT,
-            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
-            .CPUAccessFlags = 0,
-        };
+        // Apply the texture mips requested by the previous frame
+        m_textureStreamer.Update();
 
-        m_d3dDevice->CreateBuffer(&bd, nullptr, m_cbLights.GetAddressOf());
+        // Streaming may have replaced views, so nothing bound last frame is trusted
+        m_pBoundTextureRV = nullptr;
+        m_uBoundSamplerHandle = INVALID_SAMPLER;
 
         // Set the constant buffer to each shaders accordingly
         CBLights cbLights = { };
@@ -538,23 +653,43 @@ namespace library
         }
         m_immediateContext->UpdateSubresource(m_cbLights.Get(), 0u, nullptr, &cbLights, 0, 0);
 
-        for (auto renderablesElem = m_renderables.begin(); renderablesElem != m_renderables.end(); ++renderablesElem)
+        m_frustum.Update(m_camera.GetView(), m_projection);
+
+        // Terrain in view hides whatever is behind it
+        m_occlusionCuller.Begin(XMMatrixMultiply(m_camera.GetView(), m_projection));
+        for (auto voxelsElem = m_scenes.begin(); voxelsElem != m_scenes.end(); ++voxelsElem)
         {
-            auto renderable = renderablesElem->second;
+            for (const ChunkMesh& chunkMesh : voxelsElem->second->GetChunkMeshes())
+            {
+                if (!m_frustum.Intersects(chunkMesh.boundingBox))
+                    continue;
 
-            // Set the vertex buffer
-            UINT stride = sizeof(SimpleVertex);
-            UINT offset = 0;
-            m_immediateContext->IASetVertexBuffers(0, 1, renderable->GetVertexBuffer().GetAddressOf(), &stride, &offset);
+                for (const BoundingBox& occluder : chunkMesh.aOccluders)
+                    m_occlusionCuller.AddOccluder(occluder);
+            }
+        }
+        m_occlusionCuller.Rasterize();
 
-            // Set the index buffer
-            m_immediateContext->IASetIndexBuffer(renderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+        // Visible renderables come before visible models once sorted
+        m_objectHierarchy.QueryFrustum(m_frustum, m_aVisibleObjects);
+        std::sort(m_aVisibleObjects.begin(), m_aVisibleObjects.end());
 
-            // Set primitive topology
-            m_immediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        auto firstVisibleModel = std::lower_bound(m_aVisibleObjects.begin(), m_aVisibleObjects.end(), static_cast<UINT>(m_apHierarchyRenderables.size()));
 
-            // Set the input layout
-            m_immediateContext->IASetInputLayout(renderable->GetVertexLayout().Get());
+        // Draws are recorded first, then submitted sorted by state
+        m_drawList.Clear();
+        m_aDrawRecords.clear();
+        m_aShaderPairs.clear();
+        m_materialIds.clear();
+
+        for (auto visibleElem = m_aVisibleObjects.begin(); visibleElem != firstVisibleModel; ++visibleElem)
+        {
+            Renderable* renderable = m_apHierarchyRenderables[*visibleElem];
+
+            BoundingBox box;
+            BoundingBox::CreateFromSphere(box, getBoundingSphere(*renderable));
+            if (!m_occlusionCuller.TestBox(box))
+                continue;
 
             // Create renderable constant buffer and update
             CBChangesEveryFrame cbChangesEveryFrame =
@@ -564,112 +699,93 @@ namespace library
             };
             m_immediateContext->UpdateSubresource(renderable->GetConstantBuffer().Get(), 0u, nullptr, &cbChangesEveryFrame, 0, 0);
 
-            // Set shaders and constant buffers, shader resources, and samplers
-            m_immediateContext->VSSetShader(renderable->GetVertexShader().Get(), nullptr, 0);
-            m_immediateContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
-            m_immediateContext->VSSetConstantBuffers(1, 1, m_cbChangeOnResize.GetAddressOf());
-            m_immediateContext->VSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
-
-            m_immediateContext->PSSetShader(renderable->GetPixelShader().Get(), nullptr, 0);
-            m_immediateContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
-            m_immediateContext->PSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
-            m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
-
             if (renderable->HasTexture())
-            {
-                for (UINT i = 0u; i < renderable->GetNumMeshes(); ++i)
-                {
-                    UINT materialIndex = renderable->GetMesh(i).uMaterialIndex;
-                    m_immediateContext->PSSetShaderResources(0u, 1u, renderable->GetMaterial(materialIndex).pDiffuse->GetTextureResourceView().GetAddressOf());
-                    m_immediateContext->PSSetSamplers(0u, 1u, renderable->GetMaterial(materialIndex).pDiffuse->GetSamplerState().GetAddressOf());
+                requestTextureMips(*renderable);
 
-                    // Draw
-                    m_immediateContext->DrawIndexed(renderable->GetMesh(i).uNumIndices,
-                        renderable->GetMesh(i).uBaseIndex, renderable->GetMesh(i).uBaseVertex);
-                }
-            }
-            else
-                m_immediateContext->DrawIndexed(renderable->GetNumIndices(), 0, 0);
+            addDraws(
+                {
+                    .pRenderable = renderable,
+                    .pModel = nullptr,
+                    .pVoxel = nullptr,
+                    .pScene = nullptr,
+                    .uMesh = ALL_MESHES
+                },
+                getViewDepth(renderable->GetWorldMatrix().r[3])
+            );
         }
 
         // Voxel
         for (auto voxelsElem = m_scenes.begin(); voxelsElem != m_scenes.end(); ++voxelsElem)
         {
-            auto voxel = voxelsElem->second;
+            std::vector<ChunkMesh>& aChunkMeshes = voxelsElem->second->GetChunkMeshes();
 
-            for (UINT i = 0u; i < voxel->GetVoxels().size(); ++i)
-            {
-                // Set the vertex buffer
-                UINT stride = sizeof(SimpleVertex);
-                UINT offset = 0u;
-                m_immediateContext->IASetVertexBuffers(0u, 1u, voxel->GetVoxels()[i]->GetVertexBuffer().GetAddressOf(), &stride, &offset);
+            m_aBoundingBoxes.clear();
+            for (const ChunkMesh& chunkMesh : aChunkMeshes)
+                m_aBoundingBoxes.push_back(chunkMesh.boundingBox);
+            m_frustum.CullBoxes(m_aBoundingBoxes.data(), static_cast<UINT>(m_aBoundingBoxes.size()), m_aVisibleIndices);
 
-                // Set the index buffer
-                m_immediateContext->IASetIndexBuffer(voxel->GetVoxels()[i]->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-
-                // Set the instance buffer
-                stride = sizeof(InstanceData);
-                m_immediateContext->IASetVertexBuffers(1u, 1u, voxel->GetVoxels()[i]->GetInstanceBuffer().GetAddressOf(), &stride, &offset);
+            for (UINT uIndex : m_aVisibleIndices)
+            {
+                ChunkMesh& chunkMesh = aChunkMeshes[uIndex];
 
-                // Set primitive topology
-                m_immediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+                if (!m_occlusionCuller.TestBox(chunkMesh.boundingBox))
+                    continue;
 
-                // Set the input layout
-                m_immediateContext->IASetInputLayout(voxel->GetVoxels()[i]->GetVertexLayout().Get());
+                FLOAT depth = getViewDepth(XMLoadFloat3(&chunkMesh.boundingBox.Center));
 
-                CBChangesEveryFrame cbChangesEveryFrame =
+                for (const std::shared_ptr<Voxel>& voxel : chunkMesh.aVoxels)
                 {
-                    .World = XMMatrixTranspose(voxel->GetVoxels()[i]->GetWorldMatrix()),
-                    .OutputColor = voxel->GetVoxels()[i]->GetOutputColor()
-                };
-
-                m_immediateContext->UpdateSubresource(voxel->GetVoxels()[i]->GetConstantBuffer().Get(), 0, nullptr, &cbChangesEveryFrame, 0, 0);
-
-                // Set shaders and constant buffers, shader resources, and samplers
-                m_immediateContext->VSSetShader(voxel->GetVoxels()[i]->GetVertexShader().Get(), nullptr, 0); // exception
-                m_immediateContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(1, 1, m_cbChangeOnResize.GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(2, 1, voxel->GetVoxels()[i]->GetConstantBuffer().GetAddressOf());
-
-                m_immediateContext->PSSetShader(voxel->GetVoxels()[i]->GetPixelShader().Get(), nullptr, 0);
-                m_immediateContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(2, 1, voxel->GetVoxels()[i]->GetConstantBuffer().GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+                    CBChangesEveryFrame cbChangesEveryFrame =
+                    {
+                        .World = XMMatrixTranspose(voxel->GetWorldMatrix()),
+                        .OutputColor = voxel->GetOutputColor()
+                    };
+                    m_immediateContext->UpdateSubresource(voxel->GetConstantBuffer().Get(), 0, nullptr, &cbChangesEveryFrame, 0, 0);
+
+                    addDraws(
+                        {
+                            .pRenderable = voxel.get(),
+                            .pModel = nullptr,
+                            .pVoxel = voxel.get(),
+                            .pScene = voxelsElem->second.get(),
+                            .uMesh = ALL_MESHES
+                        },
+                        depth
+                    );
+                }
 
-                // Draw
-                m_immediateContext->DrawIndexedInstanced(voxel->GetVoxels()[i]->GetNumIndices(), voxel->GetVoxels()[i]->GetNumInstances(), 0, 0, 0);
+                for (const std::shared_ptr<VoxelMesh>& voxelMesh : chunkMesh.aMeshes)
+                {
+                    CBChangesEveryFrame cbChangesEveryFrame =
+                    {
+                        .World = XMMatrixTranspose(voxelMesh->GetWorldMatrix()),
+                        .OutputColor = voxelMesh->GetOutputColor()
+                    };
+                    m_immediateContext->UpdateSubresource(voxelMesh->GetConstantBuffer().Get(), 0, nullptr, &cbChangesEveryFrame, 0, 0);
+
+                    addDraws(
+                        {
+                            .pRenderable = voxelMesh.get(),
+                            .pModel = nullptr,
+                            .pVoxel = nullptr,
+                            .pScene = nullptr,
+                            .uMesh = ALL_MESHES
+                        },
+                        depth
+                    );
+                }
             }
         }
 
         // Model
-        for (auto modelElem = m_models.begin(); modelElem != m_models.end(); ++modelElem)
+        for (auto visibleElem = firstVisibleModel; visibleElem != m_aVisibleObjects.end(); ++visibleElem)
         {
-            auto model = modelElem->second;
-
-            // Set the vertex buffer
-            UINT strides[2] =
-            {
-                static_cast<UINT>(sizeof(SimpleVertex)),
-                static_cast<UINT>(sizeof(AnimationData)),
-            };
-            UINT offsets[2] = { 0u, 0u };
-
-            ComPtr<ID3D11Buffer> buffers[2]
-            {
-                model->GetVertexBuffer(),
-                model->GetAnimationBuffer()
-            };
-
-            m_immediateContext->IASetVertexBuffers(0, 2, buffers->GetAddressOf(), strides, offsets);
-
-            // Set the index buffer 
-            m_immediateContext->IASetIndexBuffer(model->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-
-            // Set primitive topology
-            m_immediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            Model* model = m_apHierarchyModels[*visibleElem - m_apHierarchyRenderables.size()];
 
-            // Set the input layout
-            m_immediateContext->IASetInputLayout(model->GetVertexLayout().Get());
+            BoundingBox box;
+            BoundingBox::CreateFromSphere(box, getBoundingSphere(*model));
+            if (!m_occlusionCuller.TestBox(box))
+                continue;
 
             // Create the constant buffer
             CBSkinning cbSkinning;
@@ -684,38 +800,39 @@ namespace library
             };
             m_immediateContext->UpdateSubresource(model->GetConstantBuffer().Get(), 0, nullptr, &cbChangesEveryFrame, 0, 0);
 
-            // Set shaders and constant buffers, shader resources, and samplers
-            m_immediateContext->VSSetShader(model->GetVertexShader().Get(), nullptr, 0);
-            m_immediateContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
-            m_immediateContext->VSSetConstantBuffers(1, 1, m_cbChangeOnResize.GetAddressOf());
-            m_immediateContext->VSSetConstantBuffers(2, 1, model->GetConstantBuffer().GetAddressOf());
-            m_immediateContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
-            m_immediateContext->VSSetConstantBuffers(4, 1, model->GetSkinningConstantBuffer().GetAddressOf());
-
-            m_immediateContext->PSSetShader(model->GetPixelShader().Get(), nullptr, 0);
-            m_immediateContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
-            m_immediateContext->PSSetConstantBuffers(2, 1, model->GetConstantBuffer().GetAddressOf());
-            m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
-            m_immediateContext->PSSetConstantBuffers(4, 1, model->GetSkinningConstantBuffer().GetAddressOf());
-
             if (model->HasTexture())
-            {
-                for (UINT i = 0u; i < model->GetNumMeshes(); ++i)
+                requestTextureMips(*model);
+
+            addDraws(
                 {
-                    UINT MaterialIndex = model->GetMesh(i).uMaterialIndex;
-                    m_immediateContext->PSSetShaderResources(0, 1, model->GetMaterial(MaterialIndex).pDiffuse->GetTextureResourceView().GetAddressOf());
-                    m_immediateContext->PSSetSamplers(0, 1, model->GetMaterial(MaterialIndex).pDiffuse->GetSamplerState().GetAddressOf());
-
-                    // Draw
-                    m_immediateContext->DrawIndexed(model->GetMesh(i).uNumIndices,
-                        model->GetMesh(i).uBaseIndex,
-                        model->GetMesh(i).uBaseVertex);
-                }
-            }
-            else
-                m_immediateContext->DrawIndexed(model->GetNumIndices(), 0, 0);
+                    .pRenderable = model,
+                    .pModel = model,
+                    .pVoxel = nullptr,
+                    .pScene = nullptr,
+                    .uMesh = ALL_MESHES
+                },
+                getViewDepth(model->GetWorldMatrix().r[3])
+            );
         }
 
+        m_drawList.Sort();
+
+        // State shared by every draw
+        m_immediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        m_immediateContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
+        m_immediateContext->VSSetConstantBuffers(1, 1, m_cbChangeOnResize.GetAddressOf());
+        m_immediateContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+        m_immediateContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
+        m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+
+        m_pBoundRenderable = nullptr;
+        m_pBoundVertexShader = nullptr;
+        m_pBoundPixelShader = nullptr;
+        m_pBoundVertexLayout = nullptr;
+
+        for (UINT i = 0u; i < m_drawList.GetNumDraws(); ++i)
+            submitDraw(m_aDrawRecords[m_drawList.GetDraw(i).uItem]);
+
         // Present the information rendered to the back buffer to the front buffer
         m_swapChain->Present(0, 0);
     }
@@ -817,7 +934,8 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
      Method:   Renderer::SetVertexShaderOfScene
-     Summary:  Sets the vertex shader for the voxels in a scene
+     Summary:  Sets the vertex shader for the voxels and voxel meshes
+               of a scene
      Args:     PCWSTR pszSceneName
                  Key of the scene
                PCWSTR pszVertexShaderName
@@ -832,15 +950,15 @@ namespace library
             m_vertexShaders.find(pszVertexShaderName) == m_vertexShaders.end())
             return E_FAIL;
 
-        for (UINT i = 0u; i < m_scenes[pszSceneName]->GetVoxels().size(); ++i)
-            m_scenes[pszSceneName]->GetVoxels()[i]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+        m_scenes[pszSceneName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
 
         return S_OK;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::SetPixelShaderOfScene
-      Summary:  Sets the pixel shader for the voxels in a scene
+      Summary:  Sets the pixel shader for the voxels and voxel meshes
+                of a scene
       Args:     PCWSTR pszRenderableName
                   Key of the renderable
                 PCWSTR pszPixelShaderName
@@ -855,8 +973,7 @@ namespace library
             m_pixelShaders.find(pszPixelShaderName) == m_pixelShaders.end())
             return E_FAIL;
 
-        for (UINT i = 0u; i < m_scenes[pszSceneName]->GetVoxels().size(); ++i)
-            m_scenes[pszSceneName]->GetVoxels()[i]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+        m_scenes[pszSceneName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
 
         return S_OK;
     }
@@ -872,4 +989,374 @@ namespace library
     {
         return m_driverType;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetFrustum
+      Summary:  Returns the view frustum of the last frame, with the
+                number of objects it tested and found visible
+      Returns:  const Frustum&
+                  The view frustum
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const Frustum& Renderer::GetFrustum() const
+    {
+        return m_frustum;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetObjectHierarchy
+      Summary:  Returns the bounding volume hierarchy of the renderables
+                followed by the models, for picking and range queries
+      Returns:  const BoundingVolumeHierarchy&
+                  The bounding volume hierarchy
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingVolumeHierarchy& Renderer::GetObjectHierarchy() const
+    {
+        return m_objectHierarchy;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetOcclusionCuller
+      Summary:  Returns the occlusion culler of the last frame, with the
+                number of objects and chunks it tested and found hidden
+      Returns:  const OcclusionCuller&
+                  The occlusion culler
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const OcclusionCuller& Renderer::GetOcclusionCuller() const
+    {
+        return m_occlusionCuller;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::bindTexture
+
+      Summary:  Binds the view and the sampler of a texture to the first
+                pixel shader slot, skipping whichever is already bound
+
+      Args:     Texture& texture
+                  Texture of the next draw
+
+      Modifies: [m_pBoundTextureRV, m_uBoundSamplerHandle].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::bindTexture(_In_ Texture& texture)
+    {
+        if (texture.GetTextureResourceView().Get() != m_pBoundTextureRV)
+        {
+            m_pBoundTextureRV = texture.GetTextureResourceView().Get();
+            m_immediateContext->PSSetShaderResources(0u, 1u, &m_pBoundTextureRV);
+        }
+
+        if (texture.GetSamplerHandle() != m_uBoundSamplerHandle)
+        {
+            m_uBoundSamplerHandle = texture.GetSamplerHandle();
+
+            ID3D11SamplerState* pSamplerState = SamplerCache::GetSamplerState(m_uBoundSamplerHandle);
+            m_immediateContext->PSSetSamplers(0u, 1u, &pSamplerState);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::registerStreamedTextures
+
+      Summary:  Registers the material textures of a renderable to the
+                texture streamer
+
+      Args:     const Renderable& renderable
+                  Initialized renderable
+
+      Modifies: [m_textureStreamer].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::registerStreamedTextures(_In_ const Renderable& renderable)
+    {
+        for (UINT i = 0u; i < renderable.GetNumMaterials(); ++i)
+        {
+            m_textureStreamer.Register(renderable.GetMaterial(i).pDiffuse);
+            m_textureStreamer.Register(renderable.GetMaterial(i).pSpecular);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::requestTextureMips
+
+      Summary:  Requests the mips of the material textures of a
+                renderable for the screen size of its bounding sphere,
+                assuming the textures span the whole renderable
+
+      Args:     const Renderable& renderable
+                  Renderable drawn this frame
+
+      Modifies: [m_textureStreamer].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::requestTextureMips(_In_ const Renderable& renderable)
+    {
+        const XMMATRIX& world = renderable.GetWorldMatrix();
+
+        FLOAT scale = std::max<FLOAT>(XMVectorGetX(XMVector3Length(world.r[0])), XMVectorGetX(XMVector3Length(world.r[1])));
+        scale = std::max<FLOAT>(scale, XMVectorGetX(XMVector3Length(world.r[2])));
+
+        FLOAT distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(world.r[3], m_camera.GetEye())));
+        distance = std::max<FLOAT>(distance, 0.01f);
+
+        // The second diagonal element of the projection is the cotangent of half the vertical field of view
+        FLOAT screenSize = 2.0f * renderable.GetBoundingRadius() * scale / distance * XMVectorGetY(m_projection.r[1]) * 0.5f * m_viewportHeight;
+
+        for (UINT i = 0u; i < renderable.GetNumMaterials(); ++i)
+        {
+            m_textureStreamer.Request(renderable.GetMaterial(i).pDiffuse, screenSize);
+            m_textureStreamer.Request(renderable.GetMaterial(i).pSpecular, screenSize);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::getBoundingSphere
+
+      Summary:  Returns the bounding sphere of a renderable in world
+                space, scaled by the largest scale of its world matrix
+
+      Args:     const Renderable& renderable
+                  Renderable to bound
+
+      Returns:  BoundingSphere
+                  Sphere around the origin of the renderable
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingSphere Renderer::getBoundingSphere(_In_ const Renderable& renderable) const
+    {
+        const XMMATRIX& world = renderable.GetWorldMatrix();
+
+        FLOAT scale = std::max<FLOAT>(XMVectorGetX(XMVector3Length(world.r[0])), XMVectorGetX(XMVector3Length(world.r[1])));
+        scale = std::max<FLOAT>(scale, XMVectorGetX(XMVector3Length(world.r[2])));
+
+        BoundingSphere sphere;
+        XMStoreFloat3(&sphere.Center, world.r[3]);
+        sphere.Radius = renderable.GetBoundingRadius() * scale;
+
+        return sphere;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::updateObjectHierarchy
+
+      Summary:  Builds the hierarchy over the renderables and the models
+                after one was added, and refits the ones that moved
+                otherwise
+
+      Modifies: [m_objectHierarchy, m_apHierarchyRenderables,
+                 m_apHierarchyModels, m_bObjectHierarchyDirty,
+                 m_aBoundingBoxes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::updateObjectHierarchy()
+    {
+        if (!m_bObjectHierarchyDirty)
+        {
+            BoundingBox box;
+            for (UINT i = 0u; i < m_apHierarchyRenderables.size(); ++i)
+            {
+                BoundingBox::CreateFromSphere(box, getBoundingSphere(*m_apHierarchyRenderables[i]));
+                m_objectHierarchy.Refit(i, box);
+            }
+
+            for (UINT i = 0u; i < m_apHierarchyModels.size(); ++i)
+            {
+                BoundingBox::CreateFromSphere(box, getBoundingSphere(*m_apHierarchyModels[i]));
+                m_objectHierarchy.Refit(static_cast<UINT>(m_apHierarchyRenderables.size()) + i, box);
+            }
+
+            return;
+        }
+
+        m_apHierarchyRenderables.clear();
+        m_apHierarchyModels.clear();
+        m_aBoundingBoxes.clear();
+
+        BoundingBox box;
+        for (auto& renderable : m_renderables)
+        {
+            m_apHierarchyRenderables.push_back(renderable.second.get());
+
+            BoundingBox::CreateFromSphere(box, getBoundingSphere(*renderable.second));
+            m_aBoundingBoxes.push_back(box);
+        }
+
+        for (auto& model : m_models)
+        {
+            m_apHierarchyModels.push_back(model.second.get());
+
+            BoundingBox::CreateFromSphere(box, getBoundingSphere(*model.second));
+            m_aBoundingBoxes.push_back(box);
+        }
+
+        m_objectHierarchy.Build(m_aBoundingBoxes.data(), static_cast<UINT>(m_aBoundingBoxes.size()));
+        m_bObjectHierarchyDirty = FALSE;
+    }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::getViewDepth
+
+      Summary:  Returns the depth of a position along the view direction
+
+      Args:     FXMVECTOR position
+                  Position in world space
+
+      Returns:  FLOAT
+                  View space z of the position
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT XM_CALLCONV Renderer::getViewDepth(_In_ FXMVECTOR position) const
+    {
+        return XMVectorGetZ(XMVector3Transform(position, m_camera.GetView()));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::addDraws
+
+      Summary:  Records the draws of a renderable, one per mesh if it
+                is textured so that each mesh sorts by its diffuse
+                texture, and one for all its indices otherwise.
+                Shaders and textures are numbered in the order they
+                are first met this frame
+
+      Args:     const DrawRecord& record
+                  Renderable to draw and how to bind it
+                FLOAT depth
+                  View depth of the renderable
+
+      Modifies: [m_drawList, m_aDrawRecords, m_aShaderPairs,
+                 m_materialIds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::addDraws(_In_ const DrawRecord& record, _In_ FLOAT depth)
+    {
+        Renderable* renderable = record.pRenderable;
+
+        std::pair<ID3D11VertexShader*, ID3D11PixelShader*> shaders(renderable->GetVertexShader().Get(), renderable->GetPixelShader().Get());
+        auto shadersElem = std::find(m_aShaderPairs.begin(), m_aShaderPairs.end(), shaders);
+        if (shadersElem == m_aShaderPairs.end())
+            shadersElem = m_aShaderPairs.insert(m_aShaderPairs.end(), shaders);
+
+        UINT uShader = std::min<UINT>(static_cast<UINT>(shadersElem - m_aShaderPairs.begin()), DrawList::MAX_SHADERS - 1u);
+
+        if (!renderable->HasTexture())
+        {
+            m_drawList.Add(DrawList::MakeKey(eDrawPass::SOLID, uShader, 0u, depth), static_cast<UINT>(m_aDrawRecords.size()));
+            m_aDrawRecords.push_back(record);
+            return;
+        }
+
+        for (UINT i = 0u; i < renderable->GetNumMeshes(); ++i)
+        {
+            const Texture* pDiffuse = renderable->GetMaterial(renderable->GetMesh(i).uMaterialIndex).pDiffuse.get();
+
+            // Material 0 is left to draws without a texture
+            UINT uMaterial = 0u;
+            if (pDiffuse)
+            {
+                uMaterial = m_materialIds.try_emplace(pDiffuse, static_cast<UINT>(m_materialIds.size()) + 1u).first->second;
+                uMaterial = std::min<UINT>(uMaterial, DrawList::MAX_MATERIALS - 1u);
+            }
+
+            DrawRecord meshRecord = record;
+            meshRecord.uMesh = i;
+
+            m_drawList.Add(DrawList::MakeKey(eDrawPass::SOLID, uShader, uMaterial, depth), static_cast<UINT>(m_aDrawRecords.size()));
+            m_aDrawRecords.push_back(meshRecord);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::submitDraw
+
+      Summary:  Binds what a recorded draw needs that is not bound yet
+                and draws it. Buffers are bound when the renderable
+                changes, shaders and the input layout when they do
+
+      Args:     const DrawRecord& record
+                  Draw to submit
+
+      Modifies: [m_pBoundRenderable, m_pBoundVertexShader,
+                 m_pBoundPixelShader, m_pBoundVertexLayout,
+                 m_pBoundTextureRV, m_uBoundSamplerHandle].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::submitDraw(_In_ const DrawRecord& record)
+    {
+        Renderable* renderable = record.pRenderable;
+
+        if (renderable != m_pBoundRenderable)
+        {
+            m_pBoundRenderable = renderable;
+
+            if (record.pModel)
+            {
+                // Set the vertex buffer and the animation buffer
+                UINT strides[2] =
+                {
+                    static_cast<UINT>(sizeof(SimpleVertex)),
+                    static_cast<UINT>(sizeof(AnimationData)),
+                };
+                UINT offsets[2] = { 0u, 0u };
+
+                ID3D11Buffer* apBuffers[2] =
+                {
+                    record.pModel->GetVertexBuffer().Get(),
+                    record.pModel->GetAnimationBuffer().Get()
+                };
+
+                m_immediateContext->IASetVertexBuffers(0u, 2u, apBuffers, strides, offsets);
+
+                m_immediateContext->VSSetConstantBuffers(4, 1, record.pModel->GetSkinningConstantBuffer().GetAddressOf());
+                m_immediateContext->PSSetConstantBuffers(4, 1, record.pModel->GetSkinningConstantBuffer().GetAddressOf());
+            }
+            else
+            {
+                // Set the vertex buffer
+                UINT stride = sizeof(SimpleVertex);
+                UINT offset = 0u;
+                m_immediateContext->IASetVertexBuffers(0u, 1u, renderable->GetVertexBuffer().GetAddressOf(), &stride, &offset);
+
+                if (record.pVoxel)
+                {
+                    // Set the instance buffer
+                    stride = sizeof(InstanceData);
+                    m_immediateContext->IASetVertexBuffers(1u, 1u, record.pVoxel->GetInstanceBuffer().GetAddressOf(), &stride, &offset);
+
+                    m_immediateContext->VSSetConstantBuffers(4, 1, record.pScene->GetBlockColorsConstantBuffer().GetAddressOf());
+                }
+            }
+
+            // Set the index buffer
+            m_immediateContext->IASetIndexBuffer(renderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+
+            m_immediateContext->VSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
+            m_immediateContext->PSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
+        }
+
+        if (renderable->GetVertexShader().Get() != m_pBoundVertexShader)
+        {
+            m_pBoundVertexShader = renderable->GetVertexShader().Get();
+            m_immediateContext->VSSetShader(m_pBoundVertexShader, nullptr, 0);
+        }
+
+        if (renderable->GetPixelShader().Get() != m_pBoundPixelShader)
+        {
+            m_pBoundPixelShader = renderable->GetPixelShader().Get();
+            m_immediateContext->PSSetShader(m_pBoundPixelShader, nullptr, 0);
+        }
+
+        if (renderable->GetVertexLayout().Get() != m_pBoundVertexLayout)
+        {
+            m_pBoundVertexLayout = renderable->GetVertexLayout().Get();
+            m_immediateContext->IASetInputLayout(m_pBoundVertexLayout);
+        }
+
+        if (record.uMesh != ALL_MESHES)
+        {
+            UINT uMaterialIndex = renderable->GetMesh(record.uMesh).uMaterialIndex;
+            if (renderable->GetMaterial(uMaterialIndex).pDiffuse)
+                bindTexture(*renderable->GetMaterial(uMaterialIndex).pDiffuse);
+
+            // Draw
+            m_immediateContext->DrawIndexed(renderable->GetMesh(record.uMesh).uNumIndices,
+                renderable->GetMesh(record.uMesh).uBaseIndex,
+                renderable->GetMesh(record.uMesh).uBaseVertex);
+        }
+        else if (record.pVoxel)
+            m_immediateContext->DrawIndexedInstanced(renderable->GetNumIndices(), record.pVoxel->GetNumInstances(), 0, 0, 0);
+        else
+            m_immediateContext->DrawIndexed(renderable->GetNumIndices(), 0, 0);
+    }
 }
\ No newline at end of file
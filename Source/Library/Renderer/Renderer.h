@@ -16,11 +16,17 @@
 #include "Camera/Camera.h"
 #include "Light/PointLight.h"
 #include "Model/Model.h"
+#include "Renderer/BoundingVolumeHierarchy.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/DrawList.h"
+#include "Renderer/Frustum.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/Renderable.h"
 #include "Scene/Scene.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
+#include "Texture/ImageDecoder.h"
+#include "Texture/TextureStreamer.h"
 #include "Window/MainWindow.h"
 
 namespace library
@@ -40,6 +46,14 @@ namespace library
                   Update the renderables each frame
                 Render
                   Renders the frame
+                GetFrustum
+                  Returns the view frustum objects are culled against
+                GetObjectHierarchy
+                  Returns the bounding volume hierarchy of the
+                  renderables and models
+                GetOcclusionCuller
+                  Returns the software depth buffer objects are
+                  culled against behind the terrain
                 GetDriverType
                   Returns the Direct3D driver type
                 Renderer
@@ -55,7 +69,7 @@ namespace library
         Renderer(Renderer&& other) = delete;
         Renderer& operator=(const Renderer& other) = delete;
         Renderer& operator=(Renderer&& other) = delete;
-        ~Renderer() = default;
+        ~Renderer();
 
         HRESULT Initialize(_In_ HWND hWnd);
         HRESULT AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable);
@@ -64,7 +78,9 @@ namespace library
         HRESULT AddVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ const std::shared_ptr<VertexShader>& vertexShader);
         HRESULT AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader);
 
-        HRESULT AddScene(_In_ PCWSTR pszSceneName, const std::filesystem::path& sceneFileDirectory);
+        HRESULT AddScene(_In_ PCWSTR pszSceneName, const std::filesystem::path& sceneFileDirectory, _In_ eVoxelMesher mesher);
+        HRESULT AddScene(_In_ PCWSTR pszSceneName, _In_ const SceneData& sceneData, _In_ eVoxelMesher mesher);
+        HRESULT AddScene(_In_ PCWSTR pszSceneName, _In_ const std::shared_ptr<Scene>& scene);
         HRESULT SetMainScene(_In_ PCWSTR pszSceneName);
 
         void HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime);
@@ -79,11 +95,43 @@ namespace library
         HRESULT SetPixelShaderOfScene(_In_ PCWSTR pszSceneName, _In_ PCWSTR pszPixelShaderName);
 
         D3D_DRIVER_TYPE GetDriverType() const;
+        const Frustum& GetFrustum() const;
+        const BoundingVolumeHierarchy& GetObjectHierarchy() const;
+        const OcclusionCuller& GetOcclusionCuller() const;
 
         std::shared_ptr<MainWindow> WindowPtr;
 
+    private:
+        static constexpr const UINT ALL_MESHES = 0xFFFFFFFFu;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   DrawRecord
+
+            Summary:  Draw of a renderable, or of one of its meshes, with
+                      the model, instanced voxel and scene it also
+                      binds buffers of when they are not null
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct DrawRecord
+        {
+            Renderable* pRenderable;
+            Model* pModel;
+            Voxel* pVoxel;
+            Scene* pScene;
+            UINT uMesh;
+        };
+
+        void bindTexture(_In_ Texture& texture);
+        void registerStreamedTextures(_In_ const Renderable& renderable);
+        void requestTextureMips(_In_ const Renderable& renderable);
+        BoundingSphere getBoundingSphere(_In_ const Renderable& renderable) const;
+        void updateObjectHierarchy();
+        FLOAT XM_CALLCONV getViewDepth(_In_ FXMVECTOR position) const;
+        void addDraws(_In_ const DrawRecord& record, _In_ FLOAT depth);
+        void submitDraw(_In_ const DrawRecord& record);
 
     private:
+        // Keeps COM, and with it the shared WIC factory, alive while textures are loaded
+        ScopedComApartment m_comApartment;
         D3D_DRIVER_TYPE m_driverType;
         D3D_FEATURE_LEVEL m_featureLevel;
         ComPtr<ID3D11Device> m_d3dDevice;
@@ -101,6 +149,33 @@ namespace library
         BYTE m_padding[8];
         Camera m_camera;
         XMMATRIX m_projection;
+        FLOAT m_viewportHeight;
+        TextureStreamer m_textureStreamer;
+        ID3D11ShaderResourceView* m_pBoundTextureRV;
+        UINT m_uBoundSamplerHandle;
+        Renderable* m_pBoundRenderable;
+        ID3D11VertexShader* m_pBoundVertexShader;
+        ID3D11PixelShader* m_pBoundPixelShader;
+        ID3D11InputLayout* m_pBoundVertexLayout;
+        Frustum m_frustum;
+        OcclusionCuller m_occlusionCuller;
+
+        // Items of the hierarchy are the renderables, then the models
+        BoundingVolumeHierarchy m_objectHierarchy;
+        std::vector<Renderable*> m_apHierarchyRenderables;
+        std::vector<Model*> m_apHierarchyModels;
+        BOOL m_bObjectHierarchyDirty;
+
+        // Reused every frame to cull without allocating
+        std::vector<BoundingBox> m_aBoundingBoxes;
+        std::vector<UINT> m_aVisibleIndices;
+        std::vector<UINT> m_aVisibleObjects;
+
+        // Draws of the frame, numbering shaders and textures for their keys
+        DrawList m_drawList;
+        std::vector<DrawRecord> m_aDrawRecords;
+        std::vector<std::pair<ID3D11VertexShader*, ID3D11PixelShader*>> m_aShaderPairs;
+        std::unordered_map<const Texture*, UINT> m_materialIds;
 
         std::unordered_map<PCWSTR, std::shared_ptr<Renderable>> m_renderables;
         std::unordered_map<PCWSTR, std::shared_ptr<Model>> m_models;
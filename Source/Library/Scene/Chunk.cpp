@@ -0,0 +1,845 @@
+#include "Scene/Chunk.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::Chunk
+
+      Summary:  Constructor of an empty chunk
+
+      Args:     INT iChunkX
+                  Chunk coordinate along x
+                INT iChunkZ
+                  Chunk coordinate along z
+                UINT uHeight
+                  Number of blocks along y
+                const XMFLOAT3& origin
+                  World position of the center of the first block
+
+      Modifies: [m_iChunkX, m_iChunkZ, m_uHeight, m_uNumBlocks,
+                 m_origin, m_aRuns, m_aColumns, m_uNumUnusedRuns].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Chunk::Chunk(_In_ INT iChunkX, _In_ INT iChunkZ, _In_ UINT uHeight, _In_ const XMFLOAT3& origin)
+        : m_iChunkX(iChunkX)
+        , m_iChunkZ(iChunkZ)
+        , m_uHeight(uHeight)
+        , m_uNumBlocks(0u)
+        , m_origin(origin)
+        , m_aRuns()
+        , m_aColumns(static_cast<size_t>(SIZE) * static_cast<size_t>(SIZE), ColumnRuns{ .uFirstRun = 0u, .uNumRuns = 0u })
+        , m_uNumUnusedRuns(0u)
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::GetBlock
+
+      Summary:  Returns the block at a position in the chunk
+
+      Args:     UINT x, y, z
+                  Position of the block in the chunk
+
+      Returns:  eBlockType
+                  Block type, AIR outside the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eBlockType Chunk::GetBlock(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        if (x >= SIZE || y >= m_uHeight || z >= SIZE)
+            return eBlockType::AIR;
+
+        const ColumnRuns& column = m_aColumns[static_cast<size_t>(z) * SIZE + static_cast<size_t>(x)];
+
+        UINT uTop = 0u;
+        for (UINT i = 0u; i < column.uNumRuns; ++i)
+        {
+            const BlockRun& run = m_aRuns[column.uFirstRun + i];
+
+            uTop += run.uLength;
+            if (y < uTop)
+                return run.blockType;
+        }
+
+        return eBlockType::AIR;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::SetBlock
+
+      Summary:  Sets the block at a position in the chunk, positions
+                outside the chunk are ignored. The column is expanded,
+                edited and encoded again
+
+      Args:     UINT x, y, z
+                  Position of the block in the chunk
+                eBlockType blockType
+                  Block type, AIR to remove the block
+
+      Modifies: [m_aRuns, m_aColumns, m_uNumUnusedRuns, m_uNumBlocks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::SetBlock(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ eBlockType blockType)
+    {
+        if (x >= SIZE || y >= m_uHeight || z >= SIZE)
+            return;
+
+        const ColumnRuns& column = m_aColumns[static_cast<size_t>(z) * SIZE + static_cast<size_t>(x)];
+
+        std::vector<eBlockType> aBlocks;
+        for (UINT i = 0u; i < column.uNumRuns; ++i)
+            aBlocks.insert(aBlocks.end(), m_aRuns[column.uFirstRun + i].uLength, m_aRuns[column.uFirstRun + i].blockType);
+
+        if (aBlocks.size() <= y)
+            aBlocks.resize(static_cast<size_t>(y) + 1u, eBlockType::AIR);
+
+        eBlockType& block = aBlocks[y];
+        if (block != eBlockType::AIR)
+            --m_uNumBlocks;
+        if (blockType != eBlockType::AIR)
+            ++m_uNumBlocks;
+
+        block = blockType;
+
+        std::vector<BlockRun> aRuns;
+        for (eBlockType columnBlock : aBlocks)
+        {
+            if (!aRuns.empty() && aRuns.back().blockType == columnBlock)
+                ++aRuns.back().uLength;
+            else
+                aRuns.push_back(BlockRun{ .blockType = columnBlock, .uLength = 1u });
+        }
+
+        // The air above the top block is not stored
+        if (!aRuns.empty() && aRuns.back().blockType == eBlockType::AIR)
+            aRuns.pop_back();
+
+        setColumnRuns(x, z, aRuns.data(), static_cast<UINT>(aRuns.size()));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::SetColumn
+
+      Summary:  Fills a column with blocks from the bottom up and clears
+                the rest of it
+
+      Args:     UINT x, z
+                  Position of the column in the chunk
+                eBlockType blockType
+                  Block type of the column
+                UINT uNumBlocks
+                  Number of blocks, clamped to the chunk height
+
+      Modifies: [m_aRuns, m_aColumns, m_uNumUnusedRuns, m_uNumBlocks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::SetColumn(_In_ UINT x, _In_ UINT z, _In_ eBlockType blockType, _In_ UINT uNumBlocks)
+    {
+        if (x >= SIZE || z >= SIZE)
+            return;
+
+        const ColumnRuns& column = m_aColumns[static_cast<size_t>(z) * SIZE + static_cast<size_t>(x)];
+        for (UINT i = 0u; i < column.uNumRuns; ++i)
+        {
+            if (m_aRuns[column.uFirstRun + i].blockType != eBlockType::AIR)
+                m_uNumBlocks -= m_aRuns[column.uFirstRun + i].uLength;
+        }
+
+        if (blockType == eBlockType::AIR)
+            uNumBlocks = 0u;
+        uNumBlocks = std::min<UINT>(uNumBlocks, m_uHeight);
+        m_uNumBlocks += uNumBlocks;
+
+        BlockRun run = { .blockType = blockType, .uLength = static_cast<WORD>(uNumBlocks) };
+        setColumnRuns(x, z, &run, uNumBlocks > 0u ? 1u : 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::GetChunkX
+
+      Summary:  Returns the chunk coordinate along x
+
+      Returns:  INT
+                  Chunk coordinate
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    INT Chunk::GetChunkX() const
+    {
+        return m_iChunkX;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::GetChunkZ
+
+      Summary:  Returns the chunk coordinate along z
+
+      Returns:  INT
+                  Chunk coordinate
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    INT Chunk::GetChunkZ() const
+    {
+        return m_iChunkZ;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::GetHeight
+
+      Summary:  Returns the number of blocks along y
+
+      Returns:  UINT
+                  Height of the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Chunk::GetHeight() const
+    {
+        return m_uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::GetNumBlocks
+
+      Summary:  Returns the number of solid blocks
+
+      Returns:  UINT
+                  Number of blocks that are not AIR
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Chunk::GetNumBlocks() const
+    {
+        return m_uNumBlocks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::GetNumRuns
+
+      Summary:  Returns the number of runs of every column
+
+      Returns:  size_t
+                  Number of runs, air between blocks included
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Chunk::GetNumRuns() const
+    {
+        return m_aRuns.size() - m_uNumUnusedRuns;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::GetMemoryUsage
+
+      Summary:  Returns the size of the runs and of the columns
+
+      Returns:  size_t
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Chunk::GetMemoryUsage() const
+    {
+        return m_aRuns.capacity() * sizeof(BlockRun) + m_aColumns.size() * sizeof(ColumnRuns);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::GetBlockPosition
+
+      Summary:  Returns the world position of the center of a block
+
+      Args:     UINT x, y, z
+                  Position of the block in the chunk
+
+      Returns:  XMFLOAT3
+                  World position
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMFLOAT3 Chunk::GetBlockPosition(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        return XMFLOAT3(
+            m_origin.x + BLOCK_SIZE * static_cast<FLOAT>(x),
+            m_origin.y + BLOCK_SIZE * static_cast<FLOAT>(y),
+            m_origin.z + BLOCK_SIZE * static_cast<FLOAT>(z)
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::GetBoundingBox
+
+      Summary:  Returns the world bounding box of the solid blocks
+
+      Returns:  BoundingBox
+                  Axis-aligned bounding box, empty at the chunk origin
+                  if the chunk has no block
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingBox Chunk::GetBoundingBox() const
+    {
+        if (m_uNumBlocks == 0u)
+            return BoundingBox(m_origin, XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+        UINT aMin[3] = { SIZE, m_uHeight, SIZE };
+        UINT aMax[3] = { 0u, 0u, 0u };
+
+        for (UINT z = 0u; z < SIZE; ++z)
+        {
+            for (UINT x = 0u; x < SIZE; ++x)
+            {
+                const ColumnRuns& column = m_aColumns[static_cast<size_t>(z) * SIZE + static_cast<size_t>(x)];
+
+                UINT uBottom = 0u;
+                for (UINT i = 0u; i < column.uNumRuns; ++i)
+                {
+                    const BlockRun& run = m_aRuns[column.uFirstRun + i];
+                    if (run.blockType != eBlockType::AIR)
+                    {
+                        aMin[0] = std::min<UINT>(aMin[0], x);
+                        aMin[1] = std::min<UINT>(aMin[1], uBottom);
+                        aMin[2] = std::min<UINT>(aMin[2], z);
+                        aMax[0] = std::max<UINT>(aMax[0], x);
+                        aMax[1] = std::max<UINT>(aMax[1], uBottom + run.uLength - 1u);
+                        aMax[2] = std::max<UINT>(aMax[2], z);
+                    }
+
+                    uBottom += run.uLength;
+                }
+            }
+        }
+
+        // Block centers are BLOCK_SIZE apart and blocks reach half of it past their centers
+        XMFLOAT3 minCenter = GetBlockPosition(aMin[0], aMin[1], aMin[2]);
+        XMFLOAT3 maxCenter = GetBlockPosition(aMax[0], aMax[1], aMax[2]);
+        XMVECTOR halfBlock = XMVectorReplicate(BLOCK_SIZE * 0.5f);
+
+        BoundingBox boundingBox;
+        BoundingBox::CreateFromPoints(
+            boundingBox,
+            XMVectorSubtract(XMLoadFloat3(&minCenter), halfBlock),
+            XMVectorAdd(XMLoadFloat3(&maxCenter), halfBlock)
+        );
+
+        return boundingBox;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::BuildOccluders
+
+      Summary:  Builds world boxes that are solid all the way through,
+                to hide what is behind them. The chunk is divided into
+                squares of OCCLUDER_SIZE columns, and each square gives
+                a box up to the lowest of the solid runs its columns
+                start with, so hills give boxes of several heights
+
+      Args:     std::vector<BoundingBox>& aOutOccluders
+                  Boxes of solid blocks, none for a square with a
+                  column that does not start with a solid block
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::BuildOccluders(_Out_ std::vector<BoundingBox>& aOutOccluders) const
+    {
+        aOutOccluders.clear();
+
+        for (UINT uSquareZ = 0u; uSquareZ < SIZE; uSquareZ += OCCLUDER_SIZE)
+        {
+            for (UINT uSquareX = 0u; uSquareX < SIZE; uSquareX += OCCLUDER_SIZE)
+            {
+                UINT uSolidHeight = m_uHeight;
+                for (UINT z = uSquareZ; z < uSquareZ + OCCLUDER_SIZE && uSolidHeight > 0u; ++z)
+                {
+                    for (UINT x = uSquareX; x < uSquareX + OCCLUDER_SIZE && uSolidHeight > 0u; ++x)
+                    {
+                        const ColumnRuns& column = m_aColumns[static_cast<size_t>(z) * SIZE + static_cast<size_t>(x)];
+
+                        UINT uColumnHeight = 0u;
+                        if (column.uNumRuns > 0u && m_aRuns[column.uFirstRun].blockType != eBlockType::AIR)
+                            uColumnHeight = m_aRuns[column.uFirstRun].uLength;
+
+                        uSolidHeight = std::min<UINT>(uSolidHeight, uColumnHeight);
+                    }
+                }
+
+                if (uSolidHeight == 0u)
+                    continue;
+
+                XMFLOAT3 minCenter = GetBlockPosition(uSquareX, 0u, uSquareZ);
+                XMFLOAT3 maxCenter = GetBlockPosition(uSquareX + OCCLUDER_SIZE - 1u, uSolidHeight - 1u, uSquareZ + OCCLUDER_SIZE - 1u);
+                XMVECTOR halfBlock = XMVectorReplicate(BLOCK_SIZE * 0.5f);
+
+                BoundingBox occluder;
+                BoundingBox::CreateFromPoints(
+                    occluder,
+                    XMVectorSubtract(XMLoadFloat3(&minCenter), halfBlock),
+                    XMVectorAdd(XMLoadFloat3(&maxCenter), halfBlock)
+                );
+
+                aOutOccluders.push_back(occluder);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::BuildInstanceData
+
+      Summary:  Builds the instance data of the blocks of every block
+                type. Instances hold the block coordinates in the chunk
+                and the block type indexed from GRASSLAND, the vertex
+                shader expands them with the chunk origin of the world
+                matrix. Blocks enclosed by solid blocks on every side
+                can never be seen and are skipped
+
+      Args:     const Chunk* const* apNeighbors
+                  NUM_NEIGHBORS adjacent chunks, nullptr where there
+                  is none
+                std::vector<InstanceData>& aOutInstanceData
+                  Vector receiving the instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::BuildInstanceData(
+        _In_reads_(NUM_NEIGHBORS) const Chunk* const* apNeighbors,
+        _Out_ std::vector<InstanceData>& aOutInstanceData
+    ) const
+    {
+        aOutInstanceData.clear();
+
+        for (UINT z = 0u; z < SIZE; ++z)
+        {
+            for (UINT x = 0u; x < SIZE; ++x)
+            {
+                const ColumnRuns& column = m_aColumns[static_cast<size_t>(z) * SIZE + static_cast<size_t>(x)];
+
+                UINT y = 0u;
+                for (UINT i = 0u; i < column.uNumRuns; ++i)
+                {
+                    const BlockRun& run = m_aRuns[column.uFirstRun + i];
+
+                    size_t uTypeIdx = static_cast<size_t>(run.blockType) - static_cast<size_t>(eBlockType::GRASSLAND);
+                    if (run.blockType == eBlockType::AIR || uTypeIdx >= NUM_BLOCK_TYPES)
+                    {
+                        y += run.uLength;
+                        continue;
+                    }
+
+                    for (UINT uTop = y + run.uLength; y < uTop; ++y)
+                    {
+                        if (isHidden(x, y, z, apNeighbors))
+                            continue;
+
+                        aOutInstanceData.push_back(
+                            InstanceData
+                            {
+                                .X = static_cast<WORD>(x),
+                                .Y = static_cast<WORD>(y),
+                                .Z = static_cast<WORD>(z),
+                                .BlockType = static_cast<WORD>(uTypeIdx)
+                            }
+                        );
+                    }
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::BuildGreedyMesh
+
+      Summary:  Builds the visible faces of the blocks of every block
+                type, indexed from GRASSLAND, as quads of four vertices
+                in world space. Each slice of the chunk along each face
+                direction is reduced to a mask of the faces without a
+                solid block in front of them, and runs of faces of the
+                same block type are grown into the widest rectangles
+                along the first axis of the slice, then along the
+                second one
+
+      Args:     const Chunk* const* apNeighbors
+                  NUM_NEIGHBORS adjacent chunks, nullptr where there
+                  is none
+                std::vector<SimpleVertex>* aOutVertices
+                  NUM_BLOCK_TYPES vectors receiving the quads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::BuildGreedyMesh(
+        _In_reads_(NUM_NEIGHBORS) const Chunk* const* apNeighbors,
+        _Out_writes_(NUM_BLOCK_TYPES) std::vector<SimpleVertex>* aOutVertices
+    ) const
+    {
+        for (UINT i = 0u; i < NUM_BLOCK_TYPES; ++i)
+            aOutVertices[i].clear();
+
+        if (m_uNumBlocks == 0u)
+            return;
+
+        // Slices cut across the columns, so the chunk is expanded once for the mesher
+        std::vector<eBlockType> aBlocks;
+        decode(aBlocks);
+
+        const UINT aDims[3] = { SIZE, m_uHeight, SIZE };
+        std::vector<eBlockType> aMask(static_cast<size_t>(SIZE) * static_cast<size_t>(std::max<UINT>(SIZE, m_uHeight)));
+
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            // The slice axes follow the face axis cyclically, so that u x v points along the face axis
+            const UINT uAxisU = (uAxis + 1u) % 3u;
+            const UINT uAxisV = (uAxis + 2u) % 3u;
+            const UINT uDimU = aDims[uAxisU];
+            const UINT uDimV = aDims[uAxisV];
+
+            for (INT iSign = -1; iSign <= 1; iSign += 2)
+            {
+                for (UINT uSlice = 0u; uSlice < aDims[uAxis]; ++uSlice)
+                {
+                    // Mask of the faces of the slice that can be seen
+                    for (UINT v = 0u; v < uDimV; ++v)
+                    {
+                        for (UINT u = 0u; u < uDimU; ++u)
+                        {
+                            UINT aPos[3];
+                            aPos[uAxis] = uSlice;
+                            aPos[uAxisU] = u;
+                            aPos[uAxisV] = v;
+
+                            eBlockType blockType = aBlocks[getIndex(aPos[0], aPos[1], aPos[2])];
+                            size_t uTypeIdx = static_cast<size_t>(blockType) - static_cast<size_t>(eBlockType::GRASSLAND);
+                            if (blockType != eBlockType::AIR && uTypeIdx < NUM_BLOCK_TYPES)
+                            {
+                                INT aFront[3] = { static_cast<INT>(aPos[0]), static_cast<INT>(aPos[1]), static_cast<INT>(aPos[2]) };
+                                aFront[uAxis] += iSign;
+                                if (isSolid(aFront[0], aFront[1], aFront[2], apNeighbors))
+                                    blockType = eBlockType::AIR;
+                            }
+                            else
+                                blockType = eBlockType::AIR;
+
+                            aMask[static_cast<size_t>(v) * uDimU + u] = blockType;
+                        }
+                    }
+
+                    // Merge the faces into rectangles
+                    for (UINT v = 0u; v < uDimV; ++v)
+                    {
+                        for (UINT u = 0u; u < uDimU; )
+                        {
+                            eBlockType blockType = aMask[static_cast<size_t>(v) * uDimU + u];
+                            if (blockType == eBlockType::AIR)
+                            {
+                                ++u;
+                                continue;
+                            }
+
+                            UINT uWidth = 1u;
+                            while (u + uWidth < uDimU && aMask[static_cast<size_t>(v) * uDimU + u + uWidth] == blockType)
+                                ++uWidth;
+
+                            UINT uHeight = 1u;
+                            for (BOOL bGrow = TRUE; bGrow && v + uHeight < uDimV; )
+                            {
+                                for (UINT k = 0u; k < uWidth; ++k)
+                                {
+                                    if (aMask[static_cast<size_t>(v + uHeight) * uDimU + u + k] != blockType)
+                                    {
+                                        bGrow = FALSE;
+                                        break;
+                                    }
+                                }
+
+                                if (bGrow)
+                                    ++uHeight;
+                            }
+
+                            for (UINT l = 0u; l < uHeight; ++l)
+                                std::fill_n(aMask.begin() + static_cast<size_t>(v + l) * uDimU + u, uWidth, eBlockType::AIR);
+
+                            // Blocks reach half a block past their centers
+                            FLOAT aCorner[3];
+                            aCorner[uAxis] = static_cast<FLOAT>(uSlice) + 0.5f * static_cast<FLOAT>(iSign);
+                            aCorner[uAxisU] = static_cast<FLOAT>(u) - 0.5f;
+                            aCorner[uAxisV] = static_cast<FLOAT>(v) - 0.5f;
+
+                            size_t uTypeIdx = static_cast<size_t>(blockType) - static_cast<size_t>(eBlockType::GRASSLAND);
+                            appendQuad(aCorner, uAxis, iSign, uWidth, uHeight, aOutVertices[uTypeIdx]);
+
+                            u += uWidth;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::BuildQuadIndices
+
+      Summary:  Builds two triangles for each quad of BuildGreedyMesh,
+                wound like the vertices of the quad
+
+      Args:     UINT uNumVertices
+                  Number of vertices of the quads, a multiple of four
+                  and at most MAX_MESH_VERTICES
+                std::vector<WORD>& aOutIndices
+                  Indices of the triangles
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::BuildQuadIndices(_In_ UINT uNumVertices, _Out_ std::vector<WORD>& aOutIndices)
+    {
+        assert(uNumVertices <= MAX_MESH_VERTICES && uNumVertices % 4u == 0u);
+
+        aOutIndices.clear();
+        aOutIndices.reserve(uNumVertices / 4u * 6u);
+        for (UINT i = 0u; i < uNumVertices; i += 4u)
+        {
+            WORD uBase = static_cast<WORD>(i);
+            aOutIndices.push_back(uBase);
+            aOutIndices.push_back(static_cast<WORD>(uBase + 1u));
+            aOutIndices.push_back(static_cast<WORD>(uBase + 2u));
+            aOutIndices.push_back(uBase);
+            aOutIndices.push_back(static_cast<WORD>(uBase + 2u));
+            aOutIndices.push_back(static_cast<WORD>(uBase + 3u));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::getIndex
+
+      Summary:  Returns the index of a block in the expanded chunk, rows
+                along x are contiguous and layers along y are the
+                outermost
+
+      Args:     UINT x, y, z
+                  Position of the block in the chunk
+
+      Returns:  size_t
+                  Index into the blocks given by decode
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Chunk::getIndex(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        return (static_cast<size_t>(y) * SIZE + static_cast<size_t>(z)) * SIZE + static_cast<size_t>(x);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::decode
+
+      Summary:  Expands the runs into one block type per block
+
+      Args:     std::vector<eBlockType>& aOutBlocks
+                  Blocks of the chunk in the order of getIndex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::decode(_Out_ std::vector<eBlockType>& aOutBlocks) const
+    {
+        aOutBlocks.assign(static_cast<size_t>(SIZE) * static_cast<size_t>(SIZE) * static_cast<size_t>(m_uHeight), eBlockType::AIR);
+
+        for (UINT z = 0u; z < SIZE; ++z)
+        {
+            for (UINT x = 0u; x < SIZE; ++x)
+            {
+                const ColumnRuns& column = m_aColumns[static_cast<size_t>(z) * SIZE + static_cast<size_t>(x)];
+
+                UINT y = 0u;
+                for (UINT i = 0u; i < column.uNumRuns; ++i)
+                {
+                    const BlockRun& run = m_aRuns[column.uFirstRun + i];
+                    for (UINT uTop = y + run.uLength; y < uTop; ++y)
+                        aOutBlocks[getIndex(x, y, z)] = run.blockType;
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::setColumnRuns
+
+      Summary:  Replaces the runs of a column. Runs that fit are written
+                in place, otherwise they are appended and the old ones
+                are left unused until the chunk is compacted, so
+                filling the columns one after another never moves the
+                runs of the other columns
+
+      Args:     UINT x, z
+                  Position of the column in the chunk
+                const BlockRun* aRuns
+                  Runs from the bottom up, without air on top
+                UINT uNumRuns
+                  Number of runs
+
+      Modifies: [m_aRuns, m_aColumns, m_uNumUnusedRuns].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::setColumnRuns(_In_ UINT x, _In_ UINT z, _In_reads_(uNumRuns) const BlockRun* aRuns, _In_ UINT uNumRuns)
+    {
+        ColumnRuns& column = m_aColumns[static_cast<size_t>(z) * SIZE + static_cast<size_t>(x)];
+
+        if (uNumRuns <= column.uNumRuns)
+        {
+            std::copy(aRuns, aRuns + uNumRuns, m_aRuns.begin() + column.uFirstRun);
+            m_uNumUnusedRuns += column.uNumRuns - uNumRuns;
+            column.uNumRuns = uNumRuns;
+            return;
+        }
+
+        m_uNumUnusedRuns += column.uNumRuns;
+        column.uFirstRun = static_cast<UINT>(m_aRuns.size());
+        column.uNumRuns = uNumRuns;
+        m_aRuns.insert(m_aRuns.end(), aRuns, aRuns + uNumRuns);
+
+        if (m_uNumUnusedRuns > m_aRuns.size() / 2u)
+            compact();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::compact
+
+      Summary:  Drops the unused runs, keeping the runs of the columns
+                in column order
+
+      Modifies: [m_aRuns, m_aColumns, m_uNumUnusedRuns].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::compact()
+    {
+        std::vector<BlockRun> aRuns;
+        aRuns.reserve(GetNumRuns());
+
+        for (ColumnRuns& column : m_aColumns)
+        {
+            UINT uFirstRun = static_cast<UINT>(aRuns.size());
+            aRuns.insert(aRuns.end(), m_aRuns.begin() + column.uFirstRun, m_aRuns.begin() + column.uFirstRun + column.uNumRuns);
+            column.uFirstRun = uFirstRun;
+        }
+
+        m_aRuns = std::move(aRuns);
+        m_uNumUnusedRuns = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::isSolid
+
+      Summary:  Returns whether a position holds a block, looking into
+                the adjacent chunks past the sides of the chunk
+
+      Args:     INT x, y, z
+                  Position in the chunk, at most one block outside it
+                const Chunk* const* apNeighbors
+                  NUM_NEIGHBORS adjacent chunks, nullptr where there
+                  is none
+
+      Returns:  BOOL
+                  True if there is a block. Below the chunk counts as
+                  solid, since the bottom of the world is never seen
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Chunk::isSolid(_In_ INT x, _In_ INT y, _In_ INT z, _In_reads_(NUM_NEIGHBORS) const Chunk* const* apNeighbors) const
+    {
+        constexpr const INT SIZE_INT = static_cast<INT>(SIZE);
+
+        if (y < 0)
+            return TRUE;
+        if (y >= static_cast<INT>(m_uHeight))
+            return FALSE;
+
+        const Chunk* pChunk = this;
+        if (x < 0)
+        {
+            pChunk = apNeighbors[NEIGHBOR_NEGATIVE_X];
+            x += SIZE_INT;
+        }
+        else if (x >= SIZE_INT)
+        {
+            pChunk = apNeighbors[NEIGHBOR_POSITIVE_X];
+            x -= SIZE_INT;
+        }
+        else if (z < 0)
+        {
+            pChunk = apNeighbors[NEIGHBOR_NEGATIVE_Z];
+            z += SIZE_INT;
+        }
+        else if (z >= SIZE_INT)
+        {
+            pChunk = apNeighbors[NEIGHBOR_POSITIVE_Z];
+            z -= SIZE_INT;
+        }
+
+        if (!pChunk)
+            return FALSE;
+
+        return pChunk->GetBlock(static_cast<UINT>(x), static_cast<UINT>(y), static_cast<UINT>(z)) != eBlockType::AIR;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::isHidden
+
+      Summary:  Returns whether all six neighbors of a block are solid
+
+      Args:     UINT x, y, z
+                  Position of the block in the chunk
+                const Chunk* const* apNeighbors
+                  NUM_NEIGHBORS adjacent chunks, nullptr where there
+                  is none
+
+      Returns:  BOOL
+                  True if no face of the block can be seen
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Chunk::isHidden(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_reads_(NUM_NEIGHBORS) const Chunk* const* apNeighbors) const
+    {
+        INT iX = static_cast<INT>(x);
+        INT iY = static_cast<INT>(y);
+        INT iZ = static_cast<INT>(z);
+
+        return isSolid(iX, iY + 1, iZ, apNeighbors)
+            && isSolid(iX - 1, iY, iZ, apNeighbors)
+            && isSolid(iX + 1, iY, iZ, apNeighbors)
+            && isSolid(iX, iY, iZ - 1, apNeighbors)
+            && isSolid(iX, iY, iZ + 1, apNeighbors)
+            && isSolid(iX, iY - 1, iZ, apNeighbors);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Chunk::appendQuad
+
+      Summary:  Appends the four vertices of a face rectangle, wound so
+                that its front faces the face direction like the faces
+                of Voxel
+
+      Args:     const FLOAT* aCorner
+                  Corner of the rectangle in block units from the
+                  center of the first block
+                UINT uAxis
+                  Axis the face is perpendicular to, 0 for x, 1 for y,
+                  2 for z
+                INT iSign
+                  Direction of the face along the axis, -1 or 1
+                UINT uWidth, uHeight
+                  Number of faces along the first and second axes of
+                  the slice
+                std::vector<SimpleVertex>& aVertices
+                  Vertices receiving the quad
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Chunk::appendQuad(
+        _In_reads_(3) const FLOAT* aCorner,
+        _In_ UINT uAxis,
+        _In_ INT iSign,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _Inout_ std::vector<SimpleVertex>& aVertices
+    ) const
+    {
+        FLOAT aU[3] = { 0.0f, 0.0f, 0.0f };
+        FLOAT aV[3] = { 0.0f, 0.0f, 0.0f };
+        aU[(uAxis + 1u) % 3u] = static_cast<FLOAT>(uWidth);
+        aV[(uAxis + 2u) % 3u] = static_cast<FLOAT>(uHeight);
+
+        FLOAT aNormal[3] = { 0.0f, 0.0f, 0.0f };
+        aNormal[uAxis] = static_cast<FLOAT>(iSign);
+
+        XMFLOAT2 size(static_cast<FLOAT>(uWidth), static_cast<FLOAT>(uHeight));
+
+        // u x v points along the positive axis, so the edges are swapped for negative faces
+        if (iSign < 0)
+        {
+            std::swap(aU, aV);
+            std::swap(size.x, size.y);
+        }
+
+        const FLOAT aaOffsets[4][2] =
+        {
+            { 0.0f, 0.0f },
+            { 1.0f, 0.0f },
+            { 1.0f, 1.0f },
+            { 0.0f, 1.0f }
+        };
+
+        for (UINT i = 0u; i < 4u; ++i)
+        {
+            FLOAT aPos[3];
+            for (UINT j = 0u; j < 3u; ++j)
+                aPos[j] = aCorner[j] + aaOffsets[i][0] * aU[j] + aaOffsets[i][1] * aV[j];
+
+            aVertices.push_back(
+                SimpleVertex
+                {
+                    .Position = XMFLOAT3(
+                        m_origin.x + BLOCK_SIZE * aPos[0],
+                        m_origin.y + BLOCK_SIZE * aPos[1],
+                        m_origin.z + BLOCK_SIZE * aPos[2]
+                    ),
+                    .TexCoord = XMFLOAT2(aaOffsets[i][0] * size.x, aaOffsets[i][1] * size.y),
+                    .Normal = XMFLOAT3(aNormal[0], aNormal[1], aNormal[2])
+                }
+            );
+        }
+    }
+}
@@ -0,0 +1,168 @@
+/*+===================================================================
+  File:      CHUNK.H
+
+  Summary:   Chunk header file contains declaration of class Chunk
+             used to store the blocks of a part of a voxel world.
+
+  Classes:  Chunk
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   BlockRun
+
+        Summary:  Run of blocks of one block type stacked in a column
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct BlockRun
+    {
+        eBlockType blockType;
+        WORD uLength;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Chunk
+
+      Summary:  SIZE x height x SIZE blocks of a voxel world, stored on
+                the CPU only. Each column is stored as runs of blocks
+                of one type from the bottom up, without the air above
+                its top block, so a terrain chunk takes memory in
+                proportion to its surface rather than its volume. A
+                chunk knows its position in the world, so it can build
+                the instance data of its blocks and the bounding box of
+                its blocks on its own
+
+      Methods:  GetBlock
+                  Returns the block at a position in the chunk
+                SetBlock
+                  Sets the block at a position in the chunk
+                SetColumn
+                  Fills a column from the bottom up
+                GetChunkX
+                  Returns the chunk coordinate along x
+                GetChunkZ
+                  Returns the chunk coordinate along z
+                GetHeight
+                  Returns the number of blocks along y
+                GetNumBlocks
+                  Returns the number of solid blocks
+                GetNumRuns
+                  Returns the number of runs of every column
+                GetMemoryUsage
+                  Returns the size of the runs in bytes
+                GetBlockPosition
+                  Returns the world position of a block center
+                GetBoundingBox
+                  Returns the world bounding box of the solid blocks
+                BuildOccluders
+                  Builds boxes that are solid all the way through
+                BuildInstanceData
+                  Builds the instance data of every visible block
+                BuildGreedyMesh
+                  Builds the merged quads of the visible faces of every
+                  block type
+                BuildQuadIndices
+                  Builds the indices of the triangles of quads
+                Chunk
+                  Constructor.
+                ~Chunk
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class Chunk final
+    {
+    public:
+        static constexpr const UINT SIZE = 32u;
+        static constexpr const FLOAT BLOCK_SIZE = 2.0f;
+        static constexpr const UINT OCCLUDER_SIZE = 8u;
+        static_assert(SIZE % OCCLUDER_SIZE == 0u, "Occluders have to tile the chunk");
+        static constexpr const UINT NUM_BLOCK_TYPES = static_cast<UINT>(eBlockType::COUNT) - static_cast<UINT>(eBlockType::GRASSLAND);
+        static_assert(NUM_BLOCK_TYPES <= NUM_BLOCK_COLORS, "Every block type needs a color in CBBlockColors");
+
+        // Order of the neighbors given to BuildInstanceData
+        static constexpr const UINT NEIGHBOR_NEGATIVE_X = 0u;
+        static constexpr const UINT NEIGHBOR_POSITIVE_X = 1u;
+        static constexpr const UINT NEIGHBOR_NEGATIVE_Z = 2u;
+        static constexpr const UINT NEIGHBOR_POSITIVE_Z = 3u;
+        static constexpr const UINT NUM_NEIGHBORS = 4u;
+
+        // Quads are indexed with WORD indices, so a mesh holds at most this many vertices
+        static constexpr const UINT MAX_MESH_VERTICES = 0x10000u;
+
+        Chunk() = delete;
+        Chunk(_In_ INT iChunkX, _In_ INT iChunkZ, _In_ UINT uHeight, _In_ const XMFLOAT3& origin);
+        Chunk(const Chunk& other) = delete;
+        Chunk(Chunk&& other) = delete;
+        Chunk& operator=(const Chunk& other) = delete;
+        Chunk& operator=(Chunk&& other) = delete;
+        ~Chunk() = default;
+
+        eBlockType GetBlock(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        void SetBlock(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ eBlockType blockType);
+        void SetColumn(_In_ UINT x, _In_ UINT z, _In_ eBlockType blockType, _In_ UINT uNumBlocks);
+
+        INT GetChunkX() const;
+        INT GetChunkZ() const;
+        UINT GetHeight() const;
+        UINT GetNumBlocks() const;
+        size_t GetNumRuns() const;
+        size_t GetMemoryUsage() const;
+
+        XMFLOAT3 GetBlockPosition(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        BoundingBox GetBoundingBox() const;
+        void BuildOccluders(_Out_ std::vector<BoundingBox>& aOutOccluders) const;
+        void BuildInstanceData(
+            _In_reads_(NUM_NEIGHBORS) const Chunk* const* apNeighbors,
+            _Out_ std::vector<InstanceData>& aOutInstanceData
+        ) const;
+        void BuildGreedyMesh(
+            _In_reads_(NUM_NEIGHBORS) const Chunk* const* apNeighbors,
+            _Out_writes_(NUM_BLOCK_TYPES) std::vector<SimpleVertex>* aOutVertices
+        ) const;
+        static void BuildQuadIndices(_In_ UINT uNumVertices, _Out_ std::vector<WORD>& aOutIndices);
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   ColumnRuns
+
+            Summary:  Runs of a column, stored next to each other in the
+                      runs of the chunk
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ColumnRuns
+        {
+            UINT uFirstRun;
+            UINT uNumRuns;
+        };
+
+        size_t getIndex(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        void decode(_Out_ std::vector<eBlockType>& aOutBlocks) const;
+        void setColumnRuns(_In_ UINT x, _In_ UINT z, _In_reads_(uNumRuns) const BlockRun* aRuns, _In_ UINT uNumRuns);
+        void compact();
+        BOOL isSolid(_In_ INT x, _In_ INT y, _In_ INT z, _In_reads_(NUM_NEIGHBORS) const Chunk* const* apNeighbors) const;
+        BOOL isHidden(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_reads_(NUM_NEIGHBORS) const Chunk* const* apNeighbors) const;
+        void appendQuad(
+            _In_reads_(3) const FLOAT* aCorner,
+            _In_ UINT uAxis,
+            _In_ INT iSign,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _Inout_ std::vector<SimpleVertex>& aVertices
+        ) const;
+
+    private:
+        INT m_iChunkX;
+        INT m_iChunkZ;
+        UINT m_uHeight;
+        UINT m_uNumBlocks;
+        XMFLOAT3 m_origin;
+        std::vector<BlockRun> m_aRuns;
+        std::vector<ColumnRuns> m_aColumns;
+        size_t m_uNumUnusedRuns;
+    };
+}
@@ -0,0 +1,704 @@
+#include "Scene/ChunkStore.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::ChunkStore
+
+      Summary:  Constructor
+
+      Modifies: [m_origin, m_uChunkHeight, m_chunks, m_minChunk,
+                 m_maxChunk].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ChunkStore::ChunkStore()
+        : m_origin(0.0f, 0.0f, 0.0f)
+        , m_uChunkHeight(0u)
+        , m_chunks()
+        , m_minChunk((std::numeric_limits<INT>::max)(), (std::numeric_limits<INT>::max)())
+        , m_maxChunk((std::numeric_limits<INT>::min)(), (std::numeric_limits<INT>::min)())
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::Load
+
+      Summary:  Replaces the chunks with the columns of a scene. Chunks
+                are as tall as the scene or its tallest column
+
+      Args:     const SceneData& sceneData
+                  Columns of the scene
+                const XMFLOAT3& origin
+                  World position of the center of block (0, 0, 0)
+
+      Modifies: [m_origin, m_uChunkHeight, m_chunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::Load(_In_ const SceneData& sceneData, _In_ const XMFLOAT3& origin)
+    {
+        UINT uChunkHeight = sceneData.uHeight;
+        if (!sceneData.aColumnHeights.empty())
+            uChunkHeight = std::max<UINT>(uChunkHeight, *std::max_element(sceneData.aColumnHeights.begin(), sceneData.aColumnHeights.end()));
+
+        Reset(origin, uChunkHeight);
+
+        for (UINT z = 0u; z < sceneData.uDepth; ++z)
+        {
+            for (UINT x = 0u; x < sceneData.uWidth; ++x)
+            {
+                size_t uColumnIdx = static_cast<size_t>(z) * static_cast<size_t>(sceneData.uWidth) + static_cast<size_t>(x);
+                if (sceneData.aColumnHeights[uColumnIdx] == 0u)
+                    continue;
+
+                Chunk* pChunk = GetOrCreateChunk(static_cast<INT>(x / Chunk::SIZE), static_cast<INT>(z / Chunk::SIZE));
+                pChunk->SetColumn(x % Chunk::SIZE, z % Chunk::SIZE, sceneData.aBlockTypes[uColumnIdx], sceneData.aColumnHeights[uColumnIdx]);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::Reset
+
+      Summary:  Removes every chunk and sets the origin and the height
+                of the chunks created from now on
+
+      Args:     const XMFLOAT3& origin
+                  World position of the center of block (0, 0, 0)
+                UINT uChunkHeight
+                  Number of blocks along y in a chunk
+
+      Modifies: [m_origin, m_uChunkHeight, m_chunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::Reset(_In_ const XMFLOAT3& origin, _In_ UINT uChunkHeight)
+    {
+        Clear();
+
+        m_origin = origin;
+        m_uChunkHeight = uChunkHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::Clear
+
+      Summary:  Removes every chunk
+
+      Modifies: [m_chunks, m_minChunk, m_maxChunk].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::Clear()
+    {
+        m_chunks.clear();
+        updateExtents();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::GetChunk
+
+      Summary:  Returns the chunk at chunk coordinates
+
+      Args:     INT iChunkX, iChunkZ
+                  Chunk coordinates
+
+      Returns:  Chunk*
+                  Chunk, nullptr if there is none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Chunk* ChunkStore::GetChunk(_In_ INT iChunkX, _In_ INT iChunkZ) const
+    {
+        auto it = m_chunks.find(GetKey(iChunkX, iChunkZ));
+        if (it == m_chunks.end())
+            return nullptr;
+
+        return it->second.get();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::GetOrCreateChunk
+
+      Summary:  Returns the chunk at chunk coordinates, creating an
+                empty one if there is none
+
+      Args:     INT iChunkX, iChunkZ
+                  Chunk coordinates
+
+      Modifies: [m_chunks, m_minChunk, m_maxChunk].
+
+      Returns:  Chunk*
+                  Chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Chunk* ChunkStore::GetOrCreateChunk(_In_ INT iChunkX, _In_ INT iChunkZ)
+    {
+        std::unique_ptr<Chunk>& pChunk = m_chunks[GetKey(iChunkX, iChunkZ)];
+        if (!pChunk)
+        {
+            XMFLOAT3 chunkOrigin(
+                m_origin.x + Chunk::BLOCK_SIZE * static_cast<FLOAT>(iChunkX * static_cast<INT>(Chunk::SIZE)),
+                m_origin.y,
+                m_origin.z + Chunk::BLOCK_SIZE * static_cast<FLOAT>(iChunkZ * static_cast<INT>(Chunk::SIZE))
+            );
+            pChunk = std::make_unique<Chunk>(iChunkX, iChunkZ, m_uChunkHeight, chunkOrigin);
+
+            m_minChunk = XMINT2(std::min<INT>(m_minChunk.x, iChunkX), std::min<INT>(m_minChunk.y, iChunkZ));
+            m_maxChunk = XMINT2(std::max<INT>(m_maxChunk.x, iChunkX), std::max<INT>(m_maxChunk.y, iChunkZ));
+        }
+
+        return pChunk.get();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::RemoveChunk
+
+      Summary:  Removes the chunk at chunk coordinates, if any
+
+      Args:     INT iChunkX, iChunkZ
+                  Chunk coordinates
+
+      Modifies: [m_chunks, m_minChunk, m_maxChunk].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::RemoveChunk(_In_ INT iChunkX, _In_ INT iChunkZ)
+    {
+        if (m_chunks.erase(GetKey(iChunkX, iChunkZ)) == 0u)
+            return;
+
+        // Only a chunk on the border of the extents can shrink them
+        if (iChunkX == m_minChunk.x || iChunkX == m_maxChunk.x || iChunkZ == m_minChunk.y || iChunkZ == m_maxChunk.y)
+            updateExtents();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::GetNeighbors
+
+      Summary:  Returns the chunks adjacent to a chunk along x and z, in
+                the order expected by Chunk::BuildInstanceData
+
+      Args:     const Chunk& chunk
+                  Chunk of the store
+                const Chunk** apOutNeighbors
+                  NUM_NEIGHBORS adjacent chunks, nullptr where there
+                  is none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::GetNeighbors(_In_ const Chunk& chunk, _Out_writes_(Chunk::NUM_NEIGHBORS) const Chunk** apOutNeighbors) const
+    {
+        apOutNeighbors[Chunk::NEIGHBOR_NEGATIVE_X] = GetChunk(chunk.GetChunkX() - 1, chunk.GetChunkZ());
+        apOutNeighbors[Chunk::NEIGHBOR_POSITIVE_X] = GetChunk(chunk.GetChunkX() + 1, chunk.GetChunkZ());
+        apOutNeighbors[Chunk::NEIGHBOR_NEGATIVE_Z] = GetChunk(chunk.GetChunkX(), chunk.GetChunkZ() - 1);
+        apOutNeighbors[Chunk::NEIGHBOR_POSITIVE_Z] = GetChunk(chunk.GetChunkX(), chunk.GetChunkZ() + 1);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::GetBlock
+
+      Summary:  Returns the block at world block coordinates
+
+      Args:     INT x, y, z
+                  World block coordinates
+
+      Returns:  eBlockType
+                  Block type, AIR where there is no chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eBlockType ChunkStore::GetBlock(_In_ INT x, _In_ INT y, _In_ INT z) const
+    {
+        if (y < 0)
+            return eBlockType::AIR;
+
+        INT iChunkX = GetChunkCoord(x);
+        INT iChunkZ = GetChunkCoord(z);
+
+        const Chunk* pChunk = GetChunk(iChunkX, iChunkZ);
+        if (!pChunk)
+            return eBlockType::AIR;
+
+        return pChunk->GetBlock(
+            static_cast<UINT>(x - iChunkX * static_cast<INT>(Chunk::SIZE)),
+            static_cast<UINT>(y),
+            static_cast<UINT>(z - iChunkZ * static_cast<INT>(Chunk::SIZE))
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::SetBlock
+
+      Summary:  Sets the block at world block coordinates, creating the
+                chunk when a block is added where there is none
+
+      Args:     INT x, y, z
+                  World block coordinates
+                eBlockType blockType
+                  Block type, AIR to remove the block
+
+      Modifies: [m_chunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::SetBlock(_In_ INT x, _In_ INT y, _In_ INT z, _In_ eBlockType blockType)
+    {
+        if (y < 0 || y >= static_cast<INT>(m_uChunkHeight))
+            return;
+
+        INT iChunkX = GetChunkCoord(x);
+        INT iChunkZ = GetChunkCoord(z);
+
+        Chunk* pChunk = blockType == eBlockType::AIR ? GetChunk(iChunkX, iChunkZ) : GetOrCreateChunk(iChunkX, iChunkZ);
+        if (!pChunk)
+            return;
+
+        pChunk->SetBlock(
+            static_cast<UINT>(x - iChunkX * static_cast<INT>(Chunk::SIZE)),
+            static_cast<UINT>(y),
+            static_cast<UINT>(z - iChunkZ * static_cast<INT>(Chunk::SIZE)),
+            blockType
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::CastRay
+
+      Summary:  Returns the first block hit by a ray, stepping through
+                the blocks it crosses one at a time in the order it
+                crosses them (Amanatides and Woo, A Fast Voxel
+                Traversal Algorithm for Ray Tracing). The chunk is only
+                looked up again when the ray leaves it, and the ray
+                stops once it leaves the extents of the chunks heading
+                away from them, so even rays of unbounded distance end
+
+      Args:     const VoxelRay& ray
+                  Ray in world space
+                VoxelRayHit& outHit
+                  First block hit
+
+      Returns:  BOOL
+                  TRUE if a block was hit within the distance of the ray
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL ChunkStore::CastRay(_In_ const VoxelRay& ray, _Out_ VoxelRayHit& outHit) const
+    {
+        constexpr const INT SIZE = static_cast<INT>(Chunk::SIZE);
+
+        outHit = VoxelRayHit
+        {
+            .block = XMINT3(0, 0, 0),
+            .normal = XMINT3(0, 0, 0),
+            .distance = 0.0f,
+            .blockType = eBlockType::AIR
+        };
+
+        // Grid coordinates put block i between i and i + 1
+        const FLOAT aOrigin[3] =
+        {
+            (ray.origin.x - m_origin.x) / Chunk::BLOCK_SIZE + 0.5f,
+            (ray.origin.y - m_origin.y) / Chunk::BLOCK_SIZE + 0.5f,
+            (ray.origin.z - m_origin.z) / Chunk::BLOCK_SIZE + 0.5f
+        };
+        const FLOAT aDirection[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+
+        INT aBlock[3];
+        INT aStep[3];
+        FLOAT aNextDistance[3];
+        FLOAT aDeltaDistance[3];
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            FLOAT cell = std::floor(aOrigin[i]);
+            aBlock[i] = static_cast<INT>(cell);
+
+            if (aDirection[i] > 0.0f)
+            {
+                aStep[i] = 1;
+                aDeltaDistance[i] = Chunk::BLOCK_SIZE / aDirection[i];
+                aNextDistance[i] = (cell + 1.0f - aOrigin[i]) * aDeltaDistance[i];
+            }
+            else if (aDirection[i] < 0.0f)
+            {
+                aStep[i] = -1;
+                aDeltaDistance[i] = -Chunk::BLOCK_SIZE / aDirection[i];
+                aNextDistance[i] = (aOrigin[i] - cell) * aDeltaDistance[i];
+            }
+            else
+            {
+                aStep[i] = 0;
+                aDeltaDistance[i] = (std::numeric_limits<FLOAT>::max)();
+                aNextDistance[i] = (std::numeric_limits<FLOAT>::max)();
+            }
+        }
+
+        if (m_chunks.empty())
+            return FALSE;
+
+        const INT iHeight = static_cast<INT>(m_uChunkHeight);
+        const INT aMinBlock[3] = { m_minChunk.x * SIZE, 0, m_minChunk.y * SIZE };
+        const INT aMaxBlock[3] = { m_maxChunk.x * SIZE + SIZE - 1, iHeight - 1, m_maxChunk.y * SIZE + SIZE - 1 };
+        INT aNormal[3] = { 0, 0, 0 };
+        FLOAT distance = 0.0f;
+
+        INT iChunkX = GetChunkCoord(aBlock[0]);
+        INT iChunkZ = GetChunkCoord(aBlock[2]);
+        const Chunk* pChunk = GetChunk(iChunkX, iChunkZ);
+
+        while (distance <= ray.maxDistance)
+        {
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                if ((aBlock[i] < aMinBlock[i] && aStep[i] <= 0) || (aBlock[i] > aMaxBlock[i] && aStep[i] >= 0))
+                    return FALSE;
+            }
+
+            if (pChunk && aBlock[1] >= 0 && aBlock[1] < iHeight)
+            {
+                eBlockType blockType = pChunk->GetBlock(
+                    static_cast<UINT>(aBlock[0] - iChunkX * SIZE),
+                    static_cast<UINT>(aBlock[1]),
+                    static_cast<UINT>(aBlock[2] - iChunkZ * SIZE)
+                );
+
+                if (blockType != eBlockType::AIR)
+                {
+                    outHit = VoxelRayHit
+                    {
+                        .block = XMINT3(aBlock[0], aBlock[1], aBlock[2]),
+                        .normal = XMINT3(aNormal[0], aNormal[1], aNormal[2]),
+                        .distance = distance,
+                        .blockType = blockType
+                    };
+                    return TRUE;
+                }
+            }
+
+            // Step into the block whose boundary the ray crosses first
+            UINT uAxis = aNextDistance[0] < aNextDistance[1]
+                ? (aNextDistance[0] < aNextDistance[2] ? 0u : 2u)
+                : (aNextDistance[1] < aNextDistance[2] ? 1u : 2u);
+
+            distance = aNextDistance[uAxis];
+            aNextDistance[uAxis] += aDeltaDistance[uAxis];
+            aBlock[uAxis] += aStep[uAxis];
+
+            aNormal[0] = 0;
+            aNormal[1] = 0;
+            aNormal[2] = 0;
+            aNormal[uAxis] = -aStep[uAxis];
+
+            if (uAxis != 1u)
+            {
+                INT iNextChunkX = GetChunkCoord(aBlock[0]);
+                INT iNextChunkZ = GetChunkCoord(aBlock[2]);
+                if (iNextChunkX != iChunkX || iNextChunkZ != iChunkZ)
+                {
+                    iChunkX = iNextChunkX;
+                    iChunkZ = iNextChunkZ;
+                    pChunk = GetChunk(iChunkX, iChunkZ);
+                }
+            }
+        }
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::CastRays
+
+      Summary:  Returns the first block hit by each of many rays. Rays
+                are cast in parallel, so the chunks must not change
+                until it returns
+
+      Args:     const std::vector<VoxelRay>& aRays
+                  Rays in world space
+                std::vector<VoxelRayHit>& aOutHits
+                  First block hit by each ray, AIR where none was hit
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::CastRays(_In_ const std::vector<VoxelRay>& aRays, _Out_ std::vector<VoxelRayHit>& aOutHits) const
+    {
+        aOutHits.resize(aRays.size());
+
+        std::vector<size_t> aIndices(aRays.size());
+        std::iota(aIndices.begin(), aIndices.end(), 0u);
+
+        std::for_each(
+            std::execution::par,
+            aIndices.begin(),
+            aIndices.end(),
+            [this, &aRays, &aOutHits](size_t i)
+            {
+                CastRay(aRays[i], aOutHits[i]);
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::MoveBox
+
+      Summary:  Moves a box as far as the blocks let it, one axis at a
+                time starting with y so that it slides along the faces
+                it hits. A box on the ground that is blocked sideways
+                also tries to climb up to a step height, move across
+                and come back down, and keeps whichever move goes
+                further. Only the blocks the box
+                sweeps through are looked at and nothing is allocated,
+                so it can be run for many boxes every frame. Blocks the
+                box already overlaps are ignored, so a box inside the
+                terrain can move out of it
+
+      Args:     const BoundingBox& box
+                  Box in world space
+                const XMFLOAT3& movement
+                  Movement in world space
+                FLOAT stepHeight
+                  Height in world space the box may climb, 0 for none
+                VoxelMove& outMove
+                  Movement the blocks let the box make
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::MoveBox(_In_ const BoundingBox& box, _In_ const XMFLOAT3& movement, _In_ FLOAT stepHeight, _Out_ VoxelMove& outMove) const
+    {
+        // Grid coordinates put block i between i and i + 1
+        const FLOAT aMin[3] =
+        {
+            (box.Center.x - box.Extents.x - m_origin.x) / Chunk::BLOCK_SIZE + 0.5f,
+            (box.Center.y - box.Extents.y - m_origin.y) / Chunk::BLOCK_SIZE + 0.5f,
+            (box.Center.z - box.Extents.z - m_origin.z) / Chunk::BLOCK_SIZE + 0.5f
+        };
+        const FLOAT aMax[3] =
+        {
+            (box.Center.x + box.Extents.x - m_origin.x) / Chunk::BLOCK_SIZE + 0.5f,
+            (box.Center.y + box.Extents.y - m_origin.y) / Chunk::BLOCK_SIZE + 0.5f,
+            (box.Center.z + box.Extents.z - m_origin.z) / Chunk::BLOCK_SIZE + 0.5f
+        };
+        const FLOAT aMovement[3] =
+        {
+            movement.x / Chunk::BLOCK_SIZE,
+            movement.y / Chunk::BLOCK_SIZE,
+            movement.z / Chunk::BLOCK_SIZE
+        };
+
+        FLOAT aMovedMin[3] = { aMin[0], aMin[1], aMin[2] };
+        FLOAT aMovedMax[3] = { aMax[0], aMax[1], aMax[2] };
+        FLOAT aMoved[3];
+        moveGridBox(aMovedMin, aMovedMax, aMovement, AXIS_ORDER, aMoved);
+
+        BOOL bBlockedSideways = aMoved[0] != aMovement[0] || aMoved[2] != aMovement[2];
+        BOOL bWasOnGround = clipMovement(aMin, aMax, 1u, -COLLISION_EPSILON * 2.0f) > -COLLISION_EPSILON * 2.0f;
+
+        if (stepHeight > 0.0f && bBlockedSideways && bWasOnGround && aMovement[1] <= 0.0f)
+        {
+            FLOAT aSteppedMin[3] = { aMin[0], aMin[1], aMin[2] };
+            FLOAT aSteppedMax[3] = { aMax[0], aMax[1], aMax[2] };
+
+            FLOAT rise = clipMovement(aSteppedMin, aSteppedMax, 1u, stepHeight / Chunk::BLOCK_SIZE);
+            aSteppedMin[1] += rise;
+            aSteppedMax[1] += rise;
+
+            // Across first and back down last, or the box would come down in front of the step again
+            const FLOAT aSteppedMovement[3] = { aMovement[0], aMovement[1] - rise, aMovement[2] };
+            FLOAT aStepped[3];
+            moveGridBox(aSteppedMin, aSteppedMax, aSteppedMovement, STEP_AXIS_ORDER, aStepped);
+            aStepped[1] += rise;
+
+            if (aStepped[0] * aStepped[0] + aStepped[2] * aStepped[2] > aMoved[0] * aMoved[0] + aMoved[2] * aMoved[2])
+            {
+                for (UINT i = 0u; i < 3u; ++i)
+                {
+                    aMoved[i] = aStepped[i];
+                    aMovedMin[i] = aSteppedMin[i];
+                    aMovedMax[i] = aSteppedMax[i];
+                }
+            }
+        }
+
+        outMove = VoxelMove
+        {
+            .movement = XMFLOAT3(aMoved[0] * Chunk::BLOCK_SIZE, aMoved[1] * Chunk::BLOCK_SIZE, aMoved[2] * Chunk::BLOCK_SIZE),
+            .bBlockedX = aMoved[0] != aMovement[0],
+            .bBlockedY = aMoved[1] != aMovement[1],
+            .bBlockedZ = aMoved[2] != aMovement[2],
+            .bOnGround = clipMovement(aMovedMin, aMovedMax, 1u, -COLLISION_EPSILON * 2.0f) > -COLLISION_EPSILON * 2.0f
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::clipMovement
+
+      Summary:  Returns how far a box can move along an axis before it
+                hits a block, looking at the layers of blocks it sweeps
+                through nearest first
+
+      Args:     const FLOAT* aMin, aMax
+                  Corners of the box in grid coordinates
+                UINT uAxis
+                  Axis to move along, 0 for x, 1 for y and 2 for z
+                FLOAT movement
+                  Movement along the axis in blocks
+
+      Returns:  FLOAT
+                  Movement along the axis the blocks let the box make
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT ChunkStore::clipMovement(_In_reads_(3) const FLOAT* aMin, _In_reads_(3) const FLOAT* aMax, _In_ UINT uAxis, _In_ FLOAT movement) const
+    {
+        if (movement == 0.0f)
+            return 0.0f;
+
+        // Blocks the box only touches are left out, and so are the ones it overlaps along the axis
+        INT aFirst[3];
+        INT aLast[3];
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            aFirst[i] = static_cast<INT>(std::floor(aMin[i] + COLLISION_EPSILON));
+            aLast[i] = static_cast<INT>(std::ceil(aMax[i] - COLLISION_EPSILON)) - 1;
+        }
+
+        INT iStep;
+        if (movement > 0.0f)
+        {
+            aFirst[uAxis] = static_cast<INT>(std::ceil(aMax[uAxis] - COLLISION_EPSILON));
+            aLast[uAxis] = static_cast<INT>(std::ceil(aMax[uAxis] + movement)) - 1;
+            iStep = 1;
+        }
+        else
+        {
+            aFirst[uAxis] = static_cast<INT>(std::floor(aMin[uAxis] + COLLISION_EPSILON)) - 1;
+            aLast[uAxis] = static_cast<INT>(std::floor(aMin[uAxis] + movement));
+            iStep = -1;
+        }
+
+        UINT uAxisA = (uAxis + 1u) % 3u;
+        UINT uAxisB = (uAxis + 2u) % 3u;
+        INT iNumLayers = (aLast[uAxis] - aFirst[uAxis]) * iStep + 1;
+
+        INT aBlock[3];
+        for (INT iLayer = 0; iLayer < iNumLayers; ++iLayer)
+        {
+            aBlock[uAxis] = aFirst[uAxis] + iLayer * iStep;
+
+            for (aBlock[uAxisA] = aFirst[uAxisA]; aBlock[uAxisA] <= aLast[uAxisA]; ++aBlock[uAxisA])
+            {
+                for (aBlock[uAxisB] = aFirst[uAxisB]; aBlock[uAxisB] <= aLast[uAxisB]; ++aBlock[uAxisB])
+                {
+                    if (GetBlock(aBlock[0], aBlock[1], aBlock[2]) == eBlockType::AIR)
+                        continue;
+
+                    if (iStep > 0)
+                        return std::max<FLOAT>(static_cast<FLOAT>(aBlock[uAxis]) - aMax[uAxis], 0.0f);
+
+                    return std::min<FLOAT>(static_cast<FLOAT>(aBlock[uAxis] + 1) - aMin[uAxis], 0.0f);
+                }
+            }
+        }
+
+        return movement;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::moveGridBox
+
+      Summary:  Moves a box along one axis after the other, each as far
+                as the blocks let it
+
+      Args:     FLOAT* aMin, aMax
+                  Corners of the box in grid coordinates, moved
+                const FLOAT* aMovement
+                  Movement in blocks
+                const UINT* auAxisOrder
+                  Axes in the order to move along
+                FLOAT* aOutMoved
+                  Movement along each axis the blocks let the box make
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::moveGridBox(
+        _Inout_updates_(3) FLOAT* aMin,
+        _Inout_updates_(3) FLOAT* aMax,
+        _In_reads_(3) const FLOAT* aMovement,
+        _In_reads_(3) const UINT* auAxisOrder,
+        _Out_writes_(3) FLOAT* aOutMoved
+    ) const
+    {
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            UINT uAxis = auAxisOrder[i];
+            aOutMoved[uAxis] = clipMovement(aMin, aMax, uAxis, aMovement[uAxis]);
+            aMin[uAxis] += aOutMoved[uAxis];
+            aMax[uAxis] += aOutMoved[uAxis];
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::updateExtents
+
+      Summary:  Recomputes the lowest and highest chunk coordinates of
+                the chunks, left crossed when there is no chunk
+
+      Modifies: [m_minChunk, m_maxChunk].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ChunkStore::updateExtents()
+    {
+        m_minChunk = XMINT2((std::numeric_limits<INT>::max)(), (std::numeric_limits<INT>::max)());
+        m_maxChunk = XMINT2((std::numeric_limits<INT>::min)(), (std::numeric_limits<INT>::min)());
+
+        for (const auto& chunkElem : m_chunks)
+        {
+            m_minChunk = XMINT2(std::min<INT>(m_minChunk.x, chunkElem.second->GetChunkX()), std::min<INT>(m_minChunk.y, chunkElem.second->GetChunkZ()));
+            m_maxChunk = XMINT2(std::max<INT>(m_maxChunk.x, chunkElem.second->GetChunkX()), std::max<INT>(m_maxChunk.y, chunkElem.second->GetChunkZ()));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::GetChunks
+
+      Summary:  Returns every chunk keyed by its packed coordinates
+
+      Returns:  const std::unordered_map<UINT64, std::unique_ptr<Chunk>>&
+                  Chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::unordered_map<UINT64, std::unique_ptr<Chunk>>& ChunkStore::GetChunks() const
+    {
+        return m_chunks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::GetChunkHeight
+
+      Summary:  Returns the number of blocks along y in a chunk
+
+      Returns:  UINT
+                  Chunk height
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ChunkStore::GetChunkHeight() const
+    {
+        return m_uChunkHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::GetOrigin
+
+      Summary:  Returns the world position of the center of block
+                (0, 0, 0)
+
+      Returns:  const XMFLOAT3&
+                  Origin of the world
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT3& ChunkStore::GetOrigin() const
+    {
+        return m_origin;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::GetChunkCoord
+
+      Summary:  Returns the coordinate of the chunk holding a block,
+                rounding down for negative block coordinates
+
+      Args:     INT iBlockCoord
+                  Block coordinate along x or z
+
+      Returns:  INT
+                  Chunk coordinate
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    INT ChunkStore::GetChunkCoord(_In_ INT iBlockCoord)
+    {
+        constexpr const INT SIZE = static_cast<INT>(Chunk::SIZE);
+
+        return iBlockCoord >= 0 ? iBlockCoord / SIZE : (iBlockCoord - SIZE + 1) / SIZE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ChunkStore::GetKey
+
+      Summary:  Packs chunk coordinates into the key of a chunk
+
+      Args:     INT iChunkX, iChunkZ
+                  Chunk coordinates
+
+      Returns:  UINT64
+                  Key of the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 ChunkStore::GetKey(_In_ INT iChunkX, _In_ INT iChunkZ)
+    {
+        return (static_cast<UINT64>(static_cast<UINT>(iChunkX)) << 32ull) | static_cast<UINT64>(static_cast<UINT>(iChunkZ));
+    }
+}
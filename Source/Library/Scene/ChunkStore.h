@@ -0,0 +1,168 @@
+/*+===================================================================
+  File:      CHUNKSTORE.H
+
+  Summary:   ChunkStore header file contains declaration of class
+             ChunkStore used to store the chunks of a voxel world.
+
+  Classes:  ChunkStore
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/Chunk.h"
+#include "Scene/SceneFile.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelRay
+
+        Summary:  Ray cast against the blocks of a voxel world, in world
+                  space with a normalized direction
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelRay
+    {
+        XMFLOAT3 origin;
+        XMFLOAT3 direction;
+        FLOAT maxDistance;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelRayHit
+
+        Summary:  First block hit by a ray, the normal of the face it
+                  entered through and the distance along the ray.
+                  blockType is AIR when nothing was hit
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelRayHit
+    {
+        XMINT3 block;
+        XMINT3 normal;
+        FLOAT distance;
+        eBlockType blockType;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   VoxelMove
+
+        Summary:  Movement of a box after colliding with blocks, the
+                  axes it was blocked along and whether it rests on a
+                  block
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelMove
+    {
+        XMFLOAT3 movement;
+        BOOL bBlockedX;
+        BOOL bBlockedY;
+        BOOL bBlockedZ;
+        BOOL bOnGround;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ChunkStore
+
+      Summary:  CPU-side store of the chunks of a voxel world, keyed by
+                chunk coordinates. Blocks are addressed with world block
+                coordinates and chunks are created on demand, so the
+                world is not bounded to the scene it was loaded from
+
+      Methods:  Load
+                  Replaces the chunks with the columns of a scene
+                Reset
+                  Removes every chunk and sets the origin and the chunk
+                  height
+                Clear
+                  Removes every chunk
+                GetChunk
+                  Returns the chunk at chunk coordinates
+                GetOrCreateChunk
+                  Returns the chunk at chunk coordinates, creating it
+                RemoveChunk
+                  Removes the chunk at chunk coordinates
+                GetNeighbors
+                  Returns the chunks adjacent to a chunk
+                GetBlock
+                  Returns the block at world block coordinates
+                SetBlock
+                  Sets the block at world block coordinates
+                CastRay
+                  Returns the first block hit by a ray
+                CastRays
+                  Returns the first block hit by each of many rays
+                MoveBox
+                  Moves a box as far as the blocks let it
+                GetChunks
+                  Returns every chunk
+                GetChunkHeight
+                  Returns the number of blocks along y in a chunk
+                GetOrigin
+                  Returns the world position of block (0, 0, 0)
+                GetChunkCoord
+                  Returns the chunk coordinate of a block coordinate
+                GetKey
+                  Packs chunk coordinates into a key
+                ChunkStore
+                  Constructor.
+                ~ChunkStore
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ChunkStore final
+    {
+    public:
+        ChunkStore();
+        ChunkStore(const ChunkStore& other) = delete;
+        ChunkStore(ChunkStore&& other) = delete;
+        ChunkStore& operator=(const ChunkStore& other) = delete;
+        ChunkStore& operator=(ChunkStore&& other) = delete;
+        ~ChunkStore() = default;
+
+        void Load(_In_ const SceneData& sceneData, _In_ const XMFLOAT3& origin);
+        void Reset(_In_ const XMFLOAT3& origin, _In_ UINT uChunkHeight);
+        void Clear();
+
+        Chunk* GetChunk(_In_ INT iChunkX, _In_ INT iChunkZ) const;
+        Chunk* GetOrCreateChunk(_In_ INT iChunkX, _In_ INT iChunkZ);
+        void RemoveChunk(_In_ INT iChunkX, _In_ INT iChunkZ);
+        void GetNeighbors(_In_ const Chunk& chunk, _Out_writes_(Chunk::NUM_NEIGHBORS) const Chunk** apOutNeighbors) const;
+
+        eBlockType GetBlock(_In_ INT x, _In_ INT y, _In_ INT z) const;
+        void SetBlock(_In_ INT x, _In_ INT y, _In_ INT z, _In_ eBlockType blockType);
+
+        BOOL CastRay(_In_ const VoxelRay& ray, _Out_ VoxelRayHit& outHit) const;
+        void CastRays(_In_ const std::vector<VoxelRay>& aRays, _Out_ std::vector<VoxelRayHit>& aOutHits) const;
+        void MoveBox(_In_ const BoundingBox& box, _In_ const XMFLOAT3& movement, _In_ FLOAT stepHeight, _Out_ VoxelMove& outMove) const;
+
+        const std::unordered_map<UINT64, std::unique_ptr<Chunk>>& GetChunks() const;
+        UINT GetChunkHeight() const;
+        const XMFLOAT3& GetOrigin() const;
+
+        static INT GetChunkCoord(_In_ INT iBlockCoord);
+        static UINT64 GetKey(_In_ INT iChunkX, _In_ INT iChunkZ);
+
+    private:
+        static constexpr const FLOAT COLLISION_EPSILON = 0.001f;
+        // Falling first lets a box slide along the ground, a stepped box moves across before it comes down
+        static constexpr const UINT AXIS_ORDER[3] = { 1u, 0u, 2u };
+        static constexpr const UINT STEP_AXIS_ORDER[3] = { 0u, 2u, 1u };
+
+        FLOAT clipMovement(_In_reads_(3) const FLOAT* aMin, _In_reads_(3) const FLOAT* aMax, _In_ UINT uAxis, _In_ FLOAT movement) const;
+        void moveGridBox(
+            _Inout_updates_(3) FLOAT* aMin,
+            _Inout_updates_(3) FLOAT* aMax,
+            _In_reads_(3) const FLOAT* aMovement,
+            _In_reads_(3) const UINT* auAxisOrder,
+            _Out_writes_(3) FLOAT* aOutMoved
+        ) const;
+        void updateExtents();
+
+    private:
+        XMFLOAT3 m_origin;
+        UINT m_uChunkHeight;
+        std::unordered_map<UINT64, std::unique_ptr<Chunk>> m_chunks;
+        XMINT2 m_minChunk;
+        XMINT2 m_maxChunk;
+    };
+}
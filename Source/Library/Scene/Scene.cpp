@@ -2,165 +2,231 @@
 
 namespace library
 {
-    FLOAT Scene::GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth)
+    Scene::Scene(const std::filesystem::path& filePath, eVoxelMesher mesher)
+        : m_filePath(filePath)
+        , m_mesher(mesher)
+        , m_voxels()
+        , m_voxelMeshes()
+        , m_aColors()
+        , m_cbBlockColors()
+        , m_chunkStore()
+        , m_aChunkMeshes()
+        , m_terrainStreamer()
+        , m_vertexShader()
+        , m_pixelShader()
+        , m_dirtyChunks()
     {
-        FLOAT xa = x * frequency;
-        FLOAT ya = y * frequency;
-        FLOAT amp = 1.0f;
-        FLOAT fin = 0.0f;
-        FLOAT div = 0.0f;
-
-        for (UINT i = 0; i < uDepth; ++i)
+        SceneData sceneData;
+        if (FAILED(SceneFile::Read(m_filePath, sceneData)))
         {
-            div += 256.0f * amp;
-            fin += getNoise2d(xa, ya) * amp;
-            amp /= 2.0f;
-            xa *= 2.0f;
-            ya *= 2.0f;
+            OutputDebugString(L"Failed to read scene \"");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L"\"\n");
+            return;
         }
 
-        return fin / div;
+        load(sceneData);
     }
 
-    Scene::Scene(const std::filesystem::path& filePath)
-        : m_filePath(filePath)
+    Scene::Scene(const SceneData& sceneData, eVoxelMesher mesher)
+        : m_filePath()
+        , m_mesher(mesher)
+        , m_voxels()
+        , m_voxelMeshes()
+        , m_aColors()
+        , m_cbBlockColors()
+        , m_chunkStore()
+        , m_aChunkMeshes()
+        , m_terrainStreamer()
+        , m_vertexShader()
+        , m_pixelShader()
+        , m_dirtyChunks()
+    {
+        load(sceneData);
+    }
+
+    Scene::Scene(std::unique_ptr<TerrainStreamer>&& terrainStreamer, const std::vector<XMFLOAT4>& aColors, const XMFLOAT3& origin, eVoxelMesher mesher)
+        : m_filePath()
+        , m_mesher(mesher)
         , m_voxels()
+        , m_voxelMeshes()
+        , m_aColors(aColors)
+        , m_cbBlockColors()
+        , m_chunkStore()
+        , m_aChunkMeshes()
+        , m_terrainStreamer(std::move(terrainStreamer))
+        , m_vertexShader()
+        , m_pixelShader()
+        , m_dirtyChunks()
     {
-        std::ifstream inputFile;
-        inputFile.open(m_filePath.string());
+        // Chunks are streamed in by Update
+        m_chunkStore.Reset(origin, m_terrainStreamer->GetChunkHeight());
+    }
+
+    HRESULT Scene::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        // Colors of the block types shared by the instances of every chunk
+        CBBlockColors cbBlockColors = {};
+        for (size_t i = 0u; i < m_aColors.size() && i < NUM_BLOCK_COLORS; ++i)
+        {
+            cbBlockColors.BlockColors[i] = m_aColors[i];
+        }
 
-        std::string trash;
-        UINT aDimension[4] = { 0u, };
-        UINT uDimensionIdx = 0u;
-        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        D3D11_BUFFER_DESC bd =
         {
-            inputFile >> aDimension[uDimensionIdx];
+            .ByteWidth = sizeof(CBBlockColors),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0
+        };
 
-            if (inputFile.fail())
+        D3D11_SUBRESOURCE_DATA initData =
+        {
+            .pSysMem = &cbBlockColors,
+            .SysMemPitch = 0,
+            .SysMemSlicePitch = 0
+        };
+
+        HRESULT hr = pDevice->CreateBuffer(&bd, &initData, m_cbBlockColors.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        for (auto voxel : m_voxels)
+        {
+            hr = voxel->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
             {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
+                return hr;
             }
-            else
+        }
+
+        for (auto voxelMesh : m_voxelMeshes)
+        {
+            hr = voxelMesh->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
             {
-                ++uDimensionIdx;
+                return hr;
             }
         }
 
-        UINT uColorIdx = 0u;
-        XMFLOAT4 color;
-        while (!inputFile.eof() && uColorIdx < aDimension[3])
+        return S_OK;
+    }
+
+    HRESULT Scene::Update(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const XMVECTOR& eye)
+    {
+        if (m_terrainStreamer)
         {
-            inputFile >> color.x >> color.y >> color.z;
+            streamChunks(eye);
+        }
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else
-            {
-                color.w = 1.0f;
-                m_voxels.push_back(std::make_shared<Voxel>(color));
-                ++uColorIdx;
-            }
+        return rebuildDirtyChunks(pDevice, pImmediateContext);
+    }
+
+    void Scene::SetBlock(_In_ INT x, _In_ INT y, _In_ INT z, _In_ eBlockType blockType)
+    {
+        // Streamed terrain is only edited where it is resident, a chunk created by the edit would never be generated
+        if (m_terrainStreamer && !m_chunkStore.GetChunk(ChunkStore::GetChunkCoord(x), ChunkStore::GetChunkCoord(z)))
+        {
+            return;
         }
 
-        std::vector<std::vector<InstanceData>> aInstanceData;
-        aInstanceData.reserve(m_voxels.size());
-        for (UINT renderableIdx = 0u; renderableIdx < m_voxels.size(); ++renderableIdx)
+        if (m_chunkStore.GetBlock(x, y, z) == blockType)
         {
-            aInstanceData.push_back(std::vector<InstanceData>());
-            aInstanceData.back().reserve(
-                static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[1]) * static_cast<size_t>(aDimension[2])
-            );
+            return;
         }
 
-        UINT uDepthIdx = 0u;
-        UINT uWidthIdx = 0u;
-        CHAR voxelType;
-        FLOAT height;
-        while (!inputFile.eof())
+        m_chunkStore.SetBlock(x, y, z, blockType);
+
+        // Blocks on the side of a chunk are also faces of the chunk next to it
+        constexpr const INT SIZE = static_cast<INT>(Chunk::SIZE);
+        INT iChunkX = ChunkStore::GetChunkCoord(x);
+        INT iChunkZ = ChunkStore::GetChunkCoord(z);
+        INT iLocalX = x - iChunkX * SIZE;
+        INT iLocalZ = z - iChunkZ * SIZE;
+
+        markChunkDirty(iChunkX, iChunkZ);
+        if (iLocalX == 0)
+        {
+            markChunkDirty(iChunkX - 1, iChunkZ);
+        }
+        else if (iLocalX == SIZE - 1)
         {
-            inputFile >> voxelType >> height;
+            markChunkDirty(iChunkX + 1, iChunkZ);
+        }
+        if (iLocalZ == 0)
+        {
+            markChunkDirty(iChunkX, iChunkZ - 1);
+        }
+        else if (iLocalZ == SIZE - 1)
+        {
+            markChunkDirty(iChunkX, iChunkZ + 1);
+        }
+    }
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
+    void Scene::ClearBlock(_In_ INT x, _In_ INT y, _In_ INT z)
+    {
+        SetBlock(x, y, z, eBlockType::AIR);
+    }
+
+    void Scene::SetBlocks(_In_ const XMINT3& minBlock, _In_ const XMINT3& maxBlock, _In_ eBlockType blockType)
+    {
+        for (INT z = minBlock.z; z <= maxBlock.z; ++z)
+        {
+            for (INT x = minBlock.x; x <= maxBlock.x; ++x)
             {
-                for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
-                {
-                    aInstanceData[static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND)].push_back(
-                        InstanceData
-                        {
-                            .Transformation = XMMatrixTranslation(
-                                2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
-                                2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
-                                2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
-                                )
-                        }
-                    );
-                }
-                ++uWidthIdx;
-                if (uWidthIdx >= aDimension[0])
+                for (INT y = minBlock.y; y <= maxBlock.y; ++y)
                 {
-                    uWidthIdx -= aDimension[0];
-                    ++uDepthIdx;
-
-                    if (uDepthIdx >= aDimension[2])
-                    {
-                        uDepthIdx -= aDimension[2];
-                    }
+                    SetBlock(x, y, z, blockType);
                 }
             }
         }
+    }
+
+    BOOL Scene::CastRay(_In_ const VoxelRay& ray, _Out_ VoxelRayHit& outHit) const
+    {
+        return m_chunkStore.CastRay(ray, outHit);
+    }
+
+    void Scene::CastRays(_In_ const std::vector<VoxelRay>& aRays, _Out_ std::vector<VoxelRayHit>& aOutHits) const
+    {
+        m_chunkStore.CastRays(aRays, aOutHits);
+    }
 
-        inputFile.close();
+    void Scene::MoveBox(_In_ const BoundingBox& box, _In_ const XMFLOAT3& movement, _In_ FLOAT stepHeight, _Out_ VoxelMove& outMove) const
+    {
+        m_chunkStore.MoveBox(box, movement, stepHeight, outMove);
+    }
+
+    void Scene::SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader)
+    {
+        m_vertexShader = vertexShader;
 
-        UINT uVoxelIdx = 0u;
-        auto it = m_voxels.begin();
-        while (it != m_voxels.end())
+        for (const std::shared_ptr<Voxel>& voxel : m_voxels)
         {
-            if (aInstanceData[uVoxelIdx].size() <= 0)
-            {
-                it = m_voxels.erase(it);
-            }
-            else
-            {
-                (*it)->SetInstanceData(std::move(aInstanceData[uVoxelIdx]));
-                ++it;
-            }
-            ++uVoxelIdx;
+            voxel->SetVertexShader(vertexShader);
+        }
+
+        for (const std::shared_ptr<VoxelMesh>& voxelMesh : m_voxelMeshes)
+        {
+            voxelMesh->SetVertexShader(vertexShader);
         }
     }
 
-    HRESULT Scene::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    void Scene::SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader)
     {
-        for (auto voxel : m_voxels)
+        m_pixelShader = pixelShader;
+
+        for (const std::shared_ptr<Voxel>& voxel : m_voxels)
         {
-            HRESULT hr = voxel->Initialize(pDevice, pImmediateContext);
-            if (FAILED(hr))
-            {
-                return hr;
-            }
+            voxel->SetPixelShader(pixelShader);
         }
 
-        return S_OK;
+        for (const std::shared_ptr<VoxelMesh>& voxelMesh : m_voxelMeshes)
+        {
+            voxelMesh->SetPixelShader(pixelShader);
+        }
     }
 
     std::vector<std::shared_ptr<Voxel>>& Scene::GetVoxels()
@@ -168,6 +234,31 @@ namespace library
         return m_voxels;
     }
 
+    std::vector<std::shared_ptr<VoxelMesh>>& Scene::GetVoxelMeshes()
+    {
+        return m_voxelMeshes;
+    }
+
+    std::vector<ChunkMesh>& Scene::GetChunkMeshes()
+    {
+        return m_aChunkMeshes;
+    }
+
+    const ChunkStore& Scene::GetChunkStore() const
+    {
+        return m_chunkStore;
+    }
+
+    const TerrainStreamer* Scene::GetTerrainStreamer() const
+    {
+        return m_terrainStreamer.get();
+    }
+
+    ComPtr<ID3D11Buffer>& Scene::GetBlockColorsConstantBuffer()
+    {
+        return m_cbBlockColors;
+    }
+
     const std::filesystem::path& Scene::GetFilePath() const
     {
         return m_filePath;
@@ -178,38 +269,275 @@ namespace library
         return m_filePath.c_str();
     }
 
-    FLOAT Scene::getNoise2(UINT x, UINT y)
+    eVoxelMesher Scene::GetMesher() const
+    {
+        return m_mesher;
+    }
+
+    void Scene::load(_In_ const SceneData& sceneData)
+    {
+        // Same placement as before chunking, the map is centered on the origin along x and z
+        XMFLOAT3 origin(
+            -Chunk::BLOCK_SIZE * static_cast<FLOAT>(sceneData.uWidth) / 2.0f,
+            -Chunk::BLOCK_SIZE * static_cast<FLOAT>(sceneData.uHeight) + static_cast<FLOAT>(sceneData.uHeight) * 0.75f,
+            -Chunk::BLOCK_SIZE * static_cast<FLOAT>(sceneData.uDepth) / 2.0f
+        );
+
+        m_aColors = sceneData.aColors;
+        m_chunkStore.Load(sceneData, origin);
+
+        size_t uNumBlocks = 0u;
+        size_t uNumRuns = 0u;
+        size_t uChunkMemoryUsage = 0u;
+        for (const auto& chunkElem : m_chunkStore.GetChunks())
+        {
+            uNumBlocks += chunkElem.second->GetNumBlocks();
+            uNumRuns += chunkElem.second->GetNumRuns();
+            uChunkMemoryUsage += chunkElem.second->GetMemoryUsage();
+            buildChunkMesh(*chunkElem.second);
+        }
+
+        WCHAR szDebugMessage[128];
+        swprintf_s(szDebugMessage, L"Scene: %zu runs of blocks in %zu bytes of chunks\n", uNumRuns, uChunkMemoryUsage);
+        OutputDebugString(szDebugMessage);
+
+        if (m_mesher == eVoxelMesher::GREEDY)
+        {
+            size_t uNumQuads = 0u;
+            for (const std::shared_ptr<VoxelMesh>& voxelMesh : m_voxelMeshes)
+            {
+                uNumQuads += voxelMesh->GetNumVertices() / 4u;
+            }
+
+            swprintf_s(szDebugMessage, L"Scene: %zu blocks, %zu quads in %zu meshes\n", uNumBlocks, uNumQuads, m_voxelMeshes.size());
+        }
+        else
+        {
+            size_t uNumInstances = 0u;
+            for (const std::shared_ptr<Voxel>& voxel : m_voxels)
+            {
+                uNumInstances += voxel->GetNumInstances();
+            }
+
+            swprintf_s(szDebugMessage, L"Scene: %zu blocks, %zu visible instances\n", uNumBlocks, uNumInstances);
+        }
+        OutputDebugString(szDebugMessage);
+    }
+
+    void Scene::streamChunks(_In_ const XMVECTOR& eye)
     {
-        UINT temp = ms_aHashes[y % 256u];
+        XMFLOAT3 eyePosition;
+        XMStoreFloat3(&eyePosition, eye);
+
+        const XMFLOAT3& origin = m_chunkStore.GetOrigin();
+        INT iCenterChunkX = ChunkStore::GetChunkCoord(static_cast<INT>(std::floor((eyePosition.x - origin.x) / Chunk::BLOCK_SIZE + 0.5f)));
+        INT iCenterChunkZ = ChunkStore::GetChunkCoord(static_cast<INT>(std::floor((eyePosition.z - origin.z) / Chunk::BLOCK_SIZE + 0.5f)));
+
+        // The meshes refer to their chunk, so they are released before the chunk is removed
+        std::vector<XMINT2> aEvicted;
+        m_terrainStreamer->SelectEvictions(iCenterChunkX, iCenterChunkZ, m_chunkStore, aEvicted);
+        for (const XMINT2& coord : aEvicted)
+        {
+            removeChunkMesh(*m_chunkStore.GetChunk(coord.x, coord.y));
+            m_chunkStore.RemoveChunk(coord.x, coord.y);
+            m_dirtyChunks.erase(ChunkStore::GetKey(coord.x, coord.y));
+            markNeighborsDirty(coord.x, coord.y);
+        }
+
+        std::vector<XMINT2> aLoaded;
+        m_terrainStreamer->Update(iCenterChunkX, iCenterChunkZ, m_chunkStore, aLoaded);
+        for (const XMINT2& coord : aLoaded)
+        {
+            markChunkDirty(coord.x, coord.y);
+            markNeighborsDirty(coord.x, coord.y);
+        }
+    }
+
+    void Scene::markChunkDirty(_In_ INT iChunkX, _In_ INT iChunkZ)
+    {
+        if (m_chunkStore.GetChunk(iChunkX, iChunkZ))
+        {
+            m_dirtyChunks.insert(ChunkStore::GetKey(iChunkX, iChunkZ));
+        }
+    }
+
+    void Scene::markNeighborsDirty(_In_ INT iChunkX, _In_ INT iChunkZ)
+    {
+        markChunkDirty(iChunkX - 1, iChunkZ);
+        markChunkDirty(iChunkX + 1, iChunkZ);
+        markChunkDirty(iChunkX, iChunkZ - 1);
+        markChunkDirty(iChunkX, iChunkZ + 1);
+    }
+
+    HRESULT Scene::rebuildDirtyChunks(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (m_dirtyChunks.empty())
+        {
+            return S_OK;
+        }
+
+        for (UINT64 uKey : m_dirtyChunks)
+        {
+            auto it = m_chunkStore.GetChunks().find(uKey);
+            if (it == m_chunkStore.GetChunks().end())
+            {
+                continue;
+            }
+
+            HRESULT hr = rebuildChunkMesh(*it->second, pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                m_dirtyChunks.clear();
+                return hr;
+            }
+        }
+
+        m_dirtyChunks.clear();
 
-        return static_cast<FLOAT>(ms_aHashes[(temp + x) % 256u]);
+        return S_OK;
     }
 
-    FLOAT Scene::getNoise2d(FLOAT x, FLOAT y)
+    void Scene::buildChunkMesh(_In_ const Chunk& chunk)
     {
-        UINT uX = static_cast<UINT>(x);
-        UINT uY = static_cast<UINT>(y);
-        FLOAT xFrac = x - static_cast<FLOAT>(uX);
-        FLOAT yFrac = y - static_cast<FLOAT>(uY);
+        const Chunk* apNeighbors[Chunk::NUM_NEIGHBORS];
+        m_chunkStore.GetNeighbors(chunk, apNeighbors);
+
+        ChunkMesh chunkMesh =
+        {
+            .pChunk = &chunk,
+            .boundingBox = chunk.GetBoundingBox(),
+            .aOccluders = std::vector<BoundingBox>(),
+            .aVoxels = std::vector<std::shared_ptr<Voxel>>(),
+            .aMeshes = std::vector<std::shared_ptr<VoxelMesh>>()
+        };
+        chunk.BuildOccluders(chunkMesh.aOccluders);
+
+        if (m_mesher == eVoxelMesher::GREEDY)
+        {
+            std::vector<SimpleVertex> aVertices[Chunk::NUM_BLOCK_TYPES];
+            chunk.BuildGreedyMesh(apNeighbors, aVertices);
+
+            for (UINT i = 0u; i < Chunk::NUM_BLOCK_TYPES && i < m_aColors.size(); ++i)
+            {
+                // Indices are 16-bit, so large meshes are split on quad boundaries
+                for (size_t uFirst = 0u; uFirst < aVertices[i].size(); uFirst += VoxelMesh::MAX_VERTICES)
+                {
+                    size_t uLast = std::min<size_t>(uFirst + VoxelMesh::MAX_VERTICES, aVertices[i].size());
+                    std::vector<SimpleVertex> aMeshVertices(aVertices[i].begin() + uFirst, aVertices[i].begin() + uLast);
 
-        UINT s = static_cast<UINT>(getNoise2(uX, uY));
-        UINT t = static_cast<UINT>(getNoise2(uX + 1u, uY));
-        UINT u = static_cast<UINT>(getNoise2(uX, uY + 1u));
-        UINT v = static_cast<UINT>(getNoise2(uX + 1u, uY + 1u));
+                    std::shared_ptr<VoxelMesh> voxelMesh = std::make_shared<VoxelMesh>(std::move(aMeshVertices), m_aColors[i]);
+                    if (m_vertexShader)
+                    {
+                        voxelMesh->SetVertexShader(m_vertexShader);
+                    }
+                    if (m_pixelShader)
+                    {
+                        voxelMesh->SetPixelShader(m_pixelShader);
+                    }
+                    chunkMesh.aMeshes.push_back(voxelMesh);
+                    m_voxelMeshes.push_back(voxelMesh);
+                }
+            }
+        }
+        else
+        {
+            std::vector<InstanceData> aInstanceData;
+            chunk.BuildInstanceData(apNeighbors, aInstanceData);
 
-        FLOAT low = smoothLerp(static_cast<FLOAT>(s), static_cast<FLOAT>(t), xFrac);
-        FLOAT high = smoothLerp(static_cast<FLOAT>(u), static_cast<FLOAT>(v), xFrac);
+            if (!aInstanceData.empty())
+            {
+                // Instances are relative to the first block of the chunk and colored from the palette
+                XMFLOAT3 chunkOrigin = chunk.GetBlockPosition(0u, 0u, 0u);
+                std::shared_ptr<Voxel> voxel = std::make_shared<Voxel>(std::move(aInstanceData), XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+                voxel->Translate(XMLoadFloat3(&chunkOrigin));
+                if (m_vertexShader)
+                {
+                    voxel->SetVertexShader(m_vertexShader);
+                }
+                if (m_pixelShader)
+                {
+                    voxel->SetPixelShader(m_pixelShader);
+                }
+                chunkMesh.aVoxels.push_back(voxel);
+                m_voxels.push_back(voxel);
+            }
+        }
 
-        return smoothLerp(low, high, yFrac);
+        if (!chunkMesh.aVoxels.empty() || !chunkMesh.aMeshes.empty())
+        {
+            m_aChunkMeshes.push_back(std::move(chunkMesh));
+        }
     }
 
-    FLOAT Scene::lerp(FLOAT x, FLOAT y, FLOAT s)
+    void Scene::removeChunkMesh(_In_ const Chunk& chunk)
     {
-        return x + s * (y - x);
+        auto it = std::find_if(m_aChunkMeshes.begin(), m_aChunkMeshes.end(),
+            [&chunk](const ChunkMesh& chunkMesh) { return chunkMesh.pChunk == &chunk; });
+        if (it == m_aChunkMeshes.end())
+        {
+            return;
+        }
+
+        std::erase_if(m_voxels, [&it](const std::shared_ptr<Voxel>& voxel)
+            {
+                return std::find(it->aVoxels.begin(), it->aVoxels.end(), voxel) != it->aVoxels.end();
+            });
+        std::erase_if(m_voxelMeshes, [&it](const std::shared_ptr<VoxelMesh>& voxelMesh)
+            {
+                return std::find(it->aMeshes.begin(), it->aMeshes.end(), voxelMesh) != it->aMeshes.end();
+            });
+
+        // Chunk meshes are drawn in any order, so the last one takes the place of the removed one
+        *it = std::move(m_aChunkMeshes.back());
+        m_aChunkMeshes.pop_back();
     }
 
-    FLOAT Scene::smoothLerp(FLOAT x, FLOAT y, FLOAT s)
+    HRESULT Scene::rebuildChunkMesh(_In_ const Chunk& chunk, _In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
-        return lerp(x, y, s * s * (3.0f - 2.0f * s));
+        // Instances of a chunk that already has a voxel are written into its instance buffer
+        auto it = std::find_if(m_aChunkMeshes.begin(), m_aChunkMeshes.end(),
+            [&chunk](const ChunkMesh& chunkMesh) { return chunkMesh.pChunk == &chunk; });
+        if (m_mesher == eVoxelMesher::INSTANCED && it != m_aChunkMeshes.end() && !it->aVoxels.empty())
+        {
+            const Chunk* apNeighbors[Chunk::NUM_NEIGHBORS];
+            m_chunkStore.GetNeighbors(chunk, apNeighbors);
+
+            std::vector<InstanceData> aInstanceData;
+            chunk.BuildInstanceData(apNeighbors, aInstanceData);
+
+            it->boundingBox = chunk.GetBoundingBox();
+            chunk.BuildOccluders(it->aOccluders);
+            return it->aVoxels.front()->UpdateInstanceData(pDevice, pImmediateContext, std::move(aInstanceData));
+        }
+
+        removeChunkMesh(chunk);
+
+        size_t uNumChunkMeshes = m_aChunkMeshes.size();
+        buildChunkMesh(chunk);
+        if (m_aChunkMeshes.size() == uNumChunkMeshes)
+        {
+            return S_OK;
+        }
+
+        HRESULT hr = S_OK;
+        for (const std::shared_ptr<Voxel>& voxel : m_aChunkMeshes.back().aVoxels)
+        {
+            hr = voxel->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        for (const std::shared_ptr<VoxelMesh>& voxelMesh : m_aChunkMeshes.back().aMeshes)
+        {
+            hr = voxelMesh->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        return S_OK;
     }
 }
\ No newline at end of file
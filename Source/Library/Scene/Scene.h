@@ -13,19 +13,51 @@
 
 #include "Common.h"
 
-#include <fstream>
-
 #include "Renderer/Renderable.h"
+#include "Scene/ChunkStore.h"
+#include "Scene/SceneFile.h"
+#include "Scene/TerrainStreamer.h"
 #include "Scene/Voxel.h"
+#include "Scene/VoxelMesh.h"
 
 namespace library
 {
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eVoxelMesher
+
+        Summary:  Enumeration of the ways a scene turns its chunks into
+                  GPU data
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eVoxelMesher
+    {
+        INSTANCED,
+        GREEDY,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   ChunkMesh
+
+        Summary:  GPU data of a chunk, the world bounding box of its
+                  blocks and the solid boxes hiding what is behind it.
+                  The instanced mesher gives one voxel holding the
+                  blocks of every type, the greedy mesher one or more
+                  meshes per block type
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ChunkMesh
+    {
+        const Chunk* pChunk;
+        BoundingBox boundingBox;
+        std::vector<BoundingBox> aOccluders;
+        std::vector<std::shared_ptr<Voxel>> aVoxels;
+        std::vector<std::shared_ptr<VoxelMesh>> aMeshes;
+    };
+
     class Scene
     {
     public:
-        static FLOAT GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth);
-
-        Scene(const std::filesystem::path& filePath);
+        Scene(const std::filesystem::path& filePath, eVoxelMesher mesher);
+        Scene(const SceneData& sceneData, eVoxelMesher mesher);
+        Scene(std::unique_ptr<TerrainStreamer>&& terrainStreamer, const std::vector<XMFLOAT4>& aColors, const XMFLOAT3& origin, eVoxelMesher mesher);
         Scene(const Scene& other) = delete;
         Scene(Scene&& other) = delete;
         Scene& operator=(const Scene& other) = delete;
@@ -33,36 +65,53 @@ namespace library
         virtual ~Scene() = default;
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        HRESULT Update(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const XMVECTOR& eye);
+
+        void SetBlock(_In_ INT x, _In_ INT y, _In_ INT z, _In_ eBlockType blockType);
+        void ClearBlock(_In_ INT x, _In_ INT y, _In_ INT z);
+        void SetBlocks(_In_ const XMINT3& minBlock, _In_ const XMINT3& maxBlock, _In_ eBlockType blockType);
+
+        BOOL CastRay(_In_ const VoxelRay& ray, _Out_ VoxelRayHit& outHit) const;
+        void CastRays(_In_ const std::vector<VoxelRay>& aRays, _Out_ std::vector<VoxelRayHit>& aOutHits) const;
+        void MoveBox(_In_ const BoundingBox& box, _In_ const XMFLOAT3& movement, _In_ FLOAT stepHeight, _Out_ VoxelMove& outMove) const;
+
+        void SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader);
+        void SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader);
 
         std::vector<std::shared_ptr<Voxel>>& GetVoxels();
+        std::vector<std::shared_ptr<VoxelMesh>>& GetVoxelMeshes();
+        std::vector<ChunkMesh>& GetChunkMeshes();
+        const ChunkStore& GetChunkStore() const;
+        const TerrainStreamer* GetTerrainStreamer() const;
+        ComPtr<ID3D11Buffer>& GetBlockColorsConstantBuffer();
         const std::filesystem::path& GetFilePath() const;
         PCWSTR GetFileName() const;
+        eVoxelMesher GetMesher() const;
 
     private:
-        static FLOAT getNoise2(UINT x, UINT y);
-        static FLOAT getNoise2d(FLOAT x, FLOAT y);
-        static FLOAT lerp(FLOAT x, FLOAT y, FLOAT s);
-        static FLOAT smoothLerp(FLOAT x, FLOAT y, FLOAT s);
+        void load(_In_ const SceneData& sceneData);
 
-    private:
-        static constexpr const UINT ms_aHashes[] =
-        {
-            208,34,231,213,32,248,233,56,161,78,24,140,71,48,140,254,245,255,247,247,40,
-            185,248,251,245,28,124,204,204,76,36,1,107,28,234,163,202,224,245,128,167,204,
-            9,92,217,54,239,174,173,102,193,189,190,121,100,108,167,44,43,77,180,204,8,81,
-            70,223,11,38,24,254,210,210,177,32,81,195,243,125,8,169,112,32,97,53,195,13,
-            203,9,47,104,125,117,114,124,165,203,181,235,193,206,70,180,174,0,167,181,41,
-            164,30,116,127,198,245,146,87,224,149,206,57,4,192,210,65,210,129,240,178,105,
-            228,108,245,148,140,40,35,195,38,58,65,207,215,253,65,85,208,76,62,3,237,55,89,
-            232,50,217,64,244,157,199,121,252,90,17,212,203,149,152,140,187,234,177,73,174,
-            193,100,192,143,97,53,145,135,19,103,13,90,135,151,199,91,239,247,33,39,145,
-            101,120,99,3,186,86,99,41,237,203,111,79,220,135,158,42,30,154,120,67,87,167,
-            135,176,183,191,253,115,184,21,233,58,129,233,142,39,128,211,118,137,139,255,
-            114,20,218,113,154,27,127,246,250,1,8,198,250,209,92,222,173,21,88,102,219
-        };
+        void streamChunks(_In_ const XMVECTOR& eye);
+        void markChunkDirty(_In_ INT iChunkX, _In_ INT iChunkZ);
+        void markNeighborsDirty(_In_ INT iChunkX, _In_ INT iChunkZ);
+        HRESULT rebuildDirtyChunks(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+
+        void buildChunkMesh(_In_ const Chunk& chunk);
+        void removeChunkMesh(_In_ const Chunk& chunk);
+        HRESULT rebuildChunkMesh(_In_ const Chunk& chunk, _In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
     private:
         std::filesystem::path m_filePath;
+        eVoxelMesher m_mesher;
         std::vector<std::shared_ptr<Voxel>> m_voxels;
+        std::vector<std::shared_ptr<VoxelMesh>> m_voxelMeshes;
+        std::vector<XMFLOAT4> m_aColors;
+        ComPtr<ID3D11Buffer> m_cbBlockColors;
+        ChunkStore m_chunkStore;
+        std::vector<ChunkMesh> m_aChunkMeshes;
+        std::unique_ptr<TerrainStreamer> m_terrainStreamer;
+        std::shared_ptr<VertexShader> m_vertexShader;
+        std::shared_ptr<PixelShader> m_pixelShader;
+        std::unordered_set<UINT64> m_dirtyChunks;
     };
 }
\ No newline at end of file
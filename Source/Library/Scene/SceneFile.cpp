@@ -0,0 +1,514 @@
+#include "Scene/SceneFile.h"
+
+#include <cwctype>
+#include <fstream>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT32 SCENE_MAGIC = 0x53584F56u; // "VOXS"
+        constexpr const UINT32 SCENE_VERSION = 1u;
+
+        constexpr const UINT32 SCENE_FLAG_16BIT_HEIGHTS = 0x1u;
+        constexpr const UINT32 SCENE_FLAG_RLE_BLOCK_TYPES = 0x2u;
+
+        constexpr const UINT NUM_BLOCK_TYPES = static_cast<UINT>(eBlockType::COUNT) - static_cast<UINT>(eBlockType::GRASSLAND);
+        constexpr const UINT MAX_SCENE_SIZE = 16384u;
+
+#pragma pack(push, 1)
+        struct SceneFileHeader
+        {
+            UINT32 uMagic;
+            UINT32 uVersion;
+            UINT32 uFlags;
+            UINT32 uWidth;
+            UINT32 uHeight;
+            UINT32 uDepth;
+            UINT32 uNumColors;
+            UINT32 uBlockTypeSize;
+        };
+#pragma pack(pop)
+
+#ifdef _WIN32
+        struct HandleCloser
+        {
+            void operator()(HANDLE hHandle) const
+            {
+                if (hHandle)
+                    CloseHandle(hHandle);
+            }
+        };
+
+        struct ViewUnmapper
+        {
+            void operator()(const void* pView) const
+            {
+                if (pView)
+                    UnmapViewOfFile(pView);
+            }
+        };
+
+        using ScopedHandle = std::unique_ptr<void, HandleCloser>;
+        using ScopedMappedView = std::unique_ptr<const void, ViewUnmapper>;
+#endif // _WIN32
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneFile::IsBinaryFile
+
+      Summary:  Returns whether the path names a binary scene file
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the scene file
+
+      Returns:  BOOL
+                  True if the extension is .vxs, in any case
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL SceneFile::IsBinaryFile(_In_ const std::filesystem::path& filePath)
+    {
+        std::wstring extension = filePath.extension().wstring();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](WCHAR c)
+            {
+                return static_cast<WCHAR>(std::towlower(c));
+            }
+        );
+
+        return extension == L".vxs";
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneFile::Read
+
+      Summary:  Reads a scene file in the format given by its extension
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the scene file
+                SceneData& outSceneData
+                  Columns of the scene
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SceneFile::Read(_In_ const std::filesystem::path& filePath, _Out_ SceneData& outSceneData)
+    {
+        if (IsBinaryFile(filePath))
+            return ReadBinary(filePath, outSceneData);
+
+        return ReadText(filePath, outSceneData);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneFile::ReadBinary
+
+      Summary:  Maps a binary scene file read-only and decodes its
+                columns straight from the mapped view. Off Windows the
+                file is read into memory whole instead
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the binary scene file
+                SceneData& outSceneData
+                  Columns of the scene
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SceneFile::ReadBinary(_In_ const std::filesystem::path& filePath, _Out_ SceneData& outSceneData)
+    {
+        outSceneData = SceneData();
+
+#ifdef _WIN32
+        HANDLE hRawFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        ScopedHandle hFile(hRawFile == INVALID_HANDLE_VALUE ? nullptr : hRawFile);
+        if (!hFile)
+            return HRESULT_FROM_WIN32(GetLastError());
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(hFile.get(), &fileSize))
+            return HRESULT_FROM_WIN32(GetLastError());
+
+        if (fileSize.QuadPart < static_cast<LONGLONG>(sizeof(SceneFileHeader)))
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+        ScopedHandle hMapping(CreateFileMappingW(hFile.get(), nullptr, PAGE_READONLY, 0u, 0u, nullptr));
+        if (!hMapping)
+            return HRESULT_FROM_WIN32(GetLastError());
+
+        ScopedMappedView view(MapViewOfFile(hMapping.get(), FILE_MAP_READ, 0u, 0u, 0u));
+        if (!view)
+            return HRESULT_FROM_WIN32(GetLastError());
+
+        return ReadBinaryData(std::span<const BYTE>(static_cast<const BYTE*>(view.get()), static_cast<size_t>(fileSize.QuadPart)), outSceneData);
+#else // _WIN32
+        std::ifstream inputFile(filePath, std::ios::binary | std::ios::ate);
+        if (!inputFile.is_open())
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+
+        std::vector<BYTE> aData(static_cast<size_t>(inputFile.tellg()));
+        inputFile.seekg(0);
+        inputFile.read(reinterpret_cast<CHAR*>(aData.data()), static_cast<std::streamsize>(aData.size()));
+        if (!inputFile)
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+
+        return ReadBinaryData(aData, outSceneData);
+#endif // _WIN32
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneFile::ReadText
+
+      Summary:  Reads a text scene file made of the width, height, depth
+                and number of colors, the colors, and a block type
+                character followed by a height in [0, 1] per column.
+                Unreadable tokens are skipped
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the text scene file
+                SceneData& outSceneData
+                  Columns of the scene
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SceneFile::ReadText(_In_ const std::filesystem::path& filePath, _Out_ SceneData& outSceneData)
+    {
+        outSceneData = SceneData();
+
+        std::ifstream inputFile(filePath);
+        if (!inputFile.is_open())
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+
+        std::string trash;
+        UINT aDimension[4] = { 0u, };
+        UINT uDimensionIdx = 0u;
+        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        {
+            inputFile >> aDimension[uDimensionIdx];
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                    break;
+
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+                ++uDimensionIdx;
+        }
+
+        if (uDimensionIdx < ARRAYSIZE(aDimension)
+            || aDimension[0] == 0u || aDimension[0] > MAX_SCENE_SIZE
+            || aDimension[2] == 0u || aDimension[2] > MAX_SCENE_SIZE)
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+        XMFLOAT4 color;
+        while (!inputFile.eof() && outSceneData.aColors.size() < aDimension[3])
+        {
+            inputFile >> color.x >> color.y >> color.z;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                    break;
+
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                color.w = 1.0f;
+                outSceneData.aColors.push_back(color);
+            }
+        }
+
+        size_t uNumColumns = static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[2]);
+
+        outSceneData.uWidth = aDimension[0];
+        outSceneData.uHeight = aDimension[1];
+        outSceneData.uDepth = aDimension[2];
+        outSceneData.aBlockTypes.assign(uNumColumns, eBlockType::GRASSLAND);
+        outSceneData.aColumnHeights.assign(uNumColumns, 0u);
+
+        size_t uColumnIdx = 0u;
+        CHAR voxelType;
+        FLOAT height;
+        while (!inputFile.eof())
+        {
+            inputFile >> voxelType >> height;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                    break;
+
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
+            {
+                // Columns past the end of the map wrap around to the first row
+                FLOAT numBlocks = std::min<FLOAT>(static_cast<FLOAT>(aDimension[1]) * height, 65535.0f);
+
+                outSceneData.aBlockTypes[uColumnIdx] = static_cast<eBlockType>(voxelType);
+                outSceneData.aColumnHeights[uColumnIdx] = numBlocks > 0.0f ? static_cast<WORD>(numBlocks) : 0u;
+                uColumnIdx = (uColumnIdx + 1u) % uNumColumns;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneFile::Write
+
+      Summary:  Writes a binary scene file. Heights take 16 bits only
+                when a column is taller than 255 blocks, and block types
+                are run-length encoded when asked to and smaller
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the binary scene file
+                const SceneData& sceneData
+                  Columns of the scene
+                BOOL bCompress
+                  Whether to run-length encode the block types
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SceneFile::Write(_In_ const std::filesystem::path& filePath, _In_ const SceneData& sceneData, _In_ BOOL bCompress)
+    {
+        size_t uNumColumns = static_cast<size_t>(sceneData.uWidth) * static_cast<size_t>(sceneData.uDepth);
+
+        if (sceneData.uWidth == 0u || sceneData.uWidth > MAX_SCENE_SIZE
+            || sceneData.uDepth == 0u || sceneData.uDepth > MAX_SCENE_SIZE
+            || sceneData.aColors.size() > NUM_BLOCK_TYPES
+            || sceneData.aBlockTypes.size() != uNumColumns
+            || sceneData.aColumnHeights.size() != uNumColumns)
+            return E_INVALIDARG;
+
+        // Block types are stored as palette indices
+        std::vector<BYTE> aBlockTypeData(uNumColumns);
+        for (size_t i = 0u; i < uNumColumns; ++i)
+        {
+            INT iPaletteIdx = static_cast<INT>(sceneData.aBlockTypes[i]) - static_cast<INT>(eBlockType::GRASSLAND);
+            if (iPaletteIdx < 0 || iPaletteIdx >= static_cast<INT>(sceneData.aColors.size()))
+                return E_INVALIDARG;
+
+            aBlockTypeData[i] = static_cast<BYTE>(iPaletteIdx);
+        }
+
+        UINT32 uFlags = 0u;
+        if (bCompress)
+        {
+            std::vector<BYTE> aEncodedData;
+            encodeBlockTypes(aBlockTypeData, aEncodedData);
+
+            if (aEncodedData.size() < aBlockTypeData.size())
+            {
+                aBlockTypeData = std::move(aEncodedData);
+                uFlags |= SCENE_FLAG_RLE_BLOCK_TYPES;
+            }
+        }
+
+        WORD uMaxHeight = *std::max_element(sceneData.aColumnHeights.begin(), sceneData.aColumnHeights.end());
+        if (uMaxHeight > 0xFFu)
+            uFlags |= SCENE_FLAG_16BIT_HEIGHTS;
+
+        SceneFileHeader header =
+        {
+            .uMagic = SCENE_MAGIC,
+            .uVersion = SCENE_VERSION,
+            .uFlags = uFlags,
+            .uWidth = sceneData.uWidth,
+            .uHeight = sceneData.uHeight,
+            .uDepth = sceneData.uDepth,
+            .uNumColors = static_cast<UINT32>(sceneData.aColors.size()),
+            .uBlockTypeSize = static_cast<UINT32>(aBlockTypeData.size()),
+        };
+
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+            return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+
+        outputFile.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+
+        for (const XMFLOAT4& color : sceneData.aColors)
+            outputFile.write(reinterpret_cast<const CHAR*>(&color), sizeof(FLOAT) * 3u);
+
+        outputFile.write(reinterpret_cast<const CHAR*>(aBlockTypeData.data()), static_cast<std::streamsize>(aBlockTypeData.size()));
+
+        if (uFlags & SCENE_FLAG_16BIT_HEIGHTS)
+            outputFile.write(reinterpret_cast<const CHAR*>(sceneData.aColumnHeights.data()), static_cast<std::streamsize>(uNumColumns * sizeof(WORD)));
+        else
+        {
+            std::vector<BYTE> aHeights(sceneData.aColumnHeights.begin(), sceneData.aColumnHeights.end());
+            outputFile.write(reinterpret_cast<const CHAR*>(aHeights.data()), static_cast<std::streamsize>(aHeights.size()));
+        }
+
+        if (!outputFile)
+            return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneFile::ConvertTextFile
+
+      Summary:  Converts a text scene file into a binary scene file
+
+      Args:     const std::filesystem::path& textFilePath
+                  Path to the text scene file
+                const std::filesystem::path& binaryFilePath
+                  Path to the binary scene file to write
+                BOOL bCompress
+                  Whether to run-length encode the block types
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SceneFile::ConvertTextFile(_In_ const std::filesystem::path& textFilePath, _In_ const std::filesystem::path& binaryFilePath, _In_ BOOL bCompress)
+    {
+        SceneData sceneData;
+
+        HRESULT hr = ReadText(textFilePath, sceneData);
+        if (FAILED(hr))
+            return hr;
+
+        return Write(binaryFilePath, sceneData, bCompress);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneFile::ReadBinaryData
+
+      Summary:  Validates and decodes the contents of a binary scene
+                file. Nothing is read past the end of the contents
+
+      Args:     std::span<const BYTE> data
+                  Contents of the file
+                SceneData& outSceneData
+                  Columns of the scene
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SceneFile::ReadBinaryData(_In_ std::span<const BYTE> data, _Out_ SceneData& outSceneData)
+    {
+        const HRESULT hrInvalidScene = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+        outSceneData = SceneData();
+
+        if (data.size() < sizeof(SceneFileHeader))
+            return hrInvalidScene;
+
+        SceneFileHeader header;
+        memcpy(&header, data.data(), sizeof(header));
+
+        if (header.uMagic != SCENE_MAGIC || header.uVersion != SCENE_VERSION
+            || header.uWidth == 0u || header.uWidth > MAX_SCENE_SIZE
+            || header.uDepth == 0u || header.uDepth > MAX_SCENE_SIZE
+            || header.uNumColors > NUM_BLOCK_TYPES)
+            return hrInvalidScene;
+
+        BOOL bIs16BitHeights = (header.uFlags & SCENE_FLAG_16BIT_HEIGHTS) != 0u;
+        BOOL bIsRle = (header.uFlags & SCENE_FLAG_RLE_BLOCK_TYPES) != 0u;
+
+        size_t uNumColumns = static_cast<size_t>(header.uWidth) * static_cast<size_t>(header.uDepth);
+        size_t uPaletteSize = static_cast<size_t>(header.uNumColors) * sizeof(FLOAT) * 3u;
+        size_t uHeightSize = uNumColumns * (bIs16BitHeights ? sizeof(WORD) : sizeof(BYTE));
+
+        if (!bIsRle && header.uBlockTypeSize != uNumColumns)
+            return hrInvalidScene;
+
+        if (data.size() < sizeof(header) + uPaletteSize + header.uBlockTypeSize + uHeightSize)
+            return hrInvalidScene;
+
+        const BYTE* pPalette = data.data() + sizeof(header);
+        const BYTE* pBlockTypes = pPalette + uPaletteSize;
+        const BYTE* pHeights = pBlockTypes + header.uBlockTypeSize;
+
+        outSceneData.uWidth = header.uWidth;
+        outSceneData.uHeight = header.uHeight;
+        outSceneData.uDepth = header.uDepth;
+
+        outSceneData.aColors.resize(header.uNumColors);
+        for (UINT i = 0u; i < header.uNumColors; ++i)
+        {
+            memcpy(&outSceneData.aColors[i], pPalette + static_cast<size_t>(i) * sizeof(FLOAT) * 3u, sizeof(FLOAT) * 3u);
+            outSceneData.aColors[i].w = 1.0f;
+        }
+
+        // Palette indices are decoded first and turned into block types once validated
+        std::vector<BYTE> aPaletteIndices;
+        if (bIsRle)
+        {
+            if (header.uBlockTypeSize % 2u != 0u)
+                return hrInvalidScene;
+
+            aPaletteIndices.reserve(uNumColumns);
+            for (size_t i = 0u; i < header.uBlockTypeSize; i += 2u)
+            {
+                BYTE uRunLength = pBlockTypes[i];
+                if (uRunLength == 0u || aPaletteIndices.size() + uRunLength > uNumColumns)
+                    return hrInvalidScene;
+
+                aPaletteIndices.insert(aPaletteIndices.end(), uRunLength, pBlockTypes[i + 1u]);
+            }
+
+            if (aPaletteIndices.size() != uNumColumns)
+                return hrInvalidScene;
+        }
+        else
+            aPaletteIndices.assign(pBlockTypes, pBlockTypes + uNumColumns);
+
+        outSceneData.aBlockTypes.resize(uNumColumns);
+        for (size_t i = 0u; i < uNumColumns; ++i)
+        {
+            if (aPaletteIndices[i] >= header.uNumColors)
+                return hrInvalidScene;
+
+            outSceneData.aBlockTypes[i] = static_cast<eBlockType>(static_cast<UINT>(eBlockType::GRASSLAND) + aPaletteIndices[i]);
+        }
+
+        outSceneData.aColumnHeights.resize(uNumColumns);
+        if (bIs16BitHeights)
+            memcpy(outSceneData.aColumnHeights.data(), pHeights, uNumColumns * sizeof(WORD));
+        else
+            std::copy(pHeights, pHeights + uNumColumns, outSceneData.aColumnHeights.begin());
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SceneFile::encodeBlockTypes
+
+      Summary:  Run-length encodes palette indices as pairs of a run
+                length up to 255 and a palette index
+
+      Args:     const std::vector<BYTE>& aPaletteIndices
+                  Palette index of every column
+                std::vector<BYTE>& aOutData
+                  Encoded runs
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SceneFile::encodeBlockTypes(_In_ const std::vector<BYTE>& aPaletteIndices, _Out_ std::vector<BYTE>& aOutData)
+    {
+        aOutData.clear();
+
+        size_t i = 0u;
+        while (i < aPaletteIndices.size())
+        {
+            BYTE uPaletteIdx = aPaletteIndices[i];
+            BYTE uRunLength = 0u;
+
+            while (i < aPaletteIndices.size() && aPaletteIndices[i] == uPaletteIdx && uRunLength < 0xFFu)
+            {
+                ++uRunLength;
+                ++i;
+            }
+
+            aOutData.push_back(uRunLength);
+            aOutData.push_back(uPaletteIdx);
+        }
+    }
+}
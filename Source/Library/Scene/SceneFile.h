@@ -0,0 +1,86 @@
+/*+===================================================================
+  File:      SCENEFILE.H
+
+  Summary:   SceneFile header file contains declaration of class
+             SceneFile used to read and write voxel scene files.
+
+  Classes:  SceneFile
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   SceneData
+
+        Summary:  Columns of a voxel scene. Columns are stored row by
+                  row, x first, and a column of height h holds h blocks
+                  of its block type stacked from the bottom
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SceneData
+    {
+        UINT uWidth;
+        UINT uHeight;
+        UINT uDepth;
+        std::vector<XMFLOAT4> aColors;
+        std::vector<eBlockType> aBlockTypes;
+        std::vector<WORD> aColumnHeights;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SceneFile
+
+      Summary:  Reads and writes voxel scenes. The binary format starts
+                with a header holding the dimensions and the palette,
+                followed by one byte of block type and an 8 or 16-bit
+                height per column. Block types can be run-length
+                encoded. Binary files are read through a read-only file
+                mapping on Windows and read whole elsewhere, then decoded
+                from memory by ReadBinaryData. The text format of the
+                labs can still be read and converted
+
+      Methods:  IsBinaryFile
+                  Returns whether a path names a binary scene file
+                Read
+                  Reads a binary or text scene file
+                ReadBinary
+                  Reads a binary scene file
+                ReadBinaryData
+                  Decodes the contents of a binary scene file
+                ReadText
+                  Reads a text scene file
+                Write
+                  Writes a binary scene file
+                ConvertTextFile
+                  Converts a text scene file into a binary one
+                SceneFile
+                  Constructor.
+                ~SceneFile
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SceneFile final
+    {
+    public:
+        SceneFile() = delete;
+        SceneFile(const SceneFile& other) = delete;
+        SceneFile(SceneFile&& other) = delete;
+        SceneFile& operator=(const SceneFile& other) = delete;
+        SceneFile& operator=(SceneFile&& other) = delete;
+        ~SceneFile() = delete;
+
+        static BOOL IsBinaryFile(_In_ const std::filesystem::path& filePath);
+        static HRESULT Read(_In_ const std::filesystem::path& filePath, _Out_ SceneData& outSceneData);
+        static HRESULT ReadBinary(_In_ const std::filesystem::path& filePath, _Out_ SceneData& outSceneData);
+        static HRESULT ReadBinaryData(_In_ std::span<const BYTE> data, _Out_ SceneData& outSceneData);
+        static HRESULT ReadText(_In_ const std::filesystem::path& filePath, _Out_ SceneData& outSceneData);
+        static HRESULT Write(_In_ const std::filesystem::path& filePath, _In_ const SceneData& sceneData, _In_ BOOL bCompress);
+        static HRESULT ConvertTextFile(_In_ const std::filesystem::path& textFilePath, _In_ const std::filesystem::path& binaryFilePath, _In_ BOOL bCompress);
+
+    private:
+        static void encodeBlockTypes(_In_ const std::vector<BYTE>& aPaletteIndices, _Out_ std::vector<BYTE>& aOutData);
+    };
+}
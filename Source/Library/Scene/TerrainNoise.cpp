@@ -0,0 +1,377 @@
+#include "Scene/TerrainNoise.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::GetPerlin2d
+
+      Summary:  Returns the sum of octaves of value noise at a point,
+                each at twice the frequency and half the amplitude of
+                the previous one. The hashes change from one tile of
+                TILE_SIZE units of x and y to the next
+
+      Args:     FLOAT x, y
+                  Point to sample, not negative
+                FLOAT frequency
+                  Frequency of the first octave
+                UINT uDepth
+                  Number of octaves
+
+      Returns:  FLOAT
+                  Noise between 0 and 1
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainNoise::GetPerlin2d(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT frequency, _In_ UINT uDepth)
+    {
+        FLOAT xa = x * frequency;
+        FLOAT ya = y * frequency;
+        FLOAT amp = 1.0f;
+        FLOAT fin = 0.0f;
+        FLOAT div = 0.0f;
+        UINT uTileSize = getTileSize(frequency);
+
+        for (UINT i = 0; i < uDepth; ++i)
+        {
+            div += 256.0f * amp;
+            fin += getNoise2d(xa, ya, uTileSize) * amp;
+            amp /= 2.0f;
+            xa *= 2.0f;
+            ya *= 2.0f;
+            uTileSize *= 2u;
+        }
+
+        return fin / div;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::GetPerlin2dVector
+
+      Summary:  Returns GetPerlin2d at four points at once
+
+      Args:     FXMVECTOR x, y
+                  Coordinates of the four points to sample, not negative
+                FLOAT frequency
+                  Frequency of the first octave
+                UINT uDepth
+                  Number of octaves
+
+      Returns:  XMVECTOR
+                  Noise between 0 and 1 of each point
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR XM_CALLCONV TerrainNoise::GetPerlin2dVector(_In_ FXMVECTOR x, _In_ FXMVECTOR y, _In_ FLOAT frequency, _In_ UINT uDepth)
+    {
+        XMVECTOR xa = XMVectorScale(x, frequency);
+        XMVECTOR ya = XMVectorScale(y, frequency);
+        FLOAT amp = 1.0f;
+        XMVECTOR fin = XMVectorZero();
+        FLOAT div = 0.0f;
+        UINT uTileSize = getTileSize(frequency);
+
+        for (UINT i = 0; i < uDepth; ++i)
+        {
+            div += 256.0f * amp;
+            fin = XMVectorAdd(fin, XMVectorScale(getNoise2dVector(xa, ya, uTileSize), amp));
+            amp /= 2.0f;
+            xa = XMVectorAdd(xa, xa);
+            ya = XMVectorAdd(ya, ya);
+            uTileSize *= 2u;
+        }
+
+        return XMVectorDivide(fin, XMVectorReplicate(div));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::GetTerrainNoise
+
+      Summary:  Returns the terrain height of a column, one sample at a
+                time. Generate gives the same heights for whole grids
+
+      Args:     INT x, z
+                  Block coordinates of the column
+
+      Returns:  FLOAT
+                  Terrain height, 0 at sea bottom
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainNoise::GetTerrainNoise(_In_ INT x, _In_ INT z)
+    {
+        FLOAT wrappedX = wrap(x);
+        FLOAT wrappedZ = wrap(z);
+
+        FLOAT value = 0.0f;
+        FLOAT frequencySum = 0.0f;
+        for (UINT i = 0; i < 4; ++i)
+        {
+            FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
+            frequencySum += 1.0f / frequency;
+
+            // Scaling the frequency by a power of two rounds the same as scaling the coordinates, and keeps the tiles in blocks
+            value += GetPerlin2d(wrappedX, wrappedZ, 0.1f * frequency, 4u) / frequency;
+        }
+        value /= frequencySum;
+
+        return pow(value * 1.2f, 1.25f);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::Generate
+
+      Summary:  Fills a grid with the terrain height of its columns.
+                Rows are generated in tiles of TILE_ROWS in parallel,
+                and four columns at a time within a row
+
+      Args:     INT iOriginX, iOriginZ
+                  Block coordinates of the first column
+                UINT uWidth, uDepth
+                  Number of columns along x and z
+                std::vector<FLOAT>& aOutValues
+                  Terrain heights, rows along x are contiguous
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainNoise::Generate(_In_ INT iOriginX, _In_ INT iOriginZ, _In_ UINT uWidth, _In_ UINT uDepth, _Out_ std::vector<FLOAT>& aOutValues)
+    {
+        aOutValues.resize(static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth));
+
+        std::vector<UINT> aTiles((uDepth + TILE_ROWS - 1u) / TILE_ROWS);
+        std::iota(aTiles.begin(), aTiles.end(), 0u);
+
+        std::for_each(
+            std::execution::par,
+            aTiles.begin(),
+            aTiles.end(),
+            [iOriginX, iOriginZ, uWidth, uDepth, &aOutValues](UINT uTile)
+            {
+                const XMVECTOR laneOffsets = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+                const XMVECTOR period = XMVectorReplicate(static_cast<FLOAT>(PERIOD));
+                UINT uLastRow = std::min<UINT>((uTile + 1u) * TILE_ROWS, uDepth);
+
+                for (UINT z = uTile * TILE_ROWS; z < uLastRow; ++z)
+                {
+                    FLOAT* pRow = aOutValues.data() + static_cast<size_t>(z) * static_cast<size_t>(uWidth);
+                    XMVECTOR vZ = XMVectorReplicate(wrap(iOriginZ + static_cast<INT>(z)));
+
+                    for (UINT x = 0u; x < uWidth; x += 4u)
+                    {
+                        XMVECTOR vX = XMVectorAdd(XMVectorReplicate(wrap(iOriginX + static_cast<INT>(x))), laneOffsets);
+                        vX = XMVectorSubtract(vX, XMVectorAndInt(XMVectorGreaterOrEqual(vX, period), period));
+
+                        XMVECTOR value = XMVectorZero();
+                        FLOAT frequencySum = 0.0f;
+                        for (UINT i = 0; i < 4; ++i)
+                        {
+                            FLOAT frequency = static_cast<FLOAT>(1u << i);
+                            frequencySum += 1.0f / frequency;
+                            value = XMVectorAdd(value, XMVectorScale(GetPerlin2dVector(vX, vZ, 0.1f * frequency, 4u), 1.0f / frequency));
+                        }
+                        value = XMVectorScale(value, 1.0f / frequencySum);
+                        value = XMVectorPow(XMVectorScale(value, 1.2f), XMVectorReplicate(1.25f));
+
+                        XMFLOAT4 values;
+                        XMStoreFloat4(&values, value);
+
+                        const FLOAT aValues[4] = { values.x, values.y, values.z, values.w };
+                        std::copy_n(aValues, std::min<UINT>(4u, uWidth - x), pRow + x);
+                    }
+                }
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::getNoise2
+
+      Summary:  Returns the hash of a lattice point from the table of
+                the labs. The first tile is hashed as the labs did;
+                every other tile of the period runs the hash through
+                the table once more, offset by the index of the tile
+
+      Args:     UINT x, y
+                  Lattice point
+                UINT uTileSize
+                  Lattice points along each side of a tile
+
+      Returns:  FLOAT
+                  Hash between 0 and 255
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainNoise::getNoise2(_In_ UINT x, _In_ UINT y, _In_ UINT uTileSize)
+    {
+        UINT temp = ms_aHashes[y % 256u];
+        UINT uHash = ms_aHashes[(temp + x) % 256u];
+
+        // NUM_TILES * NUM_TILES is 256, so every tile has an offset of its own
+        UINT uTile = y / uTileSize % NUM_TILES * NUM_TILES + x / uTileSize % NUM_TILES;
+        if (uTile != 0u)
+        {
+            uHash = ms_aHashes[(uHash + uTile) % 256u];
+        }
+
+        return static_cast<FLOAT>(uHash);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::getNoise2d
+
+      Summary:  Returns the hashes of the four lattice points around a
+                point, smoothly interpolated
+
+      Args:     FLOAT x, y
+                  Point to sample, not negative
+                UINT uTileSize
+                  Lattice points along each side of a tile
+
+      Returns:  FLOAT
+                  Noise between 0 and 255
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainNoise::getNoise2d(_In_ FLOAT x, _In_ FLOAT y, _In_ UINT uTileSize)
+    {
+        UINT uX = static_cast<UINT>(x);
+        UINT uY = static_cast<UINT>(y);
+        FLOAT xFrac = x - static_cast<FLOAT>(uX);
+        FLOAT yFrac = y - static_cast<FLOAT>(uY);
+
+        UINT s = static_cast<UINT>(getNoise2(uX, uY, uTileSize));
+        UINT t = static_cast<UINT>(getNoise2(uX + 1u, uY, uTileSize));
+        UINT u = static_cast<UINT>(getNoise2(uX, uY + 1u, uTileSize));
+        UINT v = static_cast<UINT>(getNoise2(uX + 1u, uY + 1u, uTileSize));
+
+        FLOAT low = smoothLerp(static_cast<FLOAT>(s), static_cast<FLOAT>(t), xFrac);
+        FLOAT high = smoothLerp(static_cast<FLOAT>(u), static_cast<FLOAT>(v), xFrac);
+
+        return smoothLerp(low, high, yFrac);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::lerp
+
+      Summary:  Linearly interpolates between two values
+
+      Args:     FLOAT x, y
+                  Values at 0 and 1
+                FLOAT s
+                  Interpolation factor
+
+      Returns:  FLOAT
+                  Interpolated value
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainNoise::lerp(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT s)
+    {
+        return x + s * (y - x);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::smoothLerp
+
+      Summary:  Interpolates between two values along a smoothstep
+
+      Args:     FLOAT x, y
+                  Values at 0 and 1
+                FLOAT s
+                  Interpolation factor
+
+      Returns:  FLOAT
+                  Interpolated value
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainNoise::smoothLerp(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT s)
+    {
+        return lerp(x, y, s * s * (3.0f - 2.0f * s));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::getNoise2dVector
+
+      Summary:  Returns getNoise2d at four points at once
+
+      Args:     FXMVECTOR x, y
+                  Coordinates of the four points, not negative
+                UINT uTileSize
+                  Lattice points along each side of a tile
+
+      Returns:  XMVECTOR
+                  Noise between 0 and 255 of each point
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR XM_CALLCONV TerrainNoise::getNoise2dVector(_In_ FXMVECTOR x, _In_ FXMVECTOR y, _In_ UINT uTileSize)
+    {
+        XMVECTOR xWhole = XMVectorTruncate(x);
+        XMVECTOR yWhole = XMVectorTruncate(y);
+        XMVECTOR xFrac = XMVectorSubtract(x, xWhole);
+        XMVECTOR yFrac = XMVectorSubtract(y, yWhole);
+
+        // XMStoreUInt4 converts the whole parts to integers itself
+        XMUINT4 xInt;
+        XMUINT4 yInt;
+        XMStoreUInt4(&xInt, xWhole);
+        XMStoreUInt4(&yInt, yWhole);
+
+        // The hash lookups are gathered one lane at a time
+        const UINT aX[4] = { xInt.x, xInt.y, xInt.z, xInt.w };
+        const UINT aY[4] = { yInt.x, yInt.y, yInt.z, yInt.w };
+        XMFLOAT4 aCorners[4];
+        FLOAT* apCorners[4] = { &aCorners[0].x, &aCorners[1].x, &aCorners[2].x, &aCorners[3].x };
+        for (UINT i = 0u; i < 4u; ++i)
+        {
+            apCorners[0][i] = getNoise2(aX[i], aY[i], uTileSize);
+            apCorners[1][i] = getNoise2(aX[i] + 1u, aY[i], uTileSize);
+            apCorners[2][i] = getNoise2(aX[i], aY[i] + 1u, uTileSize);
+            apCorners[3][i] = getNoise2(aX[i] + 1u, aY[i] + 1u, uTileSize);
+        }
+
+        XMVECTOR low = smoothLerpVector(XMLoadFloat4(&aCorners[0]), XMLoadFloat4(&aCorners[1]), xFrac);
+        XMVECTOR high = smoothLerpVector(XMLoadFloat4(&aCorners[2]), XMLoadFloat4(&aCorners[3]), xFrac);
+
+        return smoothLerpVector(low, high, yFrac);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::smoothLerpVector
+
+      Summary:  Returns smoothLerp of four values at once
+
+      Args:     FXMVECTOR x, y
+                  Values at 0 and 1
+                FXMVECTOR s
+                  Interpolation factors
+
+      Returns:  XMVECTOR
+                  Interpolated values
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR XM_CALLCONV TerrainNoise::smoothLerpVector(_In_ FXMVECTOR x, _In_ FXMVECTOR y, _In_ FXMVECTOR s)
+    {
+        XMVECTOR t = XMVectorMultiply(XMVectorMultiply(s, s), XMVectorNegativeMultiplySubtract(XMVectorReplicate(2.0f), s, XMVectorReplicate(3.0f)));
+
+        return XMVectorLerpV(x, y, t);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::wrap
+
+      Summary:  Wraps a block coordinate into one period of the noise,
+                so negative coordinates sample the same terrain
+
+      Args:     INT iCoord
+                  Block coordinate
+
+      Returns:  FLOAT
+                  Coordinate between 0 and PERIOD
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainNoise::wrap(_In_ INT iCoord)
+    {
+        constexpr const INT PERIOD_INT = static_cast<INT>(PERIOD);
+
+        return static_cast<FLOAT>((iCoord % PERIOD_INT + PERIOD_INT) % PERIOD_INT);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainNoise::getTileSize
+
+      Summary:  Returns the lattice points along each side of a tile
+                for the first octave at a frequency
+
+      Args:     FLOAT frequency
+                  Frequency of the first octave
+
+      Returns:  UINT
+                  TILE_SIZE units of x and y in lattice points, at
+                  least 1
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainNoise::getTileSize(_In_ FLOAT frequency)
+    {
+        return std::max<UINT>(static_cast<UINT>(static_cast<FLOAT>(TILE_SIZE) * frequency + 0.5f), 1u);
+    }
+}
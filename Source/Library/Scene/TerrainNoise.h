@@ -0,0 +1,95 @@
+/*+===================================================================
+  File:      TERRAINNOISE.H
+
+  Summary:   TerrainNoise header file contains declaration of class
+             TerrainNoise used to sample the value noise the voxel
+             terrain is generated from.
+
+  Classes:  TerrainNoise
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TerrainNoise
+
+      Summary:  Value noise of the labs, summed over octaves into the
+                height of the terrain. GetTerrainNoise samples a single
+                column and is the reference; Generate fills a grid of
+                columns four at a time with DirectXMath, in tiles of
+                rows processed in parallel. Nothing here touches the
+                GPU. The hash table of the labs repeats every TILE_SIZE
+                blocks; each tile of the terrain past the first remaps
+                the table by an offset of its own, so the first tile is
+                the terrain the labs generated and the whole terrain
+                repeats every PERIOD blocks along x and z, that is 1280
+                chunks. Past a few periods the float positions of the
+                camera lose precision anyway
+
+      Methods:  GetPerlin2d
+                  Returns the octaves of noise at a point
+                GetPerlin2dVector
+                  Returns the octaves of noise at four points
+                GetTerrainNoise
+                  Returns the terrain height of a column
+                Generate
+                  Fills a grid with the terrain height of its columns
+                TerrainNoise
+                  Constructor.
+                ~TerrainNoise
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TerrainNoise final
+    {
+    public:
+        static constexpr const UINT TILE_ROWS = 16u;
+        // The 256-entry hash table wraps every TILE_SIZE blocks at the base frequency of 0.1
+        static constexpr const UINT TILE_SIZE = 2560u;
+        static constexpr const UINT NUM_TILES = 16u;
+        static constexpr const UINT PERIOD = TILE_SIZE * NUM_TILES;
+
+        TerrainNoise() = delete;
+        TerrainNoise(const TerrainNoise& other) = delete;
+        TerrainNoise(TerrainNoise&& other) = delete;
+        TerrainNoise& operator=(const TerrainNoise& other) = delete;
+        TerrainNoise& operator=(TerrainNoise&& other) = delete;
+        ~TerrainNoise() = delete;
+
+        static FLOAT GetPerlin2d(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT frequency, _In_ UINT uDepth);
+        static XMVECTOR XM_CALLCONV GetPerlin2dVector(_In_ FXMVECTOR x, _In_ FXMVECTOR y, _In_ FLOAT frequency, _In_ UINT uDepth);
+        static FLOAT GetTerrainNoise(_In_ INT x, _In_ INT z);
+        static void Generate(_In_ INT iOriginX, _In_ INT iOriginZ, _In_ UINT uWidth, _In_ UINT uDepth, _Out_ std::vector<FLOAT>& aOutValues);
+
+    private:
+        static FLOAT getNoise2(_In_ UINT x, _In_ UINT y, _In_ UINT uTileSize);
+        static FLOAT getNoise2d(_In_ FLOAT x, _In_ FLOAT y, _In_ UINT uTileSize);
+        static FLOAT lerp(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT s);
+        static FLOAT smoothLerp(_In_ FLOAT x, _In_ FLOAT y, _In_ FLOAT s);
+        static XMVECTOR XM_CALLCONV getNoise2dVector(_In_ FXMVECTOR x, _In_ FXMVECTOR y, _In_ UINT uTileSize);
+        static XMVECTOR XM_CALLCONV smoothLerpVector(_In_ FXMVECTOR x, _In_ FXMVECTOR y, _In_ FXMVECTOR s);
+        static FLOAT wrap(_In_ INT iCoord);
+        static UINT getTileSize(_In_ FLOAT frequency);
+
+    private:
+        static constexpr const UINT ms_aHashes[] =
+        {
+            208,34,231,213,32,248,233,56,161,78,24,140,71,48,140,254,245,255,247,247,40,
+            185,248,251,245,28,124,204,204,76,36,1,107,28,234,163,202,224,245,128,167,204,
+            9,92,217,54,239,174,173,102,193,189,190,121,100,108,167,44,43,77,180,204,8,81,
+            70,223,11,38,24,254,210,210,177,32,81,195,243,125,8,169,112,32,97,53,195,13,
+            203,9,47,104,125,117,114,124,165,203,181,235,193,206,70,180,174,0,167,181,41,
+            164,30,116,127,198,245,146,87,224,149,206,57,4,192,210,65,210,129,240,178,105,
+            228,108,245,148,140,40,35,195,38,58,65,207,215,253,65,85,208,76,62,3,237,55,89,
+            232,50,217,64,244,157,199,121,252,90,17,212,203,149,152,140,187,234,177,73,174,
+            193,100,192,143,97,53,145,135,19,103,13,90,135,151,199,91,239,247,33,39,145,
+            101,120,99,3,186,86,99,41,237,203,111,79,220,135,158,42,30,154,120,67,87,167,
+            135,176,183,191,253,115,184,21,233,58,129,233,142,39,128,211,118,137,139,255,
+            114,20,218,113,154,27,127,246,250,1,8,198,250,209,92,222,173,21,88,102,219
+        };
+    };
+}
@@ -0,0 +1,547 @@
+#include "Scene/TerrainStreamer.h"
+
+#include "Scene/TerrainNoise.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::TerrainStreamer
+
+      Summary:  Constructor. Starts the worker threads
+
+      Args:     UINT uRadius
+                  Radius in chunks of the disk of resident chunks
+                UINT uMaxChunks
+                  Most chunks resident or being generated at once
+                UINT uChunkHeight
+                  Number of blocks along y in a chunk
+                UINT uNumThreads
+                  Number of worker threads, at least one
+
+      Modifies: [m_uRadius, m_uMaxChunks, m_uChunkHeight, m_mutex,
+                 m_condition, m_aJobs, m_aCompleted, m_pending,
+                 m_uNumGenerated, m_uNumEvicted, m_lastGenerationTime,
+                 m_totalGenerationTime, m_aWorkers].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TerrainStreamer::TerrainStreamer(_In_ UINT uRadius, _In_ UINT uMaxChunks, _In_ UINT uChunkHeight, _In_ UINT uNumThreads)
+        : m_uRadius(uRadius)
+        , m_uMaxChunks(uMaxChunks)
+        , m_uChunkHeight(uChunkHeight)
+        , m_mutex()
+        , m_condition()
+        , m_aJobs()
+        , m_aCompleted()
+        , m_pending()
+        , m_uNumGenerated(0u)
+        , m_uNumEvicted(0u)
+        , m_lastGenerationTime(0.0f)
+        , m_totalGenerationTime(0.0f)
+        , m_aWorkers()
+    {
+        for (UINT i = 0u; i < std::max<UINT>(uNumThreads, 1u); ++i)
+            m_aWorkers.emplace_back([this](std::stop_token stopToken) { work(stopToken); });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::~TerrainStreamer
+
+      Summary:  Destructor. Stops the worker threads, which are joined
+                when they are destroyed
+
+      Modifies: [m_aWorkers].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TerrainStreamer::~TerrainStreamer()
+    {
+        for (std::jthread& worker : m_aWorkers)
+            worker.request_stop();
+
+        m_condition.notify_all();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetBlockType
+
+      Summary:  Returns the biome of a column
+
+      Args:     FLOAT height
+                  Terrain noise of the column
+                FLOAT moisture
+                  Moisture noise of the column
+
+      Returns:  eBlockType
+                  Block type of the column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eBlockType TerrainStreamer::GetBlockType(_In_ FLOAT height, _In_ FLOAT moisture)
+    {
+        eBlockType blockType = eBlockType::GRASSLAND;
+
+        if (height < 0.1f)
+        {
+            blockType = eBlockType::OCEAN;
+        }
+        else if (height < 0.12f)
+        {
+            blockType = eBlockType::SAND;
+        }
+        else if (height > 0.8f)
+        {
+            if (moisture < 0.1f)
+            {
+                blockType = eBlockType::SCORCHED;
+            }
+            else if (moisture < 0.2f)
+            {
+                blockType = eBlockType::BARE;
+            }
+            else if (moisture < 0.5f)
+            {
+                blockType = eBlockType::TUNDRA;
+            }
+            else
+            {
+                blockType = eBlockType::SNOW;
+            }
+        }
+        else if (height > 0.6f)
+        {
+            if (moisture < 0.33f)
+            {
+                blockType = eBlockType::TEMPERATE_DESERT;
+            }
+            else if (moisture < 0.66f)
+            {
+                blockType = eBlockType::SHRUBLAND;
+            }
+            else
+            {
+                blockType = eBlockType::TAIGA;
+            }
+        }
+        else if (height > 0.3f)
+        {
+            if (moisture < 0.16f)
+            {
+                blockType = eBlockType::TEMPERATE_DESERT;
+            }
+            else if (moisture < 0.5f)
+            {
+                blockType = eBlockType::GRASSLAND;
+            }
+            else if (moisture < 0.83f)
+            {
+                blockType = eBlockType::TEMPERATE_DECIDUOUS_FOREST;
+            }
+            else
+            {
+                blockType = eBlockType::TEMPERATE_RAIN_FOREST;
+            }
+        }
+        else
+        {
+            if (moisture < 0.16f)
+            {
+                blockType = eBlockType::SUBTROPICAL_DESERT;
+            }
+            else if (moisture < 0.33f)
+            {
+                blockType = eBlockType::GRASSLAND;
+            }
+            else if (moisture < 0.66f)
+            {
+                blockType = eBlockType::TROPICAL_SEASONAL_FOREST;
+            }
+            else
+            {
+                blockType = eBlockType::TROPICAL_RAIN_FOREST;
+            }
+        }
+
+        return blockType;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GenerateChunk
+
+      Summary:  Generates the columns of a chunk from the terrain noise.
+                Height and moisture are sampled from the same noise,
+                like the fixed maps of the labs
+
+      Args:     INT iChunkX, iChunkZ
+                  Chunk coordinates
+                UINT uChunkHeight
+                  Number of blocks along y in a chunk
+                GeneratedChunk& outChunk
+                  Generated columns
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainStreamer::GenerateChunk(_In_ INT iChunkX, _In_ INT iChunkZ, _In_ UINT uChunkHeight, _Out_ GeneratedChunk& outChunk)
+    {
+        constexpr const INT SIZE = static_cast<INT>(Chunk::SIZE);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        std::vector<FLOAT> aNoise;
+        TerrainNoise::Generate(iChunkX * SIZE, iChunkZ * SIZE, Chunk::SIZE, Chunk::SIZE, aNoise);
+
+        outChunk.iChunkX = iChunkX;
+        outChunk.iChunkZ = iChunkZ;
+        outChunk.aBlockTypes.resize(aNoise.size());
+        outChunk.aColumnHeights.resize(aNoise.size());
+
+        for (size_t i = 0u; i < aNoise.size(); ++i)
+        {
+            FLOAT height = aNoise[i];
+            assert(height >= 0.0f);
+
+            outChunk.aBlockTypes[i] = GetBlockType(height, height);
+            outChunk.aColumnHeights[i] = static_cast<WORD>(std::min<FLOAT>(static_cast<FLOAT>(TERRAIN_HEIGHT) * height, static_cast<FLOAT>(uChunkHeight)));
+        }
+
+        outChunk.generationTime = std::chrono::duration<FLOAT, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::SelectEvictions
+
+      Summary:  Selects the chunks out of the radius, then the farthest
+                ones over the chunk budget. The chunks are left in the
+                store for the caller to remove
+
+      Args:     INT iCenterChunkX, iCenterChunkZ
+                  Chunk coordinates of the camera
+                const ChunkStore& chunkStore
+                  Store of the resident chunks
+                std::vector<XMINT2>& aOutEvicted
+                  Chunk coordinates of the chunks to remove
+
+      Modifies: [m_uNumEvicted].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainStreamer::SelectEvictions(
+        _In_ INT iCenterChunkX,
+        _In_ INT iCenterChunkZ,
+        _In_ const ChunkStore& chunkStore,
+        _Out_ std::vector<XMINT2>& aOutEvicted
+    )
+    {
+        aOutEvicted.clear();
+
+        std::vector<std::pair<INT, XMINT2>> aResident;
+        for (const auto& chunkElem : chunkStore.GetChunks())
+        {
+            XMINT2 coord(chunkElem.second->GetChunkX(), chunkElem.second->GetChunkZ());
+            INT iDistanceSquared = getDistanceSquared(coord.x, coord.y, iCenterChunkX, iCenterChunkZ);
+
+            if (iDistanceSquared > getKeepRadiusSquared())
+                aOutEvicted.push_back(coord);
+            else
+                aResident.push_back({ iDistanceSquared, coord });
+        }
+
+        if (aResident.size() > m_uMaxChunks)
+        {
+            std::sort(aResident.begin(), aResident.end(),
+                [](const std::pair<INT, XMINT2>& a, const std::pair<INT, XMINT2>& b) { return a.first < b.first; });
+
+            for (size_t i = m_uMaxChunks; i < aResident.size(); ++i)
+                aOutEvicted.push_back(aResident[i].second);
+        }
+
+        m_uNumEvicted += static_cast<UINT>(aOutEvicted.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::Update
+
+      Summary:  Stores the chunks generated since the last update, at
+                most DEFAULT_MAX_LOADS_PER_UPDATE of them, and queues
+                the missing chunks of the radius, nearest first. Queued
+                chunks that are no longer missing or in the radius are
+                dropped, and so are generated chunks already in the
+                store
+
+      Args:     INT iCenterChunkX, iCenterChunkZ
+                  Chunk coordinates of the camera
+                ChunkStore& chunkStore
+                  Store of the resident chunks
+                std::vector<XMINT2>& aOutLoaded
+                  Chunk coordinates of the chunks stored
+
+      Modifies: [m_aJobs, m_aCompleted, m_pending, m_uNumGenerated,
+                 m_lastGenerationTime, m_totalGenerationTime].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainStreamer::Update(
+        _In_ INT iCenterChunkX,
+        _In_ INT iCenterChunkZ,
+        _Inout_ ChunkStore& chunkStore,
+        _Out_ std::vector<XMINT2>& aOutLoaded
+    )
+    {
+        aOutLoaded.clear();
+
+        const INT iRadius = static_cast<INT>(m_uRadius);
+
+        // Store the chunks generated since the last update
+        std::vector<GeneratedChunk> aCompleted;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            size_t uNumLoads = std::min<size_t>(m_aCompleted.size(), DEFAULT_MAX_LOADS_PER_UPDATE);
+            aCompleted.assign(std::make_move_iterator(m_aCompleted.begin()), std::make_move_iterator(m_aCompleted.begin() + uNumLoads));
+            m_aCompleted.erase(m_aCompleted.begin(), m_aCompleted.begin() + uNumLoads);
+
+            for (const GeneratedChunk& generatedChunk : aCompleted)
+                m_pending.erase(ChunkStore::GetKey(generatedChunk.iChunkX, generatedChunk.iChunkZ));
+        }
+
+        for (const GeneratedChunk& generatedChunk : aCompleted)
+        {
+            ++m_uNumGenerated;
+            m_lastGenerationTime = generatedChunk.generationTime;
+            m_totalGenerationTime += generatedChunk.generationTime;
+
+            // A chunk already resident may hold edits, it is never replaced
+            if (getDistanceSquared(generatedChunk.iChunkX, generatedChunk.iChunkZ, iCenterChunkX, iCenterChunkZ) > getKeepRadiusSquared() ||
+                chunkStore.GetChunks().size() >= m_uMaxChunks ||
+                chunkStore.GetChunk(generatedChunk.iChunkX, generatedChunk.iChunkZ))
+                continue;
+
+            // Empty chunks are stored too, so they are not generated again
+            Chunk* pChunk = chunkStore.GetOrCreateChunk(generatedChunk.iChunkX, generatedChunk.iChunkZ);
+            for (UINT z = 0u; z < Chunk::SIZE; ++z)
+            {
+                for (UINT x = 0u; x < Chunk::SIZE; ++x)
+                {
+                    size_t uColumnIdx = static_cast<size_t>(z) * Chunk::SIZE + static_cast<size_t>(x);
+                    pChunk->SetColumn(x, z, generatedChunk.aBlockTypes[uColumnIdx], generatedChunk.aColumnHeights[uColumnIdx]);
+                }
+            }
+
+            aOutLoaded.push_back(XMINT2(generatedChunk.iChunkX, generatedChunk.iChunkZ));
+        }
+
+        // Queue the missing chunks of the radius, nearest first
+        std::vector<std::pair<INT, XMINT2>> aMissing;
+        for (INT iOffsetZ = -iRadius; iOffsetZ <= iRadius; ++iOffsetZ)
+        {
+            for (INT iOffsetX = -iRadius; iOffsetX <= iRadius; ++iOffsetX)
+            {
+                INT iDistanceSquared = iOffsetX * iOffsetX + iOffsetZ * iOffsetZ;
+                if (iDistanceSquared > iRadius * iRadius ||
+                    chunkStore.GetChunk(iCenterChunkX + iOffsetX, iCenterChunkZ + iOffsetZ))
+                    continue;
+
+                aMissing.push_back({ iDistanceSquared, XMINT2(iCenterChunkX + iOffsetX, iCenterChunkZ + iOffsetZ) });
+            }
+        }
+
+        std::sort(aMissing.begin(), aMissing.end(),
+            [](const std::pair<INT, XMINT2>& a, const std::pair<INT, XMINT2>& b) { return a.first < b.first; });
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (const XMINT2& coord : m_aJobs)
+                m_pending.erase(ChunkStore::GetKey(coord.x, coord.y));
+            m_aJobs.clear();
+
+            size_t uNumUsed = chunkStore.GetChunks().size() + m_pending.size();
+            for (const std::pair<INT, XMINT2>& missing : aMissing)
+            {
+                if (uNumUsed >= m_uMaxChunks)
+                    break;
+
+                if (!m_pending.insert(ChunkStore::GetKey(missing.second.x, missing.second.y)).second)
+                    continue;
+
+                m_aJobs.push_back(missing.second);
+                ++uNumUsed;
+            }
+        }
+
+        m_condition.notify_all();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetRadius
+
+      Summary:  Returns the radius in chunks of the resident chunks
+
+      Returns:  UINT
+                  Radius
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainStreamer::GetRadius() const
+    {
+        return m_uRadius;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetMaxChunks
+
+      Summary:  Returns the most chunks resident or being generated at
+                once
+
+      Returns:  UINT
+                  Chunk budget
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainStreamer::GetMaxChunks() const
+    {
+        return m_uMaxChunks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetChunkHeight
+
+      Summary:  Returns the number of blocks along y in a chunk
+
+      Returns:  UINT
+                  Chunk height
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainStreamer::GetChunkHeight() const
+    {
+        return m_uChunkHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetNumPending
+
+      Summary:  Returns the number of chunks queued, being generated or
+                waiting to be stored
+
+      Returns:  UINT
+                  Number of pending chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainStreamer::GetNumPending() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return static_cast<UINT>(m_pending.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetNumGenerated
+
+      Summary:  Returns the number of chunks generated so far
+
+      Returns:  UINT
+                  Number of generated chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainStreamer::GetNumGenerated() const
+    {
+        return m_uNumGenerated;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetNumEvicted
+
+      Summary:  Returns the number of chunks evicted so far
+
+      Returns:  UINT
+                  Number of evicted chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TerrainStreamer::GetNumEvicted() const
+    {
+        return m_uNumEvicted;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetLastGenerationTime
+
+      Summary:  Returns the time the last stored chunk took to generate
+
+      Returns:  FLOAT
+                  Time in milliseconds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainStreamer::GetLastGenerationTime() const
+    {
+        return m_lastGenerationTime;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetAverageGenerationTime
+
+      Summary:  Returns the average time a chunk took to generate
+
+      Returns:  FLOAT
+                  Time in milliseconds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainStreamer::GetAverageGenerationTime() const
+    {
+        if (m_uNumGenerated == 0u)
+            return 0.0f;
+
+        return m_totalGenerationTime / static_cast<FLOAT>(m_uNumGenerated);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::getDistanceSquared
+
+      Summary:  Returns the squared distance between two chunks
+
+      Args:     INT iChunkX, iChunkZ
+                  Chunk coordinates
+                INT iCenterChunkX, iCenterChunkZ
+                  Chunk coordinates of the camera
+
+      Returns:  INT
+                  Squared distance in chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    INT TerrainStreamer::getDistanceSquared(_In_ INT iChunkX, _In_ INT iChunkZ, _In_ INT iCenterChunkX, _In_ INT iCenterChunkZ)
+    {
+        INT iOffsetX = iChunkX - iCenterChunkX;
+        INT iOffsetZ = iChunkZ - iCenterChunkZ;
+
+        return iOffsetX * iOffsetX + iOffsetZ * iOffsetZ;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::getKeepRadiusSquared
+
+      Summary:  Returns the squared distance past which chunks are
+                evicted. Chunks are kept one chunk past the radius, so
+                moving back and forth across a chunk border does not
+                generate the same chunks again and again
+
+      Returns:  INT
+                  Squared distance in chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    INT TerrainStreamer::getKeepRadiusSquared() const
+    {
+        INT iKeepRadius = static_cast<INT>(m_uRadius) + 1;
+
+        return iKeepRadius * iKeepRadius;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::work
+
+      Summary:  Body of a worker thread. Generates queued chunks until
+                a stop is requested
+
+      Args:     std::stop_token stopToken
+                  Token of the worker thread
+
+      Modifies: [m_aJobs, m_aCompleted].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainStreamer::work(_In_ std::stop_token stopToken)
+    {
+        for (;;)
+        {
+            XMINT2 coord;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (!m_condition.wait(lock, stopToken, [this]() { return !m_aJobs.empty(); }))
+                    return;
+
+                coord = m_aJobs.front();
+                m_aJobs.pop_front();
+            }
+
+            GeneratedChunk generatedChunk;
+            GenerateChunk(coord.x, coord.y, m_uChunkHeight, generatedChunk);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_aCompleted.push_back(std::move(generatedChunk));
+            }
+        }
+    }
+}
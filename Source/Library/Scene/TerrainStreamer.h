@@ -0,0 +1,146 @@
+/*+===================================================================
+  File:      TERRAINSTREAMER.H
+
+  Summary:   TerrainStreamer header file contains declaration of class
+             TerrainStreamer used to generate the chunks of an
+             unbounded voxel world around the camera.
+
+  Classes:  TerrainStreamer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/ChunkStore.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   GeneratedChunk
+
+        Summary:  Columns of a chunk generated on a worker thread, in
+                  the layout of SceneData, and the time it took
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct GeneratedChunk
+    {
+        INT iChunkX;
+        INT iChunkZ;
+        std::vector<eBlockType> aBlockTypes;
+        std::vector<WORD> aColumnHeights;
+        FLOAT generationTime;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TerrainStreamer
+
+      Summary:  Keeps the chunks within a radius of the camera resident
+                in a chunk store. Missing chunks are generated from
+                TerrainNoise on worker threads, nearest first, and up
+                to a number of them are moved into the store per
+                update. Chunks past the radius are selected
+                for eviction, and the farthest ones too when the store
+                holds more than the chunk budget. The owner of the
+                store removes them, after releasing what refers to
+                them. Nothing here touches the GPU, so it can be driven
+                without a renderer
+
+      Methods:  GetBlockType
+                  Returns the biome of a height and a moisture
+                GenerateChunk
+                  Generates the columns of a chunk
+                SelectEvictions
+                  Returns the chunks to remove around a position
+                Update
+                  Stores generated chunks and requests missing ones
+                  around a position
+                GetRadius
+                  Returns the radius in chunks
+                GetMaxChunks
+                  Returns the chunk budget
+                GetChunkHeight
+                  Returns the number of blocks along y in a chunk
+                GetNumPending
+                  Returns the number of chunks being generated
+                GetNumGenerated
+                  Returns the number of chunks generated so far
+                GetNumEvicted
+                  Returns the number of chunks evicted so far
+                GetLastGenerationTime
+                  Returns the time the last chunk took to generate
+                GetAverageGenerationTime
+                  Returns the average time a chunk took to generate
+                TerrainStreamer
+                  Constructor.
+                ~TerrainStreamer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TerrainStreamer final
+    {
+    public:
+        static constexpr const UINT DEFAULT_RADIUS = 6u;
+        static constexpr const UINT DEFAULT_MAX_CHUNKS = 256u;
+        static constexpr const UINT DEFAULT_CHUNK_HEIGHT = 48u;
+        static constexpr const UINT DEFAULT_MAX_LOADS_PER_UPDATE = 4u;
+        static constexpr const UINT TERRAIN_HEIGHT = 32u;
+
+        TerrainStreamer(_In_ UINT uRadius, _In_ UINT uMaxChunks, _In_ UINT uChunkHeight, _In_ UINT uNumThreads);
+        TerrainStreamer(const TerrainStreamer& other) = delete;
+        TerrainStreamer(TerrainStreamer&& other) = delete;
+        TerrainStreamer& operator=(const TerrainStreamer& other) = delete;
+        TerrainStreamer& operator=(TerrainStreamer&& other) = delete;
+        ~TerrainStreamer();
+
+        static eBlockType GetBlockType(_In_ FLOAT height, _In_ FLOAT moisture);
+        static void GenerateChunk(_In_ INT iChunkX, _In_ INT iChunkZ, _In_ UINT uChunkHeight, _Out_ GeneratedChunk& outChunk);
+
+        void SelectEvictions(
+            _In_ INT iCenterChunkX,
+            _In_ INT iCenterChunkZ,
+            _In_ const ChunkStore& chunkStore,
+            _Out_ std::vector<XMINT2>& aOutEvicted
+        );
+        void Update(
+            _In_ INT iCenterChunkX,
+            _In_ INT iCenterChunkZ,
+            _Inout_ ChunkStore& chunkStore,
+            _Out_ std::vector<XMINT2>& aOutLoaded
+        );
+
+        UINT GetRadius() const;
+        UINT GetMaxChunks() const;
+        UINT GetChunkHeight() const;
+        UINT GetNumPending() const;
+        UINT GetNumGenerated() const;
+        UINT GetNumEvicted() const;
+        FLOAT GetLastGenerationTime() const;
+        FLOAT GetAverageGenerationTime() const;
+
+    private:
+        static INT getDistanceSquared(_In_ INT iChunkX, _In_ INT iChunkZ, _In_ INT iCenterChunkX, _In_ INT iCenterChunkZ);
+
+        INT getKeepRadiusSquared() const;
+
+        void work(_In_ std::stop_token stopToken);
+
+    private:
+        UINT m_uRadius;
+        UINT m_uMaxChunks;
+        UINT m_uChunkHeight;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable_any m_condition;
+        std::deque<XMINT2> m_aJobs;
+        std::vector<GeneratedChunk> m_aCompleted;
+        std::unordered_set<UINT64> m_pending;
+
+        UINT m_uNumGenerated;
+        UINT m_uNumEvicted;
+        FLOAT m_lastGenerationTime;
+        FLOAT m_totalGenerationTime;
+
+        // Declared last so the workers are joined before the queues are destroyed
+        std::vector<std::jthread> m_aWorkers;
+    };
+}
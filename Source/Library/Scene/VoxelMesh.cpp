@@ -0,0 +1,106 @@
+#include "Scene/VoxelMesh.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::VoxelMesh
+
+      Summary:  Constructor. Generates two triangles for each quad,
+                wound like the vertices of the quad
+
+      Args:     std::vector<SimpleVertex>&& aVertices
+                  Quads of four vertices, at most MAX_VERTICES vertices
+                const XMFLOAT4& outputColor
+                  Color of the mesh
+
+      Modifies: [m_aVertices, m_aIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelMesh::VoxelMesh(_In_ std::vector<SimpleVertex>&& aVertices, _In_ const XMFLOAT4& outputColor)
+        : Renderable(outputColor)
+        , m_aVertices(std::move(aVertices))
+        , m_aIndices()
+    {
+        Chunk::BuildQuadIndices(static_cast<UINT>(m_aVertices.size()), m_aIndices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::Initialize
+
+      Summary:  Initializes the buffers of the mesh
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelMesh::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        return initialize(pDevice, pImmediateContext);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::Update
+
+      Summary:  Updates the mesh every frame
+
+      Args:     FLOAT deltaTime
+                  Elapsed time
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelMesh::Update(_In_ FLOAT deltaTime)
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::GetNumVertices
+
+      Summary:  Returns the number of vertices in the mesh
+
+      Returns:  UINT
+                  Number of vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelMesh::GetNumVertices() const
+    {
+        return static_cast<UINT>(m_aVertices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::GetNumIndices
+
+      Summary:  Returns the number of indices in the mesh
+
+      Returns:  UINT
+                  Number of indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelMesh::GetNumIndices() const
+    {
+        return static_cast<UINT>(m_aIndices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::getVertices
+
+      Summary:  Returns the pointer to the vertices data
+
+      Returns:  const library::SimpleVertex*
+                  Pointer to the vertices data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const SimpleVertex* VoxelMesh::getVertices() const
+    {
+        return m_aVertices.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesh::getIndices
+
+      Summary:  Returns the pointer to the indices data
+
+      Returns:  const WORD*
+                  Pointer to the indices data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const WORD* VoxelMesh::getIndices() const
+    {
+        return m_aIndices.data();
+    }
+}
@@ -0,0 +1,68 @@
+/*+===================================================================
+  File:      VOXELMESH.H
+
+  Summary:   VoxelMesh header file contains declaration of class
+             VoxelMesh used to render the merged faces of voxels.
+
+  Classes:  VoxelMesh
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/Renderable.h"
+#include "Scene/Chunk.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelMesh
+
+      Summary:  Renderable made of quads of four vertices in world
+                space, as built by Chunk::BuildGreedyMesh. The indices
+                are generated from the quads by Chunk::BuildQuadIndices,
+                so a mesh holds at most MAX_VERTICES vertices
+
+      Methods:  Initialize
+                  Initializes the buffers
+                Update
+                  Does nothing, the mesh is static
+                GetNumVertices
+                  Returns the number of vertices
+                GetNumIndices
+                  Returns the number of indices
+                VoxelMesh
+                  Constructor.
+                ~VoxelMesh
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelMesh : public Renderable
+    {
+    public:
+        static constexpr const UINT MAX_VERTICES = Chunk::MAX_MESH_VERTICES;
+
+        VoxelMesh(_In_ std::vector<SimpleVertex>&& aVertices, _In_ const XMFLOAT4& outputColor);
+        VoxelMesh(const VoxelMesh& other) = delete;
+        VoxelMesh(VoxelMesh&& other) = delete;
+        VoxelMesh& operator=(const VoxelMesh& other) = delete;
+        VoxelMesh& operator=(VoxelMesh&& other) = delete;
+        ~VoxelMesh() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override;
+        virtual void Update(_In_ FLOAT deltaTime) override;
+
+        UINT GetNumVertices() const override;
+        UINT GetNumIndices() const override;
+
+    protected:
+        const SimpleVertex* getVertices() const override;
+        const WORD* getIndices() const override;
+
+    private:
+        std::vector<SimpleVertex> m_aVertices;
+        std::vector<WORD> m_aIndices;
+    };
+}
@@ -0,0 +1,528 @@
+#include "Scene/VoxelOctree.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::VoxelOctree
+
+      Summary:  Constructor
+
+      Modifies: [m_origin, m_uRootLevel, m_uRoot, m_aNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelOctree::VoxelOctree()
+        : m_origin(0.0f, 0.0f, 0.0f)
+        , m_uRootLevel(0u)
+        , m_uRoot(EMPTY)
+        , m_aNodes()
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::Build
+
+      Summary:  Builds the octree from the columns of a scene. The
+                lowest and highest columns of every square of 2^n
+                columns are gathered first, so cubes above or below
+                the surface become leaves without visiting their
+                blocks
+
+      Args:     const SceneData& sceneData
+                  Columns of the scene
+                const XMFLOAT3& origin
+                  World position of the center of block (0, 0, 0)
+
+      Modifies: [m_origin, m_uRootLevel, m_uRoot, m_aNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOctree::Build(_In_ const SceneData& sceneData, _In_ const XMFLOAT3& origin)
+    {
+        Clear();
+
+        m_origin = origin;
+
+        UINT uExtent = std::max<UINT>(std::max<UINT>(sceneData.uWidth, sceneData.uDepth), sceneData.uHeight);
+        if (!sceneData.aColumnHeights.empty())
+            uExtent = std::max<UINT>(uExtent, *std::max_element(sceneData.aColumnHeights.begin(), sceneData.aColumnHeights.end()));
+
+        while ((1u << m_uRootLevel) < uExtent)
+            ++m_uRootLevel;
+
+        // Level 0 is read from the scene itself
+        std::vector<std::vector<ColumnRange>> aaLevels(m_uRootLevel + 1u);
+        for (UINT uLevel = 1u; uLevel <= m_uRootLevel; ++uLevel)
+        {
+            UINT uNumCells = 1u << (m_uRootLevel - uLevel);
+            aaLevels[uLevel].resize(static_cast<size_t>(uNumCells) * static_cast<size_t>(uNumCells));
+
+            for (UINT z = 0u; z < uNumCells; ++z)
+            {
+                for (UINT x = 0u; x < uNumCells; ++x)
+                {
+                    ColumnRange range = getColumnRange(sceneData, aaLevels, uLevel - 1u, x * 2u, z * 2u);
+                    for (UINT i = 1u; i < 4u; ++i)
+                    {
+                        ColumnRange childRange = getColumnRange(sceneData, aaLevels, uLevel - 1u, x * 2u + (i & 1u), z * 2u + (i >> 1u));
+
+                        range.uMinHeight = std::min<WORD>(range.uMinHeight, childRange.uMinHeight);
+                        range.uMaxHeight = std::max<WORD>(range.uMaxHeight, childRange.uMaxHeight);
+                        if (range.blockType != childRange.blockType)
+                            range.blockType = eBlockType::COUNT;
+                    }
+
+                    aaLevels[uLevel][static_cast<size_t>(z) * static_cast<size_t>(uNumCells) + static_cast<size_t>(x)] = range;
+                }
+            }
+        }
+
+        std::unordered_map<OctreeNode, UINT, NodeHash> nodeIndices;
+        m_uRoot = buildNode(sceneData, aaLevels, nodeIndices, m_uRootLevel, 0u, 0u, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::Clear
+
+      Summary:  Removes every block
+
+      Modifies: [m_uRootLevel, m_uRoot, m_aNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelOctree::Clear()
+    {
+        m_uRootLevel = 0u;
+        m_uRoot = EMPTY;
+        m_aNodes.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::GetBlock
+
+      Summary:  Returns the block at block coordinates
+
+      Args:     INT x, y, z
+                  Block coordinates
+
+      Returns:  eBlockType
+                  Block type, AIR outside of the octree
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eBlockType VoxelOctree::GetBlock(_In_ INT x, _In_ INT y, _In_ INT z) const
+    {
+        INT iSize = static_cast<INT>(GetSize());
+        if (x < 0 || y < 0 || z < 0 || x >= iSize || y >= iSize || z >= iSize)
+            return eBlockType::AIR;
+
+        UINT uNode = m_uRoot;
+        UINT uLevel = m_uRootLevel;
+        while (!(uNode & LEAF_BIT))
+        {
+            --uLevel;
+
+            UINT uChild = ((static_cast<UINT>(x) >> uLevel) & 1u)
+                | (((static_cast<UINT>(y) >> uLevel) & 1u) << 1u)
+                | (((static_cast<UINT>(z) >> uLevel) & 1u) << 2u);
+            uNode = m_aNodes[uNode].auChildren[uChild];
+        }
+
+        return static_cast<eBlockType>(uNode & ~LEAF_BIT);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::Overlaps
+
+      Summary:  Returns whether a box overlaps a solid block. Only the
+                nodes overlapping the box are visited
+
+      Args:     const BoundingBox& box
+                  World axis-aligned box
+
+      Returns:  BOOL
+                  TRUE if a block overlaps the box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelOctree::Overlaps(_In_ const BoundingBox& box) const
+    {
+        const FLOAT aCenter[3] = { box.Center.x - m_origin.x, box.Center.y - m_origin.y, box.Center.z - m_origin.z };
+        const FLOAT aExtents[3] = { box.Extents.x, box.Extents.y, box.Extents.z };
+        const INT iSize = static_cast<INT>(GetSize());
+
+        UINT auMin[3];
+        UINT auMax[3];
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            INT iMin = static_cast<INT>(std::floor((aCenter[i] - aExtents[i]) / Chunk::BLOCK_SIZE + 0.5f));
+            INT iMax = static_cast<INT>(std::floor((aCenter[i] + aExtents[i]) / Chunk::BLOCK_SIZE + 0.5f));
+            if (iMax < 0 || iMin >= iSize)
+                return FALSE;
+
+            auMin[i] = static_cast<UINT>(std::max<INT>(iMin, 0));
+            auMax[i] = static_cast<UINT>(std::min<INT>(iMax, iSize - 1));
+        }
+
+        return overlapsNode(m_uRoot, m_uRootLevel, 0u, 0u, 0u, auMin, auMax);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::CastRay
+
+      Summary:  Returns the first solid block hit by a ray. Children are
+                visited in the order the ray enters them, so the search
+                stops at the first leaf hit
+
+      Args:     FXMVECTOR origin
+                  World origin of the ray
+                FXMVECTOR direction
+                  Normalized direction of the ray
+                FLOAT& outDistance
+                  Distance to the block hit
+                eBlockType& outBlockType
+                  Block type of the block hit
+
+      Returns:  BOOL
+                  TRUE if a block was hit
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL XM_CALLCONV VoxelOctree::CastRay(_In_ FXMVECTOR origin, _In_ FXMVECTOR direction, _Out_ FLOAT& outDistance, _Out_ eBlockType& outBlockType) const
+    {
+        outDistance = 0.0f;
+        outBlockType = eBlockType::AIR;
+
+        FLOAT distance = 0.0f;
+        if (!getBounds(m_uRootLevel, 0u, 0u, 0u).Intersects(origin, direction, distance))
+            return FALSE;
+
+        return castRayNode(origin, direction, m_uRoot, m_uRootLevel, 0u, 0u, 0u, std::max<FLOAT>(distance, 0.0f), outDistance, outBlockType);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::GetSize
+
+      Summary:  Returns the number of blocks along an edge of the cube
+
+      Returns:  UINT
+                  Power of two
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelOctree::GetSize() const
+    {
+        return 1u << m_uRootLevel;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::GetNumNodes
+
+      Summary:  Returns the number of distinct nodes
+
+      Returns:  size_t
+                  Number of nodes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t VoxelOctree::GetNumNodes() const
+    {
+        return m_aNodes.size();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::GetMemoryUsage
+
+      Summary:  Returns the size of the nodes
+
+      Returns:  size_t
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t VoxelOctree::GetMemoryUsage() const
+    {
+        return m_aNodes.size() * sizeof(OctreeNode);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::NodeHash::operator()
+
+      Summary:  Returns the hash of the children of a node
+
+      Args:     const OctreeNode& node
+                  Node to hash
+
+      Returns:  size_t
+                  Hash
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t VoxelOctree::NodeHash::operator()(const OctreeNode& node) const
+    {
+        size_t uHash = 0u;
+        for (UINT uChild : node.auChildren)
+            uHash ^= static_cast<size_t>(uChild) + 0x9e3779b9u + (uHash << 6u) + (uHash >> 2u);
+
+        return uHash;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::getColumnRange
+
+      Summary:  Returns the lowest and highest columns of a square of
+                2^level columns. Columns out of the scene are empty
+
+      Args:     const SceneData& sceneData
+                  Columns of the scene
+                const std::vector<std::vector<ColumnRange>>& aaLevels
+                  Ranges of the squares of every level above 0
+                UINT uLevel
+                  Level of the square
+                UINT x, z
+                  Position of the square in its level
+
+      Returns:  ColumnRange
+                  Lowest and highest columns of the square
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelOctree::ColumnRange VoxelOctree::getColumnRange(
+        _In_ const SceneData& sceneData,
+        _In_ const std::vector<std::vector<ColumnRange>>& aaLevels,
+        _In_ UINT uLevel,
+        _In_ UINT x,
+        _In_ UINT z
+    ) const
+    {
+        if (uLevel > 0u)
+        {
+            size_t uNumCells = static_cast<size_t>(1u << (m_uRootLevel - uLevel));
+            return aaLevels[uLevel][static_cast<size_t>(z) * uNumCells + static_cast<size_t>(x)];
+        }
+
+        if (x >= sceneData.uWidth || z >= sceneData.uDepth)
+            return ColumnRange{ .uMinHeight = 0u, .uMaxHeight = 0u, .blockType = eBlockType::AIR };
+
+        size_t uColumnIdx = static_cast<size_t>(z) * static_cast<size_t>(sceneData.uWidth) + static_cast<size_t>(x);
+        WORD uHeight = sceneData.aColumnHeights[uColumnIdx];
+
+        return ColumnRange
+        {
+            .uMinHeight = uHeight,
+            .uMaxHeight = uHeight,
+            .blockType = uHeight > 0u ? sceneData.aBlockTypes[uColumnIdx] : eBlockType::AIR
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::buildNode
+
+      Summary:  Builds the node of a cube. Cubes of a single block type
+                become leaves, and a node identical to one built before
+                is shared
+
+      Args:     const SceneData& sceneData
+                  Columns of the scene
+                const std::vector<std::vector<ColumnRange>>& aaLevels
+                  Ranges of the squares of every level above 0
+                std::unordered_map<OctreeNode, UINT, NodeHash>& nodeIndices
+                  Indices of the nodes built so far
+                UINT uLevel
+                  Level of the cube, 2^level blocks along an edge
+                UINT x, y, z
+                  Block coordinates of the lowest corner of the cube
+
+      Modifies: [m_aNodes].
+
+      Returns:  UINT
+                  Leaf or index of the node
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelOctree::buildNode(
+        _In_ const SceneData& sceneData,
+        _In_ const std::vector<std::vector<ColumnRange>>& aaLevels,
+        _Inout_ std::unordered_map<OctreeNode, UINT, NodeHash>& nodeIndices,
+        _In_ UINT uLevel,
+        _In_ UINT x,
+        _In_ UINT y,
+        _In_ UINT z
+    )
+    {
+        UINT uSize = 1u << uLevel;
+
+        ColumnRange range = getColumnRange(sceneData, aaLevels, uLevel, x >> uLevel, z >> uLevel);
+        if (y >= range.uMaxHeight)
+            return EMPTY;
+
+        if (y + uSize <= range.uMinHeight && range.blockType != eBlockType::COUNT)
+            return LEAF_BIT | static_cast<UINT>(range.blockType);
+
+        // A single block is always one of the two above
+        assert(uLevel > 0u);
+
+        UINT uHalf = uSize >> 1u;
+        OctreeNode node;
+        for (UINT i = 0u; i < 8u; ++i)
+        {
+            node.auChildren[i] = buildNode(
+                sceneData,
+                aaLevels,
+                nodeIndices,
+                uLevel - 1u,
+                x + (i & 1u) * uHalf,
+                y + ((i >> 1u) & 1u) * uHalf,
+                z + ((i >> 2u) & 1u) * uHalf
+            );
+        }
+
+        if ((node.auChildren[0] & LEAF_BIT) &&
+            std::all_of(node.auChildren, node.auChildren + 8, [&node](UINT uChild) { return uChild == node.auChildren[0]; }))
+            return node.auChildren[0];
+
+        auto [it, bInserted] = nodeIndices.try_emplace(node, static_cast<UINT>(m_aNodes.size()));
+        if (bInserted)
+            m_aNodes.push_back(node);
+
+        return it->second;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::overlapsNode
+
+      Summary:  Returns whether a solid block of a cube lies within a
+                range of blocks
+
+      Args:     UINT uNode
+                  Leaf or index of the node of the cube
+                UINT uLevel
+                  Level of the cube
+                UINT x, y, z
+                  Block coordinates of the lowest corner of the cube
+                const UINT* auMin, auMax
+                  Inclusive range of block coordinates
+
+      Returns:  BOOL
+                  TRUE if a block lies within the range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelOctree::overlapsNode(_In_ UINT uNode, _In_ UINT uLevel, _In_ UINT x, _In_ UINT y, _In_ UINT z, _In_reads_(3) const UINT* auMin, _In_reads_(3) const UINT* auMax) const
+    {
+        if (uNode & LEAF_BIT)
+            return uNode != EMPTY;
+
+        UINT uHalf = 1u << (uLevel - 1u);
+        for (UINT i = 0u; i < 8u; ++i)
+        {
+            UINT uChild = m_aNodes[uNode].auChildren[i];
+            if (uChild == EMPTY)
+                continue;
+
+            UINT auCorner[3] = { x + (i & 1u) * uHalf, y + ((i >> 1u) & 1u) * uHalf, z + ((i >> 2u) & 1u) * uHalf };
+            if (auCorner[0] > auMax[0] || auCorner[0] + uHalf <= auMin[0] ||
+                auCorner[1] > auMax[1] || auCorner[1] + uHalf <= auMin[1] ||
+                auCorner[2] > auMax[2] || auCorner[2] + uHalf <= auMin[2])
+                continue;
+
+            if (overlapsNode(uChild, uLevel - 1u, auCorner[0], auCorner[1], auCorner[2], auMin, auMax))
+                return TRUE;
+        }
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::castRayNode
+
+      Summary:  Returns the first solid block of a cube hit by a ray.
+                The children of a node are disjoint cubes, so the ray
+                crosses them in the order it enters them
+
+      Args:     FXMVECTOR origin
+                  World origin of the ray
+                FXMVECTOR direction
+                  Normalized direction of the ray
+                UINT uNode
+                  Leaf or index of the node of the cube
+                UINT uLevel
+                  Level of the cube
+                UINT x, y, z
+                  Block coordinates of the lowest corner of the cube
+                FLOAT entryDistance
+                  Distance at which the ray enters the cube
+                FLOAT& outDistance
+                  Distance to the block hit
+                eBlockType& outBlockType
+                  Block type of the block hit
+
+      Returns:  BOOL
+                  TRUE if a block was hit
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL XM_CALLCONV VoxelOctree::castRayNode(
+        _In_ FXMVECTOR origin,
+        _In_ FXMVECTOR direction,
+        _In_ UINT uNode,
+        _In_ UINT uLevel,
+        _In_ UINT x,
+        _In_ UINT y,
+        _In_ UINT z,
+        _In_ FLOAT entryDistance,
+        _Out_ FLOAT& outDistance,
+        _Out_ eBlockType& outBlockType
+    ) const
+    {
+        if (uNode & LEAF_BIT)
+        {
+            if (uNode == EMPTY)
+                return FALSE;
+
+            outDistance = entryDistance;
+            outBlockType = static_cast<eBlockType>(uNode & ~LEAF_BIT);
+            return TRUE;
+        }
+
+        // Children the ray enters, kept nearest first as they are found
+        UINT uHalf = 1u << (uLevel - 1u);
+        std::pair<FLOAT, UINT> aHits[8];
+        UINT uNumHits = 0u;
+        for (UINT i = 0u; i < 8u; ++i)
+        {
+            if (m_aNodes[uNode].auChildren[i] == EMPTY)
+                continue;
+
+            FLOAT distance = 0.0f;
+            if (!getBounds(uLevel - 1u, x + (i & 1u) * uHalf, y + ((i >> 1u) & 1u) * uHalf, z + ((i >> 2u) & 1u) * uHalf).Intersects(origin, direction, distance))
+                continue;
+
+            assert(uNumHits < 8u);
+            UINT uHit = uNumHits++;
+            for (; uHit > 0u && aHits[uHit - 1u].first > distance; --uHit)
+                aHits[uHit] = aHits[uHit - 1u];
+            aHits[uHit] = { std::max<FLOAT>(distance, 0.0f), i };
+        }
+
+        for (UINT uHit = 0u; uHit < uNumHits; ++uHit)
+        {
+            UINT i = aHits[uHit].second;
+            if (castRayNode(
+                origin,
+                direction,
+                m_aNodes[uNode].auChildren[i],
+                uLevel - 1u,
+                x + (i & 1u) * uHalf,
+                y + ((i >> 1u) & 1u) * uHalf,
+                z + ((i >> 2u) & 1u) * uHalf,
+                aHits[uHit].first,
+                outDistance,
+                outBlockType
+            ))
+                return TRUE;
+        }
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelOctree::getBounds
+
+      Summary:  Returns the world bounding box of a cube
+
+      Args:     UINT uLevel
+                  Level of the cube
+                UINT x, y, z
+                  Block coordinates of the lowest corner of the cube
+
+      Returns:  BoundingBox
+                  Axis-aligned bounding box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingBox VoxelOctree::getBounds(_In_ UINT uLevel, _In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        // Block centers are at the origin plus a multiple of the block size
+        FLOAT halfSize = Chunk::BLOCK_SIZE * static_cast<FLOAT>(1u << uLevel) * 0.5f;
+        FLOAT offset = halfSize - Chunk::BLOCK_SIZE * 0.5f;
+
+        return BoundingBox(
+            XMFLOAT3(
+                m_origin.x + Chunk::BLOCK_SIZE * static_cast<FLOAT>(x) + offset,
+                m_origin.y + Chunk::BLOCK_SIZE * static_cast<FLOAT>(y) + offset,
+                m_origin.z + Chunk::BLOCK_SIZE * static_cast<FLOAT>(z) + offset
+            ),
+            XMFLOAT3(halfSize, halfSize, halfSize)
+        );
+    }
+}
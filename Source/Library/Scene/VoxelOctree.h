@@ -0,0 +1,153 @@
+/*+===================================================================
+  File:      VOXELOCTREE.H
+
+  Summary:   VoxelOctree header file contains declaration of class
+             VoxelOctree used to store large voxel volumes sparsely.
+
+  Classes:  VoxelOctree
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/Chunk.h"
+#include "Scene/SceneFile.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   OctreeNode
+
+        Summary:  Eight children of a node of a voxel octree, ordered
+                  x first, then y, then z. A child either refers to
+                  another node or, with LEAF_BIT set, is a cube of one
+                  block type
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct OctreeNode
+    {
+        UINT auChildren[8];
+
+        bool operator==(const OctreeNode& other) const = default;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelOctree
+
+      Summary:  Sparse voxel octree over a cube of 2^n blocks. Cubes of
+                a single block type, air included, are stored as one
+                leaf, and identical subtrees are stored once, which
+                makes the octree a directed acyclic graph. Blocks use
+                the block coordinates and the origin of ChunkStore. It
+                is a read-only snapshot of the columns it was built
+                from, separate from the editable chunks of a Scene
+
+      Methods:  Build
+                  Builds the octree from the columns of a scene
+                Clear
+                  Removes every block
+                GetBlock
+                  Returns the block at block coordinates
+                Overlaps
+                  Returns whether a box overlaps a block
+                CastRay
+                  Returns the first block hit by a ray
+                GetSize
+                  Returns the number of blocks along an edge
+                GetNumNodes
+                  Returns the number of nodes
+                GetMemoryUsage
+                  Returns the size of the nodes in bytes
+                VoxelOctree
+                  Constructor.
+                ~VoxelOctree
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelOctree final
+    {
+    public:
+        static constexpr const UINT LEAF_BIT = 0x80000000u;
+        static constexpr const UINT EMPTY = LEAF_BIT | static_cast<UINT>(eBlockType::AIR);
+
+        VoxelOctree();
+        VoxelOctree(const VoxelOctree& other) = delete;
+        VoxelOctree(VoxelOctree&& other) = delete;
+        VoxelOctree& operator=(const VoxelOctree& other) = delete;
+        VoxelOctree& operator=(VoxelOctree&& other) = delete;
+        ~VoxelOctree() = default;
+
+        void Build(_In_ const SceneData& sceneData, _In_ const XMFLOAT3& origin);
+        void Clear();
+
+        eBlockType GetBlock(_In_ INT x, _In_ INT y, _In_ INT z) const;
+        BOOL Overlaps(_In_ const BoundingBox& box) const;
+        BOOL XM_CALLCONV CastRay(_In_ FXMVECTOR origin, _In_ FXMVECTOR direction, _Out_ FLOAT& outDistance, _Out_ eBlockType& outBlockType) const;
+
+        UINT GetSize() const;
+        size_t GetNumNodes() const;
+        size_t GetMemoryUsage() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   ColumnRange
+
+            Summary:  Lowest and highest columns of a square of columns,
+                      and their block type, COUNT if they differ
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ColumnRange
+        {
+            WORD uMinHeight;
+            WORD uMaxHeight;
+            eBlockType blockType;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   NodeHash
+
+            Summary:  Hash of the children of a node, used to find
+                      identical subtrees while building
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct NodeHash
+        {
+            size_t operator()(const OctreeNode& node) const;
+        };
+
+        ColumnRange getColumnRange(
+            _In_ const SceneData& sceneData,
+            _In_ const std::vector<std::vector<ColumnRange>>& aaLevels,
+            _In_ UINT uLevel,
+            _In_ UINT x,
+            _In_ UINT z
+        ) const;
+        UINT buildNode(
+            _In_ const SceneData& sceneData,
+            _In_ const std::vector<std::vector<ColumnRange>>& aaLevels,
+            _Inout_ std::unordered_map<OctreeNode, UINT, NodeHash>& nodeIndices,
+            _In_ UINT uLevel,
+            _In_ UINT x,
+            _In_ UINT y,
+            _In_ UINT z
+        );
+        BOOL overlapsNode(_In_ UINT uNode, _In_ UINT uLevel, _In_ UINT x, _In_ UINT y, _In_ UINT z, _In_reads_(3) const UINT* auMin, _In_reads_(3) const UINT* auMax) const;
+        BOOL XM_CALLCONV castRayNode(
+            _In_ FXMVECTOR origin,
+            _In_ FXMVECTOR direction,
+            _In_ UINT uNode,
+            _In_ UINT uLevel,
+            _In_ UINT x,
+            _In_ UINT y,
+            _In_ UINT z,
+            _In_ FLOAT entryDistance,
+            _Out_ FLOAT& outDistance,
+            _Out_ eBlockType& outBlockType
+        ) const;
+        BoundingBox getBounds(_In_ UINT uLevel, _In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+
+    private:
+        XMFLOAT3 m_origin;
+        UINT m_uRootLevel;
+        UINT m_uRoot;
+        std::vector<OctreeNode> m_aNodes;
+    };
+}
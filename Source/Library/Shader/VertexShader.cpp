@@ -81,41 +81,14 @@ namespace library
                 D3D11_INPUT_PER_VERTEX_DATA,
                 0
             },
-             {
-                "INSTANCE_TRANSFORM",
+            {
+                "INSTANCE_DATA",
                 0,
-                DXGI_FORMAT_R32G32B32A32_FLOAT,
+                DXGI_FORMAT_R16G16B16A16_UINT,
                 1,
                 0,
                 D3D11_INPUT_PER_INSTANCE_DATA,
                 1
-            },
-            {
-                "INSTANCE_TRANSFORM",
-                1,
-                DXGI_FORMAT_R32G32B32A32_FLOAT,
-                1,
-                16,
-                D3D11_INPUT_PER_INSTANCE_DATA,
-                1
-            },
-            {
-                "INSTANCE_TRANSFORM",
-                2,
-                DXGI_FORMAT_R32G32B32A32_FLOAT,
-                1,
-                32,
-                D3D11_INPUT_PER_INSTANCE_DATA,
-                1
-            },
-            {
-                "INSTANCE_TRANSFORM",
-                3,
-                DXGI_FORMAT_R32G32B32A32_FLOAT,
-                1,
-                48,
-                D3D11_INPUT_PER_INSTANCE_DATA,
-                1
             }
         };
         UINT uNumElements = ARRAYSIZE(aLayouts);
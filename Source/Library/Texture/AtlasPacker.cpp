@@ -0,0 +1,397 @@
+#include "Texture/AtlasPacker.h"
+
+#include "Texture/MipmapGenerator.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AtlasPacker::Pack
+
+      Summary:  Places the images no larger than MAX_SOURCE_SIZE,
+                largest first, into the smallest power of two atlas
+                holding all of them. Empty images and the ones that do
+                not fit the largest atlas are left out
+
+      Args:     const std::vector<WIC_DECODED_IMAGE>& aImages
+                  Decoded source images, only their sizes are read
+                std::vector<AtlasPlacement>& aOutPlacements
+                  Placements of the packed images
+
+      Modifies: [aOutPlacements].
+
+      Returns:  UINT
+                  Width and height of the atlas
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT AtlasPacker::Pack(_In_ const std::vector<WIC_DECODED_IMAGE>& aImages, _Out_ std::vector<AtlasPlacement>& aOutPlacements)
+    {
+        std::vector<size_t> aOrder;
+        for (size_t i = 0u; i < aImages.size(); ++i)
+        {
+            if (aImages[i].width > 0u && aImages[i].height > 0u && aImages[i].width <= MAX_SOURCE_SIZE && aImages[i].height <= MAX_SOURCE_SIZE)
+                aOrder.push_back(i);
+        }
+
+        std::sort(aOrder.begin(), aOrder.end(),
+            [&aImages](size_t uLeft, size_t uRight)
+            {
+                if (aImages[uLeft].height != aImages[uRight].height)
+                    return aImages[uLeft].height > aImages[uRight].height;
+
+                return aImages[uLeft].width > aImages[uRight].width;
+            }
+        );
+
+        UINT uAtlasSize = MIN_ATLAS_SIZE;
+        for (;;)
+        {
+            pack(uAtlasSize, aImages, aOrder, aOutPlacements);
+            if (aOutPlacements.size() == aOrder.size() || uAtlasSize == MAX_ATLAS_SIZE)
+                break;
+
+            uAtlasSize *= 2u;
+        }
+
+        return uAtlasSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AtlasPacker::Compose
+
+      Summary:  Creates the RGBA 32-bit atlas image, copies every placed
+                image with its gutter into it and builds NUM_MIP_LEVELS
+                mip levels
+
+      Args:     UINT uAtlasSize
+                  Width and height of the atlas, as returned by Pack
+                const std::vector<WIC_DECODED_IMAGE>& aImages
+                  Decoded RGBA 32-bit source images
+                const std::vector<AtlasPlacement>& aPlacements
+                  Placements returned by Pack
+                WIC_DECODED_IMAGE& outAtlas
+                  Atlas image with its mip chain
+
+      Modifies: [outAtlas].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT AtlasPacker::Compose(
+        _In_ UINT uAtlasSize,
+        _In_ const std::vector<WIC_DECODED_IMAGE>& aImages,
+        _In_ const std::vector<AtlasPlacement>& aPlacements,
+        _Out_ WIC_DECODED_IMAGE& outAtlas
+    )
+    {
+        outAtlas =
+        {
+            .width = uAtlasSize,
+            .height = uAtlasSize,
+            .format = DXGI_FORMAT_R8G8B8A8_UNORM,
+            .rowPitch = static_cast<size_t>(uAtlasSize) * 4u,
+            .bitsPerPixel = 32u,
+            .mipLevels = 1u,
+            .pixels = std::unique_ptr<uint8_t[]>(new (std::nothrow) uint8_t[static_cast<size_t>(uAtlasSize) * uAtlasSize * 4u]()),
+        };
+
+        if (!outAtlas.pixels)
+            return E_OUTOFMEMORY;
+
+        std::for_each(std::execution::par, aPlacements.begin(), aPlacements.end(),
+            [&](const AtlasPlacement& placement)
+            {
+                copyWithGutter(aImages[placement.uSourceIndex], outAtlas, placement.x, placement.y);
+            }
+        );
+
+        HRESULT hr = MipmapGenerator::GenerateMipChain(outAtlas, TRUE);
+        if (FAILED(hr))
+            return hr;
+
+        // Deeper levels would average texels of neighbouring regions
+        outAtlas.mipLevels = std::min<UINT>(outAtlas.mipLevels, NUM_MIP_LEVELS);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AtlasPacker::GetRegion
+
+      Summary:  Returns the part of the atlas holding an image, without
+                its gutter, in texture coordinates
+
+      Args:     UINT uAtlasSize
+                  Width and height of the atlas
+                const WIC_DECODED_IMAGE& image
+                  Placed source image
+                const AtlasPlacement& placement
+                  Placement of the image
+
+      Returns:  AtlasRegion
+                  Region of the image
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AtlasRegion AtlasPacker::GetRegion(_In_ UINT uAtlasSize, _In_ const WIC_DECODED_IMAGE& image, _In_ const AtlasPlacement& placement)
+    {
+        FLOAT atlasSize = static_cast<FLOAT>(uAtlasSize);
+
+        return AtlasRegion
+        {
+            .Offset = XMFLOAT2(static_cast<FLOAT>(placement.x + GUTTER_SIZE) / atlasSize, static_cast<FLOAT>(placement.y + GUTTER_SIZE) / atlasSize),
+            .Scale = XMFLOAT2(static_cast<FLOAT>(image.width) / atlasSize, static_cast<FLOAT>(image.height) / atlasSize),
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AtlasPacker::RemapTexCoord
+
+      Summary:  Maps a texture coordinate of a source texture into the
+                atlas. The coordinate must lie in [0, 1], the atlas
+                cannot repeat a region
+
+      Args:     const AtlasRegion& region
+                  Placement of the source texture
+                const XMFLOAT2& texCoord
+                  Texture coordinate of the source texture
+
+      Returns:  XMFLOAT2
+                  Texture coordinate in the atlas
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMFLOAT2 AtlasPacker::RemapTexCoord(_In_ const AtlasRegion& region, _In_ const XMFLOAT2& texCoord)
+    {
+        return XMFLOAT2(region.Offset.x + texCoord.x * region.Scale.x, region.Offset.y + texCoord.y * region.Scale.y);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AtlasPacker::GetPaddedSize
+
+      Summary:  Returns the size of a region with its gutter on both
+                sides, rounded up to a multiple of the gutter size so
+                every region starts on a texel of the last mip level
+
+      Args:     UINT uSize
+                  Width or height of the source texture
+
+      Returns:  UINT
+                  Padded size in texels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT AtlasPacker::GetPaddedSize(_In_ UINT uSize)
+    {
+        return (uSize + 3u * GUTTER_SIZE - 1u) / GUTTER_SIZE * GUTTER_SIZE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AtlasPacker::pack
+
+      Summary:  Places the padded source textures in the given order,
+                skipping the ones that do not fit
+
+      Args:     UINT uAtlasSize
+                  Width and height of the atlas
+                const std::vector<WIC_DECODED_IMAGE>& aImages
+                  Decoded source textures
+                const std::vector<size_t>& aOrder
+                  Indices of the textures to place, in placing order
+                std::vector<AtlasPlacement>& aOutPlacements
+                  Top left corners of the padded regions
+
+      Modifies: [aOutPlacements].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AtlasPacker::pack(
+        _In_ UINT uAtlasSize,
+        _In_ const std::vector<WIC_DECODED_IMAGE>& aImages,
+        _In_ const std::vector<size_t>& aOrder,
+        _Out_ std::vector<AtlasPlacement>& aOutPlacements
+    )
+    {
+        aOutPlacements.clear();
+
+        std::vector<SkylineNode> aSkyline = { { 0, 0, static_cast<INT>(uAtlasSize) } };
+        for (size_t uSourceIndex : aOrder)
+        {
+            UINT uWidth = GetPaddedSize(aImages[uSourceIndex].width);
+            UINT uHeight = GetPaddedSize(aImages[uSourceIndex].height);
+
+            size_t uNodeIndex = 0u;
+            UINT x = 0u;
+            UINT y = 0u;
+            if (!findSkylinePosition(aSkyline, uAtlasSize, uWidth, uHeight, uNodeIndex, x, y))
+                continue;
+
+            addSkylineLevel(aSkyline, uNodeIndex, x, y, uWidth, uHeight);
+            aOutPlacements.push_back({ .uSourceIndex = uSourceIndex, .x = x, .y = y });
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AtlasPacker::findSkylinePosition
+
+      Summary:  Finds the lowest position where a rectangle rests on the
+                skyline, preferring the narrowest skyline segment on
+                ties
+
+      Args:     const std::vector<SkylineNode>& aSkyline
+                  Segments of the skyline from left to right
+                UINT uAtlasSize
+                  Width and height of the atlas
+                UINT uWidth
+                  Width of the rectangle
+                UINT uHeight
+                  Height of the rectangle
+                size_t& uOutNodeIndex
+                  Segment the rectangle starts on
+                UINT& uOutX
+                  Left of the rectangle
+                UINT& uOutY
+                  Top of the rectangle
+
+      Returns:  BOOL
+                  TRUE if the rectangle fits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL AtlasPacker::findSkylinePosition(
+        _In_ const std::vector<SkylineNode>& aSkyline,
+        _In_ UINT uAtlasSize,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _Out_ size_t& uOutNodeIndex,
+        _Out_ UINT& uOutX,
+        _Out_ UINT& uOutY
+    )
+    {
+        BOOL bFound = FALSE;
+        INT bestY = INT_MAX;
+        INT bestWidth = INT_MAX;
+
+        for (size_t i = 0u; i < aSkyline.size(); ++i)
+        {
+            INT x = aSkyline[i].x;
+            if (x + static_cast<INT>(uWidth) > static_cast<INT>(uAtlasSize))
+                break;
+
+            // The rectangle rests on the highest segment below it
+            INT y = 0;
+            INT widthLeft = static_cast<INT>(uWidth);
+            for (size_t j = i; widthLeft > 0 && j < aSkyline.size(); ++j)
+            {
+                y = std::max<INT>(y, aSkyline[j].y);
+                widthLeft -= aSkyline[j].width;
+            }
+
+            if (y + static_cast<INT>(uHeight) > static_cast<INT>(uAtlasSize))
+                continue;
+
+            if (y < bestY || (y == bestY && aSkyline[i].width < bestWidth))
+            {
+                bFound = TRUE;
+                bestY = y;
+                bestWidth = aSkyline[i].width;
+                uOutNodeIndex = i;
+                uOutX = static_cast<UINT>(x);
+                uOutY = static_cast<UINT>(y);
+            }
+        }
+
+        return bFound;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AtlasPacker::addSkylineLevel
+
+      Summary:  Raises the skyline over a placed rectangle, trimming the
+                segments it covers and merging segments of equal height
+
+      Args:     std::vector<SkylineNode>& aSkyline
+                  Segments of the skyline from left to right
+                size_t uNodeIndex
+                  Segment the rectangle starts on
+                UINT x
+                  Left of the rectangle
+                UINT y
+                  Top of the rectangle
+                UINT uWidth
+                  Width of the rectangle
+                UINT uHeight
+                  Height of the rectangle
+
+      Modifies: [aSkyline].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AtlasPacker::addSkylineLevel(
+        _Inout_ std::vector<SkylineNode>& aSkyline,
+        _In_ size_t uNodeIndex,
+        _In_ UINT x,
+        _In_ UINT y,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight
+    )
+    {
+        aSkyline.insert(aSkyline.begin() + static_cast<ptrdiff_t>(uNodeIndex),
+            { static_cast<INT>(x), static_cast<INT>(y + uHeight), static_cast<INT>(uWidth) });
+
+        for (size_t i = uNodeIndex + 1u; i < aSkyline.size();)
+        {
+            const SkylineNode& previous = aSkyline[i - 1u];
+            SkylineNode& node = aSkyline[i];
+
+            INT overlap = previous.x + previous.width - node.x;
+            if (overlap <= 0)
+                break;
+
+            node.x += overlap;
+            node.width -= overlap;
+            if (node.width > 0)
+                break;
+
+            aSkyline.erase(aSkyline.begin() + static_cast<ptrdiff_t>(i));
+        }
+
+        for (size_t i = 0u; i + 1u < aSkyline.size();)
+        {
+            if (aSkyline[i].y == aSkyline[i + 1u].y)
+            {
+                aSkyline[i].width += aSkyline[i + 1u].width;
+                aSkyline.erase(aSkyline.begin() + static_cast<ptrdiff_t>(i + 1u));
+            }
+            else
+                ++i;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AtlasPacker::copyWithGutter
+
+      Summary:  Copies a source texture into its padded region, filling
+                the gutter with the nearest edge texel
+
+      Args:     const WIC_DECODED_IMAGE& source
+                  Decoded RGBA 32-bit source texture
+                WIC_DECODED_IMAGE& atlas
+                  Atlas with one mip level
+                UINT x
+                  Left of the padded region
+                UINT y
+                  Top of the padded region
+
+      Modifies: [atlas].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AtlasPacker::copyWithGutter(
+        _In_ const WIC_DECODED_IMAGE& source,
+        _Inout_ WIC_DECODED_IMAGE& atlas,
+        _In_ UINT x,
+        _In_ UINT y
+    )
+    {
+        UINT uPaddedWidth = GetPaddedSize(source.width);
+        UINT uPaddedHeight = GetPaddedSize(source.height);
+
+        for (UINT py = 0u; py < uPaddedHeight; ++py)
+        {
+            UINT uSourceY = static_cast<UINT>(std::clamp<INT>(static_cast<INT>(py) - static_cast<INT>(GUTTER_SIZE), 0, static_cast<INT>(source.height) - 1));
+            const BYTE* pSourceRow = source.pixels.get() + source.rowPitch * uSourceY;
+            BYTE* pAtlasRow = atlas.pixels.get() + atlas.rowPitch * (y + py) + static_cast<size_t>(x) * 4u;
+
+            for (UINT px = 0u; px < uPaddedWidth; ++px)
+            {
+                UINT uSourceX = static_cast<UINT>(std::clamp<INT>(static_cast<INT>(px) - static_cast<INT>(GUTTER_SIZE), 0, static_cast<INT>(source.width) - 1));
+                memcpy(pAtlasRow + static_cast<size_t>(px) * 4u, pSourceRow + static_cast<size_t>(uSourceX) * 4u, 4u);
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+/*+===================================================================
+  File:      ATLASPACKER.H
+
+  Summary:   AtlasPacker header file contains declaration of class
+             AtlasPacker used to place decoded images into a texture
+             atlas and to map texture coordinates into it.
+
+  Classes:  AtlasPacker
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/ImageDecoder.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   AtlasRegion
+
+        Summary:  Placement of a source texture in the atlas, a texture
+                  coordinate of the source maps to Offset + uv * Scale
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AtlasRegion
+    {
+        XMFLOAT2 Offset;
+        XMFLOAT2 Scale;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   AtlasPlacement
+
+        Summary:  Top left corner of the padded region of a source image
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AtlasPlacement
+    {
+        size_t uSourceIndex;
+        UINT x;
+        UINT y;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    AtlasPacker
+
+      Summary:  Packs small images into one square image with a skyline
+                bottom-left bin packer. Every region is surrounded by a
+                gutter repeating its edge texels and starts on a
+                multiple of the gutter size, so the regions do not bleed
+                into each other down to the last mip level of the atlas
+
+      Methods:  Pack
+                  Places the images in the smallest atlas holding them
+                Compose
+                  Copies the placed images into the atlas image
+                GetRegion
+                  Returns the placement of an image in texture space
+                RemapTexCoord
+                  Maps a source texture coordinate into the atlas
+                GetPaddedSize
+                  Returns the size of a region with its gutter
+                AtlasPacker
+                  Constructor.
+                ~AtlasPacker
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class AtlasPacker final
+    {
+    public:
+        static constexpr const UINT MAX_SOURCE_SIZE = 512u;
+        static constexpr const UINT MIN_ATLAS_SIZE = 256u;
+        static constexpr const UINT MAX_ATLAS_SIZE = 4096u;
+        static constexpr const UINT NUM_MIP_LEVELS = 4u;
+        static constexpr const UINT GUTTER_SIZE = 1u << (NUM_MIP_LEVELS - 1u);
+
+        AtlasPacker() = delete;
+        AtlasPacker(const AtlasPacker& other) = delete;
+        AtlasPacker(AtlasPacker&& other) = delete;
+        AtlasPacker& operator=(const AtlasPacker& other) = delete;
+        AtlasPacker& operator=(AtlasPacker&& other) = delete;
+        ~AtlasPacker() = default;
+
+        static UINT Pack(_In_ const std::vector<WIC_DECODED_IMAGE>& aImages, _Out_ std::vector<AtlasPlacement>& aOutPlacements);
+        static HRESULT Compose(
+            _In_ UINT uAtlasSize,
+            _In_ const std::vector<WIC_DECODED_IMAGE>& aImages,
+            _In_ const std::vector<AtlasPlacement>& aPlacements,
+            _Out_ WIC_DECODED_IMAGE& outAtlas
+        );
+        static AtlasRegion GetRegion(_In_ UINT uAtlasSize, _In_ const WIC_DECODED_IMAGE& image, _In_ const AtlasPlacement& placement);
+        static XMFLOAT2 RemapTexCoord(_In_ const AtlasRegion& region, _In_ const XMFLOAT2& texCoord);
+        static UINT GetPaddedSize(_In_ UINT uSize);
+
+    private:
+        struct SkylineNode
+        {
+            INT x;
+            INT y;
+            INT width;
+        };
+
+        static void pack(
+            _In_ UINT uAtlasSize,
+            _In_ const std::vector<WIC_DECODED_IMAGE>& aImages,
+            _In_ const std::vector<size_t>& aOrder,
+            _Out_ std::vector<AtlasPlacement>& aOutPlacements
+        );
+        static BOOL findSkylinePosition(
+            _In_ const std::vector<SkylineNode>& aSkyline,
+            _In_ UINT uAtlasSize,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _Out_ size_t& uOutNodeIndex,
+            _Out_ UINT& uOutX,
+            _Out_ UINT& uOutY
+        );
+        static void addSkylineLevel(
+            _Inout_ std::vector<SkylineNode>& aSkyline,
+            _In_ size_t uNodeIndex,
+            _In_ UINT x,
+            _In_ UINT y,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight
+        );
+        static void copyWithGutter(
+            _In_ const WIC_DECODED_IMAGE& source,
+            _Inout_ WIC_DECODED_IMAGE& atlas,
+            _In_ UINT x,
+            _In_ UINT y
+        );
+    };
+}
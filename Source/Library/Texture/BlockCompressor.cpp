@@ -0,0 +1,786 @@
+#include "Texture/BlockCompressor.h"
+
+#include <fstream>
+
+#include "Texture/DDSTextureInfo.h"
+#include "Texture/ImageDecoder.h"
+#include "Texture/MipmapGenerator.h"
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT32 DDSD_CAPS = 0x1u;
+        constexpr const UINT32 DDSD_WIDTH = 0x4u;
+        constexpr const UINT32 DDSD_PIXELFORMAT = 0x1000u;
+        constexpr const UINT32 DDSD_MIPMAPCOUNT = 0x20000u;
+        constexpr const UINT32 DDSD_LINEARSIZE = 0x80000u;
+        constexpr const UINT32 DDSCAPS_COMPLEX = 0x8u;
+        constexpr const UINT32 DDSCAPS_TEXTURE = 0x1000u;
+        constexpr const UINT32 DDSCAPS_MIPMAP = 0x400000u;
+
+        // BC7 interpolation weights of 4-bit indices
+        constexpr const UINT BC7_WEIGHTS4[16] = { 0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::GetTextureUsage
+
+      Summary:  Returns the usage of a texture from the suffix of its
+                file name, as named by the model assets
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture
+
+      Returns:  eTextureUsage
+                  NORMAL for _ddn, SPECULAR for _spec and _refl,
+                  DIFFUSE otherwise
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eTextureUsage BlockCompressor::GetTextureUsage(_In_ const std::filesystem::path& filePath)
+    {
+        std::wstring szStem = filePath.stem().wstring();
+        std::transform(szStem.begin(), szStem.end(), szStem.begin(), towlower);
+
+        if (szStem.ends_with(L"_ddn"))
+            return eTextureUsage::NORMAL;
+
+        if (szStem.ends_with(L"_spec") || szStem.ends_with(L"_refl"))
+            return eTextureUsage::SPECULAR;
+
+        return eTextureUsage::DIFFUSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::GetCompressedFormat
+
+      Summary:  Returns the block compressed format of a usage
+
+      Args:     eTextureUsage usage
+                  Usage of the texture
+                BOOL bHasAlpha
+                  TRUE if any texel is not opaque
+
+      Returns:  DXGI_FORMAT
+                  BC1 or BC3 for diffuse maps, BC5 for the two channels
+                  of normal maps, BC7 for specular maps
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DXGI_FORMAT BlockCompressor::GetCompressedFormat(_In_ eTextureUsage usage, _In_ BOOL bHasAlpha)
+    {
+        switch (usage)
+        {
+        case eTextureUsage::NORMAL:
+            return DXGI_FORMAT_BC5_UNORM;
+
+        case eTextureUsage::SPECULAR:
+            return DXGI_FORMAT_BC7_UNORM;
+
+        default:
+            return bHasAlpha ? DXGI_FORMAT_BC3_UNORM : DXGI_FORMAT_BC1_UNORM;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::GetCompressedPath
+
+      Summary:  Returns the path of the DDS file of a source image
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source image
+
+      Returns:  std::filesystem::path
+                  Source path with the .dds extension
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::path BlockCompressor::GetCompressedPath(_In_ const std::filesystem::path& sourcePath)
+    {
+        std::filesystem::path compressedPath = sourcePath;
+        return compressedPath.replace_extension(L".dds");
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::IsCompressedFileUpToDate
+
+      Summary:  Returns whether the DDS file of the source image exists
+                and was written after the source was modified
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source image
+
+      Returns:  BOOL
+                  TRUE if the DDS file can be used instead
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL BlockCompressor::IsCompressedFileUpToDate(_In_ const std::filesystem::path& sourcePath)
+    {
+        std::error_code errorCode;
+
+        std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(sourcePath, errorCode);
+        if (errorCode)
+            return FALSE;
+
+        std::filesystem::file_time_type compressedTime = std::filesystem::last_write_time(GetCompressedPath(sourcePath), errorCode);
+        if (errorCode)
+            return FALSE;
+
+        return compressedTime >= sourceTime;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::CompressFile
+
+      Summary:  Decodes the source image, generates its mip chain with
+                the Kaiser filter and writes every level block
+                compressed into the DDS file returned by
+                GetCompressedPath
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source image
+
+      Returns:  HRESULT
+                  Status code, ERROR_NOT_SUPPORTED if the image is not
+                  made of whole 4x4 blocks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT BlockCompressor::CompressFile(_In_ const std::filesystem::path& sourcePath)
+    {
+        // The decoder always returns RGBA 32-bit texels
+        WIC_DECODED_IMAGE image = {};
+        HRESULT hr = ImageDecoder::DecodeFromFile(sourcePath, image);
+        if (FAILED(hr))
+            return hr;
+
+        // The top level of a block compressed texture must be made of whole blocks
+        if (image.width % 4u || image.height % 4u)
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+        BOOL bHasAlpha = FALSE;
+        for (size_t y = 0u; y < image.height && !bHasAlpha; ++y)
+        {
+            const BYTE* pRow = image.pixels.get() + image.rowPitch * y;
+            for (size_t x = 0u; x < image.width; ++x)
+            {
+                if (pRow[x * 4u + 3u] != 0xFFu)
+                {
+                    bHasAlpha = TRUE;
+                    break;
+                }
+            }
+        }
+
+        eTextureUsage usage = GetTextureUsage(sourcePath);
+        DXGI_FORMAT format = GetCompressedFormat(usage, bHasAlpha);
+
+        hr = MipmapGenerator::GenerateMipChain(image, usage != eTextureUsage::NORMAL, eMipFilter::KAISER);
+        if (FAILED(hr))
+            return hr;
+
+        size_t uBlockSize = getBlockSize(format);
+        size_t uTotalSize = 0u;
+        for (UINT i = 0u; i < image.mipLevels; ++i)
+        {
+            size_t uNumBlocksX = (std::max<size_t>(image.width >> i, 1u) + 3u) / 4u;
+            size_t uNumBlocksY = (std::max<size_t>(image.height >> i, 1u) + 3u) / 4u;
+            uTotalSize += uNumBlocksX * uNumBlocksY * uBlockSize;
+        }
+
+        std::vector<BYTE> aBlocks(uTotalSize);
+
+        const BYTE* pLevel = image.pixels.get();
+        BYTE* pBlocks = aBlocks.data();
+        for (UINT i = 0u; i < image.mipLevels; ++i)
+        {
+            UINT uWidth = std::max<UINT>(image.width >> i, 1u);
+            UINT uHeight = std::max<UINT>(image.height >> i, 1u);
+
+            CompressLevel(pLevel, uWidth, uHeight, format, pBlocks);
+
+            pLevel += static_cast<size_t>(uWidth) * uHeight * 4u;
+            pBlocks += ((uWidth + 3u) / 4u) * ((uHeight + 3u) / 4u) * uBlockSize;
+        }
+
+        return writeDDSFile(GetCompressedPath(sourcePath), image.width, image.height, image.mipLevels, format, aBlocks);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::CompressDirectory
+
+      Summary:  Compresses every image of the directory whose DDS file
+                is missing or older than the image. Files are processed
+                in parallel
+
+      Args:     const std::filesystem::path& directory
+                  Directory of the source images
+
+      Returns:  HRESULT
+                  Status code of the first failure, S_OK if every stale
+                  image was compressed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT BlockCompressor::CompressDirectory(_In_ const std::filesystem::path& directory)
+    {
+        std::error_code errorCode;
+        std::filesystem::directory_iterator directoryIterator(directory, errorCode);
+        if (errorCode)
+            return HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND);
+
+        std::vector<std::filesystem::path> aSourcePaths;
+        for (const std::filesystem::directory_entry& entry : directoryIterator)
+        {
+            if (!entry.is_regular_file())
+                continue;
+
+            std::wstring szExtension = entry.path().extension().wstring();
+            std::transform(szExtension.begin(), szExtension.end(), szExtension.begin(), towlower);
+
+            if (szExtension != L".png" && szExtension != L".jpg" && szExtension != L".jpeg" && szExtension != L".bmp")
+                continue;
+
+            if (!IsCompressedFileUpToDate(entry.path()))
+                aSourcePaths.push_back(entry.path());
+        }
+
+        std::vector<HRESULT> aResults(aSourcePaths.size(), S_OK);
+
+        std::vector<size_t> aIndices(aSourcePaths.size());
+        std::iota(aIndices.begin(), aIndices.end(), 0ull);
+
+        std::for_each(std::execution::par, aIndices.begin(), aIndices.end(),
+            [&](size_t uIndex)
+            {
+                aResults[uIndex] = CompressFile(aSourcePaths[uIndex]);
+            }
+        );
+
+        for (size_t i = 0u; i < aResults.size(); ++i)
+        {
+            OutputDebugString(SUCCEEDED(aResults[i]) ? L"Compressed texture \"" : L"Error compressing texture \"");
+            OutputDebugString(aSourcePaths[i].wstring().c_str());
+            OutputDebugString(L"\"\n");
+        }
+
+        auto it = std::find_if(aResults.begin(), aResults.end(), [](HRESULT hr) { return FAILED(hr); });
+        return it != aResults.end() ? *it : S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::CompressLevel
+
+      Summary:  Compresses one mip level, rows of blocks are compressed
+                in parallel. Blocks on the edge of levels smaller than
+                4x4 repeat the last texel
+
+      Args:     const BYTE* pRgba
+                  RGBA 32-bit texels of the level with tight rows
+                UINT uWidth
+                  Width of the level
+                UINT uHeight
+                  Height of the level
+                DXGI_FORMAT format
+                  Block compressed format
+                BYTE* pBlocks
+                  Destination blocks
+
+      Modifies: [pBlocks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::CompressLevel(
+        _In_ const BYTE* pRgba,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ DXGI_FORMAT format,
+        _Out_ BYTE* pBlocks
+    )
+    {
+        UINT uNumBlocksX = (uWidth + 3u) / 4u;
+        UINT uNumBlocksY = (uHeight + 3u) / 4u;
+        size_t uBlockSize = getBlockSize(format);
+
+        std::vector<UINT> aBlockRows(uNumBlocksY);
+        std::iota(aBlockRows.begin(), aBlockRows.end(), 0u);
+
+        std::for_each(std::execution::par, aBlockRows.begin(), aBlockRows.end(),
+            [&](UINT uBlockY)
+            {
+                XMVECTOR aTexels[16];
+                BYTE aRed[16];
+                BYTE aGreen[16];
+                BYTE aAlpha[16];
+
+                for (UINT uBlockX = 0u; uBlockX < uNumBlocksX; ++uBlockX)
+                {
+                    for (UINT i = 0u; i < 16u; ++i)
+                    {
+                        UINT x = std::min<UINT>(uBlockX * 4u + (i & 3u), uWidth - 1u);
+                        UINT y = std::min<UINT>(uBlockY * 4u + (i >> 2u), uHeight - 1u);
+                        const BYTE* pTexel = pRgba + (static_cast<size_t>(y) * uWidth + x) * 4u;
+
+                        aTexels[i] = XMVectorSet(pTexel[0], pTexel[1], pTexel[2], pTexel[3]);
+                        aRed[i] = pTexel[0];
+                        aGreen[i] = pTexel[1];
+                        aAlpha[i] = pTexel[3];
+                    }
+
+                    BYTE* pBlock = pBlocks + (static_cast<size_t>(uBlockY) * uNumBlocksX + uBlockX) * uBlockSize;
+                    switch (format)
+                    {
+                    case DXGI_FORMAT_BC1_UNORM:
+                        compressBC1Block(aTexels, pBlock);
+                        break;
+
+                    case DXGI_FORMAT_BC3_UNORM:
+                        compressBC4Block(aAlpha, pBlock);
+                        compressBC1Block(aTexels, pBlock + 8u);
+                        break;
+
+                    case DXGI_FORMAT_BC5_UNORM:
+                        compressBC4Block(aRed, pBlock);
+                        compressBC4Block(aGreen, pBlock + 8u);
+                        break;
+
+                    case DXGI_FORMAT_BC7_UNORM:
+                        compressBC7Block(aTexels, pBlock);
+                        break;
+
+                    default:
+                        assert(FALSE);
+                        break;
+                    }
+                }
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::compressBC1Block
+
+      Summary:  Compresses the color of a block in the four color mode.
+                The endpoints are the extents of the texels along their
+                principal axis
+
+      Args:     const XMVECTOR* aTexels
+                  16 texels in [0, 255]
+                BYTE* pBlock
+                  8 bytes of the block
+
+      Modifies: [pBlock].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::compressBC1Block(_In_reads_(16) const XMVECTOR* aTexels, _Out_writes_(8) BYTE* pBlock)
+    {
+        const XMVECTOR rgbMask = XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f);
+
+        XMVECTOR mean = XMVectorZero();
+        for (UINT i = 0u; i < 16u; ++i)
+            mean = XMVectorAdd(mean, aTexels[i]);
+        mean = XMVectorMultiply(XMVectorScale(mean, 1.0f / 16.0f), rgbMask);
+
+        XMVECTOR axis = getPrincipalAxis(aTexels, mean, rgbMask);
+
+        FLOAT minProjection = 0.0f;
+        FLOAT maxProjection = 0.0f;
+        for (UINT i = 0u; i < 16u; ++i)
+        {
+            FLOAT projection = XMVectorGetX(XMVector3Dot(XMVectorSubtract(aTexels[i], mean), axis));
+            minProjection = std::min<FLOAT>(minProjection, projection);
+            maxProjection = std::max<FLOAT>(maxProjection, projection);
+        }
+
+        WORD uColor0 = pack565(XMVectorMultiplyAdd(axis, XMVectorReplicate(maxProjection), mean));
+        WORD uColor1 = pack565(XMVectorMultiplyAdd(axis, XMVectorReplicate(minProjection), mean));
+
+        // The four color mode requires color0 > color1
+        if (uColor0 < uColor1)
+            std::swap(uColor0, uColor1);
+
+        UINT32 uIndices = 0u;
+        if (uColor0 != uColor1)
+        {
+            XMVECTOR endpoint0 = unpack565(uColor0);
+            XMVECTOR endpoint1 = unpack565(uColor1);
+            const XMVECTOR aPalette[4] =
+            {
+                endpoint0,
+                endpoint1,
+                XMVectorLerp(endpoint0, endpoint1, 1.0f / 3.0f),
+                XMVectorLerp(endpoint0, endpoint1, 2.0f / 3.0f),
+            };
+
+            for (UINT i = 0u; i < 16u; ++i)
+            {
+                UINT uBestIndex = 0u;
+                FLOAT bestDistance = (std::numeric_limits<FLOAT>::max)();
+                for (UINT j = 0u; j < 4u; ++j)
+                {
+                    FLOAT distance = XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(aTexels[i], aPalette[j])));
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        uBestIndex = j;
+                    }
+                }
+
+                uIndices |= uBestIndex << (i * 2u);
+            }
+        }
+
+        pBlock[0] = static_cast<BYTE>(uColor0 & 0xFFu);
+        pBlock[1] = static_cast<BYTE>(uColor0 >> 8u);
+        pBlock[2] = static_cast<BYTE>(uColor1 & 0xFFu);
+        pBlock[3] = static_cast<BYTE>(uColor1 >> 8u);
+        for (UINT i = 0u; i < 4u; ++i)
+            pBlock[4u + i] = static_cast<BYTE>(uIndices >> (i * 8u));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::compressBC4Block
+
+      Summary:  Compresses one channel of a block in the eight value
+                mode, used for BC3 alpha and both BC5 channels
+
+      Args:     const BYTE* aValues
+                  16 channel values
+                BYTE* pBlock
+                  8 bytes of the block
+
+      Modifies: [pBlock].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::compressBC4Block(_In_reads_(16) const BYTE* aValues, _Out_writes_(8) BYTE* pBlock)
+    {
+        BYTE uValue0 = *std::max_element(aValues, aValues + 16);
+        BYTE uValue1 = *std::min_element(aValues, aValues + 16);
+
+        UINT64 uIndices = 0ull;
+        if (uValue0 != uValue1)
+        {
+            UINT auPalette[8] = { uValue0, uValue1 };
+            for (UINT i = 2u; i < 8u; ++i)
+                auPalette[i] = ((8u - i) * uValue0 + (i - 1u) * uValue1) / 7u;
+
+            for (UINT i = 0u; i < 16u; ++i)
+            {
+                UINT64 uBestIndex = 0ull;
+                INT bestDistance = INT_MAX;
+                for (UINT j = 0u; j < 8u; ++j)
+                {
+                    INT distance = abs(static_cast<INT>(aValues[i]) - static_cast<INT>(auPalette[j]));
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        uBestIndex = j;
+                    }
+                }
+
+                uIndices |= uBestIndex << (i * 3u);
+            }
+        }
+
+        pBlock[0] = uValue0;
+        pBlock[1] = uValue1;
+        for (UINT i = 0u; i < 6u; ++i)
+            pBlock[2u + i] = static_cast<BYTE>(uIndices >> (i * 8u));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::compressBC7Block
+
+      Summary:  Compresses a block with BC7 mode 6: one subset with
+                7-bit RGBA endpoints, a p-bit per endpoint and 4-bit
+                indices shared by color and alpha
+
+      Args:     const XMVECTOR* aTexels
+                  16 texels in [0, 255]
+                BYTE* pBlock
+                  16 bytes of the block
+
+      Modifies: [pBlock].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::compressBC7Block(_In_reads_(16) const XMVECTOR* aTexels, _Out_writes_(16) BYTE* pBlock)
+    {
+        const XMVECTOR rgbaMask = XMVectorSplatOne();
+
+        XMVECTOR mean = XMVectorZero();
+        for (UINT i = 0u; i < 16u; ++i)
+            mean = XMVectorAdd(mean, aTexels[i]);
+        mean = XMVectorScale(mean, 1.0f / 16.0f);
+
+        XMVECTOR axis = getPrincipalAxis(aTexels, mean, rgbaMask);
+
+        FLOAT minProjection = 0.0f;
+        FLOAT maxProjection = 0.0f;
+        for (UINT i = 0u; i < 16u; ++i)
+        {
+            FLOAT projection = XMVectorGetX(XMVector4Dot(XMVectorSubtract(aTexels[i], mean), axis));
+            minProjection = std::min<FLOAT>(minProjection, projection);
+            maxProjection = std::max<FLOAT>(maxProjection, projection);
+        }
+
+        XMFLOAT4 aEndpoints[2];
+        XMStoreFloat4(&aEndpoints[0], XMVectorClamp(XMVectorMultiplyAdd(axis, XMVectorReplicate(minProjection), mean), XMVectorZero(), XMVectorReplicate(255.0f)));
+        XMStoreFloat4(&aEndpoints[1], XMVectorClamp(XMVectorMultiplyAdd(axis, XMVectorReplicate(maxProjection), mean), XMVectorZero(), XMVectorReplicate(255.0f)));
+
+        // Quantize each endpoint to 7 bits per channel plus the p-bit giving the smallest error
+        UINT aauQuantized[2][4] = {};
+        UINT auPBits[2] = {};
+        for (UINT e = 0u; e < 2u; ++e)
+        {
+            const FLOAT afChannels[4] = { aEndpoints[e].x, aEndpoints[e].y, aEndpoints[e].z, aEndpoints[e].w };
+
+            FLOAT bestError = (std::numeric_limits<FLOAT>::max)();
+            for (UINT uPBit = 0u; uPBit < 2u; ++uPBit)
+            {
+                UINT auCandidate[4];
+                FLOAT error = 0.0f;
+                for (UINT c = 0u; c < 4u; ++c)
+                {
+                    INT value = static_cast<INT>(roundf((afChannels[c] - static_cast<FLOAT>(uPBit)) * 0.5f));
+                    auCandidate[c] = static_cast<UINT>(std::clamp<INT>(value, 0, 127));
+
+                    FLOAT delta = static_cast<FLOAT>((auCandidate[c] << 1u) | uPBit) - afChannels[c];
+                    error += delta * delta;
+                }
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    auPBits[e] = uPBit;
+                    memcpy(aauQuantized[e], auCandidate, sizeof(auCandidate));
+                }
+            }
+        }
+
+        XMVECTOR aPalette[16];
+        for (UINT i = 0u; i < 16u; ++i)
+        {
+            FLOAT afChannels[4];
+            for (UINT c = 0u; c < 4u; ++c)
+            {
+                UINT uValue0 = (aauQuantized[0][c] << 1u) | auPBits[0];
+                UINT uValue1 = (aauQuantized[1][c] << 1u) | auPBits[1];
+                afChannels[c] = static_cast<FLOAT>(((64u - BC7_WEIGHTS4[i]) * uValue0 + BC7_WEIGHTS4[i] * uValue1 + 32u) >> 6u);
+            }
+
+            aPalette[i] = XMVectorSet(afChannels[0], afChannels[1], afChannels[2], afChannels[3]);
+        }
+
+        UINT auIndices[16];
+        for (UINT i = 0u; i < 16u; ++i)
+        {
+            UINT uBestIndex = 0u;
+            FLOAT bestDistance = (std::numeric_limits<FLOAT>::max)();
+            for (UINT j = 0u; j < 16u; ++j)
+            {
+                FLOAT distance = XMVectorGetX(XMVector4LengthSq(XMVectorSubtract(aTexels[i], aPalette[j])));
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    uBestIndex = j;
+                }
+            }
+
+            auIndices[i] = uBestIndex;
+        }
+
+        // The most significant bit of the anchor index is implied to be zero
+        if (auIndices[0] & 0x8u)
+        {
+            std::swap(aauQuantized[0], aauQuantized[1]);
+            std::swap(auPBits[0], auPBits[1]);
+            for (UINT i = 0u; i < 16u; ++i)
+                auIndices[i] = 15u - auIndices[i];
+        }
+
+        memset(pBlock, 0, 16u);
+        UINT uBitOffset = 0u;
+        auto writeBits = [&](UINT uValue, UINT uNumBits)
+        {
+            for (UINT i = 0u; i < uNumBits; ++i, ++uBitOffset)
+            {
+                if (uValue & (1u << i))
+                    pBlock[uBitOffset >> 3u] |= static_cast<BYTE>(1u << (uBitOffset & 7u));
+            }
+        };
+
+        writeBits(1u << 6u, 7u);
+        for (UINT c = 0u; c < 4u; ++c)
+        {
+            writeBits(aauQuantized[0][c], 7u);
+            writeBits(aauQuantized[1][c], 7u);
+        }
+        writeBits(auPBits[0], 1u);
+        writeBits(auPBits[1], 1u);
+
+        writeBits(auIndices[0], 3u);
+        for (UINT i = 1u; i < 16u; ++i)
+            writeBits(auIndices[i], 4u);
+
+        assert(uBitOffset == 128u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::getPrincipalAxis
+
+      Summary:  Finds the direction of largest variance of the texels by
+                power iteration on their covariance, starting from the
+                diagonal of their bounding box
+
+      Args:     const XMVECTOR* aTexels
+                  16 texels
+                FXMVECTOR mean
+                  Mean of the texels
+                FXMVECTOR channelMask
+                  1 for the channels to consider, 0 otherwise
+
+      Returns:  XMVECTOR
+                  Normalized axis, zero if every texel is the same
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR BlockCompressor::getPrincipalAxis(_In_reads_(16) const XMVECTOR* aTexels, _In_ FXMVECTOR mean, _In_ FXMVECTOR channelMask)
+    {
+        XMVECTOR minTexel = aTexels[0];
+        XMVECTOR maxTexel = aTexels[0];
+        for (UINT i = 1u; i < 16u; ++i)
+        {
+            minTexel = XMVectorMin(minTexel, aTexels[i]);
+            maxTexel = XMVectorMax(maxTexel, aTexels[i]);
+        }
+
+        XMVECTOR axis = XMVectorMultiply(XMVectorSubtract(maxTexel, minTexel), channelMask);
+        if (XMVectorGetX(XMVector4LengthSq(axis)) < 1e-6f)
+            return XMVectorZero();
+
+        axis = XMVector4Normalize(axis);
+        for (UINT uIteration = 0u; uIteration < 8u; ++uIteration)
+        {
+            XMVECTOR next = XMVectorZero();
+            for (UINT i = 0u; i < 16u; ++i)
+            {
+                XMVECTOR delta = XMVectorMultiply(XMVectorSubtract(aTexels[i], mean), channelMask);
+                next = XMVectorMultiplyAdd(delta, XMVector4Dot(delta, axis), next);
+            }
+
+            if (XMVectorGetX(XMVector4LengthSq(next)) < 1e-6f)
+                break;
+
+            axis = XMVector4Normalize(next);
+        }
+
+        return axis;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::getBlockSize
+
+      Summary:  Returns the number of bytes of a 4x4 block
+
+      Args:     DXGI_FORMAT format
+                  Block compressed format
+
+      Returns:  size_t
+                  8 for BC1, 16 otherwise
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t BlockCompressor::getBlockSize(_In_ DXGI_FORMAT format)
+    {
+        return format == DXGI_FORMAT_BC1_UNORM ? 8u : 16u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::pack565
+
+      Summary:  Rounds a color in [0, 255] to 5:6:5 bits
+
+      Args:     FXMVECTOR color
+                  Color to pack
+
+      Returns:  WORD
+                  Packed color
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    WORD BlockCompressor::pack565(_In_ FXMVECTOR color)
+    {
+        XMVECTOR scaled = XMVectorMultiply(XMVectorClamp(color, XMVectorZero(), XMVectorReplicate(255.0f)), XMVectorSet(31.0f / 255.0f, 63.0f / 255.0f, 31.0f / 255.0f, 0.0f));
+        XMFLOAT4 rounded;
+        XMStoreFloat4(&rounded, XMVectorRound(scaled));
+
+        return static_cast<WORD>((static_cast<UINT>(rounded.x) << 11u) | (static_cast<UINT>(rounded.y) << 5u) | static_cast<UINT>(rounded.z));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::unpack565
+
+      Summary:  Expands a 5:6:5 color the way the hardware decodes it
+
+      Args:     WORD uColor
+                  Packed color
+
+      Returns:  XMVECTOR
+                  Color in [0, 255]
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR BlockCompressor::unpack565(_In_ WORD uColor)
+    {
+        UINT uRed = (uColor >> 11u) & 0x1Fu;
+        UINT uGreen = (uColor >> 5u) & 0x3Fu;
+        UINT uBlue = uColor & 0x1Fu;
+
+        return XMVectorSet(
+            static_cast<FLOAT>((uRed << 3u) | (uRed >> 2u)),
+            static_cast<FLOAT>((uGreen << 2u) | (uGreen >> 4u)),
+            static_cast<FLOAT>((uBlue << 3u) | (uBlue >> 2u)),
+            255.0f
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::writeDDSFile
+
+      Summary:  Writes the blocks of every mip level as a DDS file with
+                the DX10 extended header
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the DDS file
+                UINT uWidth
+                  Width of the first level
+                UINT uHeight
+                  Height of the first level
+                UINT uMipLevels
+                  Number of mip levels
+                DXGI_FORMAT format
+                  Block compressed format
+                const std::vector<BYTE>& aBlocks
+                  Blocks of every level, first level first
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT BlockCompressor::writeDDSFile(
+        _In_ const std::filesystem::path& filePath,
+        _In_ UINT uWidth,
+        _In_ UINT uHeight,
+        _In_ UINT uMipLevels,
+        _In_ DXGI_FORMAT format,
+        _In_ const std::vector<BYTE>& aBlocks
+    )
+    {
+        DDS_HEADER header = {};
+        header.size = sizeof(DDS_HEADER);
+        header.flags = DDSD_CAPS | DDS_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+        header.height = uHeight;
+        header.width = uWidth;
+        header.pitchOrLinearSize = static_cast<UINT32>(((uWidth + 3u) / 4u) * ((uHeight + 3u) / 4u) * getBlockSize(format));
+        header.mipMapCount = uMipLevels;
+        header.ddspf.size = sizeof(DDS_PIXELFORMAT);
+        header.ddspf.flags = DDS_FOURCC;
+        header.ddspf.fourCC = MAKEFOURCC('D', 'X', '1', '0');
+        header.caps = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+
+        DDS_HEADER_DXT10 headerDXT10 = {};
+        headerDXT10.dxgiFormat = format;
+        headerDXT10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+        headerDXT10.arraySize = 1u;
+
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+            return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+
+        outputFile.write(reinterpret_cast<const CHAR*>(&DDS_MAGIC), sizeof(DDS_MAGIC));
+        outputFile.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+        outputFile.write(reinterpret_cast<const CHAR*>(&headerDXT10), sizeof(headerDXT10));
+        outputFile.write(reinterpret_cast<const CHAR*>(aBlocks.data()), static_cast<std::streamsize>(aBlocks.size()));
+
+        if (!outputFile)
+            return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+
+        return S_OK;
+    }
+}
@@ -0,0 +1,107 @@
+/*+===================================================================
+  File:      BLOCKCOMPRESSOR.H
+
+  Summary:   BlockCompressor header file contains declaration of class
+             BlockCompressor used to convert source images into block
+             compressed DDS files.
+
+  Classes:  BlockCompressor
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/ImageDecoder.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eTextureUsage
+
+        Summary:  Enumeration of what the texels of a texture describe
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eTextureUsage : BYTE
+    {
+        DIFFUSE,
+        NORMAL,
+        SPECULAR,
+        COUNT,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BlockCompressor
+
+      Summary:  Asset pipeline step that decodes a source image, builds
+                its mip chain and writes it as a block compressed DDS
+                file next to the source. The format depends on the
+                usage of the texture: BC1 or BC3 for diffuse maps, BC5
+                for normal maps and BC7 for specular maps. BC7 blocks
+                are only encoded in mode 6, a single subset with RGBA
+                endpoints, which trades quality on blocks with several
+                distinct colors for a much smaller search
+
+      Methods:  GetTextureUsage
+                  Returns the usage of a texture from its file name
+                GetCompressedFormat
+                  Returns the block compressed format of a usage
+                GetCompressedPath
+                  Returns the path of the DDS file of a source image
+                IsCompressedFileUpToDate
+                  Returns whether the DDS file is newer than the source
+                CompressFile
+                  Writes the DDS file of a source image
+                CompressDirectory
+                  Writes the DDS files of every stale source image in
+                  a directory
+                CompressLevel
+                  Compresses the texels of one mip level
+                BlockCompressor
+                  Constructor.
+                ~BlockCompressor
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BlockCompressor final
+    {
+    public:
+        BlockCompressor() = delete;
+        BlockCompressor(const BlockCompressor& other) = delete;
+        BlockCompressor(BlockCompressor&& other) = delete;
+        BlockCompressor& operator=(const BlockCompressor& other) = delete;
+        BlockCompressor& operator=(BlockCompressor&& other) = delete;
+        ~BlockCompressor() = delete;
+
+        static eTextureUsage GetTextureUsage(_In_ const std::filesystem::path& filePath);
+        static DXGI_FORMAT GetCompressedFormat(_In_ eTextureUsage usage, _In_ BOOL bHasAlpha);
+        static std::filesystem::path GetCompressedPath(_In_ const std::filesystem::path& sourcePath);
+        static BOOL IsCompressedFileUpToDate(_In_ const std::filesystem::path& sourcePath);
+
+        static HRESULT CompressFile(_In_ const std::filesystem::path& sourcePath);
+        static HRESULT CompressDirectory(_In_ const std::filesystem::path& directory);
+        static void CompressLevel(
+            _In_ const BYTE* pRgba,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ DXGI_FORMAT format,
+            _Out_ BYTE* pBlocks
+        );
+
+    private:
+        static void compressBC1Block(_In_reads_(16) const XMVECTOR* aTexels, _Out_writes_(8) BYTE* pBlock);
+        static void compressBC4Block(_In_reads_(16) const BYTE* aValues, _Out_writes_(8) BYTE* pBlock);
+        static void compressBC7Block(_In_reads_(16) const XMVECTOR* aTexels, _Out_writes_(16) BYTE* pBlock);
+        static XMVECTOR getPrincipalAxis(_In_reads_(16) const XMVECTOR* aTexels, _In_ FXMVECTOR mean, _In_ FXMVECTOR channelMask);
+        static HRESULT writeDDSFile(
+            _In_ const std::filesystem::path& filePath,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ UINT uMipLevels,
+            _In_ DXGI_FORMAT format,
+            _In_ const std::vector<BYTE>& aBlocks
+        );
+        static size_t getBlockSize(_In_ DXGI_FORMAT format);
+        static WORD pack565(_In_ FXMVECTOR color);
+        static XMVECTOR unpack565(_In_ WORD uColor);
+    };
+}
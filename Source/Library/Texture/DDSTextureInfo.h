@@ -0,0 +1,204 @@
+//--------------------------------------------------------------------------------------
+// File: DDSTextureInfo.h
+//
+// Functions for parsing the header and the subresource layout of a DDS texture
+//
+// Note these functions only read memory and know nothing of Direct3D, so they also build
+// where it is not available. DDSTextureLoader creates the resources on top of them.
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License (MIT).
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+// http://go.microsoft.com/fwlink/?LinkId=248929
+//--------------------------------------------------------------------------------------
+#pragma once
+
+#include "Platform.h"
+
+#include "Texture/DXGIFormat.h"
+
+//--------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------
+#ifndef MAKEFOURCC
+#define MAKEFOURCC(ch0, ch1, ch2, ch3)                              \
+                ((uint32_t)(uint8_t)(ch0) | ((uint32_t)(uint8_t)(ch1) << 8) |       \
+                ((uint32_t)(uint8_t)(ch2) << 16) | ((uint32_t)(uint8_t)(ch3) << 24 ))
+#endif /* defined(MAKEFOURCC) */
+
+//--------------------------------------------------------------------------------------
+// DDS file structure definitions
+//
+// See DDS.h in the 'Texconv' sample and the 'DirectXTex' library
+//--------------------------------------------------------------------------------------
+#pragma pack(push,1)
+
+const uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+
+struct DDS_PIXELFORMAT
+{
+    uint32_t    size;
+    uint32_t    flags;
+    uint32_t    fourCC;
+    uint32_t    RGBBitCount;
+    uint32_t    RBitMask;
+    uint32_t    GBitMask;
+    uint32_t    BBitMask;
+    uint32_t    ABitMask;
+};
+
+#define DDS_FOURCC      0x00000004  // DDPF_FOURCC
+#define DDS_RGB         0x00000040  // DDPF_RGB
+#define DDS_LUMINANCE   0x00020000  // DDPF_LUMINANCE
+#define DDS_ALPHA       0x00000002  // DDPF_ALPHA
+#define DDS_BUMPDUDV    0x00080000  // DDPF_BUMPDUDV
+
+#define DDS_HEADER_FLAGS_VOLUME         0x00800000  // DDSD_DEPTH
+
+#define DDS_HEIGHT 0x00000002 // DDSD_HEIGHT
+
+#define DDS_CUBEMAP_POSITIVEX 0x00000600 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEX
+#define DDS_CUBEMAP_NEGATIVEX 0x00000a00 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEX
+#define DDS_CUBEMAP_POSITIVEY 0x00001200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEY
+#define DDS_CUBEMAP_NEGATIVEY 0x00002200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEY
+#define DDS_CUBEMAP_POSITIVEZ 0x00004200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEZ
+#define DDS_CUBEMAP_NEGATIVEZ 0x00008200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEZ
+
+#define DDS_CUBEMAP_ALLFACES ( DDS_CUBEMAP_POSITIVEX | DDS_CUBEMAP_NEGATIVEX |\
+                               DDS_CUBEMAP_POSITIVEY | DDS_CUBEMAP_NEGATIVEY |\
+                               DDS_CUBEMAP_POSITIVEZ | DDS_CUBEMAP_NEGATIVEZ )
+
+#define DDS_CUBEMAP 0x00000200 // DDSCAPS2_CUBEMAP
+
+enum DDS_MISC_FLAGS2
+{
+    DDS_MISC_FLAGS2_ALPHA_MODE_MASK = 0x7L,
+};
+
+struct DDS_HEADER
+{
+    uint32_t        size;
+    uint32_t        flags;
+    uint32_t        height;
+    uint32_t        width;
+    uint32_t        pitchOrLinearSize;
+    uint32_t        depth; // only if DDS_HEADER_FLAGS_VOLUME is set in flags
+    uint32_t        mipMapCount;
+    uint32_t        reserved1[11];
+    DDS_PIXELFORMAT ddspf;
+    uint32_t        caps;
+    uint32_t        caps2;
+    uint32_t        caps3;
+    uint32_t        caps4;
+    uint32_t        reserved2;
+};
+
+struct DDS_HEADER_DXT10
+{
+    DXGI_FORMAT     dxgiFormat;
+    uint32_t        resourceDimension;
+    uint32_t        miscFlag; // see D3D11_RESOURCE_MISC_FLAG
+    uint32_t        arraySize;
+    uint32_t        miscFlags2;
+};
+
+#pragma pack(pop)
+
+namespace DirectX
+{
+#ifndef DDS_ALPHA_MODE_DEFINED
+#define DDS_ALPHA_MODE_DEFINED
+    enum DDS_ALPHA_MODE : uint32_t
+    {
+        DDS_ALPHA_MODE_UNKNOWN = 0,
+        DDS_ALPHA_MODE_STRAIGHT = 1,
+        DDS_ALPHA_MODE_PREMULTIPLIED = 2,
+        DDS_ALPHA_MODE_OPAQUE = 3,
+        DDS_ALPHA_MODE_CUSTOM = 4,
+    };
+#endif
+
+    // Same values as D3D11_RESOURCE_DIMENSION
+    enum DDS_RESOURCE_DIMENSION : uint32_t
+    {
+        DDS_DIMENSION_UNKNOWN = 0,
+        DDS_DIMENSION_TEXTURE1D = 2,
+        DDS_DIMENSION_TEXTURE2D = 3,
+        DDS_DIMENSION_TEXTURE3D = 4,
+    };
+
+    // Same value as D3D11_RESOURCE_MISC_TEXTURECUBE
+    constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+    // Device independent description of a DDS texture, mirrors the DDS header after validation
+    struct DDS_TEXTURE_INFO
+    {
+        uint32_t    width;
+        uint32_t    height;
+        uint32_t    depth;
+        size_t      mipCount;
+        uint32_t    arraySize;
+        DXGI_FORMAT format;
+        uint32_t    resourceDimension; // see DDS_RESOURCE_DIMENSION
+        bool        isCubeMap;
+    };
+
+    // Location of one subresource (array item major, mip minor) relative to the start of the file
+    struct DDS_SUBRESOURCE
+    {
+        size_t      offset;
+        size_t      rowPitch;
+        size_t      slicePitch;
+        size_t      width;
+        size_t      height;
+        size_t      depth;
+    };
+
+    // Parses the DDS data without creating any resources, pass null subresources to query
+    // the required count of (mipCount * arraySize)
+    HRESULT GetDDSTextureInfoFromMemory(
+        _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+        _In_ size_t ddsDataSize,
+        _Out_ DDS_TEXTURE_INFO* info,
+        _Out_writes_opt_(subresourceCount) DDS_SUBRESOURCE* subresources = nullptr,
+        _In_ size_t subresourceCount = 0) noexcept;
+
+    // Building blocks shared with DDSTextureLoader
+    namespace DDS
+    {
+        // Validates the magic number and the headers, and points past them
+        HRESULT LoadTextureDataFromMemory(
+            _In_reads_(ddsDataSize) const uint8_t* ddsData,
+            size_t ddsDataSize,
+            const DDS_HEADER** header,
+            const uint8_t** bitData,
+            size_t* bitSize) noexcept;
+
+        // Return the BPP for a particular format
+        size_t BitsPerPixel(_In_ DXGI_FORMAT fmt) noexcept;
+
+        // Get surface information for a particular format
+        HRESULT GetSurfaceInfo(
+            _In_ size_t width,
+            _In_ size_t height,
+            _In_ DXGI_FORMAT fmt,
+            size_t* outNumBytes,
+            _Out_opt_ size_t* outRowBytes,
+            _Out_opt_ size_t* outNumRows) noexcept;
+
+        // Interprets and bounds checks the DDS header, shared by every loader mode
+        HRESULT GetTextureInfo(
+            _In_ const DDS_HEADER* header,
+            _Out_ DDS_TEXTURE_INFO* info) noexcept;
+
+        // Describes every subresource as an offset into the DDS file without skipping mips
+        HRESULT GetSubresourceLayout(
+            _In_ const DDS_TEXTURE_INFO& info,
+            _In_ size_t bitOffset,
+            _In_ size_t bitSize,
+            _Out_writes_(subresourceCount) DDS_SUBRESOURCE* subresources,
+            _In_ size_t subresourceCount) noexcept;
+    }
+}
@@ -0,0 +1,213 @@
+#include "Texture/ImageDecoder.h"
+
+#ifdef _WIN32
+#include "Texture/WICTextureLoader.h"
+#else // _WIN32
+#include <csetjmp>
+#include <cstdio>
+#include <fstream>
+
+#include <jpeglib.h>
+#include <png.h>
+#endif // _WIN32
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImageDecoder::DecodeFromFile
+
+      Summary:  Decodes an image file into a single level RGBA8 image.
+                Off Windows the decoder is picked from the signature at
+                the start of the file
+
+      Args:     const std::filesystem::path& filePath
+                  Path of the PNG or JPEG file
+                WIC_DECODED_IMAGE& image
+                  Decoded image
+
+      Modifies: [image].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ImageDecoder::DecodeFromFile(_In_ const std::filesystem::path& filePath, _Out_ WIC_DECODED_IMAGE& image)
+    {
+        image = {};
+
+#ifdef _WIN32
+        return DecodeWICTextureFromFile(nullptr, filePath.c_str(), image);
+#else // _WIN32
+        BYTE aSignature[8] = { };
+        {
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file)
+                return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+
+            file.read(reinterpret_cast<CHAR*>(aSignature), sizeof(aSignature));
+            if (file.gcount() != sizeof(aSignature))
+                return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        if (png_sig_cmp(aSignature, 0, sizeof(aSignature)) == 0)
+            return decodePng(filePath, image);
+
+        if (aSignature[0] == 0xFF && aSignature[1] == 0xD8 && aSignature[2] == 0xFF)
+            return decodeJpeg(filePath, image);
+
+        return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+#endif // _WIN32
+    }
+
+#ifndef _WIN32
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImageDecoder::decodePng
+
+      Summary:  Decodes a PNG file with libpng, expanding every color
+                type to four 8-bit channels
+
+      Args:     const std::filesystem::path& filePath
+                  Path of the PNG file
+                WIC_DECODED_IMAGE& image
+                  Decoded image
+
+      Modifies: [image].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ImageDecoder::decodePng(_In_ const std::filesystem::path& filePath, _Out_ WIC_DECODED_IMAGE& image)
+    {
+        png_image pngImage = { };
+        pngImage.version = PNG_IMAGE_VERSION;
+        if (!png_image_begin_read_from_file(&pngImage, filePath.c_str()))
+            return E_FAIL;
+
+        pngImage.format = PNG_FORMAT_RGBA;
+        size_t uRowPitch = PNG_IMAGE_ROW_STRIDE(pngImage);
+        std::unique_ptr<uint8_t[]> pPixels(new (std::nothrow) uint8_t[PNG_IMAGE_SIZE(pngImage)]);
+        if (!pPixels)
+        {
+            png_image_free(&pngImage);
+            return E_OUTOFMEMORY;
+        }
+
+        if (!png_image_finish_read(&pngImage, nullptr, pPixels.get(), 0, nullptr))
+        {
+            png_image_free(&pngImage);
+            return E_FAIL;
+        }
+
+        image.width = pngImage.width;
+        image.height = pngImage.height;
+        image.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        image.rowPitch = uRowPitch;
+        image.bitsPerPixel = 32u;
+        image.mipLevels = 1u;
+        image.pixels = std::move(pPixels);
+
+        return S_OK;
+    }
+
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+            Struct:   JpegErrorManager
+
+            Summary:  libjpeg error handler that returns to the decoder
+                      instead of exiting the process
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct JpegErrorManager
+        {
+            jpeg_error_mgr base;
+            std::jmp_buf jumpBuffer;
+        };
+
+        void ExitJpegError(j_common_ptr pInfo)
+        {
+            std::longjmp(reinterpret_cast<JpegErrorManager*>(pInfo->err)->jumpBuffer, 1);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ImageDecoder::decodeJpeg
+
+      Summary:  Decodes a JPEG file with libjpeg and adds an opaque
+                alpha channel
+
+      Args:     const std::filesystem::path& filePath
+                  Path of the JPEG file
+                WIC_DECODED_IMAGE& image
+                  Decoded image
+
+      Modifies: [image].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ImageDecoder::decodeJpeg(_In_ const std::filesystem::path& filePath, _Out_ WIC_DECODED_IMAGE& image)
+    {
+        // Closed once on every path, the error jump included
+        std::unique_ptr<std::FILE, decltype(&std::fclose)> pFile(std::fopen(filePath.c_str(), "rb"), &std::fclose);
+        if (!pFile)
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+
+        // Everything the error path releases lives outside of the jump
+        jpeg_decompress_struct info = { };
+        JpegErrorManager errorManager = { };
+        std::vector<BYTE> aRow;
+        std::unique_ptr<uint8_t[]> pPixels;
+
+        info.err = jpeg_std_error(&errorManager.base);
+        errorManager.base.error_exit = ExitJpegError;
+        if (setjmp(errorManager.jumpBuffer))
+        {
+            jpeg_destroy_decompress(&info);
+            return E_FAIL;
+        }
+
+        jpeg_create_decompress(&info);
+        jpeg_stdio_src(&info, pFile.get());
+        jpeg_read_header(&info, TRUE);
+        info.out_color_space = JCS_RGB;
+        jpeg_start_decompress(&info);
+
+        size_t uRowPitch = static_cast<size_t>(info.output_width) * 4u;
+        pPixels.reset(new (std::nothrow) uint8_t[uRowPitch * info.output_height]);
+        if (!pPixels)
+        {
+            jpeg_destroy_decompress(&info);
+            return E_OUTOFMEMORY;
+        }
+
+        aRow.resize(static_cast<size_t>(info.output_width) * info.output_components);
+        while (info.output_scanline < info.output_height)
+        {
+            BYTE* pRow = aRow.data();
+            BYTE* pDst = pPixels.get() + uRowPitch * info.output_scanline;
+            jpeg_read_scanlines(&info, &pRow, 1u);
+
+            for (UINT x = 0u; x < info.output_width; ++x)
+            {
+                pDst[x * 4u + 0u] = aRow[x * 3u + 0u];
+                pDst[x * 4u + 1u] = aRow[x * 3u + 1u];
+                pDst[x * 4u + 2u] = aRow[x * 3u + 2u];
+                pDst[x * 4u + 3u] = 0xFF;
+            }
+        }
+
+        jpeg_finish_decompress(&info);
+
+        image.width = info.output_width;
+        image.height = info.output_height;
+        image.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        image.rowPitch = uRowPitch;
+        image.bitsPerPixel = 32u;
+        image.mipLevels = 1u;
+        image.pixels = std::move(pPixels);
+
+        jpeg_destroy_decompress(&info);
+
+        return S_OK;
+    }
+#endif // ! _WIN32
+}
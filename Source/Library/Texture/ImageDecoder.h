@@ -0,0 +1,131 @@
+/*+===================================================================
+  File:      IMAGEDECODER.H
+
+  Summary:   ImageDecoder header file contains declaration of class
+             ImageDecoder used to decode PNG and JPEG images into
+             CPU-side pixels without a device, and of class
+             ScopedComApartment used by the threads decoding them.
+
+  Classes:  ImageDecoder, ScopedComApartment
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <filesystem>
+
+#ifdef _WIN32
+#include <objbase.h>
+#endif // _WIN32
+
+#include "Texture/DXGIFormat.h"
+
+// CPU side pixels produced by the decode half of the loader, ready to be uploaded.
+// pixels holds mipLevels levels back to back, levels after the first use tight rows
+struct WIC_DECODED_IMAGE
+{
+    UINT width;
+    UINT height;
+    DXGI_FORMAT format;
+    size_t rowPitch;
+    size_t bitsPerPixel;
+    UINT mipLevels;
+    std::unique_ptr<uint8_t[]> pixels;
+};
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ImageDecoder
+
+      Summary:  Decodes a PNG or JPEG file into a single level
+                DXGI_FORMAT_R8G8B8A8_UNORM image. WIC is used on
+                Windows, libpng and libjpeg elsewhere, so the asset
+                pipeline and its tests also run without Direct3D.
+                Safe to call from several threads
+
+      Methods:  DecodeFromFile
+                  Decodes an image file
+                ImageDecoder
+                  Constructor.
+                ~ImageDecoder
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ImageDecoder final
+    {
+    public:
+        ImageDecoder() = delete;
+        ImageDecoder(const ImageDecoder& other) = delete;
+        ImageDecoder(ImageDecoder&& other) = delete;
+        ImageDecoder& operator=(const ImageDecoder& other) = delete;
+        ImageDecoder& operator=(ImageDecoder&& other) = delete;
+        ~ImageDecoder() = delete;
+
+        static HRESULT DecodeFromFile(_In_ const std::filesystem::path& filePath, _Out_ WIC_DECODED_IMAGE& image);
+
+    private:
+#ifndef _WIN32
+        static HRESULT decodePng(_In_ const std::filesystem::path& filePath, _Out_ WIC_DECODED_IMAGE& image);
+        static HRESULT decodeJpeg(_In_ const std::filesystem::path& filePath, _Out_ WIC_DECODED_IMAGE& image);
+#endif // ! _WIN32
+    };
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ScopedComApartment
+
+      Summary:  Joins the calling thread to the multithreaded COM
+                apartment for the lifetime of the object, so that WIC
+                can decode on pool threads the application does not
+                own. A thread already in a single-threaded apartment
+                is left in it. Does nothing outside of Windows
+
+      Methods:  ScopedComApartment
+                  Constructor.
+                ~ScopedComApartment
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ScopedComApartment final
+    {
+    public:
+        ScopedComApartment();
+        ScopedComApartment(const ScopedComApartment& other) = delete;
+        ScopedComApartment(ScopedComApartment&& other) = delete;
+        ScopedComApartment& operator=(const ScopedComApartment& other) = delete;
+        ScopedComApartment& operator=(ScopedComApartment&& other) = delete;
+        ~ScopedComApartment();
+
+    private:
+        HRESULT m_hr;
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ScopedComApartment::ScopedComApartment
+
+      Summary:  Constructor. Initializes COM on the calling thread
+
+      Modifies: [m_hr].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    inline ScopedComApartment::ScopedComApartment()
+        : m_hr(E_FAIL)
+    {
+#ifdef _WIN32
+        // RPC_E_CHANGED_MODE leaves the thread in its own apartment, where WIC also works
+        m_hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif // _WIN32
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ScopedComApartment::~ScopedComApartment
+
+      Summary:  Destructor. Balances a successful initialization, S_FALSE
+                included
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    inline ScopedComApartment::~ScopedComApartment()
+    {
+#ifdef _WIN32
+        if (SUCCEEDED(m_hr))
+            CoUninitialize();
+#endif // _WIN32
+    }
+}
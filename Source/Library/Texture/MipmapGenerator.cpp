@@ -0,0 +1,486 @@
+#include "Texture/MipmapGenerator.h"
+
+#include <array>
+
+#include <DirectXPackedVector.h>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::IsFormatSupported
+
+      Summary:  Returns whether the format can be filtered. Only four
+                8-bit channel formats are handled, the other formats
+                fall back to the mipmaps generated by the device
+
+      Args:     DXGI_FORMAT format
+                  Format of the decoded image
+
+      Returns:  BOOL
+                  TRUE if GenerateMipChain accepts the format
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL MipmapGenerator::IsFormatSupported(_In_ DXGI_FORMAT format)
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+            return TRUE;
+
+        default:
+            return FALSE;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::GetNumMipLevels
+
+      Summary:  Returns the number of levels down to 1x1
+
+      Args:     UINT uWidth
+                  Width of the first level
+                UINT uHeight
+                  Height of the first level
+
+      Returns:  UINT
+                  Number of mip levels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT MipmapGenerator::GetNumMipLevels(_In_ UINT uWidth, _In_ UINT uHeight)
+    {
+        UINT uNumLevels = 1u;
+        UINT uSize = std::max<UINT>(uWidth, uHeight);
+        while (uSize > 1u)
+        {
+            uSize >>= 1u;
+            ++uNumLevels;
+        }
+
+        return uNumLevels;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::GenerateMipChain
+
+      Summary:  Replaces the pixels of a single level image by its full
+                mip chain, stored level after level with tight rows.
+                Each level is filtered from the previous one, rows of
+                a level are filtered in parallel
+
+      Args:     WIC_DECODED_IMAGE& image
+                  Decoded image with one mip level
+                BOOL bSrgb
+                  TRUE if the color channels are sRGB encoded and must
+                  be averaged in linear space
+                eMipFilter filter
+                  Filter each level is reduced with
+
+      Modifies: [image].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MipmapGenerator::GenerateMipChain(_Inout_ WIC_DECODED_IMAGE& image, _In_ BOOL bSrgb, _In_ eMipFilter filter)
+    {
+        if (!image.pixels || image.mipLevels != 1u || !image.width || !image.height || filter >= eMipFilter::COUNT)
+            return E_INVALIDARG;
+
+        if (!IsFormatSupported(image.format))
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+        UINT uNumLevels = GetNumMipLevels(image.width, image.height);
+        if (uNumLevels == 1u)
+            return S_OK;
+
+        std::vector<size_t> aOffsets(uNumLevels);
+        size_t uTotalSize = 0u;
+        for (UINT i = 0u; i < uNumLevels; ++i)
+        {
+            aOffsets[i] = uTotalSize;
+            uTotalSize += static_cast<size_t>(std::max<UINT>(image.width >> i, 1u)) * 4u * std::max<UINT>(image.height >> i, 1u);
+        }
+
+        std::unique_ptr<uint8_t[]> pChain(new (std::nothrow) uint8_t[uTotalSize]);
+        if (!pChain)
+            return E_OUTOFMEMORY;
+
+        size_t uRowSize = static_cast<size_t>(image.width) * 4u;
+        for (UINT y = 0u; y < image.height; ++y)
+        {
+            memcpy(pChain.get() + uRowSize * y, image.pixels.get() + image.rowPitch * y, uRowSize);
+        }
+
+        std::vector<UINT> aRows;
+        for (UINT uLevel = 1u; uLevel < uNumLevels; ++uLevel)
+        {
+            UINT uSrcWidth = std::max<UINT>(image.width >> (uLevel - 1u), 1u);
+            UINT uSrcHeight = std::max<UINT>(image.height >> (uLevel - 1u), 1u);
+            UINT uDstWidth = std::max<UINT>(image.width >> uLevel, 1u);
+            UINT uDstHeight = std::max<UINT>(image.height >> uLevel, 1u);
+
+            const BYTE* pSrc = pChain.get() + aOffsets[uLevel - 1u];
+            BYTE* pDst = pChain.get() + aOffsets[uLevel];
+
+            if (filter == eMipFilter::KAISER)
+            {
+                filterLevelKaiser(pSrc, uSrcWidth, uSrcHeight, pDst, uDstWidth, uDstHeight, bSrgb);
+                continue;
+            }
+
+            aRows.resize(uDstHeight);
+            std::iota(aRows.begin(), aRows.end(), 0u);
+
+            std::for_each(std::execution::par, aRows.begin(), aRows.end(),
+                [&](UINT uDstY)
+                {
+                    downsampleRow(pSrc, static_cast<size_t>(uSrcWidth) * 4u, uSrcWidth, uSrcHeight,
+                        pDst + static_cast<size_t>(uDstWidth) * 4u * uDstY, uDstWidth, uDstY, bSrgb);
+                }
+            );
+        }
+
+        image.pixels = std::move(pChain);
+        image.rowPitch = uRowSize;
+        image.mipLevels = uNumLevels;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::GetKaiserWeight
+
+      Summary:  Returns the weight of a sinc windowed by a Kaiser window
+                of KAISER_RADIUS texels of the destination level. The
+                weights of a texel are normalized by the caller
+
+      Args:     FLOAT distance
+                  Distance to the destination texel center, in texels
+                  of the destination level
+
+      Returns:  FLOAT
+                  Unnormalized weight, 0 outside of the window
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT MipmapGenerator::GetKaiserWeight(_In_ FLOAT distance)
+    {
+        FLOAT absDistance = fabsf(distance);
+        if (absDistance >= KAISER_RADIUS)
+            return 0.0f;
+
+        // Modified Bessel function of the first kind of order 0, its series converges quickly
+        auto besselI0 = [](FLOAT x)
+        {
+            FLOAT sum = 1.0f;
+            FLOAT term = 1.0f;
+            FLOAT halfX = x * 0.5f;
+            for (UINT k = 1u; k < 32u && term > sum * 1e-7f; ++k)
+            {
+                FLOAT factor = halfX / static_cast<FLOAT>(k);
+                term *= factor * factor;
+                sum += term;
+            }
+
+            return sum;
+        };
+
+        FLOAT ratio = absDistance / KAISER_RADIUS;
+        FLOAT window = besselI0(KAISER_ALPHA * sqrtf(1.0f - ratio * ratio)) / besselI0(KAISER_ALPHA);
+        FLOAT sinc = absDistance < 1e-6f ? 1.0f : sinf(XM_PI * absDistance) / (XM_PI * absDistance);
+
+        return sinc * window;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::filterLevelKaiser
+
+      Summary:  Reduces a level with the Kaiser filter, first along the
+                rows into a linear intermediate image, then along the
+                columns. Both passes run in parallel over rows
+
+      Args:     const BYTE* pSrc
+                  Source level with tight rows
+                UINT uSrcWidth
+                  Width of the source level
+                UINT uSrcHeight
+                  Height of the source level
+                BYTE* pDst
+                  Destination level with tight rows
+                UINT uDstWidth
+                  Width of the destination level
+                UINT uDstHeight
+                  Height of the destination level
+                BOOL bSrgb
+                  TRUE if the color channels are sRGB encoded
+
+      Modifies: [pDst].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipmapGenerator::filterLevelKaiser(
+        _In_ const BYTE* pSrc,
+        _In_ UINT uSrcWidth,
+        _In_ UINT uSrcHeight,
+        _Out_ BYTE* pDst,
+        _In_ UINT uDstWidth,
+        _In_ UINT uDstHeight,
+        _In_ BOOL bSrgb
+    )
+    {
+        UINT uNumTapsX = 0u;
+        std::vector<UINT> aIndicesX;
+        std::vector<FLOAT> aWeightsX;
+        computeKaiserTaps(uSrcWidth, uDstWidth, uNumTapsX, aIndicesX, aWeightsX);
+
+        UINT uNumTapsY = 0u;
+        std::vector<UINT> aIndicesY;
+        std::vector<FLOAT> aWeightsY;
+        computeKaiserTaps(uSrcHeight, uDstHeight, uNumTapsY, aIndicesY, aWeightsY);
+
+        std::vector<XMFLOAT4> aHorizontal(static_cast<size_t>(uDstWidth) * uSrcHeight);
+
+        std::vector<UINT> aRows(uSrcHeight);
+        std::iota(aRows.begin(), aRows.end(), 0u);
+        std::for_each(std::execution::par, aRows.begin(), aRows.end(),
+            [&](UINT uSrcY)
+            {
+                const BYTE* pSrcRow = pSrc + static_cast<size_t>(uSrcWidth) * 4u * uSrcY;
+                XMFLOAT4* pDstRow = aHorizontal.data() + static_cast<size_t>(uDstWidth) * uSrcY;
+
+                for (UINT x = 0u; x < uDstWidth; ++x)
+                {
+                    const UINT* pIndices = aIndicesX.data() + static_cast<size_t>(x) * uNumTapsX;
+                    const FLOAT* pWeights = aWeightsX.data() + static_cast<size_t>(x) * uNumTapsX;
+
+                    XMVECTOR sum = XMVectorZero();
+                    for (UINT i = 0u; i < uNumTapsX; ++i)
+                    {
+                        sum = XMVectorMultiplyAdd(loadPixel(pSrcRow + static_cast<size_t>(pIndices[i]) * 4u, bSrgb), XMVectorReplicate(pWeights[i]), sum);
+                    }
+
+                    XMStoreFloat4(pDstRow + x, sum);
+                }
+            }
+        );
+
+        aRows.resize(uDstHeight);
+        std::for_each(std::execution::par, aRows.begin(), aRows.end(),
+            [&](UINT uDstY)
+            {
+                const UINT* pIndices = aIndicesY.data() + static_cast<size_t>(uDstY) * uNumTapsY;
+                const FLOAT* pWeights = aWeightsY.data() + static_cast<size_t>(uDstY) * uNumTapsY;
+                BYTE* pDstRow = pDst + static_cast<size_t>(uDstWidth) * 4u * uDstY;
+
+                for (UINT x = 0u; x < uDstWidth; ++x)
+                {
+                    XMVECTOR sum = XMVectorZero();
+                    for (UINT i = 0u; i < uNumTapsY; ++i)
+                    {
+                        XMVECTOR texel = XMLoadFloat4(&aHorizontal[static_cast<size_t>(pIndices[i]) * uDstWidth + x]);
+                        sum = XMVectorMultiplyAdd(texel, XMVectorReplicate(pWeights[i]), sum);
+                    }
+
+                    storePixel(pDstRow + static_cast<size_t>(x) * 4u, sum, bSrgb);
+                }
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::computeKaiserTaps
+
+      Summary:  Computes the source texels and the normalized weights
+                of every destination texel along one axis. Every
+                destination texel gets the same number of taps, taps
+                past the edges are clamped to the last texel
+
+      Args:     UINT uSrcSize
+                  Size of the source level along the axis
+                UINT uDstSize
+                  Size of the destination level along the axis
+                UINT& uNumTaps
+                  Number of taps per destination texel
+                std::vector<UINT>& aIndices
+                  Source texel of each tap
+                std::vector<FLOAT>& aWeights
+                  Weight of each tap
+
+      Modifies: [uNumTaps, aIndices, aWeights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipmapGenerator::computeKaiserTaps(
+        _In_ UINT uSrcSize,
+        _In_ UINT uDstSize,
+        _Out_ UINT& uNumTaps,
+        _Out_ std::vector<UINT>& aIndices,
+        _Out_ std::vector<FLOAT>& aWeights
+    )
+    {
+        // A side that is already 1 texel wide is copied
+        if (uSrcSize == uDstSize)
+        {
+            uNumTaps = 1u;
+            aIndices.resize(uDstSize);
+            std::iota(aIndices.begin(), aIndices.end(), 0u);
+            aWeights.assign(uDstSize, 1.0f);
+            return;
+        }
+
+        FLOAT scale = static_cast<FLOAT>(uSrcSize) / static_cast<FLOAT>(uDstSize);
+        FLOAT srcRadius = KAISER_RADIUS * scale;
+        uNumTaps = static_cast<UINT>(ceilf(2.0f * srcRadius)) + 1u;
+        aIndices.resize(static_cast<size_t>(uNumTaps) * uDstSize);
+        aWeights.resize(static_cast<size_t>(uNumTaps) * uDstSize);
+
+        for (UINT uDst = 0u; uDst < uDstSize; ++uDst)
+        {
+            FLOAT center = (static_cast<FLOAT>(uDst) + 0.5f) * scale;
+            INT iFirst = static_cast<INT>(floorf(center - srcRadius));
+
+            FLOAT sum = 0.0f;
+            for (UINT i = 0u; i < uNumTaps; ++i)
+            {
+                INT iSrc = iFirst + static_cast<INT>(i);
+                FLOAT weight = GetKaiserWeight((static_cast<FLOAT>(iSrc) + 0.5f - center) / scale);
+
+                aIndices[static_cast<size_t>(uDst) * uNumTaps + i] = static_cast<UINT>(std::clamp<INT>(iSrc, 0, static_cast<INT>(uSrcSize) - 1));
+                aWeights[static_cast<size_t>(uDst) * uNumTaps + i] = weight;
+                sum += weight;
+            }
+
+            for (UINT i = 0u; i < uNumTaps; ++i)
+            {
+                aWeights[static_cast<size_t>(uDst) * uNumTaps + i] /= sum;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::downsampleRow
+
+      Summary:  Filters one row of the next level with a 2x2 box.
+                Odd edges reuse the last texel of the source level
+
+      Args:     const BYTE* pSrc
+                  First row of the source level
+                size_t uSrcRowPitch
+                  Row pitch of the source level
+                UINT uSrcWidth
+                  Width of the source level
+                UINT uSrcHeight
+                  Height of the source level
+                BYTE* pDstRow
+                  Row of the destination level
+                UINT uDstWidth
+                  Width of the destination level
+                UINT uDstY
+                  Index of the destination row
+                BOOL bSrgb
+                  TRUE if the color channels are sRGB encoded
+
+      Modifies: [pDstRow].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipmapGenerator::downsampleRow(
+        _In_ const BYTE* pSrc,
+        _In_ size_t uSrcRowPitch,
+        _In_ UINT uSrcWidth,
+        _In_ UINT uSrcHeight,
+        _Out_ BYTE* pDstRow,
+        _In_ UINT uDstWidth,
+        _In_ UINT uDstY,
+        _In_ BOOL bSrgb
+    )
+    {
+        const XMVECTOR quarter = XMVectorReplicate(0.25f);
+
+        UINT uY0 = std::min<UINT>(uDstY * 2u, uSrcHeight - 1u);
+        UINT uY1 = std::min<UINT>(uDstY * 2u + 1u, uSrcHeight - 1u);
+        const BYTE* pRow0 = pSrc + uSrcRowPitch * uY0;
+        const BYTE* pRow1 = pSrc + uSrcRowPitch * uY1;
+
+        for (UINT x = 0u; x < uDstWidth; ++x)
+        {
+            size_t uX0 = static_cast<size_t>(std::min<UINT>(x * 2u, uSrcWidth - 1u)) * 4u;
+            size_t uX1 = static_cast<size_t>(std::min<UINT>(x * 2u + 1u, uSrcWidth - 1u)) * 4u;
+
+            XMVECTOR sum = XMVectorAdd(loadPixel(pRow0 + uX0, bSrgb), loadPixel(pRow0 + uX1, bSrgb));
+            sum = XMVectorAdd(sum, loadPixel(pRow1 + uX0, bSrgb));
+            sum = XMVectorAdd(sum, loadPixel(pRow1 + uX1, bSrgb));
+
+            storePixel(pDstRow + static_cast<size_t>(x) * 4u, XMVectorMultiply(sum, quarter), bSrgb);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::loadPixel
+
+      Summary:  Loads a 4x8-bit texel as a normalized vector, decoding
+                the color channels to linear space if needed. Alpha is
+                always linear
+
+      Args:     const BYTE* pPixel
+                  Texel to load
+                BOOL bSrgb
+                  TRUE if the color channels are sRGB encoded
+
+      Returns:  XMVECTOR
+                  Texel in [0, 1]
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR MipmapGenerator::loadPixel(_In_ const BYTE* pPixel, _In_ BOOL bSrgb)
+    {
+        if (bSrgb)
+        {
+            const FLOAT* pTable = getSrgbToLinearTable();
+            return XMVectorSet(pTable[pPixel[0]], pTable[pPixel[1]], pTable[pPixel[2]], static_cast<FLOAT>(pPixel[3]) / 255.0f);
+        }
+
+        PackedVector::XMUBYTEN4 packed;
+        memcpy(&packed, pPixel, sizeof(packed));
+        return PackedVector::XMLoadUByteN4(&packed);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::storePixel
+
+      Summary:  Stores a normalized vector as a rounded 4x8-bit texel,
+                encoding the color channels to sRGB if needed
+
+      Args:     BYTE* pPixel
+                  Destination texel
+                FXMVECTOR color
+                  Linear color in [0, 1]
+                BOOL bSrgb
+                  TRUE if the color channels are sRGB encoded
+
+      Modifies: [pPixel].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipmapGenerator::storePixel(_Out_ BYTE* pPixel, _In_ FXMVECTOR color, _In_ BOOL bSrgb)
+    {
+        XMVECTOR encoded = bSrgb ? XMColorRGBToSRGB(color) : color;
+
+        PackedVector::XMUBYTEN4 packed;
+        PackedVector::XMStoreUByteN4(&packed, XMVectorSaturate(encoded));
+        memcpy(pPixel, &packed, sizeof(packed));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipmapGenerator::getSrgbToLinearTable
+
+      Summary:  Returns the linear value of every 8-bit sRGB value. The
+                table is built once on first use
+
+      Returns:  const FLOAT*
+                  Table of 256 linear values
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const FLOAT* MipmapGenerator::getSrgbToLinearTable()
+    {
+        static const std::array<FLOAT, 256> s_aSrgbToLinear = []()
+        {
+            std::array<FLOAT, 256> aTable = {};
+            for (UINT i = 0u; i < 256u; ++i)
+            {
+                FLOAT value = static_cast<FLOAT>(i) / 255.0f;
+                aTable[i] = value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+            }
+
+            return aTable;
+        }();
+
+        return s_aSrgbToLinear.data();
+    }
+}
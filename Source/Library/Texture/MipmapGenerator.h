@@ -0,0 +1,106 @@
+/*+===================================================================
+  File:      MIPMAPGENERATOR.H
+
+  Summary:   MipmapGenerator header file contains declaration of class
+             MipmapGenerator used to build complete mip chains of
+             decoded images on the CPU.
+
+  Classes:  MipmapGenerator
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/ImageDecoder.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eMipFilter
+
+        Summary:  Enumeration of the filters a mip level is reduced with
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eMipFilter : BYTE
+    {
+        BOX,
+        KAISER,
+        COUNT,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MipmapGenerator
+
+      Summary:  Builds the mip chain of a decoded 32-bit image, so the
+                texture is created with every level as initial data
+                instead of calling GenerateMips on the immediate
+                context. Levels are reduced with a 2x2 box, cheap
+                enough for load time, or with a separable Kaiser
+                windowed sinc that keeps the smaller levels sharp for
+                the offline pipeline. Color data is filtered in linear
+                space
+
+      Methods:  IsFormatSupported
+                  Returns whether the format can be filtered
+                GetNumMipLevels
+                  Returns the length of the full mip chain
+                GenerateMipChain
+                  Appends every mip level to the decoded image
+                GetKaiserWeight
+                  Returns the unnormalized weight of the Kaiser filter
+                MipmapGenerator
+                  Constructor.
+                ~MipmapGenerator
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MipmapGenerator final
+    {
+    public:
+        MipmapGenerator() = delete;
+        MipmapGenerator(const MipmapGenerator& other) = delete;
+        MipmapGenerator(MipmapGenerator&& other) = delete;
+        MipmapGenerator& operator=(const MipmapGenerator& other) = delete;
+        MipmapGenerator& operator=(MipmapGenerator&& other) = delete;
+        ~MipmapGenerator() = delete;
+
+        static BOOL IsFormatSupported(_In_ DXGI_FORMAT format);
+        static UINT GetNumMipLevels(_In_ UINT uWidth, _In_ UINT uHeight);
+        static HRESULT GenerateMipChain(_Inout_ WIC_DECODED_IMAGE& image, _In_ BOOL bSrgb, _In_ eMipFilter filter = eMipFilter::BOX);
+        static FLOAT GetKaiserWeight(_In_ FLOAT distance);
+
+        static constexpr const FLOAT KAISER_RADIUS = 3.0f;
+        static constexpr const FLOAT KAISER_ALPHA = 4.0f;
+
+    private:
+        static void downsampleRow(
+            _In_ const BYTE* pSrc,
+            _In_ size_t uSrcRowPitch,
+            _In_ UINT uSrcWidth,
+            _In_ UINT uSrcHeight,
+            _Out_ BYTE* pDstRow,
+            _In_ UINT uDstWidth,
+            _In_ UINT uDstY,
+            _In_ BOOL bSrgb
+        );
+        static void filterLevelKaiser(
+            _In_ const BYTE* pSrc,
+            _In_ UINT uSrcWidth,
+            _In_ UINT uSrcHeight,
+            _Out_ BYTE* pDst,
+            _In_ UINT uDstWidth,
+            _In_ UINT uDstHeight,
+            _In_ BOOL bSrgb
+        );
+        static void computeKaiserTaps(
+            _In_ UINT uSrcSize,
+            _In_ UINT uDstSize,
+            _Out_ UINT& uNumTaps,
+            _Out_ std::vector<UINT>& aIndices,
+            _Out_ std::vector<FLOAT>& aWeights
+        );
+        static XMVECTOR loadPixel(_In_ const BYTE* pPixel, _In_ BOOL bSrgb);
+        static void storePixel(_Out_ BYTE* pPixel, _In_ FXMVECTOR color, _In_ BOOL bSrgb);
+        static const FLOAT* getSrgbToLinearTable();
+    };
+}
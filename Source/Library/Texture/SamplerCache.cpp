@@ -0,0 +1,136 @@
+#include "Texture/SamplerCache.h"
+
+namespace library
+{
+    std::mutex SamplerCache::sm_mutex;
+    std::vector<SamplerCache::Entry> SamplerCache::sm_aEntries;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::GetOrCreate
+
+      Summary:  Returns the handle of the sampler state matching every
+                field of the description, creating the sampler state
+                the first time the description is seen
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the sampler state
+                const D3D11_SAMPLER_DESC& desc
+                  Description of the sampler
+                UINT& uOutHandle
+                  Handle of the sampler, INVALID_SAMPLER on failure
+
+      Modifies: [sm_aEntries].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SamplerCache::GetOrCreate(_In_ ID3D11Device* pDevice, _In_ const D3D11_SAMPLER_DESC& desc, _Out_ UINT& uOutHandle)
+    {
+        std::lock_guard<std::mutex> lock(sm_mutex);
+
+        uOutHandle = INVALID_SAMPLER;
+
+        // Only a handful of distinct samplers exist, a linear search is enough
+        auto it = std::find_if(sm_aEntries.begin(), sm_aEntries.end(),
+            [&desc](const Entry& entry)
+            {
+                return memcmp(&entry.desc, &desc, sizeof(D3D11_SAMPLER_DESC)) == 0;
+            }
+        );
+        if (it != sm_aEntries.end())
+        {
+            uOutHandle = static_cast<UINT>(it - sm_aEntries.begin());
+            return S_OK;
+        }
+
+        Entry entry =
+        {
+            .desc = desc
+        };
+
+        HRESULT hr = pDevice->CreateSamplerState(&desc, entry.samplerState.GetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        uOutHandle = static_cast<UINT>(sm_aEntries.size());
+        sm_aEntries.push_back(std::move(entry));
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::GetSamplerState
+
+      Summary:  Returns the sampler state of a handle
+
+      Args:     UINT uHandle
+                  Handle returned by GetOrCreate
+
+      Returns:  ID3D11SamplerState*
+                  Sampler state, nullptr if the handle is invalid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ID3D11SamplerState* SamplerCache::GetSamplerState(_In_ UINT uHandle)
+    {
+        std::lock_guard<std::mutex> lock(sm_mutex);
+
+        if (uHandle >= sm_aEntries.size())
+            return nullptr;
+
+        return sm_aEntries[uHandle].samplerState.Get();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::GetLinearWrapDesc
+
+      Summary:  Returns the description of the trilinear wrapping sampler
+                used by textures
+
+      Returns:  const D3D11_SAMPLER_DESC&
+                  Sampler description
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const D3D11_SAMPLER_DESC& SamplerCache::GetLinearWrapDesc()
+    {
+        static const D3D11_SAMPLER_DESC sampDesc =
+        {
+            .Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
+            .AddressU = D3D11_TEXTURE_ADDRESS_WRAP,
+            .AddressV = D3D11_TEXTURE_ADDRESS_WRAP,
+            .AddressW = D3D11_TEXTURE_ADDRESS_WRAP,
+            .ComparisonFunc = D3D11_COMPARISON_NEVER,
+            .MinLOD = 0.0f,
+            .MaxLOD = D3D11_FLOAT32_MAX,
+        };
+
+        return sampDesc;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::GetNumSamplers
+
+      Summary:  Returns the number of created sampler states
+
+      Returns:  UINT
+                  Number of sampler states
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SamplerCache::GetNumSamplers()
+    {
+        std::lock_guard<std::mutex> lock(sm_mutex);
+
+        return static_cast<UINT>(sm_aEntries.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::Clear
+
+      Summary:  Releases every sampler state, invalidating all handles.
+                Should be called before the device is destroyed
+
+      Modifies: [sm_aEntries].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SamplerCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(sm_mutex);
+
+        sm_aEntries.clear();
+    }
+}
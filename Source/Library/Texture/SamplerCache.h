@@ -0,0 +1,71 @@
+/*+===================================================================
+  File:      SAMPLERCACHE.H
+
+  Summary:   SamplerCache header file contains declaration of class
+             SamplerCache used to share sampler states between
+             textures.
+
+  Classes:  SamplerCache
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#define INVALID_SAMPLER (0xFFFFFFFF)
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SamplerCache
+
+      Summary:  Registry of sampler states keyed by their full
+                description. Each distinct description creates one
+                sampler state, and textures keep the returned handle
+                instead of owning a sampler, so the renderer can tell
+                identical samplers apart with a single comparison
+
+      Methods:  GetOrCreate
+                  Returns the handle of a sampler, creating it on a miss
+                GetSamplerState
+                  Returns the sampler state of a handle
+                GetLinearWrapDesc
+                  Returns the description of the default sampler
+                GetNumSamplers
+                  Returns the number of created sampler states
+                Clear
+                  Releases every sampler state
+                SamplerCache
+                  Constructor.
+                ~SamplerCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SamplerCache final
+    {
+    public:
+        SamplerCache() = delete;
+        SamplerCache(const SamplerCache& other) = delete;
+        SamplerCache(SamplerCache&& other) = delete;
+        SamplerCache& operator=(const SamplerCache& other) = delete;
+        SamplerCache& operator=(SamplerCache&& other) = delete;
+        ~SamplerCache() = delete;
+
+        static HRESULT GetOrCreate(_In_ ID3D11Device* pDevice, _In_ const D3D11_SAMPLER_DESC& desc, _Out_ UINT& uOutHandle);
+        static ID3D11SamplerState* GetSamplerState(_In_ UINT uHandle);
+        static const D3D11_SAMPLER_DESC& GetLinearWrapDesc();
+        static UINT GetNumSamplers();
+        static void Clear();
+
+    private:
+        struct Entry
+        {
+            D3D11_SAMPLER_DESC desc;
+            ComPtr<ID3D11SamplerState> samplerState;
+        };
+
+    private:
+        static std::mutex sm_mutex;
+        static std::vector<Entry> sm_aEntries;
+    };
+}
@@ -0,0 +1,64 @@
+/*+===================================================================
+  File:      STREAMABLETEXTURE.H
+
+  Summary:   StreamableTexture header file contains declaration of
+             the interface between the TextureStreamer and the
+             textures whose mips it keeps resident.
+
+  Classes:  StreamableTexture
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StreamableTexture
+
+      Summary:  Upload backend of the TextureStreamer. The streamer
+                decides which mips stay resident from the sizes of the
+                mip chain and applies its decisions through StreamMips.
+                Texture implements it with Direct3D, so the residency
+                policy does not depend on the graphics API
+
+      Methods:  IsStreamable
+                  Returns whether the mips can be streamed
+                GetTopMipSize
+                  Returns the largest dimension of the first mip
+                GetStartupMip
+                  Returns the most detailed mip that is always resident
+                GetResidentMip
+                  Returns the most detailed mip currently resident
+                GetMipChainSize
+                  Returns the memory size of a mip chain
+                GetMemorySize
+                  Returns the memory size of the resident mips
+                StreamMips
+                  Makes the mips from a given mip down resident
+                StreamableTexture
+                  Constructor.
+                ~StreamableTexture
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StreamableTexture
+    {
+    public:
+        StreamableTexture() = default;
+        StreamableTexture(const StreamableTexture& other) = delete;
+        StreamableTexture(StreamableTexture&& other) = delete;
+        StreamableTexture& operator=(const StreamableTexture& other) = delete;
+        StreamableTexture& operator=(StreamableTexture&& other) = delete;
+        virtual ~StreamableTexture() = default;
+
+        virtual BOOL IsStreamable() const = 0;
+        virtual UINT GetTopMipSize() const = 0;
+        virtual UINT GetStartupMip() const = 0;
+        virtual UINT GetResidentMip() const = 0;
+        virtual size_t GetMipChainSize(_In_ UINT uMostDetailedMip) const = 0;
+        virtual size_t GetMemorySize() const = 0;
+        virtual HRESULT StreamMips(_In_ UINT uMostDetailedMip) = 0;
+    };
+}
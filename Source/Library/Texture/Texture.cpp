@@ -1,5 +1,8 @@
 #include "Texture.h"
 
+#include "Texture/BlockCompressor.h"
+#include "Texture/DDSTextureLoader.h"
+#include "Texture/MipmapGenerator.h"
 #include "Texture/WICTextureLoader.h"
 
 namespace library
@@ -12,52 +15,180 @@ namespace library
       Args:     const std::filesystem::path& textureFilePath
                   Path to the texture to use
 
-      Modifies: [m_filePath, m_textureRV, m_samplerLinear].
+      Modifies: [m_filePath, m_decodedImage, m_device, m_textureRV,
+                 m_uSamplerHandle, m_uMemorySize, m_ddsInfo, m_uStartupMip,
+                 m_uResidentMip].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Texture::Texture(_In_ const std::filesystem::path& filePath)
         : m_filePath(filePath)
+        , m_decodedImage()
+        , m_device()
         , m_textureRV()
-        , m_samplerLinear()
+        , m_uSamplerHandle(INVALID_SAMPLER)
+        , m_uMemorySize(0u)
+        , m_ddsInfo()
+        , m_uStartupMip(0u)
+        , m_uResidentMip(0u)
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::Texture
+
+      Summary:  Constructor of a texture built in CPU memory, such as a
+                texture atlas. Decode keeps the given image
+
+      Args:     const std::filesystem::path& filePath
+                  Name of the texture, not read from disk
+                WIC_DECODED_IMAGE&& decodedImage
+                  Decoded image with its mip chain
+
+      Modifies: [m_filePath, m_decodedImage, m_device, m_textureRV,
+                 m_uSamplerHandle, m_uMemorySize, m_ddsInfo, m_uStartupMip,
+                 m_uResidentMip].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Texture::Texture(_In_ const std::filesystem::path& filePath, _In_ WIC_DECODED_IMAGE&& decodedImage)
+        : m_filePath(filePath)
+        , m_decodedImage(std::move(decodedImage))
+        , m_device()
+        , m_textureRV()
+        , m_uSamplerHandle(INVALID_SAMPLER)
+        , m_uMemorySize(0u)
+        , m_ddsInfo()
+        , m_uStartupMip(0u)
+        , m_uResidentMip(0u)
     {}
 
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::Initialize
 
-      Summary:  Initializes the texture
+      Summary:  Initializes the texture by decoding and uploading it
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
 
-      Modifies: [m_textureRV, m_samplerLinear].
+      Modifies: [m_decodedImage, m_textureRV, m_uSamplerHandle,
+                 m_uMemorySize].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Texture::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
-        HRESULT hr = S_OK;
+        HRESULT hr = Decode(pDevice);
+        if (FAILED(hr))
+            return hr;
 
-        hr = CreateWICTextureFromFile(
-            pDevice,
-            pImmediateContext,
-            m_filePath.c_str(),
-            nullptr,
-            m_textureRV.GetAddressOf());
+        return Upload(pDevice, pImmediateContext);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::Decode
+
+      Summary:  Decodes and converts the image into CPU memory and
+                generates its mip chain. Does not use any device
+                context, so several textures can be decoded in parallel.
+                An up-to-date block compressed file written by the
+                asset pipeline is used instead of the source image
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to query format support
+
+      Modifies: [m_filePath, m_decodedImage].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::Decode(_In_ ID3D11Device* pDevice)
+    {
+        // Textures created from decoded images, like atlases, have no file
+        if (m_decodedImage.pixels)
+            return S_OK;
+
+        if (!isDDS() && BlockCompressor::IsCompressedFileUpToDate(m_filePath))
+            m_filePath = BlockCompressor::GetCompressedPath(m_filePath);
+
+        // DDS files are uploaded straight from the file mapping
+        if (isDDS())
+            return S_OK;
+
+        HRESULT hr = DecodeWICTextureFromFile(pDevice, m_filePath.c_str(), m_decodedImage);
         if (FAILED(hr))
             return hr;
 
-        D3D11_SAMPLER_DESC sampDesc =
+        // Build the mip chain here so uploading does not need GenerateMips
+        if (MipmapGenerator::IsFormatSupported(m_decodedImage.format))
         {
-            .Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
-            .AddressU = D3D11_TEXTURE_ADDRESS_WRAP,
-            .AddressV = D3D11_TEXTURE_ADDRESS_WRAP,
-            .AddressW = D3D11_TEXTURE_ADDRESS_WRAP,
-            .ComparisonFunc = D3D11_COMPARISON_NEVER,
-            .MinLOD = 0.0f,
-            .MaxLOD = D3D11_FLOAT32_MAX,
-        };
-
-        hr = pDevice->CreateSamplerState(&sampDesc, m_samplerLinear.GetAddressOf());
+            hr = MipmapGenerator::GenerateMipChain(m_decodedImage, !isNormalMap());
+            if (FAILED(hr))
+                return hr;
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::Upload
+
+      Summary:  Creates the texture resources from the decoded image and
+                releases the CPU copy. Streamable DDS textures only
+                upload the mips up to STARTUP_MIP_SIZE and keep the
+                device to stream the other mips later
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_decodedImage, m_device, m_textureRV, m_uSamplerHandle,
+                 m_uMemorySize, m_ddsInfo, m_uStartupMip, m_uResidentMip].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::Upload(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        HRESULT hr = Decode(pDevice);
+        if (FAILED(hr))
+            return hr;
+
+        // DDS files are mapped and uploaded without an intermediate copy
+        if (isDDS())
+        {
+            hr = GetDDSTextureInfoFromFile(m_filePath.c_str(), &m_ddsInfo);
+            if (FAILED(hr))
+                return hr;
+
+            if (IsStreamable())
+            {
+                m_uStartupMip = 0u;
+                while (m_uStartupMip + 1u < GetNumMipLevels() && (GetTopMipSize() >> m_uStartupMip) > STARTUP_MIP_SIZE)
+                    ++m_uStartupMip;
+
+                m_device = pDevice;
+                hr = StreamMips(m_uStartupMip);
+            }
+            else
+            {
+                hr = CreateDDSTextureFromFileMapped(
+                    pDevice,
+                    pImmediateContext,
+                    m_filePath.c_str(),
+                    nullptr,
+                    m_textureRV.GetAddressOf());
+            }
+        }
+        else
+        {
+            hr = CreateWICTextureFromDecodedImage(
+                pDevice,
+                pImmediateContext,
+                m_decodedImage,
+                nullptr,
+                m_textureRV.GetAddressOf());
+
+            m_decodedImage.pixels.reset();
+        }
+        if (FAILED(hr))
+            return hr;
+
+        updateMemorySize();
+
+        // Every texture shares the one linear sampler of the cache
+        hr = SamplerCache::GetOrCreate(pDevice, SamplerCache::GetLinearWrapDesc(), m_uSamplerHandle);
         if (FAILED(hr))
             return hr;
 
@@ -79,15 +210,288 @@ namespace library
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Texture::GetSamplerState
+      Method:   Texture::GetSamplerHandle
 
-      Summary:  Constructor
+      Summary:  Returns the handle of the sampler in the SamplerCache
+
+      Returns:  UINT
+                  Sampler handle, INVALID_SAMPLER if not uploaded
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetSamplerHandle() const
+    {
+        return m_uSamplerHandle;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetMemorySize
+
+      Summary:  Returns the estimated memory size of the texture
+
+      Returns:  size_t
+                  Size in bytes, 0 if the texture is not initialized
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Texture::GetMemorySize() const
+    {
+        return m_uMemorySize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::IsStreamable
+
+      Summary:  Returns whether the mips of the texture can be streamed
+
+      Returns:  BOOL
+                  TRUE for uploaded 2D DDS textures with a mip chain
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::IsStreamable() const
+    {
+        return isDDS()
+            && m_ddsInfo.resourceDimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D
+            && !m_ddsInfo.isCubeMap
+            && m_ddsInfo.arraySize == 1u
+            && m_ddsInfo.mipCount > 1u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetNumMipLevels
+
+      Summary:  Returns the number of mips stored in the DDS file
+
+      Returns:  UINT
+                  Number of mip levels, 1 if the texture is not a DDS
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetNumMipLevels() const
+    {
+        return static_cast<UINT>(std::max<size_t>(m_ddsInfo.mipCount, 1u));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetTopMipSize
+
+      Summary:  Returns the largest dimension of the most detailed mip
+                stored in the DDS file
+
+      Returns:  UINT
+                  Size in texels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetTopMipSize() const
+    {
+        return std::max<UINT>(m_ddsInfo.width, m_ddsInfo.height);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetStartupMip
+
+      Summary:  Returns the most detailed mip uploaded by Upload, the
+                mips from it down always stay resident
+
+      Returns:  UINT
+                  Mip index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetStartupMip() const
+    {
+        return m_uStartupMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetResidentMip
+
+      Summary:  Returns the most detailed mip currently uploaded
+
+      Returns:  UINT
+                  Mip index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetResidentMip() const
+    {
+        return m_uResidentMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetMipChainSize
+
+      Summary:  Returns the estimated memory size of the mips from the
+                given mip down to the smallest one
+
+      Args:     UINT uMostDetailedMip
+                  Most detailed mip of the chain
+
+      Returns:  size_t
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Texture::GetMipChainSize(_In_ UINT uMostDetailedMip) const
+    {
+        size_t uSize = 0u;
+        for (UINT i = uMostDetailedMip; i < GetNumMipLevels(); ++i)
+        {
+            size_t uWidth = std::max<size_t>(m_ddsInfo.width >> i, 1u);
+            size_t uHeight = std::max<size_t>(m_ddsInfo.height >> i, 1u);
+            uSize += (uWidth * uHeight * getBitsPerPixel(m_ddsInfo.format) + 7u) / 8u;
+        }
 
-      Returns:  ComPtr<ID3D11SamplerState>&
-                  Sampler state
+        return uSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::StreamMips
+
+      Summary:  Recreates the texture from the file mapping with only
+                the mips from the given mip down, on the device given
+                to Upload. The previous view stays valid for anyone
+                still holding it
+
+      Args:     UINT uMostDetailedMip
+                  Most detailed mip to make resident
+
+      Modifies: [m_textureRV, m_uMemorySize, m_uResidentMip].
+
+      Returns:  HRESULT
+                  Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11SamplerState>& Texture::GetSamplerState()
+    HRESULT Texture::StreamMips(_In_ UINT uMostDetailedMip)
     {
-        return m_samplerLinear;
+        if (!IsStreamable() || !m_device)
+            return E_NOT_VALID_STATE;
+
+        uMostDetailedMip = std::min<UINT>(uMostDetailedMip, GetNumMipLevels() - 1u);
+        if (m_textureRV && uMostDetailedMip == m_uResidentMip)
+            return S_OK;
+
+        // The loader skips every mip larger than maxsize, 0 keeps the whole chain
+        size_t uMaxSize = 0u;
+        if (uMostDetailedMip > 0u)
+            uMaxSize = std::max<size_t>(GetTopMipSize() >> uMostDetailedMip, 1u);
+
+        ComPtr<ID3D11ShaderResourceView> textureRV;
+        HRESULT hr = CreateDDSTextureFromFileMapped(
+            m_device.Get(),
+            nullptr,
+            m_filePath.c_str(),
+            nullptr,
+            textureRV.GetAddressOf(),
+            uMaxSize);
+        if (FAILED(hr))
+            return hr;
+
+        m_textureRV = textureRV;
+        m_uResidentMip = uMostDetailedMip;
+        updateMemorySize();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::isDDS
+
+      Summary:  Returns whether the texture file is a DDS file
+
+      Returns:  BOOL
+                  TRUE if the file has the .dds extension
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::isDDS() const
+    {
+        return _wcsicmp(m_filePath.extension().c_str(), L".dds") == 0;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::isNormalMap
+
+      Summary:  Returns whether the texture file is a normal map, named
+                with the _ddn suffix used by the model assets
+
+      Returns:  BOOL
+                  TRUE if the texels are vectors rather than colors
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::isNormalMap() const
+    {
+        return BlockCompressor::GetTextureUsage(m_filePath) == eTextureUsage::NORMAL;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::getBitsPerPixel
+
+      Summary:  Returns the number of bits per pixel of the formats
+                created by the texture loaders
+
+      Args:     DXGI_FORMAT format
+                  Format of the texture
+
+      Returns:  size_t
+                  Bits per pixel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Texture::getBitsPerPixel(_In_ DXGI_FORMAT format)
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            return 128u;
+
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+            return 64u;
+
+        case DXGI_FORMAT_R16_FLOAT:
+        case DXGI_FORMAT_R16_UNORM:
+        case DXGI_FORMAT_B5G5R5A1_UNORM:
+        case DXGI_FORMAT_B5G6R5_UNORM:
+            return 16u;
+
+        case DXGI_FORMAT_R8_UNORM:
+        case DXGI_FORMAT_A8_UNORM:
+            return 8u;
+
+        case DXGI_FORMAT_R1_UNORM:
+            return 1u;
+
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            return 4u;
+
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return 8u;
+
+        default:
+            return 32u;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::updateMemorySize
+
+      Summary:  Estimates the video memory used by the resident mips
+
+      Modifies: [m_uMemorySize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Texture::updateMemorySize()
+    {
+        // Computed aside, the texture cache reads the size from other threads
+        size_t uMemorySize = 0u;
+
+        ComPtr<ID3D11Resource> resource;
+        m_textureRV->GetResource(resource.GetAddressOf());
+
+        ComPtr<ID3D11Texture2D> texture2D;
+        if (SUCCEEDED(resource.As(&texture2D)))
+        {
+            D3D11_TEXTURE2D_DESC desc;
+            texture2D->GetDesc(&desc);
+
+            for (UINT i = 0u; i < desc.MipLevels; ++i)
+            {
+                size_t uWidth = std::max<size_t>(desc.Width >> i, 1u);
+                size_t uHeight = std::max<size_t>(desc.Height >> i, 1u);
+                uMemorySize += (uWidth * uHeight * getBitsPerPixel(desc.Format) + 7u) / 8u * desc.ArraySize;
+            }
+        }
+
+        m_uMemorySize = uMemorySize;
     }
 }
\ No newline at end of file
@@ -12,13 +12,24 @@
 
 #include "Common.h"
 
+#include <atomic>
+
+#include "Texture/DDSTextureLoader.h"
+#include "Texture/SamplerCache.h"
+#include "Texture/StreamableTexture.h"
+#include "Texture/WICTextureLoader.h"
+
 namespace library
 {
-    class Texture
+    class Texture : public StreamableTexture
     {
     public:
+        // Largest dimension of the mips of DDS textures resident after Upload
+        static constexpr const UINT STARTUP_MIP_SIZE = 64u;
+
         Texture() = delete;
         Texture(_In_ const std::filesystem::path& filePath);
+        Texture(_In_ const std::filesystem::path& filePath, _In_ WIC_DECODED_IMAGE&& decodedImage);
         Texture(const Texture& other) = delete;
         Texture(Texture&& other) = delete;
         Texture& operator=(const Texture& other) = delete;
@@ -28,12 +39,40 @@ namespace library
         // Should be called once to load the texture
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
+        // Initialize split in two, Decode may run on any thread before Upload
+        HRESULT Decode(_In_ ID3D11Device* pDevice);
+        HRESULT Upload(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+
         ComPtr<ID3D11ShaderResourceView>& GetTextureResourceView();
-        ComPtr<ID3D11SamplerState>& GetSamplerState();
+        UINT GetSamplerHandle() const;
+        size_t GetMemorySize() const override;
+
+        // Mip streaming of DDS textures, only the mips from the resident mip down are uploaded
+        BOOL IsStreamable() const override;
+        UINT GetNumMipLevels() const;
+        UINT GetTopMipSize() const override;
+        UINT GetStartupMip() const override;
+        UINT GetResidentMip() const override;
+        size_t GetMipChainSize(_In_ UINT uMostDetailedMip) const override;
+        HRESULT StreamMips(_In_ UINT uMostDetailedMip) override;
+
+    private:
+        static size_t getBitsPerPixel(_In_ DXGI_FORMAT format);
+
+        void updateMemorySize();
+
+        BOOL isDDS() const;
+        BOOL isNormalMap() const;
 
     private:
         std::filesystem::path m_filePath;
+        WIC_DECODED_IMAGE m_decodedImage;
+        ComPtr<ID3D11Device> m_device;
         ComPtr<ID3D11ShaderResourceView> m_textureRV;
-        ComPtr<ID3D11SamplerState> m_samplerLinear;
+        UINT m_uSamplerHandle;
+        std::atomic<size_t> m_uMemorySize;
+        DDS_TEXTURE_INFO m_ddsInfo;
+        UINT m_uStartupMip;
+        UINT m_uResidentMip;
     };
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "Texture/TextureAtlas.h"
+
+#include "Texture/ImageDecoder.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureAtlas::TextureAtlas
+
+      Summary:  Constructor
+
+      Modifies: [m_regions, m_pTexture].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureAtlas::TextureAtlas()
+        : m_regions()
+        , m_pTexture()
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureAtlas::Build
+
+      Summary:  Decodes the source textures in parallel and packs them
+                with AtlasPacker::Pack. The atlas texture is created in
+                CPU memory and uploaded by Texture::Initialize
+
+      Args:     const std::filesystem::path& atlasPath
+                  Name of the atlas texture, neither read from nor
+                  written to disk
+                const std::vector<std::filesystem::path>& aSourcePaths
+                  Paths to the source textures
+
+      Modifies: [m_regions, m_pTexture].
+
+      Returns:  HRESULT
+                  S_FALSE if less than two textures could be packed,
+                  in which case no atlas is created
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TextureAtlas::Build(_In_ const std::filesystem::path& atlasPath, _In_ const std::vector<std::filesystem::path>& aSourcePaths)
+    {
+        m_regions.clear();
+        m_pTexture.reset();
+
+        // The decoder always returns RGBA 32-bit texels
+        std::vector<WIC_DECODED_IMAGE> aImages(aSourcePaths.size());
+
+        std::vector<size_t> aIndices(aSourcePaths.size());
+        std::iota(aIndices.begin(), aIndices.end(), 0ull);
+
+        // Images that failed to decode are left empty, so they are not packed
+        std::for_each(std::execution::par, aIndices.begin(), aIndices.end(),
+            [&](size_t uIndex)
+            {
+                ScopedComApartment comApartment;
+                if (FAILED(ImageDecoder::DecodeFromFile(aSourcePaths[uIndex], aImages[uIndex])))
+                    aImages[uIndex] = {};
+            }
+        );
+
+        std::vector<AtlasPlacement> aPlacements;
+        UINT uAtlasSize = AtlasPacker::Pack(aImages, aPlacements);
+
+        // A single texture gains nothing from an atlas
+        if (aPlacements.size() < 2u)
+            return S_FALSE;
+
+        WIC_DECODED_IMAGE atlas = {};
+        HRESULT hr = AtlasPacker::Compose(uAtlasSize, aImages, aPlacements, atlas);
+        if (FAILED(hr))
+            return hr;
+
+        for (const AtlasPlacement& placement : aPlacements)
+            m_regions[aSourcePaths[placement.uSourceIndex].wstring()] = AtlasPacker::GetRegion(uAtlasSize, aImages[placement.uSourceIndex], placement);
+
+        m_pTexture = std::make_shared<Texture>(atlasPath, std::move(atlas));
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureAtlas::GetRegion
+
+      Summary:  Returns the placement of a source texture
+
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source texture, as given to Build
+                AtlasRegion& outRegion
+                  Placement of the texture
+
+      Returns:  BOOL
+                  TRUE if the texture was packed into the atlas
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TextureAtlas::GetRegion(_In_ const std::filesystem::path& sourcePath, _Out_ AtlasRegion& outRegion) const
+    {
+        auto it = m_regions.find(sourcePath.wstring());
+        if (it == m_regions.end())
+        {
+            outRegion = {};
+            return FALSE;
+        }
+
+        outRegion = it->second;
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureAtlas::GetTexture
+
+      Summary:  Returns the atlas texture
+
+      Returns:  const std::shared_ptr<Texture>&
+                  Atlas texture, nullptr if no atlas was built
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<Texture>& TextureAtlas::GetTexture() const
+    {
+        return m_pTexture;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureAtlas::GetNumRegions
+
+      Summary:  Returns the number of packed source textures
+
+      Returns:  UINT
+                  Number of regions
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TextureAtlas::GetNumRegions() const
+    {
+        return static_cast<UINT>(m_regions.size());
+    }
+}
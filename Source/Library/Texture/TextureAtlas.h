@@ -0,0 +1,60 @@
+/*+===================================================================
+  File:      TEXTUREATLAS.H
+
+  Summary:   TextureAtlas header file contains declaration of class
+             TextureAtlas used to pack small material textures into a
+             single texture.
+
+  Classes:  TextureAtlas
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/AtlasPacker.h"
+#include "Texture/Texture.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureAtlas
+
+      Summary:  Packs small source textures into one square texture
+                with AtlasPacker and keeps the region of every source
+
+      Methods:  Build
+                  Decodes and packs the source textures
+                GetRegion
+                  Returns the placement of a source texture
+                GetTexture
+                  Returns the atlas texture
+                GetNumRegions
+                  Returns the number of packed source textures
+                TextureAtlas
+                  Constructor.
+                ~TextureAtlas
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureAtlas final
+    {
+    public:
+        TextureAtlas();
+        TextureAtlas(const TextureAtlas& other) = delete;
+        TextureAtlas(TextureAtlas&& other) = delete;
+        TextureAtlas& operator=(const TextureAtlas& other) = delete;
+        TextureAtlas& operator=(TextureAtlas&& other) = delete;
+        ~TextureAtlas() = default;
+
+        HRESULT Build(_In_ const std::filesystem::path& atlasPath, _In_ const std::vector<std::filesystem::path>& aSourcePaths);
+
+        BOOL GetRegion(_In_ const std::filesystem::path& sourcePath, _Out_ AtlasRegion& outRegion) const;
+        const std::shared_ptr<Texture>& GetTexture() const;
+        UINT GetNumRegions() const;
+
+    private:
+        std::unordered_map<std::wstring, AtlasRegion> m_regions;
+        std::shared_ptr<Texture> m_pTexture;
+    };
+}
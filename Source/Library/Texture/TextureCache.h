@@ -0,0 +1,861 @@
+/*+===================================================================
+  File:      TEXTURECACHE.H
+
+  Summary:   TextureCache header file contains declaration and
+             definition of class template TextureCache used to share
+             loaded textures between materials and models.
+
+  Classes:  TextureCache
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <list>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
+
+#include "Texture/ImageDecoder.h"
+
+// Only passed through to the textures, so the cache also builds without Direct3D
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureCache
+
+      Summary:  Registry of loaded textures keyed by canonical file path
+                and file content. Identical files are decoded and
+                uploaded once. The cache holds weak references to every
+                texture and keeps the most recently used ones alive up
+                to a memory budget. TextureType is constructed from a
+                file path and provides Initialize, Decode, Upload and
+                GetMemorySize like Texture does
+
+      Methods:  GetOrLoad
+                  Returns a shared texture, loading it on a miss
+                GetOrLoadBatch
+                  Returns shared textures, decoding the misses in
+                  parallel before uploading them
+                Clear
+                  Releases every texture and forgets every file
+                SetMemoryBudget
+                  Sets the number of bytes kept alive by the cache
+                GetMemoryBudget
+                  Returns the memory budget
+                GetMemoryUsage
+                  Returns the number of bytes kept alive by the cache
+                GetNumHits
+                  Returns the number of lookups served from the cache
+                GetNumMisses
+                  Returns the number of lookups that loaded a texture
+                GetNumEvictions
+                  Returns the number of textures evicted by the budget
+                TextureCache
+                  Constructor.
+                ~TextureCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    template <class TextureType>
+    class TextureCache final
+    {
+    public:
+        static constexpr const size_t DEFAULT_MEMORY_BUDGET = 256ull * 1024ull * 1024ull;
+
+        TextureCache();
+        TextureCache(_In_ size_t uMemoryBudget);
+        TextureCache(const TextureCache& other) = delete;
+        TextureCache(TextureCache&& other) = delete;
+        TextureCache& operator=(const TextureCache& other) = delete;
+        TextureCache& operator=(TextureCache&& other) = delete;
+        ~TextureCache() = default;
+
+        HRESULT GetOrLoad(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::filesystem::path& filePath,
+            _Out_ std::shared_ptr<TextureType>& pOutTexture
+        );
+        HRESULT GetOrLoadBatch(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::vector<std::filesystem::path>& aFilePaths,
+            _Out_ std::vector<std::shared_ptr<TextureType>>& aOutTextures
+        );
+        void Clear();
+
+        void SetMemoryBudget(_In_ size_t uMemoryBudget);
+        size_t GetMemoryBudget() const;
+        size_t GetMemoryUsage() const;
+
+        UINT GetNumHits() const;
+        UINT GetNumMisses() const;
+        UINT GetNumEvictions() const;
+
+    private:
+        struct PathEntry
+        {
+            UINT64 uContentHash;
+            std::filesystem::file_time_type lastWriteTime;
+        };
+
+        struct ContentEntry
+        {
+            std::filesystem::path sourcePath;
+            std::filesystem::file_time_type sourceWriteTime;
+            std::weak_ptr<TextureType> pWeakTexture;
+            std::shared_ptr<TextureType> pTexture;
+            std::shared_future<std::shared_ptr<TextureType>> pendingTexture;
+            std::list<UINT64>::iterator lruIterator;
+            size_t uMemorySize;
+            BOOL bInLru;
+        };
+
+        struct Request
+        {
+            UINT64 uContentKey;
+            std::shared_ptr<TextureType> pTexture;
+            std::shared_future<std::shared_ptr<TextureType>> pendingTexture;
+            std::promise<std::shared_ptr<TextureType>> loadPromise;
+            BOOL bClaimed;
+        };
+
+        static HRESULT hashFile(_In_ const std::filesystem::path& filePath, _Out_ UINT64& uOutHash);
+        static BOOL isSameContent(
+            _In_ const std::filesystem::path& filePath,
+            _In_ const std::filesystem::path& sourcePath,
+            _In_ std::filesystem::file_time_type sourceWriteTime
+        );
+
+        HRESULT lookup(_In_ const std::filesystem::path& filePath, _Out_ Request& outRequest);
+        HRESULT share(_In_ UINT64 uContentKey, _In_ const std::filesystem::path& filePath, _In_ std::filesystem::file_time_type lastWriteTime, _Out_ Request& outRequest);
+        void publish(_In_ Request& request, _In_ const std::shared_ptr<TextureType>& pTexture);
+        void touch(_In_ UINT64 uContentKey, _In_ ContentEntry& entry, _In_ const std::shared_ptr<TextureType>& pTexture);
+        void evict();
+
+    private:
+        mutable std::mutex m_mutex;
+
+        std::unordered_map<std::wstring, PathEntry> m_paths;
+        std::unordered_map<UINT64, ContentEntry> m_contents;
+        std::list<UINT64> m_lru;
+
+        size_t m_uMemoryBudget;
+        size_t m_uMemoryUsage;
+
+        UINT m_uNumHits;
+        UINT m_uNumMisses;
+        UINT m_uNumEvictions;
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::TextureCache
+
+      Summary:  Constructor
+
+      Modifies: [m_mutex, m_paths, m_contents, m_lru, m_uMemoryBudget,
+                 m_uMemoryUsage, m_uNumHits, m_uNumMisses,
+                 m_uNumEvictions].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    TextureCache<TextureType>::TextureCache()
+        : TextureCache(DEFAULT_MEMORY_BUDGET)
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::TextureCache
+
+      Summary:  Constructor
+
+      Args:     size_t uMemoryBudget
+                  Number of texture bytes the cache keeps alive
+
+      Modifies: [m_mutex, m_paths, m_contents, m_lru, m_uMemoryBudget,
+                 m_uMemoryUsage, m_uNumHits, m_uNumMisses,
+                 m_uNumEvictions].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    TextureCache<TextureType>::TextureCache(_In_ size_t uMemoryBudget)
+        : m_mutex()
+        , m_paths()
+        , m_contents()
+        , m_lru()
+        , m_uMemoryBudget(uMemoryBudget)
+        , m_uMemoryUsage(0u)
+        , m_uNumHits(0u)
+        , m_uNumMisses(0u)
+        , m_uNumEvictions(0u)
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::GetOrLoad
+
+      Summary:  Returns the texture of the given file. Files with the
+                same content share one texture. On a miss the texture
+                is loaded, while concurrent requests for the same
+                content wait for that single load
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to generate mipmaps
+                const std::filesystem::path& filePath
+                  Path to the texture file
+                std::shared_ptr<TextureType>& pOutTexture
+                  Loaded texture, nullptr on failure
+
+      Modifies: [m_paths, m_contents, m_lru, m_uMemoryUsage, m_uNumHits,
+                 m_uNumMisses, m_uNumEvictions].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    HRESULT TextureCache<TextureType>::GetOrLoad(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const std::filesystem::path& filePath,
+        _Out_ std::shared_ptr<TextureType>& pOutTexture
+    )
+    {
+        pOutTexture.reset();
+
+        Request request = {};
+        HRESULT hr = lookup(filePath, request);
+        if (FAILED(hr))
+            return hr;
+
+        if (request.pTexture)
+        {
+            pOutTexture = request.pTexture;
+            return S_OK;
+        }
+
+        // Another thread is loading the same content
+        if (request.pendingTexture.valid())
+        {
+            pOutTexture = request.pendingTexture.get();
+            return pOutTexture ? S_OK : E_FAIL;
+        }
+
+        std::shared_ptr<TextureType> pTexture = std::make_shared<TextureType>(filePath);
+        hr = pTexture->Initialize(pDevice, pImmediateContext);
+        if (FAILED(hr))
+            pTexture.reset();
+
+        publish(request, pTexture);
+
+        pOutTexture = pTexture;
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::GetOrLoadBatch
+
+      Summary:  Returns the textures of the given files. Missing
+                textures are decoded in parallel on the worker threads
+                of the standard library, then uploaded one after
+                another on the calling thread
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the textures
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to generate mipmaps
+                const std::vector<std::filesystem::path>& aFilePaths
+                  Paths to the texture files
+                std::vector<std::shared_ptr<TextureType>>& aOutTextures
+                  Loaded textures in the order of aFilePaths, nullptr
+                  for the files that failed to load
+
+      Modifies: [m_paths, m_contents, m_lru, m_uMemoryUsage, m_uNumHits,
+                 m_uNumMisses, m_uNumEvictions].
+
+      Returns:  HRESULT
+                  Status code of the first failure, S_OK if every
+                  texture was loaded
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    HRESULT TextureCache<TextureType>::GetOrLoadBatch(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const std::vector<std::filesystem::path>& aFilePaths,
+        _Out_ std::vector<std::shared_ptr<TextureType>>& aOutTextures
+    )
+    {
+        aOutTextures.assign(aFilePaths.size(), std::shared_ptr<TextureType>());
+
+        std::vector<Request> aRequests(aFilePaths.size());
+        std::vector<HRESULT> aResults(aFilePaths.size(), S_OK);
+
+        std::vector<size_t> aIndices(aFilePaths.size());
+        std::iota(aIndices.begin(), aIndices.end(), 0ull);
+
+        // Decode every claimed miss in parallel, no device context is used here
+        std::for_each(std::execution::par, aIndices.begin(), aIndices.end(),
+            [&](size_t uIndex)
+            {
+                ScopedComApartment comApartment;
+                Request& request = aRequests[uIndex];
+
+                aResults[uIndex] = lookup(aFilePaths[uIndex], request);
+                if (FAILED(aResults[uIndex]) || !request.bClaimed)
+                    return;
+
+                request.pTexture = std::make_shared<TextureType>(aFilePaths[uIndex]);
+                aResults[uIndex] = request.pTexture->Decode(pDevice);
+            }
+        );
+
+        // Upload on this thread only, then publish so waiting requests resume
+        for (size_t i = 0u; i < aRequests.size(); ++i)
+        {
+            Request& request = aRequests[i];
+            if (!request.bClaimed)
+                continue;
+
+            if (SUCCEEDED(aResults[i]))
+                aResults[i] = request.pTexture->Upload(pDevice, pImmediateContext);
+
+            if (FAILED(aResults[i]))
+                request.pTexture.reset();
+
+            publish(request, request.pTexture);
+        }
+
+        HRESULT hr = S_OK;
+        for (size_t i = 0u; i < aRequests.size(); ++i)
+        {
+            Request& request = aRequests[i];
+
+            // Duplicates within the batch were published by the loop above
+            if (!request.pTexture && request.pendingTexture.valid())
+            {
+                request.pTexture = request.pendingTexture.get();
+                if (!request.pTexture && SUCCEEDED(aResults[i]))
+                    aResults[i] = E_FAIL;
+            }
+
+            aOutTextures[i] = request.pTexture;
+
+            if (FAILED(aResults[i]) && SUCCEEDED(hr))
+                hr = aResults[i];
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::Clear
+
+      Summary:  Releases every texture kept alive by the cache and
+                forgets every file. Textures still used by a material
+                are not shared with later loads. Should be called
+                before the device is destroyed
+
+      Modifies: [m_paths, m_contents, m_lru, m_uMemoryUsage].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    void TextureCache<TextureType>::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_paths.clear();
+        m_contents.clear();
+        m_lru.clear();
+        m_uMemoryUsage = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::SetMemoryBudget
+
+      Summary:  Sets the number of texture bytes the cache keeps alive
+                and evicts the least recently used textures above it
+
+      Args:     size_t uMemoryBudget
+                  Memory budget in bytes
+
+      Modifies: [m_uMemoryBudget, m_contents, m_lru, m_uMemoryUsage,
+                 m_uNumEvictions].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    void TextureCache<TextureType>::SetMemoryBudget(_In_ size_t uMemoryBudget)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_uMemoryBudget = uMemoryBudget;
+        evict();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::GetMemoryBudget
+
+      Summary:  Returns the memory budget
+
+      Returns:  size_t
+                  Memory budget in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    size_t TextureCache<TextureType>::GetMemoryBudget() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_uMemoryBudget;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::GetMemoryUsage
+
+      Summary:  Returns the number of texture bytes kept alive by the
+                cache. The TextureStreamer changes the size of a texture
+                as it streams mips, each texture counts with its size
+                from the last time it was used
+
+      Returns:  size_t
+                  Memory usage in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    size_t TextureCache<TextureType>::GetMemoryUsage() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_uMemoryUsage;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::GetNumHits
+
+      Summary:  Returns the number of lookups served without loading
+
+      Returns:  UINT
+                  Number of hits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    UINT TextureCache<TextureType>::GetNumHits() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_uNumHits;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::GetNumMisses
+
+      Summary:  Returns the number of lookups that loaded a texture
+
+      Returns:  UINT
+                  Number of misses
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    UINT TextureCache<TextureType>::GetNumMisses() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_uNumMisses;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::GetNumEvictions
+
+      Summary:  Returns the number of textures released by the budget
+
+      Returns:  UINT
+                  Number of evictions
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    UINT TextureCache<TextureType>::GetNumEvictions() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_uNumEvictions;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::hashFile
+
+      Summary:  Computes the 64-bit FNV-1a hash of the file content
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the file
+                UINT64& uOutHash
+                  Hash of the content
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    HRESULT TextureCache<TextureType>::hashFile(_In_ const std::filesystem::path& filePath, _Out_ UINT64& uOutHash)
+    {
+        constexpr const UINT64 FNV_OFFSET_BASIS = 14695981039346656037ull;
+        constexpr const UINT64 FNV_PRIME = 1099511628211ull;
+
+        uOutHash = FNV_OFFSET_BASIS;
+
+        std::ifstream inputFile(filePath, std::ios::binary);
+        if (!inputFile.is_open())
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+
+        CHAR aBuffer[64 * 1024];
+        while (inputFile)
+        {
+            inputFile.read(aBuffer, sizeof(aBuffer));
+
+            std::streamsize numRead = inputFile.gcount();
+            for (std::streamsize i = 0; i < numRead; ++i)
+            {
+                uOutHash ^= static_cast<BYTE>(aBuffer[i]);
+                uOutHash *= FNV_PRIME;
+            }
+        }
+
+        if (inputFile.bad())
+            return HRESULT_FROM_WIN32(ERROR_READ_FAULT);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::isSameContent
+
+      Summary:  Compares the size and the bytes of a file with the file
+                a texture was loaded from. The source file has to be
+                unchanged since, otherwise it says nothing about the
+                texture
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the file
+                const std::filesystem::path& sourcePath
+                  Path to the file the texture was loaded from
+                std::filesystem::file_time_type sourceWriteTime
+                  Last write time of the source file at the load
+
+      Returns:  BOOL
+                  TRUE if the texture can be shared with the file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    BOOL TextureCache<TextureType>::isSameContent(
+        _In_ const std::filesystem::path& filePath,
+        _In_ const std::filesystem::path& sourcePath,
+        _In_ std::filesystem::file_time_type sourceWriteTime
+    )
+    {
+        constexpr const size_t BUFFER_SIZE = 64u * 1024u;
+
+        std::error_code errorCode;
+        if (std::filesystem::last_write_time(sourcePath, errorCode) != sourceWriteTime || errorCode)
+            return FALSE;
+
+        std::uintmax_t uFileSize = std::filesystem::file_size(filePath, errorCode);
+        if (errorCode || std::filesystem::file_size(sourcePath, errorCode) != uFileSize || errorCode)
+            return FALSE;
+
+        std::ifstream inputFile(filePath, std::ios::binary);
+        std::ifstream sourceFile(sourcePath, std::ios::binary);
+        if (!inputFile.is_open() || !sourceFile.is_open())
+            return FALSE;
+
+        std::vector<CHAR> aBuffer(BUFFER_SIZE);
+        std::vector<CHAR> aSourceBuffer(BUFFER_SIZE);
+        while (inputFile && sourceFile)
+        {
+            inputFile.read(aBuffer.data(), static_cast<std::streamsize>(BUFFER_SIZE));
+            sourceFile.read(aSourceBuffer.data(), static_cast<std::streamsize>(BUFFER_SIZE));
+
+            std::streamsize numRead = inputFile.gcount();
+            if (numRead != sourceFile.gcount() || std::memcmp(aBuffer.data(), aSourceBuffer.data(), static_cast<size_t>(numRead)) != 0)
+                return FALSE;
+        }
+
+        return !inputFile.bad() && !sourceFile.bad();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::lookup
+
+      Summary:  Resolves the file to its content and either returns the
+                cached texture, the pending load of another request, or
+                claims the load for the caller. A claimed request must
+                be passed to publish. Entries are keyed by the content
+                hash, and a file only shares an entry whose source file
+                has the same bytes. A hash collision moves on to the
+                next key
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture file
+                Request& outRequest
+                  Result of the lookup
+
+      Modifies: [m_paths, m_contents, m_lru, m_uMemoryUsage, m_uNumHits,
+                 m_uNumMisses, m_uNumEvictions].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    HRESULT TextureCache<TextureType>::lookup(_In_ const std::filesystem::path& filePath, _Out_ Request& outRequest)
+    {
+        HRESULT hr = S_OK;
+
+        std::error_code errorCode;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath, errorCode);
+        if (errorCode)
+            canonicalPath = filePath;
+
+        std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(canonicalPath, errorCode);
+        if (errorCode)
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+
+        // The content hash is only recomputed when the file has changed
+        UINT64 uContentHash = 0ull;
+        BOOL bHashKnown = FALSE;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto it = m_paths.find(canonicalPath.wstring());
+            if (it != m_paths.end() && it->second.lastWriteTime == lastWriteTime)
+            {
+                uContentHash = it->second.uContentHash;
+                bHashKnown = TRUE;
+            }
+        }
+
+        if (!bHashKnown)
+        {
+            hr = hashFile(canonicalPath, uContentHash);
+            if (FAILED(hr))
+                return hr;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_paths[canonicalPath.wstring()] = PathEntry{ .uContentHash = uContentHash, .lastWriteTime = lastWriteTime };
+        }
+
+        // Files are compared without the lock, so the entry is checked again after the comparison
+        UINT64 uContentKey = uContentHash;
+        std::filesystem::path comparedPath;
+        std::filesystem::file_time_type comparedWriteTime;
+        BOOL bSameContent = FALSE;
+        for (;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                auto it = m_contents.find(uContentKey);
+                if (it == m_contents.end())
+                    return share(uContentKey, canonicalPath, lastWriteTime, outRequest);
+
+                // Nothing holds the texture of the entry any more
+                const ContentEntry& entry = it->second;
+                if (entry.pWeakTexture.expired() && !entry.pendingTexture.valid())
+                    return share(uContentKey, canonicalPath, lastWriteTime, outRequest);
+
+                BOOL bSameSource = entry.sourcePath == canonicalPath && entry.sourceWriteTime == lastWriteTime;
+                BOOL bCompared = entry.sourcePath == comparedPath && entry.sourceWriteTime == comparedWriteTime;
+                if (bSameSource || (bCompared && bSameContent))
+                    return share(uContentKey, canonicalPath, lastWriteTime, outRequest);
+
+                if (bCompared)
+                {
+                    ++uContentKey;
+                    comparedPath.clear();
+                    continue;
+                }
+
+                comparedPath = entry.sourcePath;
+                comparedWriteTime = entry.sourceWriteTime;
+            }
+
+            bSameContent = isSameContent(canonicalPath, comparedPath, comparedWriteTime);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::share
+
+      Summary:  Returns the texture or the pending load of the entry,
+                or claims the load if there is neither. Must be called
+                with m_mutex held
+
+      Args:     UINT64 uContentKey
+                  Key of the entry with the content of the file
+                const std::filesystem::path& filePath
+                  Canonical path to the texture file
+                std::filesystem::file_time_type lastWriteTime
+                  Last write time of the file
+                Request& outRequest
+                  Result of the lookup
+
+      Modifies: [m_contents, m_lru, m_uMemoryUsage, m_uNumHits,
+                 m_uNumMisses, m_uNumEvictions].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    HRESULT TextureCache<TextureType>::share(
+        _In_ UINT64 uContentKey,
+        _In_ const std::filesystem::path& filePath,
+        _In_ std::filesystem::file_time_type lastWriteTime,
+        _Out_ Request& outRequest
+    )
+    {
+        outRequest.uContentKey = uContentKey;
+
+        auto it = m_contents.find(uContentKey);
+        if (it != m_contents.end())
+        {
+            std::shared_ptr<TextureType> pTexture = it->second.pWeakTexture.lock();
+            if (pTexture)
+            {
+                ++m_uNumHits;
+                touch(uContentKey, it->second, pTexture);
+                evict();
+
+                outRequest.pTexture = pTexture;
+                return S_OK;
+            }
+
+            if (it->second.pendingTexture.valid())
+            {
+                ++m_uNumHits;
+                outRequest.pendingTexture = it->second.pendingTexture;
+                return S_OK;
+            }
+
+            // Every user released the texture after it left the LRU
+            m_contents.erase(it);
+        }
+
+        ++m_uNumMisses;
+
+        ContentEntry& entry = m_contents[uContentKey];
+        entry.sourcePath = filePath;
+        entry.sourceWriteTime = lastWriteTime;
+        entry.pendingTexture = outRequest.loadPromise.get_future().share();
+        entry.uMemorySize = 0u;
+        entry.bInLru = FALSE;
+
+        outRequest.bClaimed = TRUE;
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::publish
+
+      Summary:  Stores the result of a claimed load and wakes up the
+                requests waiting for it
+
+      Args:     Request& request
+                  Request claimed by lookup
+                const std::shared_ptr<TextureType>& pTexture
+                  Loaded texture, nullptr if the load failed
+
+      Modifies: [m_contents, m_lru, m_uMemoryUsage, m_uNumEvictions].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    void TextureCache<TextureType>::publish(_In_ Request& request, _In_ const std::shared_ptr<TextureType>& pTexture)
+    {
+        assert(request.bClaimed);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // The entry is gone if the cache was cleared during the load
+            auto it = m_contents.find(request.uContentKey);
+            if (it != m_contents.end())
+            {
+                if (pTexture)
+                {
+                    it->second.pendingTexture = std::shared_future<std::shared_ptr<TextureType>>();
+                    it->second.pWeakTexture = pTexture;
+
+                    touch(request.uContentKey, it->second, pTexture);
+                    evict();
+                }
+                else
+                {
+                    m_contents.erase(it);
+                }
+            }
+        }
+
+        request.loadPromise.set_value(pTexture);
+        request.bClaimed = FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::touch
+
+      Summary:  Marks the texture as the most recently used one and keeps
+                it alive. The texture is counted with its current size,
+                which streaming may have changed since it was last used.
+                Must be called with m_mutex held
+
+      Args:     UINT64 uContentKey
+                  Key of the entry of the texture
+                ContentEntry& entry
+                  Entry of the texture
+                const std::shared_ptr<TextureType>& pTexture
+                  Texture to keep alive
+
+      Modifies: [m_lru, m_uMemoryUsage].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    void TextureCache<TextureType>::touch(_In_ UINT64 uContentKey, _In_ ContentEntry& entry, _In_ const std::shared_ptr<TextureType>& pTexture)
+    {
+        size_t uMemorySize = pTexture->GetMemorySize();
+
+        if (entry.bInLru)
+        {
+            m_uMemoryUsage = m_uMemoryUsage - entry.uMemorySize + uMemorySize;
+            entry.uMemorySize = uMemorySize;
+            m_lru.splice(m_lru.begin(), m_lru, entry.lruIterator);
+            return;
+        }
+
+        m_lru.push_front(uContentKey);
+        entry.lruIterator = m_lru.begin();
+        entry.bInLru = TRUE;
+        entry.pTexture = pTexture;
+        entry.uMemorySize = uMemorySize;
+        m_uMemoryUsage += uMemorySize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache<TextureType>::evict
+
+      Summary:  Releases the least recently used textures until the
+                memory usage fits the budget. Textures still used by a
+                material stay reachable through the weak reference.
+                Must be called with m_mutex held
+
+      Modifies: [m_contents, m_lru, m_uMemoryUsage, m_uNumEvictions].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class TextureType>
+    void TextureCache<TextureType>::evict()
+    {
+        while (m_uMemoryUsage > m_uMemoryBudget && !m_lru.empty())
+        {
+            UINT64 uContentKey = m_lru.back();
+            m_lru.pop_back();
+
+            ContentEntry& entry = m_contents.at(uContentKey);
+            m_uMemoryUsage -= entry.uMemorySize;
+            entry.uMemorySize = 0u;
+            entry.pTexture.reset();
+            entry.bInLru = FALSE;
+
+            ++m_uNumEvictions;
+
+            if (entry.pWeakTexture.expired())
+                m_contents.erase(uContentKey);
+        }
+    }
+}
@@ -0,0 +1,342 @@
+#include "Texture/TextureStreamer.h"
+
+#include <numeric>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::TextureStreamer
+
+      Summary:  Constructor
+
+      Modifies: [m_entries, m_uMemoryBudget, m_uUploadBudget,
+                 m_uMemoryUsage, m_uFrame, m_uNumStreamedIn,
+                 m_uNumEvicted].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureStreamer::TextureStreamer()
+        : TextureStreamer(DEFAULT_MEMORY_BUDGET, DEFAULT_UPLOAD_BUDGET)
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::TextureStreamer
+
+      Summary:  Constructor
+
+      Args:     size_t uMemoryBudget
+                  Number of bytes of resident mips
+                size_t uUploadBudget
+                  Number of bytes uploaded per frame
+
+      Modifies: [m_entries, m_uMemoryBudget, m_uUploadBudget,
+                 m_uMemoryUsage, m_uFrame, m_uNumStreamedIn,
+                 m_uNumEvicted].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureStreamer::TextureStreamer(_In_ size_t uMemoryBudget, _In_ size_t uUploadBudget)
+        : m_entries()
+        , m_uMemoryBudget(uMemoryBudget)
+        , m_uUploadBudget(uUploadBudget)
+        , m_uMemoryUsage(0u)
+        , m_uFrame(0u)
+        , m_uNumStreamedIn(0u)
+        , m_uNumEvicted(0u)
+    {}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::Register
+
+      Summary:  Starts streaming the mips of an uploaded texture.
+                Textures that cannot be streamed are ignored
+
+      Args:     const std::shared_ptr<StreamableTexture>& pTexture
+                  Texture to stream
+
+      Modifies: [m_entries, m_uMemoryUsage].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::Register(_In_ const std::shared_ptr<StreamableTexture>& pTexture)
+    {
+        if (!pTexture || !pTexture->IsStreamable() || m_entries.contains(pTexture.get()))
+            return;
+
+        m_entries.emplace(pTexture.get(), Entry
+            {
+                .pWeakTexture = pTexture,
+                .uLastRequestFrame = 0u,
+                .screenSize = 0.0f,
+                .uRequestedMip = pTexture->GetResidentMip(),
+                .uTargetMip = pTexture->GetResidentMip(),
+            });
+
+        m_uMemoryUsage += pTexture->GetMemorySize();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::Request
+
+      Summary:  Requests enough mips for the texture to cover the given
+                screen size this frame. The largest request of a frame
+                wins
+
+      Args:     const std::shared_ptr<StreamableTexture>& pTexture
+                  Registered texture
+                FLOAT screenSize
+                  Number of pixels covered by the texture along its
+                  largest dimension
+
+      Modifies: [m_entries].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::Request(_In_ const std::shared_ptr<StreamableTexture>& pTexture, _In_ FLOAT screenSize)
+    {
+        if (!pTexture)
+            return;
+
+        auto it = m_entries.find(pTexture.get());
+        if (it == m_entries.end())
+            return;
+
+        Entry& entry = it->second;
+        if (entry.uLastRequestFrame != m_uFrame)
+        {
+            entry.uLastRequestFrame = m_uFrame;
+            entry.screenSize = screenSize;
+        }
+        else
+            entry.screenSize = std::max<FLOAT>(entry.screenSize, screenSize);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::Update
+
+      Summary:  Applies the requests of the frame. Textures requested
+                this frame aim at their requested mip, the others keep
+                their mips. Above the memory budget, the least recently
+                requested and smallest textures on screen lose mips
+                first, down to their startup mip. Evictions are applied
+                before the most wanted textures stream in one level
+                each, up to the upload budget
+
+      Modifies: [m_entries, m_uMemoryUsage, m_uFrame, m_uNumStreamedIn,
+                 m_uNumEvicted].
+
+      Returns:  HRESULT
+                  Status code of the first failed upload
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TextureStreamer::Update()
+    {
+        std::erase_if(m_entries, [](const auto& entryElem) { return entryElem.second.pWeakTexture.expired(); });
+
+        std::vector<Entry*> aEntries;
+        std::vector<std::shared_ptr<StreamableTexture>> aTextures;
+        aEntries.reserve(m_entries.size());
+        aTextures.reserve(m_entries.size());
+        for (auto& entryElem : m_entries)
+        {
+            aEntries.push_back(&entryElem.second);
+            aTextures.push_back(entryElem.second.pWeakTexture.lock());
+        }
+
+        size_t uTargetUsage = 0u;
+        for (size_t i = 0u; i < aEntries.size(); ++i)
+        {
+            Entry& entry = *aEntries[i];
+            if (entry.uLastRequestFrame == m_uFrame)
+                entry.uRequestedMip = getMipForScreenSize(*aTextures[i], entry.screenSize);
+
+            entry.uTargetMip = entry.uLastRequestFrame == m_uFrame ? entry.uRequestedMip : aTextures[i]->GetResidentMip();
+            uTargetUsage += aTextures[i]->GetMipChainSize(entry.uTargetMip);
+        }
+
+        std::vector<size_t> aOrder(aEntries.size());
+        std::iota(aOrder.begin(), aOrder.end(), 0ull);
+
+        // Least wanted first
+        std::sort(aOrder.begin(), aOrder.end(),
+            [&aEntries](size_t uLeft, size_t uRight)
+            {
+                if (aEntries[uLeft]->uLastRequestFrame != aEntries[uRight]->uLastRequestFrame)
+                    return aEntries[uLeft]->uLastRequestFrame < aEntries[uRight]->uLastRequestFrame;
+
+                return aEntries[uLeft]->screenSize < aEntries[uRight]->screenSize;
+            }
+        );
+
+        for (size_t i = 0u; i < aOrder.size() && uTargetUsage > m_uMemoryBudget; ++i)
+        {
+            Entry& entry = *aEntries[aOrder[i]];
+            const StreamableTexture& texture = *aTextures[aOrder[i]];
+
+            while (uTargetUsage > m_uMemoryBudget && entry.uTargetMip < texture.GetStartupMip())
+            {
+                uTargetUsage -= texture.GetMipChainSize(entry.uTargetMip) - texture.GetMipChainSize(entry.uTargetMip + 1u);
+                ++entry.uTargetMip;
+            }
+        }
+
+        HRESULT hr = S_OK;
+
+        // Evict first so the freed memory is available to the streamed mips
+        for (size_t i = 0u; i < aEntries.size(); ++i)
+        {
+            UINT uResidentMip = aTextures[i]->GetResidentMip();
+            if (aEntries[i]->uTargetMip <= uResidentMip)
+                continue;
+
+            HRESULT hrStream = aTextures[i]->StreamMips(aEntries[i]->uTargetMip);
+            if (SUCCEEDED(hrStream))
+                m_uNumEvicted += aEntries[i]->uTargetMip - uResidentMip;
+            else if (SUCCEEDED(hr))
+                hr = hrStream;
+        }
+
+        // Most wanted first, one level per texture and frame
+        size_t uUploadSize = 0u;
+        for (auto it = aOrder.rbegin(); it != aOrder.rend() && uUploadSize < m_uUploadBudget; ++it)
+        {
+            UINT uResidentMip = aTextures[*it]->GetResidentMip();
+            if (aEntries[*it]->uTargetMip >= uResidentMip)
+                continue;
+
+            HRESULT hrStream = aTextures[*it]->StreamMips(uResidentMip - 1u);
+            if (SUCCEEDED(hrStream))
+            {
+                uUploadSize += aTextures[*it]->GetMipChainSize(uResidentMip - 1u) - aTextures[*it]->GetMipChainSize(uResidentMip);
+                ++m_uNumStreamedIn;
+            }
+            else if (SUCCEEDED(hr))
+                hr = hrStream;
+        }
+
+        m_uMemoryUsage = 0u;
+        for (const std::shared_ptr<StreamableTexture>& pTexture : aTextures)
+            m_uMemoryUsage += pTexture->GetMemorySize();
+
+        ++m_uFrame;
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::SetMemoryBudget
+
+      Summary:  Sets the number of bytes of resident mips, applied by
+                the next Update
+
+      Args:     size_t uMemoryBudget
+                  Memory budget in bytes
+
+      Modifies: [m_uMemoryBudget].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::SetMemoryBudget(_In_ size_t uMemoryBudget)
+    {
+        m_uMemoryBudget = uMemoryBudget;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetMemoryBudget
+
+      Summary:  Returns the memory budget
+
+      Returns:  size_t
+                  Memory budget in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t TextureStreamer::GetMemoryBudget() const
+    {
+        return m_uMemoryBudget;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::SetUploadBudget
+
+      Summary:  Sets the number of bytes uploaded per frame. At least
+                one level is streamed in per frame whatever its size
+
+      Args:     size_t uUploadBudget
+                  Upload budget in bytes
+
+      Modifies: [m_uUploadBudget].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::SetUploadBudget(_In_ size_t uUploadBudget)
+    {
+        m_uUploadBudget = uUploadBudget;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetUploadBudget
+
+      Summary:  Returns the upload budget
+
+      Returns:  size_t
+                  Upload budget in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t TextureStreamer::GetUploadBudget() const
+    {
+        return m_uUploadBudget;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetMemoryUsage
+
+      Summary:  Returns the number of bytes of resident mips of the
+                registered textures
+
+      Returns:  size_t
+                  Memory usage in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t TextureStreamer::GetMemoryUsage() const
+    {
+        return m_uMemoryUsage;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetNumStreamedIn
+
+      Summary:  Returns the number of mip levels streamed in
+
+      Returns:  UINT
+                  Number of mip levels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TextureStreamer::GetNumStreamedIn() const
+    {
+        return m_uNumStreamedIn;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetNumEvicted
+
+      Summary:  Returns the number of mip levels evicted
+
+      Returns:  UINT
+                  Number of mip levels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TextureStreamer::GetNumEvicted() const
+    {
+        return m_uNumEvicted;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::getMipForScreenSize
+
+      Summary:  Returns the most detailed mip with at least one texel
+                per pixel, never coarser than the startup mip
+
+      Args:     const StreamableTexture& texture
+                  Streamed texture
+                FLOAT screenSize
+                  Number of pixels covered by the texture along its
+                  largest dimension
+
+      Returns:  UINT
+                  Mip index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TextureStreamer::getMipForScreenSize(_In_ const StreamableTexture& texture, _In_ FLOAT screenSize)
+    {
+        if (screenSize < 1.0f)
+            return texture.GetStartupMip();
+
+        FLOAT texelsPerPixel = static_cast<FLOAT>(texture.GetTopMipSize()) / screenSize;
+        if (texelsPerPixel <= 1.0f)
+            return 0u;
+
+        UINT uMip = static_cast<UINT>(floorf(log2f(texelsPerPixel)));
+        return std::min<UINT>(uMip, texture.GetStartupMip());
+    }
+}
@@ -0,0 +1,109 @@
+/*+===================================================================
+  File:      TEXTURESTREAMER.H
+
+  Summary:   TextureStreamer header file contains declaration of class
+             TextureStreamer used to keep the mips of DDS textures
+             resident on demand.
+
+  Classes:  TextureStreamer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <unordered_map>
+
+#include "Texture/StreamableTexture.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureStreamer
+
+      Summary:  Streams the mips of registered textures. Every frame the
+                renderer requests the screen size covered by each
+                texture, which gives the most detailed mip worth having.
+                Update then drops the mips of the least recently used
+                textures to stay under the memory budget and streams
+                missing mips in, one level per texture and at most the
+                upload budget per frame. Only the StreamableTexture
+                interface is used, so the policy runs without a device
+
+      Methods:  Register
+                  Starts streaming the mips of a texture
+                Request
+                  Requests the mip matching a screen size this frame
+                Update
+                  Evicts and streams in mips, once a frame
+                SetMemoryBudget
+                  Sets the number of bytes of resident mips
+                GetMemoryBudget
+                  Returns the memory budget
+                SetUploadBudget
+                  Sets the number of bytes uploaded per frame
+                GetUploadBudget
+                  Returns the upload budget
+                GetMemoryUsage
+                  Returns the number of bytes of resident mips
+                GetNumStreamedIn
+                  Returns the number of mip levels streamed in
+                GetNumEvicted
+                  Returns the number of mip levels evicted
+                TextureStreamer
+                  Constructor.
+                ~TextureStreamer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureStreamer final
+    {
+    public:
+        static constexpr const size_t DEFAULT_MEMORY_BUDGET = 128ull * 1024ull * 1024ull;
+        static constexpr const size_t DEFAULT_UPLOAD_BUDGET = 8ull * 1024ull * 1024ull;
+
+        TextureStreamer();
+        TextureStreamer(_In_ size_t uMemoryBudget, _In_ size_t uUploadBudget);
+        TextureStreamer(const TextureStreamer& other) = delete;
+        TextureStreamer(TextureStreamer&& other) = delete;
+        TextureStreamer& operator=(const TextureStreamer& other) = delete;
+        TextureStreamer& operator=(TextureStreamer&& other) = delete;
+        ~TextureStreamer() = default;
+
+        void Register(_In_ const std::shared_ptr<StreamableTexture>& pTexture);
+        void Request(_In_ const std::shared_ptr<StreamableTexture>& pTexture, _In_ FLOAT screenSize);
+        HRESULT Update();
+
+        void SetMemoryBudget(_In_ size_t uMemoryBudget);
+        size_t GetMemoryBudget() const;
+        void SetUploadBudget(_In_ size_t uUploadBudget);
+        size_t GetUploadBudget() const;
+        size_t GetMemoryUsage() const;
+
+        UINT GetNumStreamedIn() const;
+        UINT GetNumEvicted() const;
+
+    private:
+        struct Entry
+        {
+            std::weak_ptr<StreamableTexture> pWeakTexture;
+            UINT64 uLastRequestFrame;
+            FLOAT screenSize;
+            UINT uRequestedMip;
+            UINT uTargetMip;
+        };
+
+        static UINT getMipForScreenSize(_In_ const StreamableTexture& texture, _In_ FLOAT screenSize);
+
+    private:
+        std::unordered_map<const StreamableTexture*, Entry> m_entries;
+
+        size_t m_uMemoryBudget;
+        size_t m_uUploadBudget;
+        size_t m_uMemoryUsage;
+        UINT64 m_uFrame;
+
+        UINT m_uNumStreamedIn;
+        UINT m_uNumEvicted;
+    };
+}
@@ -4,10 +4,10 @@
 // Function for loading a WIC image and creating a Direct3D 11 runtime texture for it
 // (auto-generating mipmaps if possible)
 //
-// Note: Assumes application has already called CoInitializeEx
+// Note: Joins the multithreaded COM apartment on threads that are not in one yet
 //
-// Warning: CreateWICTexture* functions are not thread-safe if given a d3dContext instance for
-//          auto-gen mipmap support.
+// Note: CreateWICTexture* functions may be called from several threads. Uses of a d3dContext
+//       instance for auto-gen mipmap support are serialized internally.
 //
 // Note these functions are useful for images created as simple 2D textures. For
 // more complex resources, DDSTextureLoader is an excellent light-weight runtime loader.
@@ -36,6 +36,7 @@
 #include <wincodec.h>
 #pragma warning(pop)
 
+#include <atomic>
 #include <memory>
 
 #include "Texture/WICTextureLoader.h"
@@ -201,26 +202,43 @@ static WICConvert g_WICConvert[] =
 //--------------------------------------------------------------------------------------
 static IWICImagingFactory* _GetWIC()
 {
-    static IWICImagingFactory* s_Factory = nullptr;
+    // Textures may be loaded from several threads. A failed creation is not remembered, the
+    // next call tries again as before
+    static std::mutex s_factoryMutex;
+    static std::atomic<IWICImagingFactory*> s_Factory = nullptr;
 
-    if (s_Factory)
-        return s_Factory;
+    IWICImagingFactory* factory = s_Factory.load(std::memory_order_acquire);
+    if (factory)
+        return factory;
+
+    std::lock_guard<std::mutex> lock(s_factoryMutex);
+
+    factory = s_Factory.load(std::memory_order_relaxed);
+    if (factory)
+        return factory;
 
     HRESULT hr = CoCreateInstance(
         CLSID_WICImagingFactory,
         nullptr,
         CLSCTX_INPROC_SERVER,
         __uuidof(IWICImagingFactory),
-        (LPVOID*)&s_Factory
+        (LPVOID*)&factory
     );
 
     if (FAILED(hr))
-    {
-        s_Factory = nullptr;
         return nullptr;
-    }
 
-    return s_Factory;
+    s_Factory.store(factory, std::memory_order_release);
+    return factory;
+}
+
+//---------------------------------------------------------------------------------
+// The immediate context is not thread-safe, serialize the auto-gen mipmap uploads
+// of both the WIC and the DDS loaders
+std::mutex& GetTextureLoaderContextMutex()
+{
+    static std::mutex s_contextMutex;
+    return s_contextMutex;
 }
 
 //---------------------------------------------------------------------------------
@@ -265,11 +283,11 @@ static size_t _WICBitsPerPixel(REFGUID targetGuid)
 }
 
 //---------------------------------------------------------------------------------
-static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
-    _In_opt_ ID3D11DeviceContext* d3dContext,
+// Decodes and converts the frame into CPU memory, the device is only queried for
+// feature level and format support which is free-threaded
+static HRESULT DecodeTextureFromWIC(_In_opt_ ID3D11Device* d3dDevice,
     _In_ IWICBitmapFrameDecode* frame,
-    _Out_opt_ ID3D11Resource** texture,
-    _Out_opt_ ID3D11ShaderResourceView** textureView,
+    _Out_ WIC_DECODED_IMAGE& image,
     _In_ size_t maxsize)
 {
     UINT width, height;
@@ -279,6 +297,11 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
 
     assert(width > 0 && height > 0);
 
+    if (!maxsize && !d3dDevice)
+    {
+        maxsize = D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION;
+    }
+
     if (!maxsize)
     {
         // This is a bit conservative because the hardware could support larger textures than
@@ -371,8 +394,9 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
 
     // Verify our target format is supported by the current device
     // (handles WDDM 1.0 or WDDM 1.1 device driver cases as well as DirectX 11.0 Runtime without 16bpp format support)
+    // Without a device the image is always converted to RGBA 32-bit for CPU processing
     UINT support = 0;
-    hr = d3dDevice->CheckFormatSupport(format, &support);
+    hr = d3dDevice ? d3dDevice->CheckFormatSupport(format, &support) : E_FAIL;
     if (FAILED(hr) || !(support & D3D11_FORMAT_SUPPORT_TEXTURE2D))
     {
         // Fallback to RGBA 32-bit format which is supported by all devices
@@ -462,9 +486,58 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
             return hr;
     }
 
+    image.width = twidth;
+    image.height = theight;
+    image.format = format;
+    image.rowPitch = rowPitch;
+    image.bitsPerPixel = bpp;
+    image.mipLevels = 1;
+    image.pixels = std::move(temp);
+
+    return S_OK;
+}
+
+//---------------------------------------------------------------------------------
+static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
+    _In_opt_ ID3D11DeviceContext* d3dContext,
+    _In_ IWICBitmapFrameDecode* frame,
+    _Out_opt_ ID3D11Resource** texture,
+    _Out_opt_ ID3D11ShaderResourceView** textureView,
+    _In_ size_t maxsize)
+{
+    WIC_DECODED_IMAGE image = {};
+    HRESULT hr = DecodeTextureFromWIC(d3dDevice, frame, image, maxsize);
+    if (FAILED(hr))
+        return hr;
+
+    return CreateWICTextureFromDecodedImage(d3dDevice, d3dContext, image, texture, textureView);
+}
+
+//--------------------------------------------------------------------------------------
+HRESULT CreateWICTextureFromDecodedImage(_In_ ID3D11Device* d3dDevice,
+    _In_opt_ ID3D11DeviceContext* d3dContext,
+    _In_ const WIC_DECODED_IMAGE& image,
+    _Out_opt_ ID3D11Resource** texture,
+    _Out_opt_ ID3D11ShaderResourceView** textureView)
+{
+    if (!d3dDevice || !image.pixels || (!texture && !textureView))
+    {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+
+    UINT twidth = image.width;
+    UINT theight = image.height;
+    DXGI_FORMAT format = image.format;
+    size_t rowPitch = image.rowPitch;
+    size_t imageSize = rowPitch * theight;
+    const uint8_t* temp = image.pixels.get();
+    UINT mipLevels = std::max<UINT>(image.mipLevels, 1);
+
     // See if format is supported for auto-gen mipmaps (varies by feature level)
     bool autogen = false;
-    if (d3dContext != 0 && textureView != 0) // Must have context and shader-view to auto generate mipmaps
+    if (mipLevels == 1 && d3dContext != 0 && textureView != 0) // Must have context and shader-view to auto generate mipmaps
     {
         UINT fmtSupport = 0;
         hr = d3dDevice->CheckFormatSupport(format, &fmtSupport);
@@ -478,7 +551,7 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
     D3D11_TEXTURE2D_DESC desc;
     desc.Width = twidth;
     desc.Height = theight;
-    desc.MipLevels = (autogen) ? 0 : 1;
+    desc.MipLevels = (autogen) ? 0 : mipLevels;
     desc.ArraySize = 1;
     desc.Format = format;
     desc.SampleDesc.Count = 1;
@@ -488,13 +561,31 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
     desc.CPUAccessFlags = 0;
     desc.MiscFlags = (autogen) ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0;
 
-    D3D11_SUBRESOURCE_DATA initData;
-    initData.pSysMem = temp.get();
-    initData.SysMemPitch = static_cast<UINT>(rowPitch);
-    initData.SysMemSlicePitch = static_cast<UINT>(imageSize);
+    // A pre-generated chain is stored level after level with tight rows
+    std::unique_ptr<D3D11_SUBRESOURCE_DATA[]> initData(new (std::nothrow) D3D11_SUBRESOURCE_DATA[mipLevels]);
+    if (!initData)
+        return E_OUTOFMEMORY;
+
+    initData[0].pSysMem = temp;
+    initData[0].SysMemPitch = static_cast<UINT>(rowPitch);
+    initData[0].SysMemSlicePitch = static_cast<UINT>(imageSize);
+
+    const uint8_t* pLevel = temp + imageSize;
+    for (UINT level = 1; level < mipLevels; ++level)
+    {
+        size_t levelWidth = std::max<size_t>(twidth >> level, 1);
+        size_t levelHeight = std::max<size_t>(theight >> level, 1);
+        size_t levelRowPitch = (levelWidth * image.bitsPerPixel + 7) / 8;
+
+        initData[level].pSysMem = pLevel;
+        initData[level].SysMemPitch = static_cast<UINT>(levelRowPitch);
+        initData[level].SysMemSlicePitch = static_cast<UINT>(levelRowPitch * levelHeight);
+
+        pLevel += levelRowPitch * levelHeight;
+    }
 
     ID3D11Texture2D* tex = nullptr;
-    hr = d3dDevice->CreateTexture2D(&desc, (autogen) ? nullptr : &initData, &tex);
+    hr = d3dDevice->CreateTexture2D(&desc, (autogen) ? nullptr : initData.get(), &tex);
     if (SUCCEEDED(hr) && tex != 0)
     {
         if (textureView != 0)
@@ -503,7 +594,7 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
             memset(&SRVDesc, 0, sizeof(SRVDesc));
             SRVDesc.Format = format;
             SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-            SRVDesc.Texture2D.MipLevels = (autogen) ? -1 : 1;
+            SRVDesc.Texture2D.MipLevels = (autogen) ? -1 : mipLevels;
 
             hr = d3dDevice->CreateShaderResourceView(tex, &SRVDesc, textureView);
             if (FAILED(hr))
@@ -515,7 +606,8 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
             if (autogen)
             {
                 assert(d3dContext != 0);
-                d3dContext->UpdateSubresource(tex, 0, nullptr, temp.get(), static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize));
+                std::lock_guard<std::mutex> lock(GetTextureLoaderContextMutex());
+                d3dContext->UpdateSubresource(tex, 0, nullptr, temp, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize));
                 d3dContext->GenerateMips(*textureView);
             }
         }
@@ -614,6 +706,37 @@ HRESULT CreateWICTextureFromMemory(_In_ ID3D11Device* d3dDevice,
     return hr;
 }
 
+//--------------------------------------------------------------------------------------
+HRESULT DecodeWICTextureFromFile(_In_opt_ ID3D11Device* d3dDevice,
+    _In_z_ const wchar_t* fileName,
+    _Out_ WIC_DECODED_IMAGE& image,
+    _In_ size_t maxsize)
+{
+    image = {};
+
+    if (!fileName)
+    {
+        return E_INVALIDARG;
+    }
+
+    IWICImagingFactory* pWIC = _GetWIC();
+    if (!pWIC)
+        return E_NOINTERFACE;
+
+    // Initialize WIC
+    ScopedObject<IWICBitmapDecoder> decoder;
+    HRESULT hr = pWIC->CreateDecoderFromFilename(fileName, 0, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
+    if (FAILED(hr))
+        return hr;
+
+    ScopedObject<IWICBitmapFrameDecode> frame;
+    hr = decoder->GetFrame(0, &frame);
+    if (FAILED(hr))
+        return hr;
+
+    return DecodeTextureFromWIC(d3dDevice, frame.Get(), image, maxsize);
+}
+
 //--------------------------------------------------------------------------------------
 HRESULT CreateWICTextureFromFile(_In_ ID3D11Device* d3dDevice,
     _In_opt_ ID3D11DeviceContext* d3dContext,
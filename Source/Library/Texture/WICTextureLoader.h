@@ -4,10 +4,12 @@
 // Function for loading a WIC image and creating a Direct3D 11 runtime texture for it
 // (auto-generating mipmaps if possible)
 //
-// Note: Assumes application has already called CoInitializeEx
+// Note: Assumes COM is initialized on the calling thread. Decode tasks on worker threads
+//       initialize it for their duration with library::ScopedComApartment, and the
+//       application keeps it initialized while the shared WIC factory is in use
 //
-// Warning: CreateWICTexture* functions are not thread-safe if given a d3dContext instance for
-//          auto-gen mipmap support.
+// Note: CreateWICTexture* functions may be called from several threads. Uses of a d3dContext
+//       instance for auto-gen mipmap support are serialized internally.
 //
 // Note these functions are useful for images created as simple 2D textures. For
 // more complex resources, DDSTextureLoader is an excellent light-weight runtime loader.
@@ -31,11 +33,16 @@
 
 #include "Common.h"
 
+#include "Texture/ImageDecoder.h"
+
 #pragma warning(push)
 #pragma warning(disable : 4005)
 #include <stdint.h>
 #pragma warning(pop)
 
+// Serializes loader uses of a shared d3dContext for auto-gen mipmap support
+std::mutex& GetTextureLoaderContextMutex();
+
 HRESULT CreateWICTextureFromMemory(
     _In_ ID3D11Device* d3dDevice,
     _In_opt_ ID3D11DeviceContext* d3dContext,
@@ -53,4 +60,22 @@ HRESULT CreateWICTextureFromFile(
     _Out_opt_ ID3D11Resource** texture,
     _Out_opt_ ID3D11ShaderResourceView** textureView,
     _In_ size_t maxsize = 0
-    );
\ No newline at end of file
+    );
+
+// Decode only, safe to call from several threads as it never touches a d3dContext.
+// Without a d3dDevice the image is always converted to DXGI_FORMAT_R8G8B8A8_UNORM
+HRESULT DecodeWICTextureFromFile(
+    _In_opt_ ID3D11Device* d3dDevice,
+    _In_z_ const wchar_t* szFileName,
+    _Out_ WIC_DECODED_IMAGE& image,
+    _In_ size_t maxsize = 0
+    );
+
+// Upload only, creates the texture from an image returned by DecodeWICTextureFromFile
+HRESULT CreateWICTextureFromDecodedImage(
+    _In_ ID3D11Device* d3dDevice,
+    _In_opt_ ID3D11DeviceContext* d3dContext,
+    _In_ const WIC_DECODED_IMAGE& image,
+    _Out_opt_ ID3D11Resource** texture,
+    _Out_opt_ ID3D11ShaderResourceView** textureView
+    );
@@ -0,0 +1,116 @@
+/*+===================================================================
+  File:      MAIN.CPP
+
+  Summary:   Runs the test cases of the Library project, or its
+             benchmarks when started with --bench. Data files are
+             read relative to this directory
+
+  2022 Kyung Hee University
+===================================================================+*/
+
+#include "Test.h"
+
+#include <fstream>
+
+namespace test
+{
+    namespace
+    {
+        INT s_iNumFailures = 0;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetTestCases
+
+      Summary:  Returns every registered test case and benchmark
+
+      Returns:  std::vector<TestCase>&
+                  Registered test cases, in the order they were loaded
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<TestCase>& GetTestCases()
+    {
+        static std::vector<TestCase> s_aTestCases;
+        return s_aTestCases;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ReportFailure
+
+      Summary:  Prints a failed check and counts it
+
+      Args:     const CHAR* pszFile
+                  File of the check
+                INT iLine
+                  Line of the check
+                const CHAR* pszExpression
+                  Expression that was false
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void ReportFailure(_In_ const CHAR* pszFile, _In_ INT iLine, _In_ const CHAR* pszExpression)
+    {
+        std::fprintf(stderr, "%s(%d): CHECK(%s) failed\n", pszFile, iLine, pszExpression);
+        ++s_iNumFailures;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ReadFile
+
+      Summary:  Reads a whole file
+
+      Args:     const CHAR* pszFileName
+                  Path of the file
+
+      Returns:  std::vector<BYTE>
+                  Bytes of the file, empty if it could not be read
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<BYTE> ReadFile(_In_ const CHAR* pszFileName)
+    {
+        std::ifstream file(pszFileName, std::ios::binary | std::ios::ate);
+        if (!file)
+            return std::vector<BYTE>();
+
+        std::vector<BYTE> aBytes(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<CHAR*>(aBytes.data()), static_cast<std::streamsize>(aBytes.size()));
+        return aBytes;
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Runs the test cases, or the benchmarks with --bench. A
+            name given after the options only runs the cases whose
+            name contains it
+
+  Returns:  INT
+              0 if every check passed, 1 otherwise
+-----------------------------------------------------------------F-F*/
+INT main(INT argc, CHAR* argv[])
+{
+    BOOL bBenchmark = FALSE;
+    const CHAR* pszFilter = nullptr;
+    for (INT i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--bench") == 0)
+            bBenchmark = TRUE;
+        else
+            pszFilter = argv[i];
+    }
+
+    UINT uNumRun = 0u;
+    for (const test::TestCase& testCase : test::GetTestCases())
+    {
+        if (testCase.bBenchmark != bBenchmark)
+            continue;
+        if (pszFilter && !std::strstr(testCase.pszName, pszFilter))
+            continue;
+
+        std::printf("%s\n", testCase.pszName);
+        std::fflush(stdout);
+        testCase.pfnRun();
+        ++uNumRun;
+    }
+
+    std::printf("%u %s, %d failed checks\n", uNumRun, bBenchmark ? "benchmarks" : "test cases", test::s_iNumFailures);
+    return test::s_iNumFailures == 0 ? 0 : 1;
+}
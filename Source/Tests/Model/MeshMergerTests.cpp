@@ -0,0 +1,116 @@
+#include "Test.h"
+
+#include "Model/MeshMerger.h"
+
+using namespace library;
+
+namespace
+{
+    // Vertex each index of the range refers to
+    std::vector<UINT> GetVertices(const IndexRange& range, const std::vector<WORD>& aIndices)
+    {
+        std::vector<UINT> auVertices;
+        for (UINT i = range.uBaseIndex; i < range.uBaseIndex + range.uNumIndices; ++i)
+            auVertices.push_back(range.uBaseVertex + aIndices[i]);
+
+        return auVertices;
+    }
+}
+
+TEST_CASE(MeshMerger_RebasesIndicesOntoPreviousDraw)
+{
+    // Two triangles of three vertices each
+    std::vector<WORD> aIndices = { 0u, 1u, 2u, 0u, 2u, 1u };
+    IndexRange previous = { .uNumIndices = 3u, .uBaseVertex = 10u, .uBaseIndex = 0u };
+    IndexRange range = { .uNumIndices = 3u, .uBaseVertex = 13u, .uBaseIndex = 3u };
+
+    std::vector<UINT> auExpected = GetVertices(previous, aIndices);
+    std::vector<UINT> auRangeVertices = GetVertices(range, aIndices);
+    auExpected.insert(auExpected.end(), auRangeVertices.begin(), auRangeVertices.end());
+
+    CHECK(MeshMerger::Append(previous, range, aIndices));
+    CHECK(previous.uNumIndices == 6u && previous.uBaseVertex == 10u && previous.uBaseIndex == 0u);
+    CHECK(aIndices == std::vector<WORD>({ 0u, 1u, 2u, 3u, 5u, 4u }));
+    CHECK(GetVertices(previous, aIndices) == auExpected);
+
+    // An empty range joins without touching anything
+    CHECK(MeshMerger::Append(previous, { .uNumIndices = 0u, .uBaseVertex = 100000u, .uBaseIndex = 6u }, aIndices));
+    CHECK(previous.uNumIndices == 6u);
+}
+
+TEST_CASE(MeshMerger_RefusesRangesItCannotJoin)
+{
+    std::vector<WORD> aIndices = { 0u, 1u, 2u, 0u, 1u, 2u, 0u, 1u, 2u };
+    const std::vector<WORD> aOriginalIndices = aIndices;
+    IndexRange previous = { .uNumIndices = 3u, .uBaseVertex = 3u, .uBaseIndex = 0u };
+
+    // A gap in the index buffer, vertices before the previous ones, and indices past the buffer
+    CHECK(!MeshMerger::Append(previous, { .uNumIndices = 3u, .uBaseVertex = 6u, .uBaseIndex = 6u }, aIndices));
+    CHECK(!MeshMerger::Append(previous, { .uNumIndices = 3u, .uBaseVertex = 0u, .uBaseIndex = 3u }, aIndices));
+    CHECK(!MeshMerger::Append(previous, { .uNumIndices = 7u, .uBaseVertex = 6u, .uBaseIndex = 3u }, aIndices));
+    CHECK(previous.uNumIndices == 3u);
+    CHECK(aIndices == aOriginalIndices);
+}
+
+TEST_CASE(MeshMerger_StopsAtSixteenBitLimit)
+{
+    std::vector<WORD> aIndices = { 0u, 1u, 2u, 0u, 1u, 2u };
+    const std::vector<WORD> aOriginalIndices = aIndices;
+    IndexRange previous = { .uNumIndices = 3u, .uBaseVertex = 0u, .uBaseIndex = 0u };
+
+    // Rebased, the largest index would be 65536
+    CHECK(!MeshMerger::CanAppend(previous, { .uNumIndices = 3u, .uBaseVertex = MeshMerger::MAX_INDEX - 1u, .uBaseIndex = 3u }, aIndices));
+
+    // A delta of 65536 would wrap every index back onto the first vertices
+    CHECK(!MeshMerger::Append(previous, { .uNumIndices = 3u, .uBaseVertex = MeshMerger::MAX_INDEX + 1u, .uBaseIndex = 3u }, aIndices));
+    CHECK(!MeshMerger::Append(previous, { .uNumIndices = 3u, .uBaseVertex = 0xFFFFFFFFu, .uBaseIndex = 3u }, aIndices));
+    CHECK(previous.uNumIndices == 3u);
+    CHECK(aIndices == aOriginalIndices);
+
+    // Up to the limit itself
+    CHECK(MeshMerger::Append(previous, { .uNumIndices = 3u, .uBaseVertex = MeshMerger::MAX_INDEX - 2u, .uBaseIndex = 3u }, aIndices));
+    CHECK(previous.uNumIndices == 6u);
+    CHECK(aIndices[5] == MeshMerger::MAX_INDEX);
+}
+
+TEST_CASE(MeshMerger_SplitsLongRunsIntoDrawsThatFit)
+{
+    // 100 meshes of 1000 vertices in one vertex buffer, two triangles each
+    constexpr const UINT NUM_MESHES = 100u;
+    constexpr const UINT NUM_VERTICES = 1000u;
+
+    std::vector<WORD> aIndices;
+    std::vector<IndexRange> aMeshes;
+    for (UINT i = 0u; i < NUM_MESHES; ++i)
+    {
+        aMeshes.push_back({ .uNumIndices = 6u, .uBaseVertex = i * NUM_VERTICES, .uBaseIndex = static_cast<UINT>(aIndices.size()) });
+        aIndices.insert(aIndices.end(), { 0u, 1u, 2u, 997u, 998u, 999u });
+    }
+
+    std::vector<UINT> auExpected;
+    for (const IndexRange& mesh : aMeshes)
+    {
+        std::vector<UINT> auVertices = GetVertices(mesh, aIndices);
+        auExpected.insert(auExpected.end(), auVertices.begin(), auVertices.end());
+    }
+
+    // Merged like Model::mergeMeshes does
+    std::vector<IndexRange> aDraws = { aMeshes[0] };
+    for (UINT i = 1u; i < NUM_MESHES; ++i)
+    {
+        if (!MeshMerger::Append(aDraws.back(), aMeshes[i], aIndices))
+            aDraws.push_back(aMeshes[i]);
+    }
+
+    // 65 meshes end below 65536 vertices
+    CHECK(aDraws.size() == 2u);
+    CHECK(aDraws[0].uNumIndices == 65u * 6u);
+
+    std::vector<UINT> auVertices;
+    for (const IndexRange& draw : aDraws)
+    {
+        std::vector<UINT> auDrawVertices = GetVertices(draw, aIndices);
+        auVertices.insert(auVertices.end(), auDrawVertices.begin(), auDrawVertices.end());
+    }
+    CHECK(auVertices == auExpected);
+}
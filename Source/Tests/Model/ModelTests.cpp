@@ -0,0 +1,94 @@
+#include "Test.h"
+
+#include <thread>
+
+#include "Model/Model.h"
+
+using namespace library;
+
+namespace
+{
+    // nanosuit.obj is not checked in with its textures, the animated model always is
+    const CHAR* const MODEL_PATHS[] =
+    {
+        "../Game/nanosuit/nanosuit.obj",
+        "../Game/Content/BobLampClean/boblampclean.md5mesh",
+    };
+
+    // Falls back to WARP on machines without a GPU
+    HRESULT CreateDevice(_Out_ ComPtr<ID3D11Device>& outDevice, _Out_ ComPtr<ID3D11DeviceContext>& outImmediateContext)
+    {
+        HRESULT hr = E_FAIL;
+        for (D3D_DRIVER_TYPE driverType : { D3D_DRIVER_TYPE_HARDWARE, D3D_DRIVER_TYPE_WARP })
+        {
+            hr = D3D11CreateDevice(nullptr, driverType, nullptr, 0u, nullptr, 0u, D3D11_SDK_VERSION,
+                outDevice.ReleaseAndGetAddressOf(), nullptr, outImmediateContext.ReleaseAndGetAddressOf());
+            if (SUCCEEDED(hr))
+                break;
+        }
+
+        return hr;
+    }
+
+    // Fastest of a few loads, every one decoding and uploading the textures again
+    double MeasureLoad(ID3D11Device* pDevice, ID3D11DeviceContext* pImmediateContext, const CHAR* pszFilePath, BOOL bParallelLoading, UINT& uOutNumVertices)
+    {
+        constexpr const UINT NUM_LOADS = 5u;
+
+        Model::SetParallelLoading(bParallelLoading);
+
+        double seconds = std::numeric_limits<double>::max();
+        for (UINT i = 0u; i < NUM_LOADS; ++i)
+        {
+            std::unique_ptr<Model> model = std::make_unique<Model>(pszFilePath);
+            HRESULT hr = S_OK;
+            seconds = std::min<double>(seconds, test::MeasureSeconds([&]()
+                {
+                    hr = model->Initialize(pDevice, pImmediateContext);
+                }
+            ));
+            CHECK(SUCCEEDED(hr));
+
+            uOutNumVertices = model->GetNumVertices();
+        }
+
+        return seconds;
+    }
+}
+
+BENCHMARK(Model_SerialVsParallelLoad)
+{
+    ComPtr<ID3D11Device> device;
+    ComPtr<ID3D11DeviceContext> immediateContext;
+    CHECK(SUCCEEDED(CreateDevice(device, immediateContext)));
+    if (!device)
+        return;
+
+    // Textures that no model holds are dropped, so the loads do not hit the cache
+    TextureCache<Texture>& textureCache = Model::GetTextureCache();
+    size_t uMemoryBudget = textureCache.GetMemoryBudget();
+    textureCache.SetMemoryBudget(0u);
+
+    for (const CHAR* pszFilePath : MODEL_PATHS)
+    {
+        if (!std::filesystem::exists(pszFilePath))
+        {
+            std::printf("  %s not found, skipped\n", pszFilePath);
+            continue;
+        }
+
+        // The first load brings the files into the OS cache for both
+        UINT uNumVertices = 0u;
+        MeasureLoad(device.Get(), immediateContext.Get(), pszFilePath, TRUE, uNumVertices);
+
+        double serialSeconds = MeasureLoad(device.Get(), immediateContext.Get(), pszFilePath, FALSE, uNumVertices);
+        double parallelSeconds = MeasureLoad(device.Get(), immediateContext.Get(), pszFilePath, TRUE, uNumVertices);
+
+        std::printf("  %s, %u vertices: serial %.2f ms, parallel %.2f ms on %u threads, %.2fx\n",
+            pszFilePath, uNumVertices, serialSeconds * 1e3, parallelSeconds * 1e3, std::thread::hardware_concurrency(),
+            serialSeconds / parallelSeconds);
+    }
+
+    Model::SetParallelLoading(TRUE);
+    textureCache.SetMemoryBudget(uMemoryBudget);
+}
@@ -0,0 +1,240 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Renderer/BoundingVolumeHierarchy.h"
+
+using namespace library;
+
+namespace
+{
+    // Scattered over a square of the given half size, in a layer 50 high
+    std::vector<BoundingBox> CreateBoxes(UINT uNumBoxes, FLOAT worldSize, UINT uSeed)
+    {
+        std::mt19937 generator(uSeed);
+        std::uniform_real_distribution<FLOAT> position(-worldSize, worldSize);
+        std::uniform_real_distribution<FLOAT> height(-25.0f, 25.0f);
+        std::uniform_real_distribution<FLOAT> size(0.1f, 2.0f);
+
+        std::vector<BoundingBox> aBoxes(uNumBoxes);
+        for (BoundingBox& box : aBoxes)
+        {
+            box.Center = XMFLOAT3(position(generator), height(generator), position(generator));
+            box.Extents = XMFLOAT3(size(generator), size(generator), size(generator));
+        }
+
+        return aBoxes;
+    }
+
+    std::vector<UINT> Sorted(std::vector<UINT> aItems)
+    {
+        std::sort(aItems.begin(), aItems.end());
+        return aItems;
+    }
+
+    template <class Predicate>
+    std::vector<UINT> FindAll(const std::vector<BoundingBox>& aBoxes, Predicate predicate)
+    {
+        std::vector<UINT> aItems;
+        for (UINT i = 0u; i < static_cast<UINT>(aBoxes.size()); ++i)
+        {
+            if (predicate(aBoxes[i]))
+                aItems.push_back(i);
+        }
+
+        return aItems;
+    }
+
+    // Checks every kind of query against testing each box in turn
+    BOOL QueriesMatch(const BoundingVolumeHierarchy& bvh, const std::vector<BoundingBox>& aBoxes, UINT uSeed)
+    {
+        std::mt19937 generator(uSeed);
+        std::uniform_real_distribution<FLOAT> unit(-1.0f, 1.0f);
+
+        BOOL bMatches = TRUE;
+        std::vector<UINT> aItems;
+        for (UINT i = 0u; i < 50u; ++i)
+        {
+            BoundingBox box(XMFLOAT3(unit(generator) * 100.0f, unit(generator) * 25.0f, unit(generator) * 100.0f), XMFLOAT3(15.0f, 10.0f, 20.0f));
+            bvh.QueryBox(box, aItems);
+            bMatches &= Sorted(aItems) == FindAll(aBoxes, [&box](const BoundingBox& other) { return box.Intersects(other); });
+
+            BoundingSphere sphere(box.Center, 12.0f);
+            bvh.QuerySphere(sphere, aItems);
+            bMatches &= Sorted(aItems) == FindAll(aBoxes, [&sphere](const BoundingBox& other) { return other.Intersects(sphere); });
+
+            Frustum frustum;
+            XMVECTOR eye = XMVectorSet(unit(generator) * 100.0f, 30.0f, unit(generator) * 100.0f, 1.0f);
+            frustum.Update(
+                XMMatrixLookAtLH(eye, XMVectorSet(unit(generator) * 50.0f, 0.0f, unit(generator) * 50.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)),
+                XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 80.0f)
+            );
+            bvh.QueryFrustum(frustum, aItems);
+            bMatches &= Sorted(aItems) == FindAll(aBoxes, [&frustum](const BoundingBox& other) { return frustum.Intersects(other); });
+
+            XMVECTOR direction = XMVector3Normalize(XMVectorSet(unit(generator), unit(generator) * 0.3f - 0.2f, unit(generator), 0.0f));
+            FLOAT nearest = 150.0f;
+            for (const BoundingBox& other : aBoxes)
+            {
+                FLOAT distance = 0.0f;
+                if (other.Intersects(eye, direction, distance) && distance < nearest)
+                    nearest = distance;
+            }
+
+            UINT uItem = BoundingVolumeHierarchy::INVALID_INDEX;
+            FLOAT distance = 0.0f;
+            BOOL bHit = bvh.CastRay(eye, direction, 150.0f, uItem, distance);
+            bMatches &= bHit == (nearest < 150.0f);
+            if (bHit)
+            {
+                FLOAT itemDistance = 0.0f;
+                bMatches &= std::fabs(distance - nearest) < 1e-3f;
+                bMatches &= aBoxes[uItem].Intersects(eye, direction, itemDistance) && std::fabs(itemDistance - nearest) < 1e-3f;
+            }
+        }
+
+        return bMatches;
+    }
+}
+
+TEST_CASE(BoundingVolumeHierarchy_QueriesMatchBruteForce)
+{
+    std::vector<BoundingBox> aBoxes = CreateBoxes(3001u, 100.0f, 1u);
+
+    BoundingVolumeHierarchy bvh;
+    bvh.Build(aBoxes.data(), static_cast<UINT>(aBoxes.size()));
+    CHECK(bvh.GetNumItems() == 3001u);
+    CHECK(bvh.GetNumNodes() >= 2u * (3001u / BoundingVolumeHierarchy::MAX_LEAF_SIZE) - 1u);
+    CHECK(bvh.GetNumNodes() < 2u * 3001u);
+    CHECK(QueriesMatch(bvh, aBoxes, 2u));
+}
+
+TEST_CASE(BoundingVolumeHierarchy_RefitsMovedItems)
+{
+    std::vector<BoundingBox> aBoxes = CreateBoxes(2000u, 100.0f, 3u);
+
+    BoundingVolumeHierarchy bvh;
+    bvh.Build(aBoxes.data(), static_cast<UINT>(aBoxes.size()));
+    UINT uNumNodes = bvh.GetNumNodes();
+
+    // Half the items move, some of them across the whole scene
+    std::mt19937 generator(4u);
+    std::uniform_real_distribution<FLOAT> offset(-5.0f, 5.0f);
+    for (UINT i = 0u; i < static_cast<UINT>(aBoxes.size()); i += 2u)
+    {
+        aBoxes[i].Center.x += i % 10u == 0u ? -aBoxes[i].Center.x * 2.0f : offset(generator);
+        aBoxes[i].Center.y += offset(generator);
+        aBoxes[i].Center.z += offset(generator);
+        bvh.Refit(i, aBoxes[i]);
+    }
+
+    // Unknown items are ignored
+    bvh.Refit(static_cast<UINT>(aBoxes.size()), BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)));
+
+    CHECK(bvh.GetNumNodes() == uNumNodes);
+    CHECK(QueriesMatch(bvh, aBoxes, 5u));
+}
+
+TEST_CASE(BoundingVolumeHierarchy_HandlesDegenerateInput)
+{
+    BoundingVolumeHierarchy bvh;
+    std::vector<UINT> aItems = { 1u };
+    bvh.QueryBox(BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)), aItems);
+    CHECK(aItems.empty());
+
+    UINT uItem = 0u;
+    FLOAT distance = 0.0f;
+    CHECK(!bvh.CastRay(XMVectorZero(), XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), 10.0f, uItem, distance));
+    CHECK(uItem == BoundingVolumeHierarchy::INVALID_INDEX);
+
+    // Items all in the same place cannot be split by their centers
+    std::vector<BoundingBox> aBoxes(1000u, BoundingBox(XMFLOAT3(3.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)));
+    bvh.Build(aBoxes.data(), static_cast<UINT>(aBoxes.size()));
+    bvh.QueryBox(BoundingBox(XMFLOAT3(3.0f, 0.0f, 0.0f), XMFLOAT3(0.5f, 0.5f, 0.5f)), aItems);
+    CHECK(aItems.size() == aBoxes.size());
+    CHECK(bvh.CastRay(XMVectorZero(), XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), 10.0f, uItem, distance));
+    CHECK(uItem < aBoxes.size() && std::fabs(distance - 2.0f) < 1e-4f);
+
+    bvh.Clear();
+    CHECK(bvh.GetNumItems() == 0u);
+    CHECK(bvh.GetNumNodes() == 0u);
+    bvh.QueryBox(BoundingBox(XMFLOAT3(3.0f, 0.0f, 0.0f), XMFLOAT3(0.5f, 0.5f, 0.5f)), aItems);
+    CHECK(aItems.empty());
+}
+
+BENCHMARK(BoundingVolumeHierarchy_BuildRefitQuery)
+{
+    constexpr const UINT NUM_QUERIES = 1000u;
+
+    for (UINT uNumItems = 1000u; uNumItems <= 1000000u; uNumItems *= 10u)
+    {
+        // The density stays the same as the number of items grows
+        FLOAT worldSize = 100.0f * std::sqrt(static_cast<FLOAT>(uNumItems) / 1000.0f);
+        std::vector<BoundingBox> aBoxes = CreateBoxes(uNumItems, worldSize, 6u);
+
+        BoundingVolumeHierarchy bvh;
+        double buildSeconds = test::MeasureSeconds([&]()
+            {
+                bvh.Build(aBoxes.data(), uNumItems);
+            }
+        );
+
+        double refitSeconds = test::MeasureSeconds([&]()
+            {
+                for (UINT i = 0u; i < uNumItems; ++i)
+                {
+                    aBoxes[i].Center.y += 0.25f;
+                    bvh.Refit(i, aBoxes[i]);
+                }
+            }
+        );
+
+        std::vector<BoundingBox> aQueries = CreateBoxes(NUM_QUERIES, worldSize, 7u);
+        for (BoundingBox& query : aQueries)
+            query.Extents = XMFLOAT3(10.0f, 10.0f, 10.0f);
+
+        std::vector<UINT> aItems;
+        size_t uNumFound = 0u;
+        double querySeconds = test::MeasureSeconds([&]()
+            {
+                for (const BoundingBox& query : aQueries)
+                {
+                    bvh.QueryBox(query, aItems);
+                    uNumFound += aItems.size();
+                }
+            }
+        );
+
+        UINT uNumHits = 0u;
+        double raySeconds = test::MeasureSeconds([&]()
+            {
+                for (UINT i = 0u; i < NUM_QUERIES; ++i)
+                {
+                    UINT uItem = 0u;
+                    FLOAT distance = 0.0f;
+                    XMVECTOR direction = XMVector3Normalize(XMVectorSet(std::cos(static_cast<FLOAT>(i)), -0.1f, std::sin(static_cast<FLOAT>(i)), 0.0f));
+                    uNumHits += bvh.CastRay(XMLoadFloat3(&aQueries[i].Center), direction, worldSize, uItem, distance) ? 1u : 0u;
+                }
+            }
+        );
+
+        // Brute force for comparison, over the first few queries only for the large sizes
+        UINT uNumBruteQueries = std::max<UINT>(1u, std::min<UINT>(NUM_QUERIES, 10000000u / uNumItems));
+        size_t uNumBruteFound = 0u;
+        double bruteSeconds = test::MeasureSeconds([&]()
+            {
+                for (UINT i = 0u; i < uNumBruteQueries; ++i)
+                {
+                    for (const BoundingBox& box : aBoxes)
+                        uNumBruteFound += aQueries[i].Intersects(box) ? 1u : 0u;
+                }
+            }
+        );
+        CHECK(uNumBruteQueries < NUM_QUERIES || uNumBruteFound == uNumFound);
+
+        std::printf("  %7u items, %7u nodes: build %8.2f ms, refit all %7.2f ms, box query %7.2f us (%6.1f found, brute force %9.2f us), ray %6.2f us (%u hits)\n",
+            uNumItems, bvh.GetNumNodes(), buildSeconds * 1e3, refitSeconds * 1e3,
+            querySeconds / NUM_QUERIES * 1e6, static_cast<double>(uNumFound) / NUM_QUERIES,
+            bruteSeconds / uNumBruteQueries * 1e6, raySeconds / NUM_QUERIES * 1e6, uNumHits);
+    }
+}
@@ -0,0 +1,143 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Renderer/DrawList.h"
+
+using namespace library;
+
+namespace
+{
+    UINT GetDepthBits(UINT64 uKey)
+    {
+        return static_cast<UINT>(uKey & 0xFFFFFFFFull);
+    }
+
+    // Sorts the keys with the draw list and with std::stable_sort, the item of each draw being its index
+    BOOL SortsLikeStableSort(DrawList& drawList, const std::vector<UINT64>& auKeys)
+    {
+        std::vector<DrawCommand> aExpected;
+        drawList.Clear();
+        for (UINT i = 0u; i < static_cast<UINT>(auKeys.size()); ++i)
+        {
+            drawList.Add(auKeys[i], i);
+            aExpected.push_back({ .uKey = auKeys[i], .uItem = i });
+        }
+
+        drawList.Sort();
+        std::stable_sort(aExpected.begin(), aExpected.end(),
+            [](const DrawCommand& a, const DrawCommand& b)
+            {
+                return a.uKey < b.uKey;
+            }
+        );
+
+        if (drawList.GetNumDraws() != static_cast<UINT>(aExpected.size()))
+            return FALSE;
+
+        for (UINT i = 0u; i < drawList.GetNumDraws(); ++i)
+        {
+            if (drawList.GetDraw(i).uKey != aExpected[i].uKey || drawList.GetDraw(i).uItem != aExpected[i].uItem)
+                return FALSE;
+        }
+
+        return TRUE;
+    }
+}
+
+TEST_CASE(DrawList_KeysOrderPassShaderMaterialDepth)
+{
+    const UINT MAX_SHADER = DrawList::MAX_SHADERS - 1u;
+    const UINT MAX_MATERIAL = DrawList::MAX_MATERIALS - 1u;
+    const FLOAT MAX_DEPTH = std::numeric_limits<FLOAT>::max();
+
+    // Each field outweighs every field below it
+    CHECK(DrawList::MakeKey(eDrawPass::SOLID, MAX_SHADER, MAX_MATERIAL, MAX_DEPTH) < DrawList::MakeKey(eDrawPass::BLENDED, 0u, 0u, MAX_DEPTH));
+    CHECK(DrawList::MakeKey(eDrawPass::SOLID, 0u, MAX_MATERIAL, MAX_DEPTH) < DrawList::MakeKey(eDrawPass::SOLID, 1u, 0u, 0.0f));
+    CHECK(DrawList::MakeKey(eDrawPass::SOLID, 7u, 0u, MAX_DEPTH) < DrawList::MakeKey(eDrawPass::SOLID, 7u, 1u, 0.0f));
+    CHECK(DrawList::MakeKey(eDrawPass::BLENDED, MAX_SHADER, MAX_MATERIAL, 0.0f) > DrawList::MakeKey(eDrawPass::BLENDED, MAX_SHADER - 1u, MAX_MATERIAL, 0.0f));
+
+    // Solid draws go front to back
+    CHECK(DrawList::MakeKey(eDrawPass::SOLID, 7u, 3u, 0.0f) < DrawList::MakeKey(eDrawPass::SOLID, 7u, 3u, 1e-30f));
+    CHECK(DrawList::MakeKey(eDrawPass::SOLID, 7u, 3u, 1e-30f) < DrawList::MakeKey(eDrawPass::SOLID, 7u, 3u, 0.5f));
+    CHECK(DrawList::MakeKey(eDrawPass::SOLID, 7u, 3u, 0.5f) < DrawList::MakeKey(eDrawPass::SOLID, 7u, 3u, 100.0f));
+    CHECK(DrawList::MakeKey(eDrawPass::SOLID, 7u, 3u, 100.0f) < DrawList::MakeKey(eDrawPass::SOLID, 7u, 3u, std::numeric_limits<FLOAT>::infinity()));
+
+    // Fields sit where the bit counts say
+    UINT64 uKey = DrawList::MakeKey(eDrawPass::BLENDED, 0xABCu, 0x1234u, 2.0f);
+    CHECK((uKey >> (DrawList::NUM_SHADER_BITS + DrawList::NUM_MATERIAL_BITS + DrawList::NUM_DEPTH_BITS)) == static_cast<UINT64>(eDrawPass::BLENDED));
+    CHECK(((uKey >> (DrawList::NUM_MATERIAL_BITS + DrawList::NUM_DEPTH_BITS)) & (DrawList::MAX_SHADERS - 1u)) == 0xABCu);
+    CHECK(((uKey >> DrawList::NUM_DEPTH_BITS) & (DrawList::MAX_MATERIALS - 1u)) == 0x1234u);
+}
+
+TEST_CASE(DrawList_InvertsBlendedDepth)
+{
+    const FLOAT aDepths[] = { 0.0f, 1e-30f, 0.25f, 1.0f, 3.5f, 1000.0f, std::numeric_limits<FLOAT>::max() };
+
+    for (FLOAT depth : aDepths)
+    {
+        UINT uDepthBits = 0u;
+        std::memcpy(&uDepthBits, &depth, sizeof(uDepthBits));
+
+        CHECK(GetDepthBits(DrawList::MakeKey(eDrawPass::SOLID, 5u, 9u, depth)) == uDepthBits);
+        CHECK(GetDepthBits(DrawList::MakeKey(eDrawPass::BLENDED, 5u, 9u, depth)) == ~uDepthBits);
+    }
+
+    // Blended draws go back to front
+    for (UINT i = 1u; i < std::size(aDepths); ++i)
+        CHECK(DrawList::MakeKey(eDrawPass::BLENDED, 5u, 9u, aDepths[i]) < DrawList::MakeKey(eDrawPass::BLENDED, 5u, 9u, aDepths[i - 1u]));
+}
+
+TEST_CASE(DrawList_ClampsNegativeAndNaNDepths)
+{
+    const FLOAT aDepths[] = { -0.0f, -1e-30f, -1.0f, -std::numeric_limits<FLOAT>::infinity(), std::numeric_limits<FLOAT>::quiet_NaN(), -std::numeric_limits<FLOAT>::quiet_NaN() };
+
+    for (FLOAT depth : aDepths)
+    {
+        CHECK(DrawList::MakeKey(eDrawPass::SOLID, 2u, 4u, depth) == DrawList::MakeKey(eDrawPass::SOLID, 2u, 4u, 0.0f));
+        CHECK(DrawList::MakeKey(eDrawPass::BLENDED, 2u, 4u, depth) == DrawList::MakeKey(eDrawPass::BLENDED, 2u, 4u, 0.0f));
+    }
+}
+
+TEST_CASE(DrawList_SortMatchesStableSort)
+{
+    DrawList drawList;
+    std::mt19937_64 generator(11u);
+
+    // Nothing and a single draw are left as they are
+    CHECK(SortsLikeStableSort(drawList, {}));
+    CHECK(SortsLikeStableSort(drawList, { 42u }));
+
+    // Keys over all 64 bits
+    std::vector<UINT64> auKeys(5000u);
+    for (UINT64& uKey : auKeys)
+        uKey = generator();
+    CHECK(SortsLikeStableSort(drawList, auKeys));
+
+    // Few distinct keys, so the order of equal keys shows
+    for (UINT64& uKey : auKeys)
+        uKey = generator() % 7u * 0x0101010101010101ull;
+    CHECK(SortsLikeStableSort(drawList, auKeys));
+
+    // Keys of a typical frame: one pass and a few shaders, so the digits of the pass and shader bits are skipped
+    std::uniform_int_distribution<UINT> shader(0u, 3u);
+    std::uniform_int_distribution<UINT> material(0u, 40u);
+    std::uniform_real_distribution<FLOAT> depth(0.5f, 400.0f);
+    for (UINT64& uKey : auKeys)
+        uKey = DrawList::MakeKey(eDrawPass::SOLID, shader(generator), material(generator), depth(generator));
+    CHECK(SortsLikeStableSort(drawList, auKeys));
+
+    // Only the top digit differs, and then every digit is the same
+    for (UINT64& uKey : auKeys)
+        uKey = (generator() % 3u << 56u) | 0x00123456789ABCDEull;
+    CHECK(SortsLikeStableSort(drawList, auKeys));
+
+    std::fill(auKeys.begin(), auKeys.end(), DrawList::MakeKey(eDrawPass::BLENDED, 1u, 2u, 3.0f));
+    CHECK(SortsLikeStableSort(drawList, auKeys));
+
+    // Fewer draws than the frame before
+    auKeys.resize(300u);
+    for (UINT64& uKey : auKeys)
+        uKey = generator() >> (generator() % 64u);
+    CHECK(SortsLikeStableSort(drawList, auKeys));
+}
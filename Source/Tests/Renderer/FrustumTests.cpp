@@ -0,0 +1,255 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Renderer/Frustum.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const FLOAT NEAR_Z = 1.0f;
+    constexpr const FLOAT FAR_Z = 100.0f;
+
+    // Camera at the origin looking down +z with a field of view of 90 degrees, so the side planes are x = +-z and y = +-z
+    void UpdateStraightAhead(Frustum& frustum)
+    {
+        frustum.Update(XMMatrixIdentity(), XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, NEAR_Z, FAR_Z));
+    }
+
+    // Signed distances of a point to the planes of UpdateStraightAhead, normals pointing inside
+    void GetPlaneDistances(const XMFLOAT3& point, FLOAT* aOutDistances)
+    {
+        const FLOAT INV_SQRT2 = 0.70710678f;
+        aOutDistances[0] = (point.z + point.x) * INV_SQRT2;
+        aOutDistances[1] = (point.z - point.x) * INV_SQRT2;
+        aOutDistances[2] = (point.z + point.y) * INV_SQRT2;
+        aOutDistances[3] = (point.z - point.y) * INV_SQRT2;
+        aOutDistances[4] = point.z - NEAR_Z;
+        aOutDistances[5] = FAR_Z - point.z;
+    }
+
+    // Returns 1 if visible, 0 if culled and -1 too close to a plane to tell
+    INT IsBoxVisible(const BoundingBox& box)
+    {
+        const FLOAT INV_SQRT2 = 0.70710678f;
+        const FLOAT aRadii[Frustum::NUM_PLANES] =
+        {
+            (box.Extents.z + box.Extents.x) * INV_SQRT2,
+            (box.Extents.z + box.Extents.x) * INV_SQRT2,
+            (box.Extents.z + box.Extents.y) * INV_SQRT2,
+            (box.Extents.z + box.Extents.y) * INV_SQRT2,
+            box.Extents.z,
+            box.Extents.z
+        };
+
+        FLOAT aDistances[Frustum::NUM_PLANES];
+        GetPlaneDistances(box.Center, aDistances);
+
+        INT iVisible = 1;
+        for (UINT i = 0u; i < Frustum::NUM_PLANES; ++i)
+        {
+            FLOAT margin = aDistances[i] + aRadii[i];
+            if (margin < -1e-3f)
+                return 0;
+            if (margin < 1e-3f)
+                iVisible = -1;
+        }
+
+        return iVisible;
+    }
+
+    INT IsSphereVisible(const BoundingSphere& sphere)
+    {
+        FLOAT aDistances[Frustum::NUM_PLANES];
+        GetPlaneDistances(sphere.Center, aDistances);
+
+        INT iVisible = 1;
+        for (UINT i = 0u; i < Frustum::NUM_PLANES; ++i)
+        {
+            FLOAT margin = aDistances[i] + sphere.Radius;
+            if (margin < -1e-3f)
+                return 0;
+            if (margin < 1e-3f)
+                iVisible = -1;
+        }
+
+        return iVisible;
+    }
+
+    std::vector<BoundingBox> CreateBoxes(UINT uNumBoxes, UINT uSeed)
+    {
+        std::mt19937 generator(uSeed);
+        std::uniform_real_distribution<FLOAT> position(-120.0f, 120.0f);
+        std::uniform_real_distribution<FLOAT> size(0.1f, 4.0f);
+
+        std::vector<BoundingBox> aBoxes(uNumBoxes);
+        for (BoundingBox& box : aBoxes)
+        {
+            box.Center = XMFLOAT3(position(generator), position(generator), position(generator));
+            box.Extents = XMFLOAT3(size(generator), size(generator), size(generator));
+        }
+
+        return aBoxes;
+    }
+}
+
+TEST_CASE(Frustum_CullsOutsideEachPlane)
+{
+    Frustum frustum;
+    UpdateStraightAhead(frustum);
+
+    const BoundingBox aBoxes[] =
+    {
+        BoundingBox(XMFLOAT3(0.0f, 0.0f, 10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)),     // in front
+        BoundingBox(XMFLOAT3(0.0f, 0.0f, -10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)),    // behind
+        BoundingBox(XMFLOAT3(-20.0f, 0.0f, 10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)),   // left
+        BoundingBox(XMFLOAT3(20.0f, 0.0f, 10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)),    // right
+        BoundingBox(XMFLOAT3(0.0f, -20.0f, 10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)),   // below
+        BoundingBox(XMFLOAT3(0.0f, 20.0f, 10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)),    // above
+        BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.5f), XMFLOAT3(0.2f, 0.2f, 0.2f)),      // before the near plane
+        BoundingBox(XMFLOAT3(0.0f, 0.0f, 150.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)),    // past the far plane
+        BoundingBox(XMFLOAT3(-10.5f, 0.0f, 10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)),   // across the left plane
+        BoundingBox(XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(0.5f, 0.5f, 0.5f)),      // across the near plane
+        BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(500.0f, 500.0f, 500.0f)) // around the whole frustum
+    };
+    const UINT NUM_BOXES = static_cast<UINT>(std::size(aBoxes));
+    const std::vector<UINT> aExpected = { 0u, 8u, 9u, 10u };
+
+    for (UINT i = 0u; i < NUM_BOXES; ++i)
+        CHECK(frustum.Intersects(aBoxes[i]) == (std::find(aExpected.begin(), aExpected.end(), i) != aExpected.end()));
+
+    std::vector<UINT> aVisible;
+    frustum.CullBoxes(aBoxes, NUM_BOXES, aVisible);
+    CHECK(aVisible == aExpected);
+    CHECK(frustum.GetNumTested() == NUM_BOXES);
+    CHECK(frustum.GetNumVisible() == 4u);
+
+    const BoundingSphere aSpheres[] =
+    {
+        BoundingSphere(XMFLOAT3(0.0f, 0.0f, 50.0f), 1.0f),
+        BoundingSphere(XMFLOAT3(0.0f, 0.0f, 100.5f), 1.0f),
+        BoundingSphere(XMFLOAT3(0.0f, 0.0f, 102.5f), 1.0f),
+        BoundingSphere(XMFLOAT3(0.0f, 30.0f, 10.0f), 5.0f),
+        BoundingSphere(XMFLOAT3(0.0f, 13.0f, 10.0f), 5.0f)
+    };
+
+    // Counts add up until the next update
+    frustum.CullSpheres(aSpheres, static_cast<UINT>(std::size(aSpheres)), aVisible);
+    CHECK(aVisible == std::vector<UINT>({ 0u, 1u, 4u }));
+    CHECK(frustum.GetNumTested() == NUM_BOXES + 5u);
+    CHECK(frustum.GetNumVisible() == 7u);
+
+    frustum.CullBoxes(aBoxes, 0u, aVisible);
+    CHECK(aVisible.empty());
+
+    UpdateStraightAhead(frustum);
+    CHECK(frustum.GetNumTested() == 0u);
+    CHECK(frustum.GetNumVisible() == 0u);
+}
+
+TEST_CASE(Frustum_BatchesMatchPlaneTests)
+{
+    Frustum frustum;
+    UpdateStraightAhead(frustum);
+
+    // Not a multiple of the batch size, so the last batch is cut short
+    std::vector<BoundingBox> aBoxes = CreateBoxes(4099u, 3u);
+    std::vector<BoundingSphere> aSpheres(aBoxes.size());
+    for (size_t i = 0u; i < aBoxes.size(); ++i)
+        aSpheres[i] = BoundingSphere(aBoxes[i].Center, aBoxes[i].Extents.x);
+
+    std::vector<UINT> aVisibleBoxes;
+    frustum.CullBoxes(aBoxes.data(), static_cast<UINT>(aBoxes.size()), aVisibleBoxes);
+    std::vector<UINT> aVisibleSpheres;
+    frustum.CullSpheres(aSpheres.data(), static_cast<UINT>(aSpheres.size()), aVisibleSpheres);
+
+    UINT uNumVisible = 0u;
+    BOOL bBoxesMatch = TRUE;
+    BOOL bSpheresMatch = TRUE;
+    for (UINT i = 0u; i < static_cast<UINT>(aBoxes.size()); ++i)
+    {
+        BOOL bVisibleBox = std::binary_search(aVisibleBoxes.begin(), aVisibleBoxes.end(), i);
+        INT iExpectedBox = IsBoxVisible(aBoxes[i]);
+        if (iExpectedBox >= 0)
+            bBoxesMatch &= bVisibleBox == (iExpectedBox == 1);
+        bBoxesMatch &= bVisibleBox == frustum.Intersects(aBoxes[i]);
+        uNumVisible += bVisibleBox ? 1u : 0u;
+
+        INT iExpectedSphere = IsSphereVisible(aSpheres[i]);
+        if (iExpectedSphere >= 0)
+            bSpheresMatch &= std::binary_search(aVisibleSpheres.begin(), aVisibleSpheres.end(), i) == (iExpectedSphere == 1);
+    }
+
+    CHECK(bBoxesMatch);
+    CHECK(bSpheresMatch);
+    CHECK(uNumVisible > 100u && uNumVisible < 4000u);
+    CHECK(std::is_sorted(aVisibleBoxes.begin(), aVisibleBoxes.end()));
+
+    // A camera turned away from the axes, where only the batches and Intersects can be compared
+    frustum.Update(
+        XMMatrixLookAtLH(XMVectorSet(10.0f, 20.0f, -30.0f, 1.0f), XMVectorSet(-40.0f, -5.0f, 60.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)),
+        XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 150.0f)
+    );
+    frustum.CullBoxes(aBoxes.data(), static_cast<UINT>(aBoxes.size()), aVisibleBoxes);
+
+    std::vector<UINT> aExpected;
+    for (UINT i = 0u; i < static_cast<UINT>(aBoxes.size()); ++i)
+    {
+        if (frustum.Intersects(aBoxes[i]))
+            aExpected.push_back(i);
+    }
+    CHECK(aVisibleBoxes == aExpected);
+    CHECK(!aExpected.empty());
+}
+
+BENCHMARK(Frustum_Cull100kBoxes)
+{
+    constexpr const UINT NUM_BOXES = 100000u;
+    constexpr const UINT NUM_FRAMES = 100u;
+
+    std::vector<BoundingBox> aBoxes = CreateBoxes(NUM_BOXES, 7u);
+    std::vector<BoundingSphere> aSpheres(NUM_BOXES);
+    for (UINT i = 0u; i < NUM_BOXES; ++i)
+        aSpheres[i] = BoundingSphere(aBoxes[i].Center, aBoxes[i].Extents.x);
+
+    Frustum frustum;
+    frustum.Update(
+        XMMatrixLookAtLH(XMVectorSet(0.0f, 10.0f, -50.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)),
+        XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f)
+    );
+
+    std::vector<UINT> aVisible;
+    aVisible.reserve(NUM_BOXES);
+
+    UINT uNumSingle = 0u;
+    double singleSeconds = test::MeasureSeconds([&]()
+        {
+            for (UINT uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+            {
+                uNumSingle = 0u;
+                for (const BoundingBox& box : aBoxes)
+                    uNumSingle += frustum.Intersects(box) ? 1u : 0u;
+            }
+        }
+    );
+
+    double boxSeconds = test::MeasureSeconds([&]()
+        {
+            for (UINT uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+                frustum.CullBoxes(aBoxes.data(), NUM_BOXES, aVisible);
+        }
+    );
+    UINT uNumBoxes = static_cast<UINT>(aVisible.size());
+    CHECK(uNumBoxes == uNumSingle);
+
+    double sphereSeconds = test::MeasureSeconds([&]()
+        {
+            for (UINT uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+                frustum.CullSpheres(aSpheres.data(), NUM_BOXES, aVisible);
+        }
+    );
+
+    std::printf("  %u boxes, %u visible: one at a time %.3f ms, CullBoxes %.3f ms, CullSpheres %.3f ms per frame\n",
+        NUM_BOXES, uNumBoxes, singleSeconds / NUM_FRAMES * 1e3, boxSeconds / NUM_FRAMES * 1e3, sphereSeconds / NUM_FRAMES * 1e3);
+}
@@ -0,0 +1,277 @@
+#include "Test.h"
+
+#include "Renderer/Frustum.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Scene/ChunkStore.h"
+#include "Scene/TerrainStreamer.h"
+
+using namespace library;
+
+namespace
+{
+    // Camera at the origin looking down +z, with the aspect ratio of the depth buffer
+    XMMATRIX GetViewProjection()
+    {
+        return XMMatrixPerspectiveFovLH(
+            XM_PIDIV2,
+            static_cast<FLOAT>(OcclusionCuller::WIDTH) / static_cast<FLOAT>(OcclusionCuller::HEIGHT),
+            1.0f,
+            100.0f
+        );
+    }
+
+    // The generated map is placed as in Main.cpp, so chunk (4, 4) starts at the world origin
+    constexpr const INT CENTER_CHUNK = 4;
+    const XMFLOAT3 TERRAIN_ORIGIN(-256.0f, -40.0f, -256.0f);
+
+    void GenerateTerrain(ChunkStore& chunkStore, INT iRadius)
+    {
+        chunkStore.Reset(TERRAIN_ORIGIN, TerrainStreamer::DEFAULT_CHUNK_HEIGHT);
+
+        GeneratedChunk generatedChunk;
+        for (INT iChunkZ = CENTER_CHUNK - iRadius; iChunkZ <= CENTER_CHUNK + iRadius; ++iChunkZ)
+        {
+            for (INT iChunkX = CENTER_CHUNK - iRadius; iChunkX <= CENTER_CHUNK + iRadius; ++iChunkX)
+            {
+                TerrainStreamer::GenerateChunk(iChunkX, iChunkZ, chunkStore.GetChunkHeight(), generatedChunk);
+
+                Chunk* pChunk = chunkStore.GetOrCreateChunk(iChunkX, iChunkZ);
+                for (UINT z = 0u; z < Chunk::SIZE; ++z)
+                {
+                    for (UINT x = 0u; x < Chunk::SIZE; ++x)
+                    {
+                        size_t uColumnIdx = static_cast<size_t>(z) * Chunk::SIZE + static_cast<size_t>(x);
+                        pChunk->SetColumn(x, z, generatedChunk.aBlockTypes[uColumnIdx], generatedChunk.aColumnHeights[uColumnIdx]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Eye of someone standing on the ground at a world position
+    XMVECTOR GetEyeOnGround(const ChunkStore& chunkStore, FLOAT x, FLOAT z)
+    {
+        INT iBlockX = static_cast<INT>(std::floor((x - TERRAIN_ORIGIN.x) / Chunk::BLOCK_SIZE + 0.5f));
+        INT iBlockZ = static_cast<INT>(std::floor((z - TERRAIN_ORIGIN.z) / Chunk::BLOCK_SIZE + 0.5f));
+
+        INT iHeight = static_cast<INT>(chunkStore.GetChunkHeight());
+        while (iHeight > 0 && chunkStore.GetBlock(iBlockX, iHeight - 1, iBlockZ) == eBlockType::AIR)
+            --iHeight;
+
+        return XMVectorSet(x, TERRAIN_ORIGIN.y + (static_cast<FLOAT>(iHeight) + 1.0f) * Chunk::BLOCK_SIZE, z, 1.0f);
+    }
+
+    // Culls the chunks against the frustum, then against the occluders of the chunks in view, as Renderer::Render does
+    void XM_CALLCONV CullChunks(
+        OcclusionCuller& culler,
+        Frustum& frustum,
+        const ChunkStore& chunkStore,
+        FXMVECTOR eye,
+        FXMVECTOR direction,
+        FLOAT farZ,
+        std::vector<const Chunk*>& apOutInView,
+        std::vector<const Chunk*>& apOutOccluded
+    )
+    {
+        XMMATRIX view = XMMatrixLookToLH(eye, direction, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        XMMATRIX projection = XMMatrixPerspectiveFovLH(
+            XM_PIDIV2,
+            static_cast<FLOAT>(OcclusionCuller::WIDTH) / static_cast<FLOAT>(OcclusionCuller::HEIGHT),
+            0.01f,
+            farZ
+        );
+        frustum.Update(view, projection);
+
+        apOutInView.clear();
+        apOutOccluded.clear();
+
+        std::vector<BoundingBox> aOccluders;
+        culler.Begin(XMMatrixMultiply(view, projection));
+        for (const auto& chunkElem : chunkStore.GetChunks())
+        {
+            if (!frustum.Intersects(chunkElem.second->GetBoundingBox()))
+                continue;
+
+            apOutInView.push_back(chunkElem.second.get());
+            chunkElem.second->BuildOccluders(aOccluders);
+            for (const BoundingBox& occluder : aOccluders)
+                culler.AddOccluder(occluder);
+        }
+        culler.Rasterize();
+
+        for (const Chunk* pChunk : apOutInView)
+        {
+            if (!culler.TestBox(pChunk->GetBoundingBox()))
+                apOutOccluded.push_back(pChunk);
+        }
+    }
+
+    XMVECTOR GetViewDirection(UINT uView)
+    {
+        FLOAT yaw = static_cast<FLOAT>(uView) * XM_PIDIV4;
+        return XMVectorSet(std::sin(yaw), -0.1f, std::cos(yaw), 0.0f);
+    }
+}
+
+TEST_CASE(OcclusionCuller_HidesBoxesBehindOccluder)
+{
+    OcclusionCuller culler;
+    culler.Begin(GetViewProjection());
+
+    // A wall across the view from z = 19 to 21, its silhouette spans |x| and |y| up to 10 / 19 of the depth
+    const BoundingBox wall(XMFLOAT3(0.0f, 0.0f, 20.0f), XMFLOAT3(10.0f, 10.0f, 1.0f));
+    culler.AddOccluder(wall);
+    culler.Rasterize();
+    CHECK(culler.GetNumOccluders() == 1u);
+
+    // Behind the wall, wider than the wall itself but inside its silhouette
+    CHECK(!culler.TestBox(BoundingBox(XMFLOAT3(0.0f, 0.0f, 40.0f), XMFLOAT3(2.0f, 2.0f, 2.0f))));
+    CHECK(!culler.TestBox(BoundingBox(XMFLOAT3(0.0f, 0.0f, 40.0f), XMFLOAT3(18.0f, 2.0f, 1.0f))));
+    CHECK(!culler.TestBox(BoundingBox(XMFLOAT3(-5.0f, 6.0f, 80.0f), XMFLOAT3(4.0f, 4.0f, 4.0f))));
+
+    // In front of the wall, through it, partly past its silhouette, beside it and behind the eye
+    CHECK(culler.TestBox(BoundingBox(XMFLOAT3(0.0f, 0.0f, 10.0f), XMFLOAT3(2.0f, 2.0f, 2.0f))));
+    CHECK(culler.TestBox(BoundingBox(XMFLOAT3(0.0f, 0.0f, 20.0f), XMFLOAT3(2.0f, 2.0f, 2.0f))));
+    CHECK(culler.TestBox(BoundingBox(XMFLOAT3(25.0f, 0.0f, 40.0f), XMFLOAT3(3.0f, 3.0f, 3.0f))));
+    CHECK(culler.TestBox(BoundingBox(XMFLOAT3(0.0f, 30.0f, 40.0f), XMFLOAT3(2.0f, 2.0f, 2.0f))));
+    CHECK(culler.TestBox(BoundingBox(XMFLOAT3(0.0f, 0.0f, -10.0f), XMFLOAT3(2.0f, 2.0f, 2.0f))));
+
+    CHECK(culler.GetNumTested() == 8u);
+    CHECK(culler.GetNumOccluded() == 3u);
+
+    // A new frame starts without occluders
+    culler.Begin(GetViewProjection());
+    culler.Rasterize();
+    CHECK(culler.GetNumOccluders() == 0u);
+    CHECK(culler.TestBox(BoundingBox(XMFLOAT3(0.0f, 0.0f, 40.0f), XMFLOAT3(2.0f, 2.0f, 2.0f))));
+    CHECK(culler.GetNumTested() == 1u);
+    CHECK(culler.GetNumOccluded() == 0u);
+}
+
+TEST_CASE(OcclusionCuller_CoversSeamsBetweenOccluders)
+{
+    OcclusionCuller culler;
+    culler.Begin(GetViewProjection());
+
+    // Two halves of a wall meeting at x = 0, the way neighbouring runs of blocks do
+    culler.AddOccluder(BoundingBox(XMFLOAT3(-5.0f, 0.0f, 20.0f), XMFLOAT3(5.0f, 10.0f, 1.0f)));
+    culler.AddOccluder(BoundingBox(XMFLOAT3(5.0f, 0.0f, 20.0f), XMFLOAT3(5.0f, 10.0f, 1.0f)));
+    culler.Rasterize();
+
+    CHECK(!culler.TestBox(BoundingBox(XMFLOAT3(0.0f, 0.0f, 40.0f), XMFLOAT3(6.0f, 6.0f, 1.0f))));
+    CHECK(culler.TestBox(BoundingBox(XMFLOAT3(0.0f, 0.0f, 15.0f), XMFLOAT3(6.0f, 6.0f, 1.0f))));
+}
+
+TEST_CASE(OcclusionCuller_KeepsVisibleTerrain)
+{
+    ChunkStore chunkStore;
+    GenerateTerrain(chunkStore, static_cast<INT>(TerrainStreamer::DEFAULT_RADIUS));
+
+    OcclusionCuller culler;
+    Frustum frustum;
+    std::vector<const Chunk*> apInView;
+    std::vector<const Chunk*> apOccluded;
+
+    // Rays from the eye to the top of every column of an occluded chunk in view must hit something else first.
+    // The far plane takes in the whole map, so there is more to hide than with the one of Renderer
+    UINT uNumOccluded = 0u;
+    UINT uNumRays = 0u;
+    UINT uNumVisibleHits = 0u;
+    for (UINT uPosition = 0u; uPosition < 4u; ++uPosition)
+    {
+        FLOAT angle = static_cast<FLOAT>(uPosition) * XM_PIDIV2;
+        XMVECTOR eye = GetEyeOnGround(chunkStore, 60.0f * std::cos(angle), 60.0f * std::sin(angle));
+
+        for (UINT uView = 0u; uView < 8u; ++uView)
+        {
+            CullChunks(culler, frustum, chunkStore, eye, GetViewDirection(uView), 1000.0f, apInView, apOccluded);
+            CHECK(culler.GetNumTested() == apInView.size());
+            CHECK(culler.GetNumOccluded() == apOccluded.size());
+            uNumOccluded += static_cast<UINT>(apOccluded.size());
+
+            for (const Chunk* pChunk : apOccluded)
+            {
+                for (UINT z = 0u; z < Chunk::SIZE; ++z)
+                {
+                    for (UINT x = 0u; x < Chunk::SIZE; ++x)
+                    {
+                        UINT uHeight = pChunk->GetHeight();
+                        while (uHeight > 0u && pChunk->GetBlock(x, uHeight - 1u, z) == eBlockType::AIR)
+                            --uHeight;
+                        if (uHeight == 0u)
+                            continue;
+
+                        XMFLOAT3 top = pChunk->GetBlockPosition(x, uHeight - 1u, z);
+                        top.y += Chunk::BLOCK_SIZE * 0.5f + 0.01f;
+                        if (!frustum.Intersects(BoundingBox(top, XMFLOAT3(0.001f, 0.001f, 0.001f))))
+                            continue;
+
+                        XMVECTOR toTop = XMVectorSubtract(XMLoadFloat3(&top), eye);
+                        VoxelRay ray = { .origin = XMFLOAT3(), .direction = XMFLOAT3(), .maxDistance = XMVectorGetX(XMVector3Length(toTop)) + 0.1f };
+                        XMStoreFloat3(&ray.origin, eye);
+                        XMStoreFloat3(&ray.direction, XMVector3Normalize(toTop));
+
+                        VoxelRayHit hit;
+                        ++uNumRays;
+                        if (chunkStore.CastRay(ray, hit) && ChunkStore::GetChunkCoord(hit.block.x) == pChunk->GetChunkX() &&
+                            ChunkStore::GetChunkCoord(hit.block.z) == pChunk->GetChunkZ())
+                            ++uNumVisibleHits;
+                    }
+                }
+            }
+        }
+    }
+
+    std::printf("  %u chunks occluded over 32 views, %u rays to their tops, %u reached them\n", uNumOccluded, uNumRays, uNumVisibleHits);
+    CHECK(uNumOccluded > 0u);
+    CHECK(uNumRays > 0u);
+    CHECK(uNumVisibleHits == 0u);
+}
+
+BENCHMARK(OcclusionCuller_GeneratedTerrain)
+{
+    ChunkStore chunkStore;
+    GenerateTerrain(chunkStore, static_cast<INT>(TerrainStreamer::DEFAULT_RADIUS));
+
+    OcclusionCuller culler;
+    Frustum frustum;
+    std::vector<const Chunk*> apInView;
+    std::vector<const Chunk*> apOccluded;
+
+    // Standing on the ground on a circle around the center of the map, looking all around, with the far plane of
+    // Renderer first and then further ones
+    constexpr const UINT NUM_POSITIONS = 16u;
+    constexpr const UINT NUM_VIEWS = 8u;
+    constexpr const UINT NUM_FRAMES = NUM_POSITIONS * NUM_VIEWS;
+
+    std::printf("  %zu chunks, %u frames for each far plane\n", chunkStore.GetChunks().size(), NUM_FRAMES);
+    for (FLOAT farZ : { 100.0f, 200.0f, 400.0f, 800.0f })
+    {
+        UINT uNumOccluders = 0u;
+        UINT uNumInView = 0u;
+        UINT uNumOccluded = 0u;
+        double seconds = 0.0;
+        for (UINT uPosition = 0u; uPosition < NUM_POSITIONS; ++uPosition)
+        {
+            FLOAT angle = static_cast<FLOAT>(uPosition) * XM_2PI / static_cast<FLOAT>(NUM_POSITIONS);
+            XMVECTOR eye = GetEyeOnGround(chunkStore, 60.0f * std::cos(angle), 60.0f * std::sin(angle));
+
+            for (UINT uView = 0u; uView < NUM_VIEWS; ++uView)
+            {
+                seconds += test::MeasureSeconds([&]()
+                    {
+                        CullChunks(culler, frustum, chunkStore, eye, GetViewDirection(uView), farZ, apInView, apOccluded);
+                    }
+                );
+
+                uNumOccluders += culler.GetNumOccluders();
+                uNumInView += culler.GetNumTested();
+                uNumOccluded += culler.GetNumOccluded();
+            }
+        }
+
+        std::printf("  far plane %5.0f: %6.1f occluders and %5.1f chunks in view per frame, %5.1f%% of them occluded, %.3f ms per frame\n",
+            static_cast<double>(farZ), static_cast<double>(uNumOccluders) / NUM_FRAMES, static_cast<double>(uNumInView) / NUM_FRAMES,
+            uNumInView > 0u ? 100.0 * static_cast<double>(uNumOccluded) / static_cast<double>(uNumInView) : 0.0, seconds / NUM_FRAMES * 1e3);
+    }
+}
@@ -0,0 +1,863 @@
+#include "Test.h"
+
+#include <map>
+#include <tuple>
+
+#include "Scene/ChunkStore.h"
+
+using namespace library;
+
+namespace
+{
+    const Chunk* const NO_NEIGHBORS[Chunk::NUM_NEIGHBORS] = { nullptr, nullptr, nullptr, nullptr };
+
+    BOOL IsNear(FLOAT value, FLOAT expected)
+    {
+        return std::fabs(value - expected) < 1e-4f;
+    }
+
+    // Rolling hills from 1 up to uMaxHeight blocks
+    WORD GetHillHeight(INT x, INT z, UINT uMaxHeight)
+    {
+        FLOAT wave = 0.5f + 0.25f * std::sin(static_cast<FLOAT>(x) * 0.07f) + 0.25f * std::cos(static_cast<FLOAT>(z) * 0.05f);
+        return static_cast<WORD>(1.0f + wave * static_cast<FLOAT>(uMaxHeight - 1u));
+    }
+
+    // Hills of sand, grassland and snow up to 21 blocks high
+    SceneData CreateHills(UINT uWidth, UINT uDepth)
+    {
+        SceneData sceneData =
+        {
+            .uWidth = uWidth,
+            .uHeight = 24u,
+            .uDepth = uDepth,
+            .aColors = {},
+            .aBlockTypes = std::vector<eBlockType>(static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth)),
+            .aColumnHeights = std::vector<WORD>(static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth))
+        };
+
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                FLOAT height = 11.0f + 5.0f * std::sin(static_cast<FLOAT>(x) * 0.05f) + 4.0f * std::cos(static_cast<FLOAT>(z) * 0.037f)
+                    + std::sin(static_cast<FLOAT>(x + z) * 0.21f);
+                size_t uColumnIdx = static_cast<size_t>(z) * uWidth + x;
+
+                sceneData.aColumnHeights[uColumnIdx] = static_cast<WORD>(height);
+                sceneData.aBlockTypes[uColumnIdx] = height < 8.0f ? eBlockType::SAND : height < 15.0f ? eBlockType::GRASSLAND : eBlockType::SNOW;
+            }
+        }
+
+        return sceneData;
+    }
+
+    // Block position, face axis and face direction
+    using FaceKey = std::tuple<INT, INT, INT, UINT, INT>;
+
+    // Visible faces of the blocks drawn by BuildInstanceData, with the index of their block type
+    std::map<FaceKey, UINT> GetInstancedFaces(const ChunkStore& store, const Chunk& chunk, const Chunk* const* apNeighbors)
+    {
+        std::vector<InstanceData> aInstanceData;
+        chunk.BuildInstanceData(apNeighbors, aInstanceData);
+
+        std::map<FaceKey, UINT> faces;
+        for (const InstanceData& instance : aInstanceData)
+        {
+            const INT aBlock[3] =
+            {
+                chunk.GetChunkX() * static_cast<INT>(Chunk::SIZE) + instance.X,
+                static_cast<INT>(instance.Y),
+                chunk.GetChunkZ() * static_cast<INT>(Chunk::SIZE) + instance.Z
+            };
+
+            for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+            {
+                for (INT iSign = -1; iSign <= 1; iSign += 2)
+                {
+                    INT aFront[3] = { aBlock[0], aBlock[1], aBlock[2] };
+                    aFront[uAxis] += iSign;
+
+                    // The bottom of the world is never seen
+                    if (aFront[1] < 0 || store.GetBlock(aFront[0], aFront[1], aFront[2]) != eBlockType::AIR)
+                        continue;
+
+                    faces.emplace(FaceKey(aBlock[0], aBlock[1], aBlock[2], uAxis, iSign), instance.BlockType);
+                }
+            }
+        }
+
+        return faces;
+    }
+
+    // Faces of the blocks covered by the greedy quads. Fails on faces covered twice, quads that are not
+    // axis-aligned rectangles and triangles not wound towards the normal
+    BOOL GetGreedyFaces(const Chunk& chunk, const Chunk* const* apNeighbors, std::map<FaceKey, UINT>& outFaces)
+    {
+        std::vector<SimpleVertex> aVertices[Chunk::NUM_BLOCK_TYPES];
+        chunk.BuildGreedyMesh(apNeighbors, aVertices);
+
+        outFaces.clear();
+        const XMFLOAT3 firstBlock = chunk.GetBlockPosition(0u, 0u, 0u);
+        for (UINT uTypeIdx = 0u; uTypeIdx < Chunk::NUM_BLOCK_TYPES; ++uTypeIdx)
+        {
+            const std::vector<SimpleVertex>& aTypeVertices = aVertices[uTypeIdx];
+            if (aTypeVertices.size() % 4u != 0u || aTypeVertices.size() > Chunk::MAX_MESH_VERTICES)
+                return FALSE;
+
+            std::vector<WORD> aIndices;
+            Chunk::BuildQuadIndices(static_cast<UINT>(aTypeVertices.size()), aIndices);
+            if (aIndices.size() != aTypeVertices.size() / 4u * 6u)
+                return FALSE;
+
+            for (size_t i = 0u; i < aIndices.size(); i += 3u)
+            {
+                XMVECTOR p0 = XMLoadFloat3(&aTypeVertices[aIndices[i]].Position);
+                XMVECTOR p1 = XMLoadFloat3(&aTypeVertices[aIndices[i + 1u]].Position);
+                XMVECTOR p2 = XMLoadFloat3(&aTypeVertices[aIndices[i + 2u]].Position);
+                XMVECTOR normal = XMLoadFloat3(&aTypeVertices[aIndices[i]].Normal);
+                if (aIndices[i] / 4u != aIndices[i + 1u] / 4u || aIndices[i] / 4u != aIndices[i + 2u] / 4u
+                    || XMVectorGetX(XMVector3Dot(XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0)), normal)) <= 0.0f)
+                    return FALSE;
+            }
+
+            for (size_t i = 0u; i < aTypeVertices.size(); i += 4u)
+            {
+                const XMFLOAT3& normal = aTypeVertices[i].Normal;
+                const FLOAT aNormal[3] = { normal.x, normal.y, normal.z };
+                UINT uAxis = aNormal[0] != 0.0f ? 0u : aNormal[1] != 0.0f ? 1u : 2u;
+                INT iSign = aNormal[uAxis] > 0.0f ? 1 : -1;
+
+                // Corners in block units, around the centers of the blocks
+                INT aMin[3] = { INT_MAX, INT_MAX, INT_MAX };
+                INT aMax[3] = { INT_MIN, INT_MIN, INT_MIN };
+                for (size_t j = i; j < i + 4u; ++j)
+                {
+                    const XMFLOAT3& position = aTypeVertices[j].Position;
+                    const FLOAT aPosition[3] = { position.x - firstBlock.x, position.y - firstBlock.y, position.z - firstBlock.z };
+                    for (UINT k = 0u; k < 3u; ++k)
+                    {
+                        INT iCorner = static_cast<INT>(std::lround(aPosition[k] / Chunk::BLOCK_SIZE + 0.5f));
+                        aMin[k] = std::min<INT>(aMin[k], iCorner);
+                        aMax[k] = std::max<INT>(aMax[k], iCorner);
+                    }
+
+                    if (aTypeVertices[j].Normal.x != normal.x || aTypeVertices[j].Normal.y != normal.y || aTypeVertices[j].Normal.z != normal.z)
+                        return FALSE;
+                }
+
+                if (aMin[uAxis] != aMax[uAxis])
+                    return FALSE;
+
+                UINT uAxisU = (uAxis + 1u) % 3u;
+                UINT uAxisV = (uAxis + 2u) % 3u;
+                INT aBlock[3];
+                aBlock[uAxis] = iSign > 0 ? aMin[uAxis] - 1 : aMin[uAxis];
+                for (aBlock[uAxisV] = aMin[uAxisV]; aBlock[uAxisV] < aMax[uAxisV]; ++aBlock[uAxisV])
+                {
+                    for (aBlock[uAxisU] = aMin[uAxisU]; aBlock[uAxisU] < aMax[uAxisU]; ++aBlock[uAxisU])
+                    {
+                        FaceKey key(
+                            chunk.GetChunkX() * static_cast<INT>(Chunk::SIZE) + aBlock[0],
+                            aBlock[1],
+                            chunk.GetChunkZ() * static_cast<INT>(Chunk::SIZE) + aBlock[2],
+                            uAxis,
+                            iSign
+                        );
+                        if (!outFaces.emplace(key, uTypeIdx).second)
+                            return FALSE;
+                    }
+                }
+            }
+        }
+
+        return TRUE;
+    }
+
+    // Sets the blocks of a box like Scene::SetBlocks, gathering the chunks whose faces change
+    void EditBlocks(ChunkStore& store, const XMINT3& minBlock, const XMINT3& maxBlock, eBlockType blockType, std::unordered_set<UINT64>& outDirtyChunks)
+    {
+        constexpr const INT SIZE = static_cast<INT>(Chunk::SIZE);
+
+        for (INT z = minBlock.z; z <= maxBlock.z; ++z)
+        {
+            for (INT x = minBlock.x; x <= maxBlock.x; ++x)
+            {
+                for (INT y = minBlock.y; y <= maxBlock.y; ++y)
+                {
+                    if (store.GetBlock(x, y, z) == blockType)
+                        continue;
+
+                    store.SetBlock(x, y, z, blockType);
+
+                    // Blocks on the side of a chunk are also faces of the chunk next to it
+                    INT iChunkX = ChunkStore::GetChunkCoord(x);
+                    INT iChunkZ = ChunkStore::GetChunkCoord(z);
+                    INT iLocalX = x - iChunkX * SIZE;
+                    INT iLocalZ = z - iChunkZ * SIZE;
+                    outDirtyChunks.insert(ChunkStore::GetKey(iChunkX, iChunkZ));
+                    if (iLocalX == 0 || iLocalX == SIZE - 1)
+                        outDirtyChunks.insert(ChunkStore::GetKey(iLocalX == 0 ? iChunkX - 1 : iChunkX + 1, iChunkZ));
+                    if (iLocalZ == 0 || iLocalZ == SIZE - 1)
+                        outDirtyChunks.insert(ChunkStore::GetKey(iChunkX, iLocalZ == 0 ? iChunkZ - 1 : iChunkZ + 1));
+                }
+            }
+        }
+    }
+
+    // Builds what Scene::rebuildDirtyChunks uploads for each dirty chunk, returning the number of vertices or instances
+    size_t RebuildChunks(const ChunkStore& store, const std::unordered_set<UINT64>& dirtyChunks, BOOL bGreedy)
+    {
+        size_t uNumBuilt = 0u;
+        std::vector<BoundingBox> aOccluders;
+        std::vector<SimpleVertex> aVertices[Chunk::NUM_BLOCK_TYPES];
+        std::vector<WORD> aIndices;
+        std::vector<InstanceData> aInstanceData;
+
+        for (UINT64 uKey : dirtyChunks)
+        {
+            auto it = store.GetChunks().find(uKey);
+            if (it == store.GetChunks().end())
+                continue;
+
+            const Chunk* apNeighbors[Chunk::NUM_NEIGHBORS];
+            store.GetNeighbors(*it->second, apNeighbors);
+            it->second->BuildOccluders(aOccluders);
+
+            if (bGreedy)
+            {
+                it->second->BuildGreedyMesh(apNeighbors, aVertices);
+                for (const std::vector<SimpleVertex>& aTypeVertices : aVertices)
+                {
+                    // Split into meshes of 16-bit indices like VoxelMesh
+                    for (size_t uFirst = 0u; uFirst < aTypeVertices.size(); uFirst += Chunk::MAX_MESH_VERTICES)
+                        Chunk::BuildQuadIndices(static_cast<UINT>(std::min<size_t>(Chunk::MAX_MESH_VERTICES, aTypeVertices.size() - uFirst)), aIndices);
+                    uNumBuilt += aTypeVertices.size();
+                }
+            }
+            else
+            {
+                it->second->BuildInstanceData(apNeighbors, aInstanceData);
+                uNumBuilt += aInstanceData.size();
+            }
+        }
+
+        return uNumBuilt;
+    }
+}
+
+TEST_CASE(Chunk_StoresColumnsAsRuns)
+{
+    Chunk chunk(0, 0, 16u, XMFLOAT3(0.0f, 0.0f, 0.0f));
+    CHECK(chunk.GetNumBlocks() == 0u);
+    CHECK(chunk.GetNumRuns() == 0u);
+
+    chunk.SetColumn(3u, 5u, eBlockType::SAND, 6u);
+    CHECK(chunk.GetNumBlocks() == 6u);
+    CHECK(chunk.GetNumRuns() == 1u);
+    CHECK(chunk.GetBlock(3u, 0u, 5u) == eBlockType::SAND);
+    CHECK(chunk.GetBlock(3u, 5u, 5u) == eBlockType::SAND);
+    CHECK(chunk.GetBlock(3u, 6u, 5u) == eBlockType::AIR);
+
+    // Carving a hole splits the run, filling it merges the runs again
+    chunk.SetBlock(3u, 2u, 5u, eBlockType::AIR);
+    CHECK(chunk.GetNumBlocks() == 5u);
+    CHECK(chunk.GetNumRuns() == 3u);
+    CHECK(chunk.GetBlock(3u, 2u, 5u) == eBlockType::AIR);
+    CHECK(chunk.GetBlock(3u, 3u, 5u) == eBlockType::SAND);
+
+    chunk.SetBlock(3u, 2u, 5u, eBlockType::SAND);
+    CHECK(chunk.GetNumBlocks() == 6u);
+    CHECK(chunk.GetNumRuns() == 1u);
+
+    // Air above the top block is not stored
+    chunk.SetBlock(3u, 10u, 5u, eBlockType::SNOW);
+    CHECK(chunk.GetNumRuns() == 3u);
+    chunk.SetBlock(3u, 10u, 5u, eBlockType::AIR);
+    CHECK(chunk.GetNumRuns() == 1u);
+
+    // Columns are clamped to the chunk and positions outside it are ignored
+    chunk.SetColumn(0u, 0u, eBlockType::SNOW, 100u);
+    CHECK(chunk.GetNumBlocks() == 22u);
+    chunk.SetBlock(Chunk::SIZE, 0u, 0u, eBlockType::SNOW);
+    chunk.SetBlock(0u, 16u, 0u, eBlockType::SNOW);
+    CHECK(chunk.GetNumBlocks() == 22u);
+    CHECK(chunk.GetBlock(Chunk::SIZE, 0u, 0u) == eBlockType::AIR);
+    CHECK(chunk.GetBlock(0u, 16u, 0u) == eBlockType::AIR);
+
+    chunk.SetColumn(0u, 0u, eBlockType::AIR, 0u);
+    chunk.SetColumn(3u, 5u, eBlockType::AIR, 0u);
+    CHECK(chunk.GetNumBlocks() == 0u);
+    CHECK(chunk.GetNumRuns() == 0u);
+}
+
+TEST_CASE(Chunk_BuildsVisibleBlocks)
+{
+    // 3x3x3 cube on the bottom of the world, which is never seen, so the
+    // centers of its two lower layers are enclosed
+    Chunk chunk(0, 0, 8u, XMFLOAT3(0.0f, 0.0f, 0.0f));
+    for (UINT z = 0u; z < 3u; ++z)
+    {
+        for (UINT x = 0u; x < 3u; ++x)
+            chunk.SetColumn(x, z, eBlockType::SAND, 3u);
+    }
+
+    std::vector<InstanceData> aInstanceData;
+    chunk.BuildInstanceData(NO_NEIGHBORS, aInstanceData);
+    CHECK(aInstanceData.size() == 25u);
+    CHECK(std::none_of(aInstanceData.begin(), aInstanceData.end(),
+        [](const InstanceData& instance) { return instance.X == 1u && instance.Y < 2u && instance.Z == 1u; }));
+    CHECK(std::all_of(aInstanceData.begin(), aInstanceData.end(),
+        [](const InstanceData& instance)
+        {
+            return instance.BlockType == static_cast<WORD>(eBlockType::SAND) - static_cast<WORD>(eBlockType::GRASSLAND);
+        }));
+
+    // Each face of the cube but the bottom one merges into a single quad
+    std::vector<SimpleVertex> aVertices[Chunk::NUM_BLOCK_TYPES];
+    chunk.BuildGreedyMesh(NO_NEIGHBORS, aVertices);
+    UINT uSandIdx = static_cast<UINT>(eBlockType::SAND) - static_cast<UINT>(eBlockType::GRASSLAND);
+    CHECK(aVertices[uSandIdx].size() == 5u * 4u);
+    for (UINT i = 0u; i < Chunk::NUM_BLOCK_TYPES; ++i)
+        CHECK(i == uSandIdx || aVertices[i].empty());
+
+    // Faces of another block type are not merged with it
+    chunk.SetBlock(1u, 2u, 1u, eBlockType::SNOW);
+    chunk.BuildGreedyMesh(NO_NEIGHBORS, aVertices);
+    UINT uSnowIdx = static_cast<UINT>(eBlockType::SNOW) - static_cast<UINT>(eBlockType::GRASSLAND);
+    CHECK(aVertices[uSnowIdx].size() == 4u);
+    CHECK(aVertices[uSandIdx].size() > 5u * 4u);
+}
+
+TEST_CASE(Chunk_LooksIntoNeighbors)
+{
+    Chunk left(0, 0, 4u, XMFLOAT3(0.0f, 0.0f, 0.0f));
+    Chunk right(1, 0, 4u, XMFLOAT3(Chunk::BLOCK_SIZE * Chunk::SIZE, 0.0f, 0.0f));
+    left.SetColumn(Chunk::SIZE - 1u, 0u, eBlockType::SAND, 1u);
+    right.SetColumn(0u, 0u, eBlockType::SAND, 1u);
+
+    const Chunk* apLeftNeighbors[Chunk::NUM_NEIGHBORS] = { nullptr, &right, nullptr, nullptr };
+    const Chunk* apRightNeighbors[Chunk::NUM_NEIGHBORS] = { &left, nullptr, nullptr, nullptr };
+    UINT uSandIdx = static_cast<UINT>(eBlockType::SAND) - static_cast<UINT>(eBlockType::GRASSLAND);
+
+    std::vector<SimpleVertex> aVertices[Chunk::NUM_BLOCK_TYPES];
+    left.BuildGreedyMesh(NO_NEIGHBORS, aVertices);
+    CHECK(aVertices[uSandIdx].size() == 5u * 4u);
+
+    // The faces between the two chunks are hidden
+    left.BuildGreedyMesh(apLeftNeighbors, aVertices);
+    CHECK(aVertices[uSandIdx].size() == 4u * 4u);
+    right.BuildGreedyMesh(apRightNeighbors, aVertices);
+    CHECK(aVertices[uSandIdx].size() == 4u * 4u);
+
+    ChunkStore store;
+    store.Reset(XMFLOAT3(0.0f, 0.0f, 0.0f), 4u);
+    Chunk* pCenter = store.GetOrCreateChunk(0, 0);
+    Chunk* pEast = store.GetOrCreateChunk(1, 0);
+    Chunk* pSouth = store.GetOrCreateChunk(0, -1);
+
+    const Chunk* apNeighbors[Chunk::NUM_NEIGHBORS];
+    store.GetNeighbors(*pCenter, apNeighbors);
+    CHECK(apNeighbors[Chunk::NEIGHBOR_NEGATIVE_X] == nullptr);
+    CHECK(apNeighbors[Chunk::NEIGHBOR_POSITIVE_X] == pEast);
+    CHECK(apNeighbors[Chunk::NEIGHBOR_NEGATIVE_Z] == pSouth);
+    CHECK(apNeighbors[Chunk::NEIGHBOR_POSITIVE_Z] == nullptr);
+}
+
+TEST_CASE(Chunk_GreedyMeshCoversVisibleFaces)
+{
+    ChunkStore store;
+    store.Load(CreateHills(80u, 70u), XMFLOAT3(3.0f, -5.0f, 7.0f));
+
+    // Caves, overhangs and floating blocks, some of them on the sides of the chunks
+    for (INT i = 0; i < 300; ++i)
+    {
+        INT x = (i * 37) % 80;
+        INT z = (i * 53 + i / 7) % 70;
+        INT y = 2 + (i * 11) % 16;
+        store.SetBlock(x, y, z, i % 3 == 0 ? eBlockType::SNOW : eBlockType::AIR);
+        store.SetBlock(static_cast<INT>(Chunk::SIZE) - (i % 2), y, z, i % 5 == 0 ? eBlockType::OCEAN : eBlockType::AIR);
+    }
+    CHECK(store.GetChunks().size() == 9u);
+
+    for (const auto& chunkElem : store.GetChunks())
+    {
+        const Chunk* apNeighbors[Chunk::NUM_NEIGHBORS];
+        store.GetNeighbors(*chunkElem.second, apNeighbors);
+
+        std::map<FaceKey, UINT> instancedFaces = GetInstancedFaces(store, *chunkElem.second, apNeighbors);
+        std::map<FaceKey, UINT> greedyFaces;
+        CHECK(GetGreedyFaces(*chunkElem.second, apNeighbors, greedyFaces));
+        CHECK(!instancedFaces.empty());
+        CHECK(greedyFaces == instancedFaces);
+    }
+}
+
+TEST_CASE(Chunk_BuildsBoundsAndOccluders)
+{
+    Chunk chunk(2, -1, 16u, XMFLOAT3(100.0f, 10.0f, -200.0f));
+    BoundingBox emptyBox = chunk.GetBoundingBox();
+    CHECK(IsNear(emptyBox.Extents.x, 0.0f) && IsNear(emptyBox.Extents.y, 0.0f) && IsNear(emptyBox.Extents.z, 0.0f));
+
+    for (UINT z = 0u; z < Chunk::SIZE; ++z)
+    {
+        for (UINT x = 0u; x < Chunk::SIZE; ++x)
+            chunk.SetColumn(x, z, eBlockType::GRASSLAND, x < Chunk::OCCLUDER_SIZE ? 4u : 2u);
+    }
+
+    // Blocks reach half a block past their centers
+    BoundingBox box = chunk.GetBoundingBox();
+    CHECK(IsNear(box.Center.x - box.Extents.x, 99.0f));
+    CHECK(IsNear(box.Center.x + box.Extents.x, 100.0f + Chunk::BLOCK_SIZE * Chunk::SIZE - 1.0f));
+    CHECK(IsNear(box.Center.y - box.Extents.y, 9.0f));
+    CHECK(IsNear(box.Center.y + box.Extents.y, 10.0f + Chunk::BLOCK_SIZE * 4.0f - 1.0f));
+
+    std::vector<BoundingBox> aOccluders;
+    chunk.BuildOccluders(aOccluders);
+    CHECK(aOccluders.size() == (Chunk::SIZE / Chunk::OCCLUDER_SIZE) * (Chunk::SIZE / Chunk::OCCLUDER_SIZE));
+    for (const BoundingBox& occluder : aOccluders)
+    {
+        BOOL bTall = occluder.Center.x < 100.0f + Chunk::BLOCK_SIZE * Chunk::OCCLUDER_SIZE;
+        CHECK(IsNear(occluder.Extents.x, Chunk::BLOCK_SIZE * Chunk::OCCLUDER_SIZE * 0.5f));
+        CHECK(IsNear(occluder.Extents.y, bTall ? Chunk::BLOCK_SIZE * 2.0f : Chunk::BLOCK_SIZE));
+    }
+
+    // A column with a hole at the bottom leaves its square without occluder
+    chunk.SetBlock(Chunk::SIZE - 1u, 0u, Chunk::SIZE - 1u, eBlockType::AIR);
+    chunk.BuildOccluders(aOccluders);
+    CHECK(aOccluders.size() == (Chunk::SIZE / Chunk::OCCLUDER_SIZE) * (Chunk::SIZE / Chunk::OCCLUDER_SIZE) - 1u);
+}
+
+TEST_CASE(ChunkStore_AddressesBlocksAcrossChunks)
+{
+    CHECK(ChunkStore::GetChunkCoord(0) == 0);
+    CHECK(ChunkStore::GetChunkCoord(static_cast<INT>(Chunk::SIZE) - 1) == 0);
+    CHECK(ChunkStore::GetChunkCoord(static_cast<INT>(Chunk::SIZE)) == 1);
+    CHECK(ChunkStore::GetChunkCoord(-1) == -1);
+    CHECK(ChunkStore::GetChunkCoord(-static_cast<INT>(Chunk::SIZE)) == -1);
+    CHECK(ChunkStore::GetChunkCoord(-static_cast<INT>(Chunk::SIZE) - 1) == -2);
+    CHECK(ChunkStore::GetKey(-1, 0) != ChunkStore::GetKey(0, -1));
+    CHECK(ChunkStore::GetKey(-1, -1) != ChunkStore::GetKey(0, 0));
+
+    ChunkStore store;
+    store.Reset(XMFLOAT3(10.0f, 0.0f, 20.0f), 16u);
+
+    // Removing blocks never creates chunks
+    store.SetBlock(5, 3, 5, eBlockType::AIR);
+    CHECK(store.GetChunks().empty());
+
+    store.SetBlock(-1, 3, -40, eBlockType::SAND);
+    CHECK(store.GetChunks().size() == 1u);
+    CHECK(store.GetBlock(-1, 3, -40) == eBlockType::SAND);
+    CHECK(store.GetBlock(-1, 3, -39) == eBlockType::AIR);
+    CHECK(store.GetBlock(-1, -1, -40) == eBlockType::AIR);
+
+    const Chunk* pChunk = store.GetChunk(-1, -2);
+    CHECK(pChunk != nullptr);
+    CHECK(pChunk->GetNumBlocks() == 1u);
+    XMFLOAT3 position = pChunk->GetBlockPosition(Chunk::SIZE - 1u, 3u, 24u);
+    CHECK(IsNear(position.x, 10.0f - Chunk::BLOCK_SIZE));
+    CHECK(IsNear(position.y, 3.0f * Chunk::BLOCK_SIZE));
+    CHECK(IsNear(position.z, 20.0f - 40.0f * Chunk::BLOCK_SIZE));
+
+    // Blocks above the chunk height are ignored
+    store.SetBlock(100, 16, 0, eBlockType::SAND);
+    CHECK(store.GetChunks().size() == 1u);
+
+    store.RemoveChunk(-1, -2);
+    CHECK(store.GetBlock(-1, 3, -40) == eBlockType::AIR);
+    CHECK(store.GetChunks().empty());
+}
+
+TEST_CASE(ChunkStore_LoadsScenes)
+{
+    SceneData sceneData =
+    {
+        .uWidth = 40u,
+        .uHeight = 4u,
+        .uDepth = 36u,
+        .aColors = {},
+        .aBlockTypes = std::vector<eBlockType>(40u * 36u, eBlockType::TUNDRA),
+        .aColumnHeights = std::vector<WORD>(40u * 36u, 0u)
+    };
+
+    for (UINT z = 0u; z < 36u; ++z)
+    {
+        for (UINT x = 0u; x < 40u; ++x)
+            sceneData.aColumnHeights[z * 40u + x] = static_cast<WORD>((x + z) % 3u);
+    }
+    sceneData.aColumnHeights[5u * 40u + 35u] = 9u;
+
+    ChunkStore store;
+    store.Load(sceneData, XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+    // Chunks grow to hold the tallest column
+    CHECK(store.GetChunkHeight() == 9u);
+    CHECK(store.GetChunks().size() == 4u);
+
+    UINT uNumBlocks = 0u;
+    for (const auto& chunkElem : store.GetChunks())
+        uNumBlocks += chunkElem.second->GetNumBlocks();
+
+    UINT uExpectedBlocks = 0u;
+    BOOL bMatches = TRUE;
+    for (UINT z = 0u; z < 36u; ++z)
+    {
+        for (UINT x = 0u; x < 40u; ++x)
+        {
+            UINT uHeight = sceneData.aColumnHeights[z * 40u + x];
+            uExpectedBlocks += uHeight;
+            for (UINT y = 0u; y < store.GetChunkHeight(); ++y)
+                bMatches &= store.GetBlock(static_cast<INT>(x), static_cast<INT>(y), static_cast<INT>(z)) == (y < uHeight ? eBlockType::TUNDRA : eBlockType::AIR);
+        }
+    }
+
+    CHECK(bMatches);
+    CHECK(uNumBlocks == uExpectedBlocks);
+
+    // Loading again replaces the chunks
+    sceneData.aColumnHeights.assign(40u * 36u, 0u);
+    sceneData.aColumnHeights[0] = 1u;
+    store.Load(sceneData, XMFLOAT3(0.0f, 0.0f, 0.0f));
+    CHECK(store.GetChunkHeight() == 4u);
+    CHECK(store.GetChunks().size() == 1u);
+}
+
+TEST_CASE(ChunkStore_CastsRays)
+{
+    constexpr const FLOAT UNBOUNDED = (std::numeric_limits<FLOAT>::max)();
+
+    ChunkStore store;
+    store.Reset(XMFLOAT3(0.0f, 0.0f, 0.0f), 8u);
+
+    VoxelRayHit hit;
+    CHECK(!store.CastRay(VoxelRay{ .origin = XMFLOAT3(0.0f, 5.0f, 0.0f), .direction = XMFLOAT3(1.0f, 0.0f, 0.0f), .maxDistance = UNBOUNDED }, hit));
+
+    // A floor two blocks thick over chunk (0, 0), its top at y = 3
+    Chunk* pChunk = store.GetOrCreateChunk(0, 0);
+    for (UINT z = 0u; z < Chunk::SIZE; ++z)
+    {
+        for (UINT x = 0u; x < Chunk::SIZE; ++x)
+            pChunk->SetColumn(x, z, eBlockType::GRASSLAND, 2u);
+    }
+
+    CHECK(store.CastRay(VoxelRay{ .origin = XMFLOAT3(5.0f, 11.0f, 5.0f), .direction = XMFLOAT3(0.0f, -1.0f, 0.0f), .maxDistance = 100.0f }, hit));
+    CHECK(hit.block.x == 3 && hit.block.y == 1 && hit.block.z == 3);
+    CHECK(hit.normal.x == 0 && hit.normal.y == 1 && hit.normal.z == 0);
+    CHECK(IsNear(hit.distance, 8.0f));
+    CHECK(hit.blockType == eBlockType::GRASSLAND);
+
+    // Too short to reach the floor
+    CHECK(!store.CastRay(VoxelRay{ .origin = XMFLOAT3(5.0f, 11.0f, 5.0f), .direction = XMFLOAT3(0.0f, -1.0f, 0.0f), .maxDistance = 7.0f }, hit));
+    CHECK(hit.blockType == eBlockType::AIR);
+
+    // From far outside the chunks towards them
+    CHECK(store.CastRay(VoxelRay{ .origin = XMFLOAT3(-100.0f, 2.0f, 6.0f), .direction = XMFLOAT3(1.0f, 0.0f, 0.0f), .maxDistance = UNBOUNDED }, hit));
+    CHECK(hit.block.x == 0 && hit.block.y == 1 && hit.block.z == 3);
+    CHECK(hit.normal.x == -1 && hit.normal.y == 0 && hit.normal.z == 0);
+    CHECK(IsNear(hit.distance, 99.0f));
+
+    // Unbounded rays over the floor, along it and away from it, end at the extents of the chunks
+    CHECK(!store.CastRay(VoxelRay{ .origin = XMFLOAT3(5.0f, 7.0f, 5.0f), .direction = XMFLOAT3(1.0f, 0.0f, 0.0f), .maxDistance = UNBOUNDED }, hit));
+    CHECK(!store.CastRay(VoxelRay{ .origin = XMFLOAT3(5.0f, 7.0f, 5.0f), .direction = XMFLOAT3(0.0f, 0.0f, -1.0f), .maxDistance = UNBOUNDED }, hit));
+    CHECK(!store.CastRay(VoxelRay{ .origin = XMFLOAT3(-100.0f, 2.0f, 6.0f), .direction = XMFLOAT3(-1.0f, 0.0f, 0.0f), .maxDistance = UNBOUNDED }, hit));
+
+    // The extents shrink again when the farthest chunk is removed
+    store.SetBlock(5 * static_cast<INT>(Chunk::SIZE), 6, 3, eBlockType::SNOW);
+    CHECK(store.CastRay(VoxelRay{ .origin = XMFLOAT3(5.0f, 12.0f, 6.0f), .direction = XMFLOAT3(1.0f, 0.0f, 0.0f), .maxDistance = UNBOUNDED }, hit));
+    CHECK(hit.blockType == eBlockType::SNOW);
+
+    store.RemoveChunk(5, 0);
+    CHECK(!store.CastRay(VoxelRay{ .origin = XMFLOAT3(5.0f, 12.0f, 6.0f), .direction = XMFLOAT3(1.0f, 0.0f, 0.0f), .maxDistance = UNBOUNDED }, hit));
+
+    // Casting many rays gives the hits of casting them one at a time
+    std::vector<VoxelRay> aRays;
+    for (INT i = 0; i < 64; ++i)
+    {
+        XMVECTOR direction = XMVector3Normalize(XMVectorSet(static_cast<FLOAT>(i % 7) - 3.0f, -1.0f - static_cast<FLOAT>(i % 3), static_cast<FLOAT>(i % 5) - 2.0f, 0.0f));
+        VoxelRay ray = { .origin = XMFLOAT3(static_cast<FLOAT>(i), 14.0f, static_cast<FLOAT>(64 - i)), .direction = XMFLOAT3(), .maxDistance = UNBOUNDED };
+        XMStoreFloat3(&ray.direction, direction);
+        aRays.push_back(ray);
+    }
+
+    std::vector<VoxelRayHit> aHits;
+    store.CastRays(aRays, aHits);
+    CHECK(aHits.size() == aRays.size());
+
+    BOOL bMatches = TRUE;
+    for (size_t i = 0u; i < aRays.size(); ++i)
+    {
+        BOOL bHit = store.CastRay(aRays[i], hit);
+        bMatches &= bHit == (aHits[i].blockType != eBlockType::AIR);
+        bMatches &= hit.block.x == aHits[i].block.x && hit.block.y == aHits[i].block.y && hit.block.z == aHits[i].block.z;
+    }
+    CHECK(bMatches);
+}
+
+TEST_CASE(ChunkStore_MovesBoxesUpSteps)
+{
+    ChunkStore store;
+    store.Reset(XMFLOAT3(0.0f, 0.0f, 0.0f), 8u);
+
+    // A floor one block high, a ledge one block higher from x = 10 and a wall from x = 20
+    Chunk* pChunk = store.GetOrCreateChunk(0, 0);
+    for (UINT z = 0u; z < Chunk::SIZE; ++z)
+    {
+        for (UINT x = 0u; x < Chunk::SIZE; ++x)
+            pChunk->SetColumn(x, z, eBlockType::GRASSLAND, x >= 20u ? 4u : x >= 10u ? 2u : 1u);
+    }
+
+    // A box 0.6 by 1.8 by 0.6 blocks standing on the floor right in front of the ledge
+    const FLOAT BLOCK_SIZE = Chunk::BLOCK_SIZE;
+    BoundingBox box(XMFLOAT3(9.0f * BLOCK_SIZE, 1.4f * BLOCK_SIZE, 5.0f * BLOCK_SIZE), XMFLOAT3(0.3f * BLOCK_SIZE, 0.9f * BLOCK_SIZE, 0.3f * BLOCK_SIZE));
+    const XMFLOAT3 walk(0.5f * BLOCK_SIZE, -0.05f * BLOCK_SIZE, 0.0f);
+
+    VoxelMove move;
+    store.MoveBox(box, walk, 0.0f, move);
+    CHECK(move.bBlockedX && move.bBlockedY && move.bOnGround);
+    CHECK(IsNear(move.movement.x, 0.2f * BLOCK_SIZE));
+    CHECK(IsNear(move.movement.y, 0.0f));
+
+    // Walking into the ledge ends on top of it
+    store.MoveBox(box, walk, 1.1f * BLOCK_SIZE, move);
+    CHECK(!move.bBlockedX && move.bOnGround);
+    CHECK(IsNear(move.movement.x, 0.5f * BLOCK_SIZE));
+    CHECK(IsNear(move.movement.y, 1.0f * BLOCK_SIZE));
+    CHECK(IsNear(move.movement.z, 0.0f));
+
+    // A step too high to climb blocks the box
+    box.Center = XMFLOAT3(19.0f * BLOCK_SIZE, 2.4f * BLOCK_SIZE, 5.0f * BLOCK_SIZE);
+    store.MoveBox(box, walk, 1.1f * BLOCK_SIZE, move);
+    CHECK(move.bBlockedX && move.bOnGround);
+    CHECK(IsNear(move.movement.x, 0.2f * BLOCK_SIZE));
+    CHECK(IsNear(move.movement.y, 0.0f));
+}
+
+BENCHMARK(ChunkStore_BuildChunks)
+{
+    constexpr const UINT NUM_CHUNKS = 16u;
+    constexpr const UINT HEIGHT = 64u;
+
+    for (UINT uNumChunks = 4u; uNumChunks <= NUM_CHUNKS; uNumChunks *= 2u)
+    {
+        ChunkStore store;
+        store.Reset(XMFLOAT3(0.0f, 0.0f, 0.0f), HEIGHT);
+
+        INT iNumBlocks = static_cast<INT>(uNumChunks * Chunk::SIZE);
+        double fillSeconds = test::MeasureSeconds([&]()
+            {
+                for (INT z = 0; z < iNumBlocks; ++z)
+                {
+                    for (INT x = 0; x < iNumBlocks; ++x)
+                    {
+                        Chunk* pChunk = store.GetOrCreateChunk(ChunkStore::GetChunkCoord(x), ChunkStore::GetChunkCoord(z));
+                        eBlockType blockType = (x / 7 + z / 5) % 4 == 0 ? eBlockType::OCEAN : eBlockType::GRASSLAND;
+                        pChunk->SetColumn(static_cast<UINT>(x) % Chunk::SIZE, static_cast<UINT>(z) % Chunk::SIZE, blockType, GetHillHeight(x, z, HEIGHT));
+                    }
+                }
+            }
+        );
+
+        size_t uNumInstances = 0u;
+        double instanceSeconds = test::MeasureSeconds([&]()
+            {
+                std::vector<InstanceData> aInstanceData;
+                for (const auto& chunkElem : store.GetChunks())
+                {
+                    const Chunk* apNeighbors[Chunk::NUM_NEIGHBORS];
+                    store.GetNeighbors(*chunkElem.second, apNeighbors);
+                    chunkElem.second->BuildInstanceData(apNeighbors, aInstanceData);
+                    uNumInstances += aInstanceData.size();
+                }
+            }
+        );
+
+        size_t uNumVertices = 0u;
+        double meshSeconds = test::MeasureSeconds([&]()
+            {
+                std::vector<SimpleVertex> aVertices[Chunk::NUM_BLOCK_TYPES];
+                for (const auto& chunkElem : store.GetChunks())
+                {
+                    const Chunk* apNeighbors[Chunk::NUM_NEIGHBORS];
+                    store.GetNeighbors(*chunkElem.second, apNeighbors);
+                    chunkElem.second->BuildGreedyMesh(apNeighbors, aVertices);
+                    for (const std::vector<SimpleVertex>& aTypeVertices : aVertices)
+                        uNumVertices += aTypeVertices.size();
+                }
+            }
+        );
+
+        size_t uMemoryUsage = 0u;
+        size_t uNumStoredBlocks = 0u;
+        for (const auto& chunkElem : store.GetChunks())
+        {
+            uMemoryUsage += chunkElem.second->GetMemoryUsage();
+            uNumStoredBlocks += chunkElem.second->GetNumBlocks();
+        }
+
+        std::printf("  %ux%u chunks, %zu blocks: fill %.3f s, %.2f bytes/block, %zu instances in %.3f s, %zu greedy vertices in %.3f s\n",
+            uNumChunks, uNumChunks, uNumStoredBlocks, fillSeconds,
+            static_cast<double>(uMemoryUsage) / static_cast<double>(uNumStoredBlocks),
+            uNumInstances, instanceSeconds, uNumVertices, meshSeconds);
+    }
+}
+
+BENCHMARK(Chunk_GreedyVsInstancedMeshing)
+{
+    // Voxel draws the 24 vertices and 12 triangles of a cube for every instance
+    constexpr const size_t NUM_CUBE_VERTICES = 24u;
+    constexpr const size_t NUM_CUBE_TRIANGLES = 12u;
+
+    for (UINT uSize = 128u; uSize <= 512u; uSize *= 2u)
+    {
+        ChunkStore store;
+        store.Load(CreateHills(uSize, uSize), XMFLOAT3(0.0f, 0.0f, 0.0f));
+        double numChunks = static_cast<double>(store.GetChunks().size());
+
+        size_t uNumInstances = 0u;
+        double instanceSeconds = test::MeasureSeconds([&]()
+            {
+                std::vector<InstanceData> aInstanceData;
+                for (const auto& chunkElem : store.GetChunks())
+                {
+                    const Chunk* apNeighbors[Chunk::NUM_NEIGHBORS];
+                    store.GetNeighbors(*chunkElem.second, apNeighbors);
+                    chunkElem.second->BuildInstanceData(apNeighbors, aInstanceData);
+                    uNumInstances += aInstanceData.size();
+                }
+            }
+        );
+
+        size_t uNumVertices = 0u;
+        double greedySeconds = test::MeasureSeconds([&]()
+            {
+                std::vector<SimpleVertex> aVertices[Chunk::NUM_BLOCK_TYPES];
+                for (const auto& chunkElem : store.GetChunks())
+                {
+                    const Chunk* apNeighbors[Chunk::NUM_NEIGHBORS];
+                    store.GetNeighbors(*chunkElem.second, apNeighbors);
+                    chunkElem.second->BuildGreedyMesh(apNeighbors, aVertices);
+                    for (const std::vector<SimpleVertex>& aTypeVertices : aVertices)
+                        uNumVertices += aTypeVertices.size();
+                }
+            }
+        );
+        CHECK(uNumVertices > 0u && uNumVertices < uNumInstances * NUM_CUBE_VERTICES);
+
+        std::printf("  %ux%u blocks, %.0f chunks: instanced %.0f chunks/s, %zu instances, %zu vertices, %zu triangles; greedy %.0f chunks/s, %zu vertices, %zu triangles\n",
+            uSize, uSize, numChunks,
+            numChunks / instanceSeconds, uNumInstances, uNumInstances * NUM_CUBE_VERTICES, uNumInstances * NUM_CUBE_TRIANGLES,
+            numChunks / greedySeconds, uNumVertices, uNumVertices / 2u);
+    }
+}
+
+BENCHMARK(ChunkStore_EditToRebuiltMesh)
+{
+    constexpr const UINT WORLD_SIZE = 512u;
+    constexpr const UINT NUM_EDITS = 64u;
+    const INT aBrushSizes[] = { 1, 4, 8, 16 };
+
+    for (BOOL bGreedy : { TRUE, FALSE })
+    {
+        for (INT iBrushSize : aBrushSizes)
+        {
+            ChunkStore store;
+            store.Load(CreateHills(WORLD_SIZE, WORLD_SIZE), XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+            // Each edit digs a cube into the surface somewhere on the hills and waits for its meshes
+            UINT uSeed = 3u;
+            double totalSeconds = 0.0;
+            double maxSeconds = 0.0;
+            size_t uNumDirtyChunks = 0u;
+            size_t uNumBuilt = 0u;
+            for (UINT i = 0u; i < NUM_EDITS; ++i)
+            {
+                uSeed = uSeed * 1664525u + 1013904223u;
+                INT x = static_cast<INT>((uSeed >> 8u) % (WORLD_SIZE - 32u)) + 16;
+                uSeed = uSeed * 1664525u + 1013904223u;
+                INT z = static_cast<INT>((uSeed >> 8u) % (WORLD_SIZE - 32u)) + 16;
+
+                INT y = static_cast<INT>(store.GetChunkHeight()) - 1;
+                while (y > 0 && store.GetBlock(x, y, z) == eBlockType::AIR)
+                    --y;
+
+                XMINT3 minBlock(x - iBrushSize / 2, std::max<INT>(y - iBrushSize / 2, 0), z - iBrushSize / 2);
+                XMINT3 maxBlock(minBlock.x + iBrushSize - 1, minBlock.y + iBrushSize - 1, minBlock.z + iBrushSize - 1);
+
+                std::unordered_set<UINT64> dirtyChunks;
+                double seconds = test::MeasureSeconds([&]()
+                    {
+                        EditBlocks(store, minBlock, maxBlock, eBlockType::AIR, dirtyChunks);
+                        uNumBuilt += RebuildChunks(store, dirtyChunks, bGreedy);
+                    }
+                );
+                CHECK(!dirtyChunks.empty());
+
+                totalSeconds += seconds;
+                maxSeconds = std::max<double>(maxSeconds, seconds);
+                uNumDirtyChunks += dirtyChunks.size();
+            }
+            CHECK(uNumBuilt > 0u);
+
+            std::printf("  %s, %2d^3 brush: %.3f ms per edit (worst %.3f ms), %.2f chunks rebuilt per edit\n",
+                bGreedy ? "greedy   " : "instanced", iBrushSize, totalSeconds / NUM_EDITS * 1e3, maxSeconds * 1e3,
+                static_cast<double>(uNumDirtyChunks) / NUM_EDITS);
+        }
+    }
+}
+
+BENCHMARK(ChunkStore_CastRays)
+{
+    constexpr const UINT NUM_CHUNKS = 16u;
+    constexpr const UINT HEIGHT = 64u;
+    constexpr const UINT NUM_RAYS = 1u << 20u;
+
+    ChunkStore store;
+    store.Reset(XMFLOAT3(0.0f, 0.0f, 0.0f), HEIGHT);
+
+    INT iNumBlocks = static_cast<INT>(NUM_CHUNKS * Chunk::SIZE);
+    for (INT z = 0; z < iNumBlocks; ++z)
+    {
+        for (INT x = 0; x < iNumBlocks; ++x)
+            store.GetOrCreateChunk(ChunkStore::GetChunkCoord(x), ChunkStore::GetChunkCoord(z))->SetColumn(
+                static_cast<UINT>(x) % Chunk::SIZE, static_cast<UINT>(z) % Chunk::SIZE, eBlockType::GRASSLAND, GetHillHeight(x, z, HEIGHT));
+    }
+
+    // Rays from above the middle of the hills, some looking down at them and some towards the horizon
+    FLOAT center = static_cast<FLOAT>(iNumBlocks) * Chunk::BLOCK_SIZE * 0.5f;
+    std::vector<VoxelRay> aRays(NUM_RAYS);
+    UINT uSeed = 1u;
+    for (VoxelRay& ray : aRays)
+    {
+        FLOAT aRandom[3];
+        for (FLOAT& random : aRandom)
+        {
+            uSeed = uSeed * 1664525u + 1013904223u;
+            random = static_cast<FLOAT>(uSeed >> 8u) / static_cast<FLOAT>(1u << 24u) - 0.5f;
+        }
+
+        ray.origin = XMFLOAT3(center, static_cast<FLOAT>(HEIGHT) * Chunk::BLOCK_SIZE, center);
+        XMStoreFloat3(&ray.direction, XMVector3Normalize(XMVectorSet(aRandom[0], aRandom[1] - 0.5f, aRandom[2], 0.0f)));
+        ray.maxDistance = (std::numeric_limits<FLOAT>::max)();
+    }
+
+    std::vector<VoxelRayHit> aHits(NUM_RAYS);
+    double serialSeconds = test::MeasureSeconds([&]()
+        {
+            for (UINT i = 0u; i < NUM_RAYS; ++i)
+                store.CastRay(aRays[i], aHits[i]);
+        }
+    );
+
+    double parallelSeconds = test::MeasureSeconds([&]()
+        {
+            store.CastRays(aRays, aHits);
+        }
+    );
+
+    size_t uNumHits = static_cast<size_t>(std::count_if(aHits.begin(), aHits.end(), [](const VoxelRayHit& hit) { return hit.blockType != eBlockType::AIR; }));
+    CHECK(uNumHits > 0u && uNumHits < NUM_RAYS);
+
+    std::printf("  %u rays over %ux%u chunks, %zu hits: one at a time %.2f Mrays/s, CastRays %.2f Mrays/s\n",
+        NUM_RAYS, NUM_CHUNKS, NUM_CHUNKS, uNumHits, NUM_RAYS / serialSeconds * 1e-6, NUM_RAYS / parallelSeconds * 1e-6);
+}
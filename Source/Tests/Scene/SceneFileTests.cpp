@@ -0,0 +1,347 @@
+#include "Test.h"
+
+#include <fstream>
+
+#include "Scene/SceneFile.h"
+
+using namespace library;
+
+namespace
+{
+    // Size of the header of a binary scene file, eight 32-bit fields
+    constexpr const size_t HEADER_SIZE = 8u * sizeof(UINT32);
+    constexpr const size_t COLOR_SIZE = 3u * sizeof(FLOAT);
+
+    // Order of the fields of the header
+    constexpr const UINT FIELD_MAGIC = 0u;
+    constexpr const UINT FIELD_VERSION = 1u;
+    constexpr const UINT FIELD_FLAGS = 2u;
+    constexpr const UINT FIELD_WIDTH = 3u;
+    constexpr const UINT FIELD_DEPTH = 5u;
+    constexpr const UINT FIELD_NUM_COLORS = 6u;
+    constexpr const UINT FIELD_BLOCK_TYPE_SIZE = 7u;
+
+    // Hills up to uMaxHeight blocks, in bands of uNumTypes block types from GRASSLAND on
+    SceneData CreateScene(UINT uWidth, UINT uDepth, UINT uMaxHeight, UINT uNumTypes)
+    {
+        SceneData sceneData =
+        {
+            .uWidth = uWidth,
+            .uHeight = uMaxHeight,
+            .uDepth = uDepth,
+            .aColors = {},
+            .aBlockTypes = std::vector<eBlockType>(static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth)),
+            .aColumnHeights = std::vector<WORD>(static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth))
+        };
+
+        // Sixteenths, which the text format writes exactly
+        for (UINT i = 0u; i < uNumTypes; ++i)
+            sceneData.aColors.push_back(XMFLOAT4(static_cast<FLOAT>(i) / 16.0f, 0.5f, 1.0f - static_cast<FLOAT>(i) / 16.0f, 1.0f));
+
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                FLOAT wave = 0.5f + 0.25f * std::sin(static_cast<FLOAT>(x) * 0.07f) + 0.25f * std::cos(static_cast<FLOAT>(z) * 0.05f);
+                UINT uHeight = std::min<UINT>(static_cast<UINT>(wave * static_cast<FLOAT>(uMaxHeight)), uMaxHeight);
+                size_t uColumnIdx = static_cast<size_t>(z) * uWidth + x;
+
+                sceneData.aColumnHeights[uColumnIdx] = static_cast<WORD>(uHeight);
+                sceneData.aBlockTypes[uColumnIdx] = static_cast<eBlockType>(static_cast<UINT>(eBlockType::GRASSLAND) + std::min<UINT>(static_cast<UINT>(wave * static_cast<FLOAT>(uNumTypes)), uNumTypes - 1u));
+            }
+        }
+
+        return sceneData;
+    }
+
+    BOOL IsSameScene(const SceneData& a, const SceneData& b)
+    {
+        if (a.uWidth != b.uWidth || a.uHeight != b.uHeight || a.uDepth != b.uDepth || a.aColors.size() != b.aColors.size())
+            return FALSE;
+
+        for (size_t i = 0u; i < a.aColors.size(); ++i)
+        {
+            if (a.aColors[i].x != b.aColors[i].x || a.aColors[i].y != b.aColors[i].y || a.aColors[i].z != b.aColors[i].z || b.aColors[i].w != 1.0f)
+                return FALSE;
+        }
+
+        return a.aBlockTypes == b.aBlockTypes && a.aColumnHeights == b.aColumnHeights;
+    }
+
+    // Writes a scene in the text format of the labs, a block type character and a height in [0, 1] per column
+    void WriteTextFile(const std::filesystem::path& filePath, const SceneData& sceneData)
+    {
+        std::ofstream sceneFile(filePath);
+        sceneFile << sceneData.uWidth << ' ' << sceneData.uHeight << ' ' << sceneData.uDepth << ' ' << sceneData.aColors.size() << '\n';
+
+        for (const XMFLOAT4& color : sceneData.aColors)
+            sceneFile << color.x << ' ' << color.y << ' ' << color.z << '\n';
+
+        for (UINT z = 0u; z < sceneData.uDepth; ++z)
+        {
+            for (UINT x = 0u; x < sceneData.uWidth; ++x)
+            {
+                size_t uColumnIdx = static_cast<size_t>(z) * sceneData.uWidth + x;
+                sceneFile << static_cast<CHAR>(sceneData.aBlockTypes[uColumnIdx]);
+                sceneFile << static_cast<FLOAT>(sceneData.aColumnHeights[uColumnIdx]) / static_cast<FLOAT>(sceneData.uHeight) << ' ';
+            }
+            sceneFile << '\n';
+        }
+    }
+
+    void SetHeaderField(std::vector<BYTE>& aData, UINT uField, UINT32 uValue)
+    {
+        memcpy(aData.data() + uField * sizeof(UINT32), &uValue, sizeof(uValue));
+    }
+
+    BOOL IsRejected(const std::vector<BYTE>& aData)
+    {
+        SceneData sceneData;
+        return SceneFile::ReadBinaryData(aData, sceneData) == HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+}
+
+TEST_CASE(SceneFile_RoundTripsBinaryFiles)
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "SceneFileTests";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path filePath = directory / "Hills.vxs";
+    SceneData sceneData;
+
+    CHECK(SceneFile::IsBinaryFile(filePath));
+    CHECK(SceneFile::IsBinaryFile(directory / "HILLS.VXS"));
+    CHECK(!SceneFile::IsBinaryFile(directory / "Hills.txt"));
+    CHECK(!SceneFile::IsBinaryFile(directory / "vxs"));
+
+    // 8-bit heights, and block types raw or run-length encoded
+    SceneData hills = CreateScene(70u, 45u, 200u, 5u);
+    size_t uNumColumns = 70u * 45u;
+    CHECK(SUCCEEDED(SceneFile::Write(filePath, hills, FALSE)));
+    CHECK(std::filesystem::file_size(filePath) == HEADER_SIZE + 5u * COLOR_SIZE + uNumColumns + uNumColumns);
+    CHECK(SUCCEEDED(SceneFile::Read(filePath, sceneData)));
+    CHECK(IsSameScene(sceneData, hills));
+
+    CHECK(SUCCEEDED(SceneFile::Write(filePath, hills, TRUE)));
+    CHECK(std::filesystem::file_size(filePath) < HEADER_SIZE + 5u * COLOR_SIZE + uNumColumns / 4u + uNumColumns);
+    CHECK(SUCCEEDED(SceneFile::Read(filePath, sceneData)));
+    CHECK(IsSameScene(sceneData, hills));
+
+    // Heights past 255 take 16 bits
+    SceneData mountains = CreateScene(70u, 45u, 600u, 5u);
+    CHECK(*std::max_element(mountains.aColumnHeights.begin(), mountains.aColumnHeights.end()) > 255u);
+    CHECK(SUCCEEDED(SceneFile::Write(filePath, mountains, FALSE)));
+    CHECK(std::filesystem::file_size(filePath) == HEADER_SIZE + 5u * COLOR_SIZE + uNumColumns + uNumColumns * sizeof(WORD));
+    CHECK(SUCCEEDED(SceneFile::ReadBinary(filePath, sceneData)));
+    CHECK(IsSameScene(sceneData, mountains));
+
+    // Runs longer than 255 columns are split
+    SceneData plain = CreateScene(300u, 20u, 10u, 1u);
+    CHECK(SUCCEEDED(SceneFile::Write(filePath, plain, TRUE)));
+    CHECK(std::filesystem::file_size(filePath) == HEADER_SIZE + COLOR_SIZE + 2u * ((6000u + 254u) / 255u) + 6000u);
+    CHECK(SUCCEEDED(SceneFile::Read(filePath, sceneData)));
+    CHECK(IsSameScene(sceneData, plain));
+
+    // Block types that change every column stay raw, since the runs would be larger
+    SceneData checkers = CreateScene(64u, 64u, 16u, 2u);
+    for (size_t i = 0u; i < checkers.aBlockTypes.size(); ++i)
+        checkers.aBlockTypes[i] = i % 2u == 0u ? eBlockType::GRASSLAND : eBlockType::SNOW;
+    CHECK(SUCCEEDED(SceneFile::Write(filePath, checkers, TRUE)));
+    CHECK(std::filesystem::file_size(filePath) == HEADER_SIZE + 2u * COLOR_SIZE + 4096u + 4096u);
+    CHECK(SUCCEEDED(SceneFile::Read(filePath, sceneData)));
+    CHECK(IsSameScene(sceneData, checkers));
+
+    // Block types outside the palette and columns that do not match the size are not written
+    checkers.aBlockTypes[7] = eBlockType::OCEAN;
+    CHECK(SceneFile::Write(filePath, checkers, FALSE) == E_INVALIDARG);
+    checkers.aBlockTypes[7] = eBlockType::AIR;
+    CHECK(SceneFile::Write(filePath, checkers, FALSE) == E_INVALIDARG);
+    checkers.aBlockTypes[7] = eBlockType::SNOW;
+    checkers.aColumnHeights.pop_back();
+    CHECK(SceneFile::Write(filePath, checkers, FALSE) == E_INVALIDARG);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(SceneFile_ReadsAndConvertsTextFiles)
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "SceneFileTests";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path textFilePath = directory / "Hills.txt";
+    std::filesystem::path binaryFilePath = directory / "Hills.vxs";
+
+    // Heights in 32ths are written exactly. TEMPERATE_RAIN_FOREST is left out, its character is a space
+    SceneData hills = CreateScene(50u, 37u, 32u, static_cast<UINT>(eBlockType::TEMPERATE_RAIN_FOREST) - static_cast<UINT>(eBlockType::GRASSLAND));
+    WriteTextFile(textFilePath, hills);
+
+    SceneData sceneData;
+    CHECK(SUCCEEDED(SceneFile::Read(textFilePath, sceneData)));
+    CHECK(IsSameScene(sceneData, hills));
+
+    CHECK(SUCCEEDED(SceneFile::ConvertTextFile(textFilePath, binaryFilePath, TRUE)));
+    CHECK(SUCCEEDED(SceneFile::Read(binaryFilePath, sceneData)));
+    CHECK(IsSameScene(sceneData, hills));
+
+    CHECK(FAILED(SceneFile::Read(directory / "Missing.txt", sceneData)));
+    CHECK(FAILED(SceneFile::ConvertTextFile(directory / "Missing.txt", binaryFilePath, TRUE)));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(SceneFile_RejectsCorruptData)
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "SceneFileTests";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path filePath = directory / "Hills.vxs";
+
+    SceneData hills = CreateScene(40u, 25u, 30u, 4u);
+    CHECK(SUCCEEDED(SceneFile::Write(filePath, hills, TRUE)));
+    std::vector<BYTE> aCompressed = test::ReadFile(filePath.string().c_str());
+    CHECK(SUCCEEDED(SceneFile::Write(filePath, hills, FALSE)));
+    std::vector<BYTE> aRaw = test::ReadFile(filePath.string().c_str());
+    CHECK(aCompressed.size() < aRaw.size());
+
+    SceneData sceneData;
+    CHECK(SUCCEEDED(SceneFile::ReadBinaryData(aCompressed, sceneData)));
+    CHECK(IsSameScene(sceneData, hills));
+    CHECK(SUCCEEDED(SceneFile::ReadBinaryData(aRaw, sceneData)));
+    CHECK(IsSameScene(sceneData, hills));
+
+    // Every truncation is caught, from an empty file on
+    BOOL bRejectsTruncated = TRUE;
+    for (const std::vector<BYTE>& aData : { aCompressed, aRaw })
+    {
+        for (size_t uSize = 0u; uSize < aData.size(); ++uSize)
+            bRejectsTruncated &= IsRejected(std::vector<BYTE>(aData.begin(), aData.begin() + static_cast<std::ptrdiff_t>(uSize)));
+    }
+    CHECK(bRejectsTruncated);
+
+    std::vector<BYTE> aData = aRaw;
+    SetHeaderField(aData, FIELD_MAGIC, 0x12345678u);
+    CHECK(IsRejected(aData));
+
+    aData = aRaw;
+    SetHeaderField(aData, FIELD_VERSION, 2u);
+    CHECK(IsRejected(aData));
+
+    aData = aRaw;
+    SetHeaderField(aData, FIELD_WIDTH, 0u);
+    CHECK(IsRejected(aData));
+
+    aData = aRaw;
+    SetHeaderField(aData, FIELD_WIDTH, 0x80000000u);
+    CHECK(IsRejected(aData));
+
+    aData = aRaw;
+    SetHeaderField(aData, FIELD_DEPTH, 26u);
+    CHECK(IsRejected(aData));
+
+    aData = aRaw;
+    SetHeaderField(aData, FIELD_NUM_COLORS, 16u);
+    CHECK(IsRejected(aData));
+
+    // Raw block types take one byte per column
+    aData = aRaw;
+    SetHeaderField(aData, FIELD_BLOCK_TYPE_SIZE, 40u * 25u - 1u);
+    CHECK(IsRejected(aData));
+
+    // 16-bit heights that the file is too short for
+    aData = aRaw;
+    SetHeaderField(aData, FIELD_FLAGS, 0x1u);
+    CHECK(IsRejected(aData));
+
+    // A palette index past the palette
+    aData = aRaw;
+    aData[HEADER_SIZE + 4u * COLOR_SIZE + 17u] = 4u;
+    CHECK(IsRejected(aData));
+
+    // Runs of zero columns, runs past the last column, too few runs and runs cut in half
+    const size_t uRunsOffset = HEADER_SIZE + 4u * COLOR_SIZE;
+    aData = aCompressed;
+    aData[uRunsOffset] = 0u;
+    CHECK(IsRejected(aData));
+
+    aData = aCompressed;
+    aData[uRunsOffset] = 255u;
+    CHECK(IsRejected(aData));
+
+    aData = aCompressed;
+    aData[uRunsOffset] = static_cast<BYTE>(aData[uRunsOffset] - 1u);
+    CHECK(IsRejected(aData));
+
+    aData = aCompressed;
+    aData[uRunsOffset + 1u] = 9u;
+    CHECK(IsRejected(aData));
+
+    aData = aCompressed;
+    UINT32 uBlockTypeSize = 0u;
+    memcpy(&uBlockTypeSize, aData.data() + FIELD_BLOCK_TYPE_SIZE * sizeof(UINT32), sizeof(uBlockTypeSize));
+    SetHeaderField(aData, FIELD_BLOCK_TYPE_SIZE, uBlockTypeSize - 1u);
+    CHECK(IsRejected(aData));
+
+    // Files are checked the same way
+    std::ofstream(filePath, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const CHAR*>(aRaw.data()), static_cast<std::streamsize>(HEADER_SIZE + 10u));
+    CHECK(FAILED(SceneFile::ReadBinary(filePath, sceneData)));
+    std::ofstream(filePath, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const CHAR*>(aRaw.data()), 5);
+    CHECK(FAILED(SceneFile::ReadBinary(filePath, sceneData)));
+    CHECK(FAILED(SceneFile::ReadBinary(directory / "Missing.vxs", sceneData)));
+
+    std::filesystem::remove_all(directory);
+}
+
+BENCHMARK(SceneFile_TextVsBinaryParse)
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "SceneFileTests";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path textFilePath = directory / "Map.txt";
+    std::filesystem::path rawFilePath = directory / "Map.vxs";
+    std::filesystem::path compressedFilePath = directory / "MapRle.vxs";
+
+    for (UINT uSize : { 256u, 4096u })
+    {
+        SceneData map = CreateScene(uSize, uSize, 32u, 8u);
+        WriteTextFile(textFilePath, map);
+        CHECK(SUCCEEDED(SceneFile::Write(rawFilePath, map, FALSE)));
+        CHECK(SUCCEEDED(SceneFile::Write(compressedFilePath, map, TRUE)));
+
+        SceneData sceneData;
+        HRESULT hr = S_OK;
+        double textSeconds = test::MeasureSeconds([&]()
+            {
+                hr = SceneFile::ReadText(textFilePath, sceneData);
+            }
+        );
+        CHECK(SUCCEEDED(hr) && IsSameScene(sceneData, map));
+
+        double rawSeconds = test::MeasureSeconds([&]()
+            {
+                hr = SceneFile::ReadBinary(rawFilePath, sceneData);
+            }
+        );
+        CHECK(SUCCEEDED(hr) && IsSameScene(sceneData, map));
+
+        double compressedSeconds = test::MeasureSeconds([&]()
+            {
+                hr = SceneFile::ReadBinary(compressedFilePath, sceneData);
+            }
+        );
+        CHECK(SUCCEEDED(hr) && IsSameScene(sceneData, map));
+
+        // Decoding alone, without the file
+        std::vector<BYTE> aData = test::ReadFile(compressedFilePath.string().c_str());
+        double memorySeconds = test::MeasureSeconds([&]()
+            {
+                hr = SceneFile::ReadBinaryData(aData, sceneData);
+            }
+        );
+        CHECK(SUCCEEDED(hr));
+
+        std::printf("  %ux%u columns: text %.2f MB in %.1f ms, binary %.2f MB in %.1f ms, run-length encoded %.2f MB in %.1f ms (%.1f ms from memory)\n",
+            uSize, uSize,
+            static_cast<double>(std::filesystem::file_size(textFilePath)) / (1024.0 * 1024.0), textSeconds * 1e3,
+            static_cast<double>(std::filesystem::file_size(rawFilePath)) / (1024.0 * 1024.0), rawSeconds * 1e3,
+            static_cast<double>(std::filesystem::file_size(compressedFilePath)) / (1024.0 * 1024.0), compressedSeconds * 1e3,
+            memorySeconds * 1e3);
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,163 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Scene/TerrainNoise.h"
+
+using namespace library;
+
+namespace
+{
+    // Largest difference between Generate and the scalar reference over a grid
+    FLOAT GetMaxGenerateError(INT iOriginX, INT iOriginZ, UINT uWidth, UINT uDepth)
+    {
+        std::vector<FLOAT> aValues;
+        TerrainNoise::Generate(iOriginX, iOriginZ, uWidth, uDepth, aValues);
+        if (aValues.size() != static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth))
+            return (std::numeric_limits<FLOAT>::max)();
+
+        FLOAT maxError = 0.0f;
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                FLOAT reference = TerrainNoise::GetTerrainNoise(iOriginX + static_cast<INT>(x), iOriginZ + static_cast<INT>(z));
+                maxError = std::max<FLOAT>(maxError, std::fabs(aValues[static_cast<size_t>(z) * uWidth + x] - reference));
+            }
+        }
+
+        return maxError;
+    }
+}
+
+TEST_CASE(TerrainNoise_VectorMatchesScalar)
+{
+    std::mt19937 generator(11u);
+    std::uniform_real_distribution<FLOAT> distribution(0.0f, static_cast<FLOAT>(TerrainNoise::PERIOD));
+
+    FLOAT maxError = 0.0f;
+    for (UINT i = 0u; i < 4096u; ++i)
+    {
+        FLOAT aX[4];
+        FLOAT aY[4];
+        for (UINT j = 0u; j < 4u; ++j)
+        {
+            aX[j] = distribution(generator);
+            aY[j] = distribution(generator);
+        }
+
+        XMFLOAT4 values;
+        XMStoreFloat4(&values, TerrainNoise::GetPerlin2dVector(XMVectorSet(aX[0], aX[1], aX[2], aX[3]), XMVectorSet(aY[0], aY[1], aY[2], aY[3]), 0.1f, 4u));
+
+        const FLOAT aValues[4] = { values.x, values.y, values.z, values.w };
+        for (UINT j = 0u; j < 4u; ++j)
+            maxError = std::max<FLOAT>(maxError, std::fabs(aValues[j] - TerrainNoise::GetPerlin2d(aX[j], aY[j], 0.1f, 4u)));
+    }
+
+    CHECK(maxError < 1e-5f);
+}
+
+TEST_CASE(TerrainNoise_GenerateMatchesReference)
+{
+    CHECK(GetMaxGenerateError(0, 0, 64u, 48u) < 1e-4f);
+
+    // Widths that are not a multiple of four, and tiles cut short
+    CHECK(GetMaxGenerateError(-100, 37, 37u, 19u) < 1e-4f);
+    CHECK(GetMaxGenerateError(5, -3, 1u, TerrainNoise::TILE_ROWS + 1u) < 1e-4f);
+
+    // Across the end of a period, where the lanes of a row wrap
+    INT iPeriod = static_cast<INT>(TerrainNoise::PERIOD);
+    CHECK(GetMaxGenerateError(iPeriod - 6, iPeriod - 3, 13u, 7u) < 1e-4f);
+
+    std::vector<FLOAT> aValues;
+    TerrainNoise::Generate(0, 0, 0u, 0u, aValues);
+    CHECK(aValues.empty());
+
+    TerrainNoise::Generate(-512, -512, 256u, 256u, aValues);
+    CHECK(std::all_of(aValues.begin(), aValues.end(), [](FLOAT value) { return value >= 0.0f && value < 2.0f; }));
+    CHECK(*std::max_element(aValues.begin(), aValues.end()) > *std::min_element(aValues.begin(), aValues.end()) + 0.1f);
+}
+
+TEST_CASE(TerrainNoise_MatchesTheMapOfTheLabs)
+{
+    // Heights of the 256 x 256 map from Scene::GetPerlin2d and the height loop of Main.cpp before the terrain streamed
+    struct ReferenceHeight
+    {
+        INT x;
+        INT z;
+        FLOAT height;
+    };
+    const ReferenceHeight aReferences[] =
+    {
+        { 0, 0, 0.131140918f },
+        { 1, 0, 0.141202688f },
+        { 0, 1, 0.366823137f },
+        { 17, 42, 0.75790894f },
+        { 100, 7, 0.615988135f },
+        { 128, 128, 0.483432114f },
+        { 200, 31, 0.898041844f },
+        { 63, 250, 0.801103175f },
+        { 255, 255, 0.321695209f },
+        { 240, 96, 0.534802675f },
+    };
+
+    std::vector<FLOAT> aValues;
+    TerrainNoise::Generate(0, 0, 256u, 256u, aValues);
+    for (const ReferenceHeight& reference : aReferences)
+    {
+        CHECK(std::fabs(TerrainNoise::GetTerrainNoise(reference.x, reference.z) - reference.height) < 1e-5f);
+        CHECK(std::fabs(aValues[static_cast<size_t>(reference.z) * 256u + static_cast<size_t>(reference.x)] - reference.height) < 1e-4f);
+    }
+}
+
+TEST_CASE(TerrainNoise_RepeatsOnlyEveryPeriod)
+{
+    const INT iPeriod = static_cast<INT>(TerrainNoise::PERIOD);
+
+    UINT uNumRepeats = 0u;
+    for (INT i = 0; i < 64; ++i)
+    {
+        INT x = i * 37 - 1000;
+        INT z = i * 53 + 17;
+        CHECK(TerrainNoise::GetTerrainNoise(x, z) == TerrainNoise::GetTerrainNoise(x + iPeriod, z - iPeriod));
+
+        // The hash table alone repeats the terrain every tile
+        if (std::fabs(TerrainNoise::GetTerrainNoise(x, z) - TerrainNoise::GetTerrainNoise(x + static_cast<INT>(TerrainNoise::TILE_SIZE), z)) < 1e-6f)
+            ++uNumRepeats;
+    }
+    CHECK(uNumRepeats < 4u);
+}
+
+BENCHMARK(TerrainNoise_ScalarVsGenerate)
+{
+    for (UINT uSize = 256u; uSize <= 8192u; uSize *= 2u)
+    {
+        std::vector<FLOAT> aScalar(static_cast<size_t>(uSize) * static_cast<size_t>(uSize));
+        double scalarSeconds = test::MeasureSeconds([&]()
+            {
+                for (UINT z = 0u; z < uSize; ++z)
+                {
+                    for (UINT x = 0u; x < uSize; ++x)
+                        aScalar[static_cast<size_t>(z) * uSize + x] = TerrainNoise::GetTerrainNoise(static_cast<INT>(x), static_cast<INT>(z));
+                }
+            }
+        );
+
+        std::vector<FLOAT> aValues;
+        double generateSeconds = test::MeasureSeconds([&]()
+            {
+                TerrainNoise::Generate(0, 0, uSize, uSize, aValues);
+            }
+        );
+
+        FLOAT maxError = 0.0f;
+        for (size_t i = 0u; i < aValues.size(); ++i)
+            maxError = std::max<FLOAT>(maxError, std::fabs(aValues[i] - aScalar[i]));
+        CHECK(maxError < 1e-4f);
+
+        double numSamples = static_cast<double>(uSize) * static_cast<double>(uSize);
+        std::printf("  %ux%u: scalar %.3f s (%.1f Msamples/s), vector and parallel %.3f s (%.1f Msamples/s), max error %g\n",
+            uSize, uSize, scalarSeconds, numSamples / scalarSeconds * 1e-6, generateSeconds, numSamples / generateSeconds * 1e-6,
+            static_cast<double>(maxError));
+    }
+}
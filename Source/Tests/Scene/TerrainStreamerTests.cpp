@@ -0,0 +1,190 @@
+#include "Test.h"
+
+#include <thread>
+
+#include "Scene/TerrainNoise.h"
+#include "Scene/TerrainStreamer.h"
+
+using namespace library;
+
+namespace
+{
+    struct StreamStats
+    {
+        UINT uNumUpdates;
+        size_t uMaxResident;
+        double seconds;
+    };
+
+    BOOL IsWithin(const XMINT2& coord, INT iCenterChunkX, INT iCenterChunkZ, INT iRadius)
+    {
+        INT iOffsetX = coord.x - iCenterChunkX;
+        INT iOffsetZ = coord.y - iCenterChunkZ;
+        return iOffsetX * iOffsetX + iOffsetZ * iOffsetZ <= iRadius * iRadius;
+    }
+
+    BOOL HasRadius(const ChunkStore& chunkStore, INT iCenterChunkX, INT iCenterChunkZ, INT iRadius)
+    {
+        for (INT iOffsetZ = -iRadius; iOffsetZ <= iRadius; ++iOffsetZ)
+        {
+            for (INT iOffsetX = -iRadius; iOffsetX <= iRadius; ++iOffsetX)
+            {
+                if (iOffsetX * iOffsetX + iOffsetZ * iOffsetZ <= iRadius * iRadius &&
+                    !chunkStore.GetChunk(iCenterChunkX + iOffsetX, iCenterChunkZ + iOffsetZ))
+                    return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+
+    // Updates the streamer the way Scene does each frame, until the radius around the camera is resident
+    StreamStats StreamUntilResident(TerrainStreamer& streamer, ChunkStore& chunkStore, INT iCenterChunkX, INT iCenterChunkZ)
+    {
+        const INT iRadius = static_cast<INT>(streamer.GetRadius());
+
+        StreamStats stats = { 0u, 0u, 0.0 };
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point timeout = start + std::chrono::seconds(30);
+
+        std::vector<XMINT2> aEvicted;
+        std::vector<XMINT2> aLoaded;
+        for (;;)
+        {
+            streamer.SelectEvictions(iCenterChunkX, iCenterChunkZ, chunkStore, aEvicted);
+            for (const XMINT2& coord : aEvicted)
+                chunkStore.RemoveChunk(coord.x, coord.y);
+
+            streamer.Update(iCenterChunkX, iCenterChunkZ, chunkStore, aLoaded);
+            for (const XMINT2& coord : aLoaded)
+                CHECK(IsWithin(coord, iCenterChunkX, iCenterChunkZ, iRadius + 1));
+
+            ++stats.uNumUpdates;
+            stats.uMaxResident = std::max<size_t>(stats.uMaxResident, chunkStore.GetChunks().size());
+
+            if (HasRadius(chunkStore, iCenterChunkX, iCenterChunkZ, iRadius) || std::chrono::steady_clock::now() > timeout)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        CHECK(HasRadius(chunkStore, iCenterChunkX, iCenterChunkZ, iRadius));
+
+        return stats;
+    }
+}
+
+TEST_CASE(TerrainStreamer_GeneratesChunksFromTheNoise)
+{
+    GeneratedChunk generatedChunk;
+    TerrainStreamer::GenerateChunk(-3, 2, TerrainStreamer::DEFAULT_CHUNK_HEIGHT, generatedChunk);
+    CHECK(generatedChunk.iChunkX == -3 && generatedChunk.iChunkZ == 2);
+    CHECK(generatedChunk.aColumnHeights.size() == static_cast<size_t>(Chunk::SIZE) * Chunk::SIZE);
+    CHECK(generatedChunk.aBlockTypes.size() == generatedChunk.aColumnHeights.size());
+
+    const INT SIZE = static_cast<INT>(Chunk::SIZE);
+    FLOAT maxError = 0.0f;
+    for (UINT z = 0u; z < Chunk::SIZE; ++z)
+    {
+        for (UINT x = 0u; x < Chunk::SIZE; ++x)
+        {
+            FLOAT height = TerrainNoise::GetTerrainNoise(-3 * SIZE + static_cast<INT>(x), 2 * SIZE + static_cast<INT>(z));
+            FLOAT expected = std::min<FLOAT>(static_cast<FLOAT>(TerrainStreamer::TERRAIN_HEIGHT) * height, static_cast<FLOAT>(TerrainStreamer::DEFAULT_CHUNK_HEIGHT));
+            maxError = std::max<FLOAT>(maxError, std::fabs(static_cast<FLOAT>(generatedChunk.aColumnHeights[z * Chunk::SIZE + x]) - expected));
+        }
+    }
+    CHECK(maxError <= 1.0f);
+}
+
+TEST_CASE(TerrainStreamer_FollowsMovingCamera)
+{
+    // A radius of 3 chunks covers 29 of them, the budget leaves room for a few kept behind the camera
+    constexpr const UINT RADIUS = 3u;
+    constexpr const UINT MAX_CHUNKS = 40u;
+
+    TerrainStreamer streamer(RADIUS, MAX_CHUNKS, TerrainStreamer::DEFAULT_CHUNK_HEIGHT, 2u);
+    ChunkStore chunkStore;
+    chunkStore.Reset(XMFLOAT3(0.0f, 0.0f, 0.0f), streamer.GetChunkHeight());
+
+    // Across the origin and along a diagonal, one chunk at a time
+    const XMINT2 aPath[] = { XMINT2(0, 0), XMINT2(-1, 0), XMINT2(-2, 0), XMINT2(-2, -1), XMINT2(-3, -2), XMINT2(-4, -3), XMINT2(-4, -3), XMINT2(2, 2) };
+
+    double maxSeconds = 0.0;
+    for (const XMINT2& center : aPath)
+    {
+        StreamStats stats = StreamUntilResident(streamer, chunkStore, center.x, center.y);
+        maxSeconds = std::max<double>(maxSeconds, stats.seconds);
+
+        CHECK(stats.uMaxResident <= MAX_CHUNKS);
+        for (const auto& chunkElem : chunkStore.GetChunks())
+            CHECK(IsWithin(XMINT2(chunkElem.second->GetChunkX(), chunkElem.second->GetChunkZ()), center.x, center.y, static_cast<INT>(RADIUS) + 1));
+
+        std::printf("  camera at chunk (%d, %d): %zu resident, %u updates, %.1f ms until the radius is resident\n",
+            center.x, center.y, chunkStore.GetChunks().size(), stats.uNumUpdates, stats.seconds * 1e3);
+    }
+
+    CHECK(streamer.GetNumGenerated() >= 29u);
+    CHECK(streamer.GetNumEvicted() > 0u);
+    CHECK(streamer.GetAverageGenerationTime() > 0.0f);
+    std::printf("  %u generated, %u evicted, %.3f ms per chunk on average, %.1f ms worst latency\n",
+        streamer.GetNumGenerated(), streamer.GetNumEvicted(), static_cast<double>(streamer.GetAverageGenerationTime()), maxSeconds * 1e3);
+}
+
+TEST_CASE(TerrainStreamer_KeepsResidentChunks)
+{
+    TerrainStreamer streamer(1u, 16u, TerrainStreamer::DEFAULT_CHUNK_HEIGHT, 1u);
+    ChunkStore chunkStore;
+    chunkStore.Reset(XMFLOAT3(0.0f, 0.0f, 0.0f), streamer.GetChunkHeight());
+
+    std::vector<XMINT2> aLoaded;
+    streamer.Update(0, 0, chunkStore, aLoaded);
+    CHECK(aLoaded.empty());
+    CHECK(streamer.GetNumPending() == 5u);
+
+    // An edit lands after the chunk was generated but before it is stored; a chunk takes about a millisecond
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    chunkStore.SetBlock(3, 40, 3, eBlockType::SNOW);
+
+    std::chrono::steady_clock::time_point timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (streamer.GetNumPending() > 0u && std::chrono::steady_clock::now() < timeout)
+    {
+        streamer.Update(0, 0, chunkStore, aLoaded);
+        for (const XMINT2& coord : aLoaded)
+            CHECK(coord.x != 0 || coord.y != 0);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    CHECK(streamer.GetNumPending() == 0u);
+    CHECK(chunkStore.GetChunks().size() == 5u);
+    CHECK(chunkStore.GetBlock(3, 40, 3) == eBlockType::SNOW);
+    CHECK(chunkStore.GetChunk(0, 0)->GetNumBlocks() == 1u);
+}
+
+BENCHMARK(TerrainStreamer_FlyOver)
+{
+    TerrainStreamer streamer(TerrainStreamer::DEFAULT_RADIUS, TerrainStreamer::DEFAULT_MAX_CHUNKS, TerrainStreamer::DEFAULT_CHUNK_HEIGHT, std::max<UINT>(1u, std::thread::hardware_concurrency() - 1u));
+    ChunkStore chunkStore;
+    chunkStore.Reset(XMFLOAT3(0.0f, 0.0f, 0.0f), streamer.GetChunkHeight());
+
+    // The first position loads the whole radius, then the camera crosses one chunk at a time
+    std::vector<double> aLatencies;
+    size_t uMaxResident = 0u;
+    for (INT i = 0; i <= 64; ++i)
+    {
+        StreamStats stats = StreamUntilResident(streamer, chunkStore, i, i / 2);
+        uMaxResident = std::max<size_t>(uMaxResident, stats.uMaxResident);
+        if (i > 0)
+            aLatencies.push_back(stats.seconds);
+        else
+            std::printf("  initial radius: %.1f ms\n", stats.seconds * 1e3);
+    }
+
+    CHECK(uMaxResident <= TerrainStreamer::DEFAULT_MAX_CHUNKS);
+
+    std::sort(aLatencies.begin(), aLatencies.end());
+    std::printf("  per chunk crossed: median %.1f ms, worst %.1f ms; at most %zu resident, %u generated, %.3f ms per chunk\n",
+        aLatencies[aLatencies.size() / 2] * 1e3, aLatencies.back() * 1e3, uMaxResident, streamer.GetNumGenerated(),
+        static_cast<double>(streamer.GetAverageGenerationTime()));
+}
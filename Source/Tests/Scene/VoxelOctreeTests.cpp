@@ -0,0 +1,212 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Scene/ChunkStore.h"
+#include "Scene/VoxelOctree.h"
+
+using namespace library;
+
+namespace
+{
+    // Hills from 1 to about 21 blocks, in bands of block types by height
+    SceneData CreateHills(UINT uWidth, UINT uDepth)
+    {
+        SceneData sceneData =
+        {
+            .uWidth = uWidth,
+            .uHeight = 24u,
+            .uDepth = uDepth,
+            .aColors = {},
+            .aBlockTypes = std::vector<eBlockType>(static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth)),
+            .aColumnHeights = std::vector<WORD>(static_cast<size_t>(uWidth) * static_cast<size_t>(uDepth))
+        };
+
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                FLOAT height = 11.0f + 5.0f * std::sin(static_cast<FLOAT>(x) * 0.05f) + 4.0f * std::cos(static_cast<FLOAT>(z) * 0.037f)
+                    + std::sin(static_cast<FLOAT>(x + z) * 0.21f);
+                size_t uColumnIdx = static_cast<size_t>(z) * uWidth + x;
+
+                sceneData.aColumnHeights[uColumnIdx] = static_cast<WORD>(height);
+                sceneData.aBlockTypes[uColumnIdx] = height < 8.0f ? eBlockType::SAND : height < 15.0f ? eBlockType::GRASSLAND : eBlockType::SNOW;
+            }
+        }
+
+        return sceneData;
+    }
+
+    eBlockType GetSceneBlock(const SceneData& sceneData, INT x, INT y, INT z)
+    {
+        if (x < 0 || y < 0 || z < 0 || x >= static_cast<INT>(sceneData.uWidth) || z >= static_cast<INT>(sceneData.uDepth))
+            return eBlockType::AIR;
+
+        size_t uColumnIdx = static_cast<size_t>(z) * sceneData.uWidth + static_cast<size_t>(x);
+        return y < static_cast<INT>(sceneData.aColumnHeights[uColumnIdx]) ? sceneData.aBlockTypes[uColumnIdx] : eBlockType::AIR;
+    }
+}
+
+TEST_CASE(VoxelOctree_MatchesColumns)
+{
+    SceneData sceneData = CreateHills(40u, 27u);
+
+    VoxelOctree octree;
+    CHECK(octree.GetSize() == 1u);
+    CHECK(octree.GetBlock(0, 0, 0) == eBlockType::AIR);
+
+    octree.Build(sceneData, XMFLOAT3(0.0f, 0.0f, 0.0f));
+    CHECK(octree.GetSize() == 64u);
+    CHECK(octree.GetNumNodes() > 0u);
+    CHECK(octree.GetMemoryUsage() == octree.GetNumNodes() * sizeof(OctreeNode));
+
+    BOOL bMatches = TRUE;
+    for (INT z = -1; z <= 64; ++z)
+    {
+        for (INT y = -1; y <= 64; ++y)
+        {
+            for (INT x = -1; x <= 64; ++x)
+                bMatches &= octree.GetBlock(x, y, z) == GetSceneBlock(sceneData, x, y, z);
+        }
+    }
+    CHECK(bMatches);
+
+    octree.Clear();
+    CHECK(octree.GetNumNodes() == 0u);
+    CHECK(octree.GetBlock(3, 0, 3) == eBlockType::AIR);
+}
+
+TEST_CASE(VoxelOctree_SharesIdenticalSubtrees)
+{
+    // A flat floor of one block type is a handful of nodes however wide it is
+    SceneData sceneData =
+    {
+        .uWidth = 256u,
+        .uHeight = 4u,
+        .uDepth = 256u,
+        .aColors = {},
+        .aBlockTypes = std::vector<eBlockType>(256u * 256u, eBlockType::TUNDRA),
+        .aColumnHeights = std::vector<WORD>(256u * 256u, 3u)
+    };
+
+    VoxelOctree octree;
+    octree.Build(sceneData, XMFLOAT3(0.0f, 0.0f, 0.0f));
+    CHECK(octree.GetSize() == 256u);
+    CHECK(octree.GetNumNodes() <= 16u);
+    CHECK(octree.GetBlock(200, 2, 17) == eBlockType::TUNDRA);
+    CHECK(octree.GetBlock(200, 3, 17) == eBlockType::AIR);
+}
+
+TEST_CASE(VoxelOctree_QueriesMatchChunkStore)
+{
+    SceneData sceneData = CreateHills(72u, 50u);
+    const XMFLOAT3 origin(-10.0f, 2.0f, 5.0f);
+
+    VoxelOctree octree;
+    octree.Build(sceneData, origin);
+    ChunkStore store;
+    store.Load(sceneData, origin);
+
+    std::mt19937 generator(5u);
+    std::uniform_real_distribution<FLOAT> unit(0.0f, 1.0f);
+
+    // Boxes against the blocks they cover
+    UINT uNumOverlaps = 0u;
+    BOOL bOverlapsMatch = TRUE;
+    for (UINT i = 0u; i < 500u; ++i)
+    {
+        XMFLOAT3 center(
+            origin.x + (unit(generator) * 80.0f - 4.0f) * Chunk::BLOCK_SIZE,
+            origin.y + unit(generator) * 30.0f * Chunk::BLOCK_SIZE,
+            origin.z + (unit(generator) * 56.0f - 3.0f) * Chunk::BLOCK_SIZE
+        );
+        XMFLOAT3 extents(unit(generator) * 2.0f * Chunk::BLOCK_SIZE, unit(generator) * 2.0f * Chunk::BLOCK_SIZE, unit(generator) * 2.0f * Chunk::BLOCK_SIZE);
+
+        INT aiMin[3];
+        INT aiMax[3];
+        const FLOAT aCenter[3] = { center.x - origin.x, center.y - origin.y, center.z - origin.z };
+        const FLOAT aExtents[3] = { extents.x, extents.y, extents.z };
+        for (UINT j = 0u; j < 3u; ++j)
+        {
+            aiMin[j] = static_cast<INT>(std::floor((aCenter[j] - aExtents[j]) / Chunk::BLOCK_SIZE + 0.5f));
+            aiMax[j] = static_cast<INT>(std::floor((aCenter[j] + aExtents[j]) / Chunk::BLOCK_SIZE + 0.5f));
+        }
+
+        BOOL bExpected = FALSE;
+        for (INT z = aiMin[2]; z <= aiMax[2]; ++z)
+        {
+            for (INT y = aiMin[1]; y <= aiMax[1]; ++y)
+            {
+                for (INT x = aiMin[0]; x <= aiMax[0]; ++x)
+                    bExpected |= GetSceneBlock(sceneData, x, y, z) != eBlockType::AIR;
+            }
+        }
+
+        BOOL bOverlaps = octree.Overlaps(BoundingBox(center, extents));
+        bOverlapsMatch &= bOverlaps == bExpected;
+        uNumOverlaps += bOverlaps ? 1u : 0u;
+    }
+    CHECK(bOverlapsMatch);
+    CHECK(uNumOverlaps > 50u && uNumOverlaps < 450u);
+
+    // Rays from above the hills, against the grid traversal of the chunk store
+    UINT uNumHits = 0u;
+    FLOAT maxError = 0.0f;
+    BOOL bHitsMatch = TRUE;
+    for (UINT i = 0u; i < 500u; ++i)
+    {
+        XMFLOAT3 rayOrigin(origin.x + unit(generator) * 72.0f * Chunk::BLOCK_SIZE, origin.y + 30.0f * Chunk::BLOCK_SIZE, origin.z + unit(generator) * 50.0f * Chunk::BLOCK_SIZE);
+        XMVECTOR direction = XMVector3Normalize(XMVectorSet(unit(generator) - 0.5f, -0.2f - unit(generator), unit(generator) - 0.5f, 0.0f));
+        XMFLOAT3 rayDirection;
+        XMStoreFloat3(&rayDirection, direction);
+
+        VoxelRayHit hit;
+        BOOL bExpected = store.CastRay(VoxelRay{ .origin = rayOrigin, .direction = rayDirection, .maxDistance = 500.0f }, hit);
+
+        FLOAT distance = 0.0f;
+        eBlockType blockType = eBlockType::AIR;
+        BOOL bHit = octree.CastRay(XMLoadFloat3(&rayOrigin), direction, distance, blockType);
+
+        bHitsMatch &= bHit == bExpected;
+        if (bHit && bExpected)
+        {
+            ++uNumHits;
+            bHitsMatch &= blockType == hit.blockType;
+            maxError = std::max<FLOAT>(maxError, std::fabs(distance - hit.distance));
+        }
+    }
+    CHECK(bHitsMatch);
+    CHECK(uNumHits > 100u);
+    CHECK(maxError < 1e-3f);
+}
+
+BENCHMARK(VoxelOctree_MemoryPerVoxel)
+{
+    std::printf("  %-12s %12s %12s %16s %18s %10s\n", "map", "nodes", "bytes", "bytes per block", "bytes per voxel", "build s");
+
+    for (UINT uSize = 256u; uSize <= 16384u; uSize *= 2u)
+    {
+        SceneData sceneData = CreateHills(uSize, uSize);
+
+        size_t uNumBlocks = 0u;
+        for (WORD uHeight : sceneData.aColumnHeights)
+            uNumBlocks += uHeight;
+
+        VoxelOctree octree;
+        double seconds = test::MeasureSeconds([&]()
+            {
+                octree.Build(sceneData, XMFLOAT3(0.0f, 0.0f, 0.0f));
+            }
+        );
+
+        CHECK(octree.GetBlock(0, 0, 0) != eBlockType::AIR);
+
+        // Voxels of the whole cube the octree spans, air included, against its solid blocks
+        double numVoxels = static_cast<double>(uSize) * static_cast<double>(uSize) * static_cast<double>(octree.GetSize());
+        std::printf("  %5ux%-6u %12zu %12zu %16.4f %18.7f %10.2f\n",
+            uSize, uSize, octree.GetNumNodes(), octree.GetMemoryUsage(),
+            static_cast<double>(octree.GetMemoryUsage()) / static_cast<double>(uNumBlocks),
+            static_cast<double>(octree.GetMemoryUsage()) / numVoxels, seconds);
+    }
+}
@@ -0,0 +1,86 @@
+/*+===================================================================
+  File:      TEST.H
+
+  Summary:   Test header file contains the macros that register the
+             test cases and the benchmarks of the Tests project, and
+             the checks used inside them.
+
+  Functions: GetTestCases
+             ReportFailure
+             ReadFile
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Platform.h"
+
+#include <cstdio>
+
+namespace test
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   TestCase
+
+        Summary:  Name and function of a test case or a benchmark
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestCase
+    {
+        const CHAR* pszName;
+        void (*pfnRun)();
+        BOOL bBenchmark;
+    };
+
+    std::vector<TestCase>& GetTestCases();
+    void ReportFailure(_In_ const CHAR* pszFile, _In_ INT iLine, _In_ const CHAR* pszExpression);
+    std::vector<BYTE> ReadFile(_In_ const CHAR* pszFileName);
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   TestRegistrar
+
+        Summary:  Adds a test case when a test file is loaded
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestRegistrar
+    {
+        TestRegistrar(_In_ const CHAR* pszName, _In_ void (*pfnRun)(), _In_ BOOL bBenchmark)
+        {
+            GetTestCases().push_back({ .pszName = pszName, .pfnRun = pfnRun, .bBenchmark = bBenchmark });
+        }
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: MeasureSeconds
+
+      Summary:  Runs a function and returns how long it took
+
+      Args:     Function function
+                  Function to time
+
+      Returns:  double
+                  Wall clock time in seconds
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    template <class Function>
+    double MeasureSeconds(_In_ Function function)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static test::TestRegistrar s_##name##Registrar(#name, name, FALSE); \
+    static void name()
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static test::TestRegistrar s_##name##Registrar(#name, name, TRUE); \
+    static void name()
+
+#define CHECK(expression) \
+    do \
+    { \
+        if (!(expression)) \
+            test::ReportFailure(__FILE__, __LINE__, #expression); \
+    } while (false)
@@ -0,0 +1,221 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Texture/AtlasPacker.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr const UINT GUTTER_SIZE = AtlasPacker::GUTTER_SIZE;
+
+    // Only the size is read when packing
+    WIC_DECODED_IMAGE MakeEmptyImage(UINT uWidth, UINT uHeight)
+    {
+        return WIC_DECODED_IMAGE{ .width = uWidth, .height = uHeight, .format = DXGI_FORMAT_R8G8B8A8_UNORM, .rowPitch = static_cast<size_t>(uWidth) * 4u, .bitsPerPixel = 32u, .mipLevels = 1u, .pixels = nullptr };
+    }
+
+    // Texels hold their position, and blue tells the images apart
+    WIC_DECODED_IMAGE MakeImage(UINT uWidth, UINT uHeight, BYTE blue)
+    {
+        WIC_DECODED_IMAGE image = MakeEmptyImage(uWidth, uHeight);
+        image.pixels.reset(new uint8_t[image.rowPitch * uHeight]);
+        for (UINT y = 0u; y < uHeight; ++y)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                BYTE* pTexel = image.pixels.get() + image.rowPitch * y + static_cast<size_t>(x) * 4u;
+                pTexel[0] = static_cast<BYTE>(x * 16u);
+                pTexel[1] = static_cast<BYTE>(y * 16u);
+                pTexel[2] = blue;
+                pTexel[3] = 255u;
+            }
+        }
+
+        return image;
+    }
+
+    const BYTE* GetTexel(const WIC_DECODED_IMAGE& image, UINT uLevel, UINT x, UINT y)
+    {
+        const BYTE* pLevel = image.pixels.get();
+        for (UINT i = 0u; i < uLevel; ++i)
+            pLevel += static_cast<size_t>(std::max<UINT>(image.width >> i, 1u)) * std::max<UINT>(image.height >> i, 1u) * 4u;
+
+        return pLevel + static_cast<size_t>(std::max<UINT>(image.width >> uLevel, 1u)) * 4u * y + static_cast<size_t>(x) * 4u;
+    }
+
+    // Padded regions inside the atlas, on the gutter grid, not overlapping each other
+    BOOL IsValidPacking(UINT uAtlasSize, const std::vector<WIC_DECODED_IMAGE>& aImages, const std::vector<AtlasPlacement>& aPlacements)
+    {
+        for (size_t i = 0u; i < aPlacements.size(); ++i)
+        {
+            const AtlasPlacement& a = aPlacements[i];
+            UINT uWidth = AtlasPacker::GetPaddedSize(aImages[a.uSourceIndex].width);
+            UINT uHeight = AtlasPacker::GetPaddedSize(aImages[a.uSourceIndex].height);
+            if (a.x % GUTTER_SIZE != 0u || a.y % GUTTER_SIZE != 0u || a.x + uWidth > uAtlasSize || a.y + uHeight > uAtlasSize)
+                return FALSE;
+
+            for (size_t j = i + 1u; j < aPlacements.size(); ++j)
+            {
+                const AtlasPlacement& b = aPlacements[j];
+                if (a.uSourceIndex == b.uSourceIndex)
+                    return FALSE;
+
+                UINT uOtherWidth = AtlasPacker::GetPaddedSize(aImages[b.uSourceIndex].width);
+                UINT uOtherHeight = AtlasPacker::GetPaddedSize(aImages[b.uSourceIndex].height);
+                if (a.x < b.x + uOtherWidth && b.x < a.x + uWidth && a.y < b.y + uOtherHeight && b.y < a.y + uHeight)
+                    return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+}
+
+TEST_CASE(AtlasPacker_PadsToGutterMultiples)
+{
+    for (UINT uSize = 1u; uSize <= AtlasPacker::MAX_SOURCE_SIZE; ++uSize)
+    {
+        UINT uPaddedSize = AtlasPacker::GetPaddedSize(uSize);
+        CHECK(uPaddedSize % GUTTER_SIZE == 0u);
+        CHECK(uPaddedSize >= uSize + 2u * GUTTER_SIZE);
+        CHECK(uPaddedSize < uSize + 3u * GUTTER_SIZE);
+    }
+
+    // Every mip level the atlas keeps ends on a region boundary
+    CHECK(GUTTER_SIZE == 1u << (AtlasPacker::NUM_MIP_LEVELS - 1u));
+}
+
+TEST_CASE(AtlasPacker_PacksWithoutOverlap)
+{
+    std::mt19937 generator(7u);
+    std::uniform_int_distribution<UINT> size(1u, 200u);
+
+    for (UINT uNumImages : { 2u, 10u, 40u, 120u })
+    {
+        std::vector<WIC_DECODED_IMAGE> aImages;
+        for (UINT i = 0u; i < uNumImages; ++i)
+            aImages.push_back(MakeEmptyImage(size(generator), size(generator)));
+
+        std::vector<AtlasPlacement> aPlacements;
+        UINT uAtlasSize = AtlasPacker::Pack(aImages, aPlacements);
+        CHECK(aPlacements.size() == aImages.size());
+        CHECK(uAtlasSize >= AtlasPacker::MIN_ATLAS_SIZE && uAtlasSize <= AtlasPacker::MAX_ATLAS_SIZE);
+        CHECK((uAtlasSize & (uAtlasSize - 1u)) == 0u);
+        CHECK(IsValidPacking(uAtlasSize, aImages, aPlacements));
+    }
+}
+
+TEST_CASE(AtlasPacker_GrowsAndSkipsWhatDoesNotFit)
+{
+    std::vector<AtlasPlacement> aPlacements;
+
+    // Four padded to 128 fill the smallest atlas
+    std::vector<WIC_DECODED_IMAGE> aImages;
+    for (UINT i = 0u; i < 4u; ++i)
+        aImages.push_back(MakeEmptyImage(128u - 2u * GUTTER_SIZE, 128u - 2u * GUTTER_SIZE));
+    CHECK(AtlasPacker::Pack(aImages, aPlacements) == AtlasPacker::MIN_ATLAS_SIZE);
+    CHECK(aPlacements.size() == 4u);
+
+    // A fifth one does not
+    aImages.push_back(MakeEmptyImage(1u, 1u));
+    CHECK(AtlasPacker::Pack(aImages, aPlacements) == 2u * AtlasPacker::MIN_ATLAS_SIZE);
+    CHECK(aPlacements.size() == 5u);
+
+    // Too large, empty, or failed to decode
+    aImages.push_back(MakeEmptyImage(AtlasPacker::MAX_SOURCE_SIZE + 1u, 4u));
+    aImages.push_back(MakeEmptyImage(0u, 0u));
+    CHECK(AtlasPacker::Pack(aImages, aPlacements) == 2u * AtlasPacker::MIN_ATLAS_SIZE);
+    CHECK(aPlacements.size() == 5u);
+    for (const AtlasPlacement& placement : aPlacements)
+        CHECK(placement.uSourceIndex < 5u);
+
+    // More than the largest atlas holds, 7 by 7 of them fit
+    aImages.clear();
+    for (UINT i = 0u; i < 60u; ++i)
+        aImages.push_back(MakeEmptyImage(AtlasPacker::MAX_SOURCE_SIZE, AtlasPacker::MAX_SOURCE_SIZE));
+    CHECK(AtlasPacker::Pack(aImages, aPlacements) == AtlasPacker::MAX_ATLAS_SIZE);
+    CHECK(aPlacements.size() == 49u);
+    CHECK(IsValidPacking(AtlasPacker::MAX_ATLAS_SIZE, aImages, aPlacements));
+}
+
+TEST_CASE(AtlasPacker_FillsGutterWithEdgeTexels)
+{
+    std::vector<WIC_DECODED_IMAGE> aImages;
+    aImages.push_back(MakeImage(5u, 3u, 0u));
+    aImages.push_back(MakeImage(9u, 14u, 255u));
+
+    std::vector<AtlasPlacement> aPlacements;
+    UINT uAtlasSize = AtlasPacker::Pack(aImages, aPlacements);
+    CHECK(aPlacements.size() == 2u);
+
+    WIC_DECODED_IMAGE atlas = {};
+    CHECK(SUCCEEDED(AtlasPacker::Compose(uAtlasSize, aImages, aPlacements, atlas)));
+    CHECK(atlas.width == uAtlasSize && atlas.height == uAtlasSize);
+    CHECK(atlas.mipLevels == AtlasPacker::NUM_MIP_LEVELS);
+
+    for (const AtlasPlacement& placement : aPlacements)
+    {
+        const WIC_DECODED_IMAGE& image = aImages[placement.uSourceIndex];
+        UINT uPaddedWidth = AtlasPacker::GetPaddedSize(image.width);
+        UINT uPaddedHeight = AtlasPacker::GetPaddedSize(image.height);
+
+        // Inside the region the image, in the gutter the nearest edge texel
+        for (UINT py = 0u; py < uPaddedHeight; ++py)
+        {
+            for (UINT px = 0u; px < uPaddedWidth; ++px)
+            {
+                UINT uSourceX = static_cast<UINT>(std::clamp<INT>(static_cast<INT>(px) - static_cast<INT>(GUTTER_SIZE), 0, static_cast<INT>(image.width) - 1));
+                UINT uSourceY = static_cast<UINT>(std::clamp<INT>(static_cast<INT>(py) - static_cast<INT>(GUTTER_SIZE), 0, static_cast<INT>(image.height) - 1));
+                CHECK(std::memcmp(GetTexel(atlas, 0u, placement.x + px, placement.y + py), GetTexel(image, 0u, uSourceX, uSourceY), 4u) == 0);
+            }
+        }
+
+        // Down to the last level kept, the texels of the region only average its own texels
+        for (UINT uLevel = 1u; uLevel < atlas.mipLevels; ++uLevel)
+        {
+            for (UINT py = 0u; py < uPaddedHeight >> uLevel; ++py)
+            {
+                for (UINT px = 0u; px < uPaddedWidth >> uLevel; ++px)
+                {
+                    const BYTE* pTexel = GetTexel(atlas, uLevel, (placement.x >> uLevel) + px, (placement.y >> uLevel) + py);
+                    CHECK(pTexel[2] == GetTexel(image, 0u, 0u, 0u)[2]);
+                    CHECK(pTexel[3] == 255u);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(AtlasPacker_RemapsTexCoordsIntoRegion)
+{
+    std::vector<WIC_DECODED_IMAGE> aImages;
+    aImages.push_back(MakeEmptyImage(100u, 60u));
+    aImages.push_back(MakeEmptyImage(32u, 32u));
+    aImages.push_back(MakeEmptyImage(17u, 90u));
+
+    std::vector<AtlasPlacement> aPlacements;
+    UINT uAtlasSize = AtlasPacker::Pack(aImages, aPlacements);
+    CHECK(aPlacements.size() == aImages.size());
+
+    FLOAT atlasSize = static_cast<FLOAT>(uAtlasSize);
+    for (const AtlasPlacement& placement : aPlacements)
+    {
+        const WIC_DECODED_IMAGE& image = aImages[placement.uSourceIndex];
+        AtlasRegion region = AtlasPacker::GetRegion(uAtlasSize, image, placement);
+
+        // The corners of the source land on the corners of the image inside the gutter
+        XMFLOAT2 topLeft = AtlasPacker::RemapTexCoord(region, XMFLOAT2(0.0f, 0.0f));
+        XMFLOAT2 bottomRight = AtlasPacker::RemapTexCoord(region, XMFLOAT2(1.0f, 1.0f));
+        CHECK(std::abs(topLeft.x * atlasSize - static_cast<FLOAT>(placement.x + GUTTER_SIZE)) < 1e-3f);
+        CHECK(std::abs(topLeft.y * atlasSize - static_cast<FLOAT>(placement.y + GUTTER_SIZE)) < 1e-3f);
+        CHECK(std::abs(bottomRight.x * atlasSize - static_cast<FLOAT>(placement.x + GUTTER_SIZE + image.width)) < 1e-3f);
+        CHECK(std::abs(bottomRight.y * atlasSize - static_cast<FLOAT>(placement.y + GUTTER_SIZE + image.height)) < 1e-3f);
+
+        // The center of a source texel is the center of its copy
+        XMFLOAT2 texelCenter = AtlasPacker::RemapTexCoord(region, XMFLOAT2(2.5f / static_cast<FLOAT>(image.width), 1.5f / static_cast<FLOAT>(image.height)));
+        CHECK(std::abs(texelCenter.x * atlasSize - (static_cast<FLOAT>(placement.x + GUTTER_SIZE) + 2.5f)) < 1e-3f);
+        CHECK(std::abs(texelCenter.y * atlasSize - (static_cast<FLOAT>(placement.y + GUTTER_SIZE) + 1.5f)) < 1e-3f);
+    }
+}
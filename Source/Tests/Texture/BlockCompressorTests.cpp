@@ -0,0 +1,346 @@
+#include "Test.h"
+
+#include <filesystem>
+#include <random>
+
+#include "Texture/BlockCompressor.h"
+#include "Texture/DDSTextureInfo.h"
+
+using namespace library;
+
+namespace
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   RgbaImage
+
+        Summary:  Tightly packed RGBA 32-bit texels
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct RgbaImage
+    {
+        UINT uWidth;
+        UINT uHeight;
+        std::vector<BYTE> aTexels;
+    };
+
+    void DecodeColorBlock(const BYTE* pBlock, BYTE aTexels[16][4])
+    {
+        UINT uColor0 = pBlock[0] | (pBlock[1] << 8u);
+        UINT uColor1 = pBlock[2] | (pBlock[3] << 8u);
+
+        auto expand = [](UINT uColor, UINT* pRgb)
+        {
+            UINT uRed = (uColor >> 11u) & 0x1Fu;
+            UINT uGreen = (uColor >> 5u) & 0x3Fu;
+            UINT uBlue = uColor & 0x1Fu;
+            pRgb[0] = (uRed << 3u) | (uRed >> 2u);
+            pRgb[1] = (uGreen << 2u) | (uGreen >> 4u);
+            pRgb[2] = (uBlue << 3u) | (uBlue >> 2u);
+        };
+
+        UINT aauPalette[4][3];
+        expand(uColor0, aauPalette[0]);
+        expand(uColor1, aauPalette[1]);
+        for (UINT c = 0u; c < 3u; ++c)
+        {
+            if (uColor0 > uColor1)
+            {
+                aauPalette[2][c] = (2u * aauPalette[0][c] + aauPalette[1][c] + 1u) / 3u;
+                aauPalette[3][c] = (aauPalette[0][c] + 2u * aauPalette[1][c] + 1u) / 3u;
+            }
+            else
+            {
+                aauPalette[2][c] = (aauPalette[0][c] + aauPalette[1][c]) / 2u;
+                aauPalette[3][c] = 0u;
+            }
+        }
+
+        UINT uIndices = pBlock[4] | (pBlock[5] << 8u) | (pBlock[6] << 16u) | (static_cast<UINT>(pBlock[7]) << 24u);
+        for (UINT i = 0u; i < 16u; ++i)
+        {
+            UINT uIndex = (uIndices >> (i * 2u)) & 0x3u;
+            for (UINT c = 0u; c < 3u; ++c)
+                aTexels[i][c] = static_cast<BYTE>(aauPalette[uIndex][c]);
+            aTexels[i][3] = 0xFFu;
+        }
+    }
+
+    void DecodeChannelBlock(const BYTE* pBlock, BYTE aTexels[16][4], UINT uChannel)
+    {
+        UINT auPalette[8] = { pBlock[0], pBlock[1] };
+        for (UINT i = 2u; i < 8u; ++i)
+        {
+            if (auPalette[0] > auPalette[1])
+                auPalette[i] = ((8u - i) * auPalette[0] + (i - 1u) * auPalette[1]) / 7u;
+            else if (i < 6u)
+                auPalette[i] = ((6u - i) * auPalette[0] + (i - 1u) * auPalette[1]) / 5u;
+            else
+                auPalette[i] = i == 6u ? 0u : 255u;
+        }
+
+        UINT64 uIndices = 0ull;
+        for (UINT i = 0u; i < 6u; ++i)
+            uIndices |= static_cast<UINT64>(pBlock[2u + i]) << (i * 8u);
+
+        for (UINT i = 0u; i < 16u; ++i)
+            aTexels[i][uChannel] = static_cast<BYTE>(auPalette[(uIndices >> (i * 3u)) & 0x7u]);
+    }
+
+    // Only mode 6 is decoded, any other mode fails the test
+    BOOL DecodeBC7Block(const BYTE* pBlock, BYTE aTexels[16][4])
+    {
+        UINT uBitOffset = 0u;
+        auto readBits = [&](UINT uNumBits)
+        {
+            UINT uValue = 0u;
+            for (UINT i = 0u; i < uNumBits; ++i, ++uBitOffset)
+                uValue |= ((pBlock[uBitOffset >> 3u] >> (uBitOffset & 7u)) & 1u) << i;
+            return uValue;
+        };
+
+        if (readBits(7u) != (1u << 6u))
+            return FALSE;
+
+        UINT aauEndpoints[2][4];
+        for (UINT c = 0u; c < 4u; ++c)
+        {
+            aauEndpoints[0][c] = readBits(7u);
+            aauEndpoints[1][c] = readBits(7u);
+        }
+
+        for (UINT e = 0u; e < 2u; ++e)
+        {
+            UINT uPBit = readBits(1u);
+            for (UINT c = 0u; c < 4u; ++c)
+                aauEndpoints[e][c] = (aauEndpoints[e][c] << 1u) | uPBit;
+        }
+
+        static const UINT s_auWeights[16] = { 0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u };
+        for (UINT i = 0u; i < 16u; ++i)
+        {
+            UINT uIndex = readBits(i == 0u ? 3u : 4u);
+            for (UINT c = 0u; c < 4u; ++c)
+                aTexels[i][c] = static_cast<BYTE>(((64u - s_auWeights[uIndex]) * aauEndpoints[0][c] + s_auWeights[uIndex] * aauEndpoints[1][c] + 32u) >> 6u);
+        }
+
+        return uBitOffset == 128u;
+    }
+
+    // Decodes the blocks of one level the way the hardware does, BC5 leaves blue at 0 and alpha opaque
+    RgbaImage DecodeLevel(const BYTE* pBlocks, UINT uWidth, UINT uHeight, DXGI_FORMAT format)
+    {
+        RgbaImage image = { .uWidth = uWidth, .uHeight = uHeight, .aTexels = std::vector<BYTE>(static_cast<size_t>(uWidth) * uHeight * 4u) };
+
+        UINT uNumBlocksX = (uWidth + 3u) / 4u;
+        UINT uNumBlocksY = (uHeight + 3u) / 4u;
+        size_t uBlockSize = format == DXGI_FORMAT_BC1_UNORM ? 8u : 16u;
+        for (UINT uBlockY = 0u; uBlockY < uNumBlocksY; ++uBlockY)
+        {
+            for (UINT uBlockX = 0u; uBlockX < uNumBlocksX; ++uBlockX)
+            {
+                const BYTE* pBlock = pBlocks + (static_cast<size_t>(uBlockY) * uNumBlocksX + uBlockX) * uBlockSize;
+                BYTE aTexels[16][4] = {};
+                switch (format)
+                {
+                case DXGI_FORMAT_BC1_UNORM:
+                    DecodeColorBlock(pBlock, aTexels);
+                    break;
+
+                case DXGI_FORMAT_BC3_UNORM:
+                    DecodeColorBlock(pBlock + 8u, aTexels);
+                    DecodeChannelBlock(pBlock, aTexels, 3u);
+                    break;
+
+                case DXGI_FORMAT_BC5_UNORM:
+                    DecodeChannelBlock(pBlock, aTexels, 0u);
+                    DecodeChannelBlock(pBlock + 8u, aTexels, 1u);
+                    for (UINT i = 0u; i < 16u; ++i)
+                        aTexels[i][3] = 0xFFu;
+                    break;
+
+                case DXGI_FORMAT_BC7_UNORM:
+                    CHECK(DecodeBC7Block(pBlock, aTexels));
+                    break;
+
+                default:
+                    CHECK(FALSE);
+                    break;
+                }
+
+                for (UINT i = 0u; i < 16u; ++i)
+                {
+                    UINT x = uBlockX * 4u + (i & 3u);
+                    UINT y = uBlockY * 4u + (i >> 2u);
+                    if (x < uWidth && y < uHeight)
+                        memcpy(&image.aTexels[(static_cast<size_t>(y) * uWidth + x) * 4u], aTexels[i], 4u);
+                }
+            }
+        }
+
+        return image;
+    }
+
+    // Peak signal to noise ratio over the channels set in the mask, in decibels
+    double ComputePsnr(const std::vector<BYTE>& aExpected, const std::vector<BYTE>& aActual, UINT uChannelMask)
+    {
+        double sumSquares = 0.0;
+        size_t uCount = 0u;
+        for (size_t i = 0u; i < aExpected.size(); ++i)
+        {
+            if (!(uChannelMask & (1u << (i % 4u))))
+                continue;
+
+            double delta = static_cast<double>(aExpected[i]) - static_cast<double>(aActual[i]);
+            sumSquares += delta * delta;
+            ++uCount;
+        }
+
+        double meanSquare = sumSquares / static_cast<double>(uCount);
+        return meanSquare == 0.0 ? 100.0 : 10.0 * std::log10(255.0 * 255.0 / meanSquare);
+    }
+
+    // Smooth gradients with a little noise and a few hard edges, like a typical diffuse map
+    RgbaImage MakeTestImage(UINT uWidth, UINT uHeight)
+    {
+        RgbaImage image = { .uWidth = uWidth, .uHeight = uHeight, .aTexels = std::vector<BYTE>(static_cast<size_t>(uWidth) * uHeight * 4u) };
+
+        std::mt19937 generator(5u);
+        std::uniform_int_distribution<INT> noise(-3, 3);
+        for (UINT y = 0u; y < uHeight; ++y)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                FLOAT u = static_cast<FLOAT>(x) / static_cast<FLOAT>(uWidth);
+                FLOAT v = static_cast<FLOAT>(y) / static_cast<FLOAT>(uHeight);
+                BOOL bStripe = ((x / 24u) + (y / 40u)) % 5u == 0u;
+                INT aiChannels[4] =
+                {
+                    static_cast<INT>(200.0f * u + 30.0f * sinf(v * 12.0f)) + noise(generator),
+                    static_cast<INT>(160.0f * v + 40.0f) + noise(generator),
+                    bStripe ? 220 : static_cast<INT>(90.0f + 60.0f * u * v) + noise(generator),
+                    static_cast<INT>(255.0f * (0.5f + 0.5f * cosf(u * 6.0f + v * 3.0f))),
+                };
+
+                for (UINT c = 0u; c < 4u; ++c)
+                    image.aTexels[(static_cast<size_t>(y) * uWidth + x) * 4u + c] = static_cast<BYTE>(std::clamp<INT>(aiChannels[c], 0, 255));
+            }
+        }
+
+        return image;
+    }
+
+    double CompressAndMeasure(const RgbaImage& image, DXGI_FORMAT format, UINT uChannelMask)
+    {
+        size_t uBlockSize = format == DXGI_FORMAT_BC1_UNORM ? 8u : 16u;
+        std::vector<BYTE> aBlocks(static_cast<size_t>((image.uWidth + 3u) / 4u) * ((image.uHeight + 3u) / 4u) * uBlockSize);
+        BlockCompressor::CompressLevel(image.aTexels.data(), image.uWidth, image.uHeight, format, aBlocks.data());
+
+        RgbaImage decoded = DecodeLevel(aBlocks.data(), image.uWidth, image.uHeight, format);
+        return ComputePsnr(image.aTexels, decoded.aTexels, uChannelMask);
+    }
+}
+
+TEST_CASE(BlockCompressor_PicksFormatFromUsage)
+{
+    CHECK(BlockCompressor::GetTextureUsage("nanosuit/arm_dif.png") == eTextureUsage::DIFFUSE);
+    CHECK(BlockCompressor::GetTextureUsage("nanosuit/arm_ddn.png") == eTextureUsage::NORMAL);
+    CHECK(BlockCompressor::GetTextureUsage("nanosuit/arm_SPEC.png") == eTextureUsage::SPECULAR);
+    CHECK(BlockCompressor::GetCompressedFormat(eTextureUsage::DIFFUSE, FALSE) == DXGI_FORMAT_BC1_UNORM);
+    CHECK(BlockCompressor::GetCompressedFormat(eTextureUsage::DIFFUSE, TRUE) == DXGI_FORMAT_BC3_UNORM);
+    CHECK(BlockCompressor::GetCompressedFormat(eTextureUsage::NORMAL, FALSE) == DXGI_FORMAT_BC5_UNORM);
+    CHECK(BlockCompressor::GetCompressedFormat(eTextureUsage::SPECULAR, TRUE) == DXGI_FORMAT_BC7_UNORM);
+    CHECK(BlockCompressor::GetCompressedPath("nanosuit/arm_dif.png") == std::filesystem::path("nanosuit/arm_dif.dds"));
+}
+
+TEST_CASE(BlockCompressor_ReachesTargetPsnr)
+{
+    RgbaImage image = MakeTestImage(256u, 256u);
+
+    double bc1 = CompressAndMeasure(image, DXGI_FORMAT_BC1_UNORM, 0x7u);
+    double bc3Color = CompressAndMeasure(image, DXGI_FORMAT_BC3_UNORM, 0x7u);
+    double bc3Alpha = CompressAndMeasure(image, DXGI_FORMAT_BC3_UNORM, 0x8u);
+    double bc5 = CompressAndMeasure(image, DXGI_FORMAT_BC5_UNORM, 0x3u);
+    double bc7 = CompressAndMeasure(image, DXGI_FORMAT_BC7_UNORM, 0xFu);
+    CHECK(bc1 > 38.0);
+    CHECK(bc3Color == bc1);
+    CHECK(bc3Alpha > 48.0);
+    CHECK(bc5 > 50.0);
+    CHECK(bc7 > 40.0);
+}
+
+TEST_CASE(BlockCompressor_HandlesPartialBlocks)
+{
+    // Top left corner of the usual test image, the blocks past the edges repeat the last texel
+    RgbaImage source = MakeTestImage(256u, 256u);
+    RgbaImage image = { .uWidth = 6u, .uHeight = 3u, .aTexels = std::vector<BYTE>(6u * 3u * 4u) };
+    for (UINT y = 0u; y < image.uHeight; ++y)
+        memcpy(&image.aTexels[y * image.uWidth * 4u], &source.aTexels[y * source.uWidth * 4u], image.uWidth * 4u);
+
+    CHECK(CompressAndMeasure(image, DXGI_FORMAT_BC1_UNORM, 0x7u) > 30.0);
+    CHECK(CompressAndMeasure(image, DXGI_FORMAT_BC7_UNORM, 0xFu) > 30.0);
+
+    // A flat block is exact in every format but BC1, which rounds to 5:6:5
+    RgbaImage flat = { .uWidth = 4u, .uHeight = 4u, .aTexels = std::vector<BYTE>(64u) };
+    for (size_t i = 0u; i < flat.aTexels.size(); i += 4u)
+    {
+        flat.aTexels[i + 0u] = 10u;
+        flat.aTexels[i + 1u] = 200u;
+        flat.aTexels[i + 2u] = 90u;
+        flat.aTexels[i + 3u] = 255u;
+    }
+
+    CHECK(CompressAndMeasure(flat, DXGI_FORMAT_BC5_UNORM, 0x3u) == 100.0);
+    CHECK(CompressAndMeasure(flat, DXGI_FORMAT_BC7_UNORM, 0xFu) > 48.0);
+}
+
+TEST_CASE(BlockCompressor_WritesReadableDDSFile)
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "BlockCompressorTests";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path sourcePath = directory / "glass_dif.png";
+    std::filesystem::copy_file("../Game/nanosuit/glass_dif.png", sourcePath, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::remove(BlockCompressor::GetCompressedPath(sourcePath));
+
+    CHECK(SUCCEEDED(BlockCompressor::CompressFile(sourcePath)));
+    CHECK(BlockCompressor::IsCompressedFileUpToDate(sourcePath));
+
+    std::vector<BYTE> aData = test::ReadFile(BlockCompressor::GetCompressedPath(sourcePath).string().c_str());
+    DDS_TEXTURE_INFO info = {};
+    DDS_SUBRESOURCE aSubresources[8] = {};
+    CHECK(SUCCEEDED(GetDDSTextureInfoFromMemory(aData.data(), aData.size(), &info, aSubresources, 8u)));
+    CHECK(info.width == 128u);
+    CHECK(info.height == 128u);
+    CHECK(info.mipCount == 8u);
+
+    WIC_DECODED_IMAGE source = {};
+    CHECK(SUCCEEDED(ImageDecoder::DecodeFromFile(sourcePath, source)));
+    if (info.mipCount == 8u && source.pixels)
+    {
+        RgbaImage decoded = DecodeLevel(aData.data() + aSubresources[0].offset, info.width, info.height, info.format);
+        std::vector<BYTE> aSource(source.pixels.get(), source.pixels.get() + source.rowPitch * source.height);
+        CHECK(ComputePsnr(aSource, decoded.aTexels, 0x7u) > 30.0);
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+BENCHMARK(BlockCompressor_Throughput)
+{
+    RgbaImage image = MakeTestImage(2048u, 2048u);
+    for (DXGI_FORMAT format : { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC5_UNORM, DXGI_FORMAT_BC7_UNORM })
+    {
+        size_t uBlockSize = format == DXGI_FORMAT_BC1_UNORM ? 8u : 16u;
+        std::vector<BYTE> aBlocks(512u * 512u * uBlockSize);
+        double seconds = test::MeasureSeconds([&]()
+            {
+                BlockCompressor::CompressLevel(image.aTexels.data(), image.uWidth, image.uHeight, format, aBlocks.data());
+            }
+        );
+
+        UINT uChannelMask = format == DXGI_FORMAT_BC5_UNORM ? 0x3u : format == DXGI_FORMAT_BC1_UNORM ? 0x7u : 0xFu;
+        RgbaImage decoded = DecodeLevel(aBlocks.data(), image.uWidth, image.uHeight, format);
+
+        std::printf("  BC%u 2048x2048: %.3f s, %.1f Mtexels/s, %.1f dB\n",
+            format == DXGI_FORMAT_BC1_UNORM ? 1u : format == DXGI_FORMAT_BC3_UNORM ? 3u : format == DXGI_FORMAT_BC5_UNORM ? 5u : 7u,
+            seconds, 2048.0 * 2048.0 / seconds / 1e6, ComputePsnr(image.aTexels, decoded.aTexels, uChannelMask));
+    }
+}
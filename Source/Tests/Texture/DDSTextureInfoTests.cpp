@@ -0,0 +1,86 @@
+#include "Test.h"
+
+#include "Texture/DDSTextureInfo.h"
+
+using namespace DirectX;
+
+TEST_CASE(DDSTextureInfo_ParsesBlockCompressedFile)
+{
+    std::vector<BYTE> aData = test::ReadFile("../Game/dog.dds");
+    CHECK(!aData.empty());
+
+    DDS_TEXTURE_INFO info = {};
+    HRESULT hr = GetDDSTextureInfoFromMemory(aData.data(), aData.size(), &info);
+    CHECK(SUCCEEDED(hr));
+    CHECK(info.width == 700u);
+    CHECK(info.height == 420u);
+    CHECK(info.depth == 1u);
+    CHECK(info.mipCount == 1u);
+    CHECK(info.arraySize == 1u);
+    CHECK(info.format == DXGI_FORMAT_BC1_UNORM);
+    CHECK(info.resourceDimension == DDS_DIMENSION_TEXTURE2D);
+    CHECK(!info.isCubeMap);
+
+    DDS_SUBRESOURCE subresource = {};
+    hr = GetDDSTextureInfoFromMemory(aData.data(), aData.size(), &info, &subresource, 1u);
+    CHECK(SUCCEEDED(hr));
+
+    // 175 x 105 blocks of 8 bytes right after the magic number and the header
+    CHECK(subresource.offset == sizeof(uint32_t) + sizeof(DDS_HEADER));
+    CHECK(subresource.rowPitch == 175u * 8u);
+    CHECK(subresource.slicePitch == 175u * 105u * 8u);
+    CHECK(subresource.offset + subresource.slicePitch == aData.size());
+}
+
+TEST_CASE(DDSTextureInfo_ParsesUncompressedFile)
+{
+    std::vector<BYTE> aData = test::ReadFile("../Game/seafloor.dds");
+    CHECK(!aData.empty());
+
+    DDS_TEXTURE_INFO info = {};
+    DDS_SUBRESOURCE subresource = {};
+    HRESULT hr = GetDDSTextureInfoFromMemory(aData.data(), aData.size(), &info, &subresource, 1u);
+    CHECK(SUCCEEDED(hr));
+    CHECK(info.width == 256u);
+    CHECK(info.height == 256u);
+    CHECK(info.mipCount == 1u);
+    CHECK(info.format == DXGI_FORMAT_R8G8B8A8_UNORM);
+    CHECK(info.resourceDimension == DDS_DIMENSION_TEXTURE2D);
+
+    CHECK(subresource.offset == sizeof(uint32_t) + sizeof(DDS_HEADER));
+    CHECK(subresource.rowPitch == 256u * 4u);
+    CHECK(subresource.slicePitch == 256u * 256u * 4u);
+    CHECK(subresource.offset + subresource.slicePitch == aData.size());
+}
+
+TEST_CASE(DDSTextureInfo_RejectsBadData)
+{
+    std::vector<BYTE> aData = test::ReadFile("../Game/seafloor.dds");
+    CHECK(!aData.empty());
+
+    DDS_TEXTURE_INFO info = {};
+    DDS_SUBRESOURCE subresource = {};
+
+    // Too short for the header
+    CHECK(FAILED(GetDDSTextureInfoFromMemory(aData.data(), sizeof(uint32_t) + sizeof(DDS_HEADER) - 1u, &info)));
+
+    // The header is complete but the pixels are cut short
+    CHECK(SUCCEEDED(GetDDSTextureInfoFromMemory(aData.data(), aData.size() - 1u, &info)));
+    CHECK(FAILED(GetDDSTextureInfoFromMemory(aData.data(), aData.size() - 1u, &info, &subresource, 1u)));
+
+    // Not enough room for the subresources
+    CHECK(GetDDSTextureInfoFromMemory(aData.data(), aData.size(), &info, &subresource, 0u) == E_NOT_SUFFICIENT_BUFFER);
+
+    // Wrong magic number
+    std::vector<BYTE> aBadMagic = aData;
+    aBadMagic[0] = 'X';
+    CHECK(FAILED(GetDDSTextureInfoFromMemory(aBadMagic.data(), aBadMagic.size(), &info)));
+
+    // Larger than the hardware allows
+    std::vector<BYTE> aTooWide = aData;
+    DDS_HEADER* pHeader = reinterpret_cast<DDS_HEADER*>(aTooWide.data() + sizeof(uint32_t));
+    pHeader->width = 16385u;
+    CHECK(GetDDSTextureInfoFromMemory(aTooWide.data(), aTooWide.size(), &info) == HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+
+    CHECK(GetDDSTextureInfoFromMemory(nullptr, aData.size(), &info) == E_INVALIDARG);
+}
@@ -0,0 +1,145 @@
+#include "Test.h"
+
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+#include "Texture/ImageDecoder.h"
+
+using namespace library;
+
+namespace
+{
+    BOOL HasOpaqueAlpha(_In_ const WIC_DECODED_IMAGE& image)
+    {
+        for (UINT y = 0u; y < image.height; ++y)
+        {
+            const BYTE* pRow = image.pixels.get() + image.rowPitch * y;
+            for (UINT x = 0u; x < image.width; ++x)
+            {
+                if (pRow[x * 4u + 3u] != 0xFF)
+                    return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+
+    std::vector<std::filesystem::path> GetNanosuitTextures()
+    {
+        std::vector<std::filesystem::path> aPaths;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator("../Game/nanosuit"))
+        {
+            std::filesystem::path extension = entry.path().extension();
+            if (extension == ".png" || extension == ".jpg")
+                aPaths.push_back(entry.path());
+        }
+
+        std::sort(aPaths.begin(), aPaths.end());
+        return aPaths;
+    }
+}
+
+TEST_CASE(ImageDecoder_DecodesPng)
+{
+    WIC_DECODED_IMAGE image = {};
+    CHECK(SUCCEEDED(ImageDecoder::DecodeFromFile("../Game/nanosuit/glass_dif.png", image)));
+    CHECK(image.width == 128u);
+    CHECK(image.height == 128u);
+    CHECK(image.format == DXGI_FORMAT_R8G8B8A8_UNORM);
+    CHECK(image.rowPitch == 128u * 4u);
+    CHECK(image.bitsPerPixel == 32u);
+    CHECK(image.mipLevels == 1u);
+    CHECK(image.pixels != nullptr);
+}
+
+TEST_CASE(ImageDecoder_ExpandsPngWithoutAlpha)
+{
+    WIC_DECODED_IMAGE image = {};
+    CHECK(SUCCEEDED(ImageDecoder::DecodeFromFile("../Game/nanosuit/cell_arm_alpha.png", image)));
+    CHECK(image.width == 1024u);
+    CHECK(image.height == 1024u);
+    CHECK(image.pixels && HasOpaqueAlpha(image));
+}
+
+TEST_CASE(ImageDecoder_DecodesJpeg)
+{
+    WIC_DECODED_IMAGE image = {};
+    CHECK(SUCCEEDED(ImageDecoder::DecodeFromFile("../Game/nanosuit/back.jpg", image)));
+    CHECK(image.width == 1024u);
+    CHECK(image.height == 768u);
+    CHECK(image.format == DXGI_FORMAT_R8G8B8A8_UNORM);
+    CHECK(image.rowPitch == 1024u * 4u);
+    CHECK(image.pixels && HasOpaqueAlpha(image));
+}
+
+TEST_CASE(ImageDecoder_RejectsOtherFiles)
+{
+    WIC_DECODED_IMAGE image = {};
+    CHECK(FAILED(ImageDecoder::DecodeFromFile("../Game/nanosuit/nanosuit.mtl", image)));
+    CHECK(!image.pixels);
+    CHECK(FAILED(ImageDecoder::DecodeFromFile("../Game/nanosuit/missing.png", image)));
+    CHECK(!image.pixels);
+}
+
+TEST_CASE(ImageDecoder_FailsOnCorruptJpeg)
+{
+    // The start of a JPEG followed by no image, so libjpeg jumps out of the decoder
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ImageDecoderTests";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path filePath = directory / "corrupt.jpg";
+    {
+        std::vector<BYTE> aData = test::ReadFile("../Game/nanosuit/back.jpg");
+        aData.resize(std::min<size_t>(aData.size(), 3u));
+        aData.resize(64u, 0u);
+
+        std::ofstream file(filePath, std::ios::binary);
+        file.write(reinterpret_cast<const CHAR*>(aData.data()), static_cast<std::streamsize>(aData.size()));
+    }
+
+    WIC_DECODED_IMAGE image = {};
+    CHECK(FAILED(ImageDecoder::DecodeFromFile(filePath, image)));
+    CHECK(!image.pixels);
+
+    // The file was closed, so it can go
+    CHECK(std::filesystem::remove(filePath));
+    std::filesystem::remove_all(directory);
+}
+
+BENCHMARK(ImageDecoder_NanosuitSerialVsParallel)
+{
+    std::vector<std::filesystem::path> aPaths = GetNanosuitTextures();
+    std::vector<WIC_DECODED_IMAGE> aImages(aPaths.size());
+    std::vector<HRESULT> aResults(aPaths.size(), S_OK);
+    std::vector<size_t> aIndices(aPaths.size());
+    std::iota(aIndices.begin(), aIndices.end(), 0ull);
+
+    double serialSeconds = test::MeasureSeconds([&]()
+        {
+            for (size_t uIndex : aIndices)
+                aResults[uIndex] = ImageDecoder::DecodeFromFile(aPaths[uIndex], aImages[uIndex]);
+        }
+    );
+
+    double parallelSeconds = test::MeasureSeconds([&]()
+        {
+            std::for_each(std::execution::par, aIndices.begin(), aIndices.end(),
+                [&](size_t uIndex)
+                {
+                    aResults[uIndex] = ImageDecoder::DecodeFromFile(aPaths[uIndex], aImages[uIndex]);
+                }
+            );
+        }
+    );
+
+    size_t uNumBytes = 0u;
+    for (size_t uIndex : aIndices)
+    {
+        CHECK(SUCCEEDED(aResults[uIndex]));
+        uNumBytes += aImages[uIndex].rowPitch * aImages[uIndex].height;
+    }
+
+    std::printf("  %zu textures, %.1f MB decoded: serial %.3f s, parallel %.3f s (%.2fx)\n",
+        aPaths.size(), static_cast<double>(uNumBytes) / (1024.0 * 1024.0), serialSeconds, parallelSeconds, serialSeconds / parallelSeconds);
+}
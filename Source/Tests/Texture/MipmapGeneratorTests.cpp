@@ -0,0 +1,249 @@
+#include "Test.h"
+
+#include <random>
+
+#include "Texture/MipmapGenerator.h"
+
+using namespace library;
+
+namespace
+{
+    double SrgbToLinear(double value)
+    {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    double LinearToSrgb(double value)
+    {
+        value = std::clamp(value, 0.0, 1.0);
+        return value < 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+    }
+
+    double DecodeChannel(BYTE value, UINT uChannel, BOOL bSrgb)
+    {
+        double normalized = static_cast<double>(value) / 255.0;
+        return bSrgb && uChannel < 3u ? SrgbToLinear(normalized) : normalized;
+    }
+
+    BYTE EncodeChannel(double value, UINT uChannel, BOOL bSrgb)
+    {
+        double encoded = bSrgb && uChannel < 3u ? LinearToSrgb(value) : std::clamp(value, 0.0, 1.0);
+        return static_cast<BYTE>(std::lround(encoded * 255.0));
+    }
+
+    // Kaiser windowed sinc written independently of the library, in double precision
+    double ReferenceKaiserWeight(double distance)
+    {
+        const double radius = MipmapGenerator::KAISER_RADIUS;
+        const double alpha = MipmapGenerator::KAISER_ALPHA;
+        if (std::fabs(distance) >= radius)
+            return 0.0;
+
+        auto besselI0 = [](double x)
+        {
+            double sum = 1.0;
+            double term = 1.0;
+            for (INT k = 1; k < 64; ++k)
+            {
+                term *= (x * 0.5 / k) * (x * 0.5 / k);
+                sum += term;
+            }
+
+            return sum;
+        };
+
+        double ratio = distance / radius;
+        double sinc = distance == 0.0 ? 1.0 : std::sin(3.14159265358979323846 * distance) / (3.14159265358979323846 * distance);
+        return sinc * besselI0(alpha * std::sqrt(1.0 - ratio * ratio)) / besselI0(alpha);
+    }
+
+    std::vector<std::pair<UINT, double>> ReferenceKaiserTaps(UINT uSrcSize, UINT uDstSize, UINT uDst)
+    {
+        if (uSrcSize == uDstSize)
+            return { { uDst, 1.0 } };
+
+        double scale = static_cast<double>(uSrcSize) / uDstSize;
+        double center = (uDst + 0.5) * scale;
+        std::vector<std::pair<UINT, double>> aTaps;
+        double sum = 0.0;
+        for (INT i = static_cast<INT>(std::floor(center - 4.0 * scale)); i <= static_cast<INT>(std::ceil(center + 4.0 * scale)); ++i)
+        {
+            double weight = ReferenceKaiserWeight((i + 0.5 - center) / scale);
+            if (weight == 0.0)
+                continue;
+
+            aTaps.push_back({ static_cast<UINT>(std::clamp<INT>(i, 0, static_cast<INT>(uSrcSize) - 1)), weight });
+            sum += weight;
+        }
+
+        for (std::pair<UINT, double>& tap : aTaps)
+            tap.second /= sum;
+
+        return aTaps;
+    }
+
+    // Scalar reference of one level computed from the previous level of the generated chain
+    std::vector<BYTE> ReferenceLevel(const BYTE* pSrc, UINT uSrcWidth, UINT uSrcHeight, UINT uDstWidth, UINT uDstHeight, BOOL bSrgb, eMipFilter filter)
+    {
+        std::vector<BYTE> aDst(static_cast<size_t>(uDstWidth) * uDstHeight * 4u);
+        for (UINT y = 0u; y < uDstHeight; ++y)
+        {
+            for (UINT x = 0u; x < uDstWidth; ++x)
+            {
+                std::vector<std::pair<UINT, double>> aTapsX;
+                std::vector<std::pair<UINT, double>> aTapsY;
+                if (filter == eMipFilter::BOX)
+                {
+                    aTapsX = { { std::min<UINT>(x * 2u, uSrcWidth - 1u), 0.5 }, { std::min<UINT>(x * 2u + 1u, uSrcWidth - 1u), 0.5 } };
+                    aTapsY = { { std::min<UINT>(y * 2u, uSrcHeight - 1u), 0.5 }, { std::min<UINT>(y * 2u + 1u, uSrcHeight - 1u), 0.5 } };
+                }
+                else
+                {
+                    aTapsX = ReferenceKaiserTaps(uSrcWidth, uDstWidth, x);
+                    aTapsY = ReferenceKaiserTaps(uSrcHeight, uDstHeight, y);
+                }
+
+                for (UINT c = 0u; c < 4u; ++c)
+                {
+                    double sum = 0.0;
+                    for (const std::pair<UINT, double>& tapY : aTapsY)
+                    {
+                        for (const std::pair<UINT, double>& tapX : aTapsX)
+                        {
+                            BYTE value = pSrc[(static_cast<size_t>(tapY.first) * uSrcWidth + tapX.first) * 4u + c];
+                            sum += tapX.second * tapY.second * DecodeChannel(value, c, bSrgb);
+                        }
+                    }
+
+                    aDst[(static_cast<size_t>(y) * uDstWidth + x) * 4u + c] = EncodeChannel(sum, c, bSrgb);
+                }
+            }
+        }
+
+        return aDst;
+    }
+
+    WIC_DECODED_IMAGE MakeRandomImage(UINT uWidth, UINT uHeight, UINT uSeed)
+    {
+        WIC_DECODED_IMAGE image = {};
+        image.width = uWidth;
+        image.height = uHeight;
+        image.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        image.rowPitch = static_cast<size_t>(uWidth) * 4u;
+        image.bitsPerPixel = 32u;
+        image.mipLevels = 1u;
+        image.pixels.reset(new uint8_t[image.rowPitch * uHeight]);
+
+        std::mt19937 generator(uSeed);
+        std::uniform_int_distribution<INT> distribution(0, 255);
+        for (size_t i = 0u; i < image.rowPitch * uHeight; ++i)
+            image.pixels[i] = static_cast<uint8_t>(distribution(generator));
+
+        return image;
+    }
+
+    // Largest difference of a channel between every level of the chain and the reference
+    INT CompareWithReference(UINT uWidth, UINT uHeight, BOOL bSrgb, eMipFilter filter)
+    {
+        WIC_DECODED_IMAGE image = MakeRandomImage(uWidth, uHeight, uWidth * 31u + uHeight);
+        if (FAILED(MipmapGenerator::GenerateMipChain(image, bSrgb, filter)))
+            return 256;
+
+        INT iMaxError = 0;
+        const BYTE* pLevel = image.pixels.get();
+        for (UINT uLevel = 1u; uLevel < image.mipLevels; ++uLevel)
+        {
+            UINT uSrcWidth = std::max<UINT>(uWidth >> (uLevel - 1u), 1u);
+            UINT uSrcHeight = std::max<UINT>(uHeight >> (uLevel - 1u), 1u);
+            UINT uDstWidth = std::max<UINT>(uWidth >> uLevel, 1u);
+            UINT uDstHeight = std::max<UINT>(uHeight >> uLevel, 1u);
+
+            const BYTE* pNext = pLevel + static_cast<size_t>(uSrcWidth) * uSrcHeight * 4u;
+            std::vector<BYTE> aReference = ReferenceLevel(pLevel, uSrcWidth, uSrcHeight, uDstWidth, uDstHeight, bSrgb, filter);
+            for (size_t i = 0u; i < aReference.size(); ++i)
+                iMaxError = std::max<INT>(iMaxError, std::abs(static_cast<INT>(pNext[i]) - static_cast<INT>(aReference[i])));
+
+            pLevel = pNext;
+        }
+
+        return iMaxError;
+    }
+}
+
+TEST_CASE(MipmapGenerator_CountsLevels)
+{
+    CHECK(MipmapGenerator::GetNumMipLevels(1u, 1u) == 1u);
+    CHECK(MipmapGenerator::GetNumMipLevels(256u, 256u) == 9u);
+    CHECK(MipmapGenerator::GetNumMipLevels(700u, 420u) == 10u);
+    CHECK(MipmapGenerator::GetNumMipLevels(1u, 64u) == 7u);
+
+    WIC_DECODED_IMAGE image = MakeRandomImage(37u, 10u, 1u);
+    CHECK(SUCCEEDED(MipmapGenerator::GenerateMipChain(image, TRUE, eMipFilter::KAISER)));
+    CHECK(image.mipLevels == 6u);
+    CHECK(image.rowPitch == 37u * 4u);
+
+    WIC_DECODED_IMAGE twice = MakeRandomImage(4u, 4u, 1u);
+    CHECK(SUCCEEDED(MipmapGenerator::GenerateMipChain(twice, TRUE)));
+    CHECK(MipmapGenerator::GenerateMipChain(twice, TRUE) == E_INVALIDARG);
+
+    WIC_DECODED_IMAGE unsupported = MakeRandomImage(4u, 4u, 1u);
+    unsupported.format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    CHECK(MipmapGenerator::GenerateMipChain(unsupported, TRUE) == HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+}
+
+TEST_CASE(MipmapGenerator_BoxMatchesScalarReference)
+{
+    CHECK(CompareWithReference(64u, 64u, TRUE, eMipFilter::BOX) <= 1);
+    CHECK(CompareWithReference(64u, 64u, FALSE, eMipFilter::BOX) <= 1);
+    CHECK(CompareWithReference(37u, 10u, TRUE, eMipFilter::BOX) <= 1);
+}
+
+TEST_CASE(MipmapGenerator_KaiserMatchesScalarReference)
+{
+    CHECK(CompareWithReference(64u, 64u, TRUE, eMipFilter::KAISER) <= 1);
+    CHECK(CompareWithReference(64u, 64u, FALSE, eMipFilter::KAISER) <= 1);
+    CHECK(CompareWithReference(37u, 10u, TRUE, eMipFilter::KAISER) <= 1);
+    CHECK(CompareWithReference(1u, 33u, FALSE, eMipFilter::KAISER) <= 1);
+}
+
+TEST_CASE(MipmapGenerator_KaiserKeepsFlatImages)
+{
+    WIC_DECODED_IMAGE image = MakeRandomImage(48u, 20u, 1u);
+    for (size_t i = 0u; i < image.rowPitch * image.height; i += 4u)
+    {
+        image.pixels[i + 0u] = 200u;
+        image.pixels[i + 1u] = 90u;
+        image.pixels[i + 2u] = 17u;
+        image.pixels[i + 3u] = 128u;
+    }
+
+    CHECK(SUCCEEDED(MipmapGenerator::GenerateMipChain(image, TRUE, eMipFilter::KAISER)));
+
+    size_t uTotalSize = 0u;
+    for (UINT i = 0u; i < image.mipLevels; ++i)
+        uTotalSize += static_cast<size_t>(std::max<UINT>(48u >> i, 1u)) * std::max<UINT>(20u >> i, 1u) * 4u;
+
+    INT iMaxError = 0;
+    const BYTE aExpected[4] = { 200u, 90u, 17u, 128u };
+    for (size_t i = 0u; i < uTotalSize; ++i)
+        iMaxError = std::max<INT>(iMaxError, std::abs(static_cast<INT>(image.pixels[i]) - static_cast<INT>(aExpected[i % 4u])));
+
+    CHECK(iMaxError <= 1);
+    CHECK(MipmapGenerator::GetKaiserWeight(0.0f) == 1.0f);
+    CHECK(MipmapGenerator::GetKaiserWeight(MipmapGenerator::KAISER_RADIUS) == 0.0f);
+}
+
+BENCHMARK(MipmapGenerator_BoxVsKaiser)
+{
+    for (eMipFilter filter : { eMipFilter::BOX, eMipFilter::KAISER })
+    {
+        WIC_DECODED_IMAGE image = MakeRandomImage(2048u, 2048u, 7u);
+        double seconds = test::MeasureSeconds([&]()
+            {
+                CHECK(SUCCEEDED(MipmapGenerator::GenerateMipChain(image, TRUE, filter)));
+            }
+        );
+
+        std::printf("  2048x2048 sRGB chain, %s filter: %.3f s\n", filter == eMipFilter::BOX ? "box" : "Kaiser", seconds);
+    }
+}
@@ -0,0 +1,305 @@
+#include "Test.h"
+
+#include <atomic>
+
+#include "Texture/TextureCache.h"
+
+using namespace library;
+
+namespace
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FakeTexture
+
+      Summary:  Texture whose content is the text of its file and whose
+                size is the size of that file until streaming changes
+                it. Files starting with "bad" fail to decode
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FakeTexture final
+    {
+    public:
+        static std::atomic<UINT> sm_uNumDecodes;
+
+        FakeTexture(_In_ const std::filesystem::path& filePath)
+            : m_filePath(filePath)
+            , m_content()
+            , m_uMemorySize(0u)
+        {}
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+        {
+            HRESULT hr = Decode(pDevice);
+            if (FAILED(hr))
+                return hr;
+
+            return Upload(pDevice, pImmediateContext);
+        }
+
+        HRESULT Decode(_In_ ID3D11Device*)
+        {
+            ++sm_uNumDecodes;
+
+            std::vector<BYTE> aData = test::ReadFile(m_filePath.string().c_str());
+            m_content.assign(aData.begin(), aData.end());
+            if (m_content.empty() || m_content.starts_with("bad"))
+                return E_FAIL;
+
+            m_uMemorySize = m_content.size();
+            return S_OK;
+        }
+
+        HRESULT Upload(_In_ ID3D11Device*, _In_ ID3D11DeviceContext*) { return S_OK; }
+
+        size_t GetMemorySize() const { return m_uMemorySize; }
+        void SetMemorySize(_In_ size_t uMemorySize) { m_uMemorySize = uMemorySize; }
+        const std::string& GetContent() const { return m_content; }
+
+    private:
+        std::filesystem::path m_filePath;
+        std::string m_content;
+        size_t m_uMemorySize;
+    };
+
+    std::atomic<UINT> FakeTexture::sm_uNumDecodes(0u);
+
+    std::filesystem::path GetDirectory()
+    {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "TextureCacheTests";
+        std::filesystem::create_directories(directory);
+        return directory;
+    }
+
+    void WriteFile(const std::filesystem::path& filePath, const CHAR* pszContent)
+    {
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        file << pszContent;
+    }
+
+    std::shared_ptr<FakeTexture> Load(TextureCache<FakeTexture>& cache, const std::filesystem::path& filePath)
+    {
+        std::shared_ptr<FakeTexture> pTexture;
+        HRESULT hr = cache.GetOrLoad(nullptr, nullptr, filePath, pTexture);
+        CHECK(SUCCEEDED(hr) == (pTexture != nullptr));
+        return pTexture;
+    }
+}
+
+TEST_CASE(TextureCache_SharesFilesWithTheSameContent)
+{
+    std::filesystem::path directory = GetDirectory();
+    WriteFile(directory / "a.png", "brick");
+    WriteFile(directory / "copy.png", "brick");
+    WriteFile(directory / "b.png", "stone");
+
+    TextureCache<FakeTexture> cache;
+    FakeTexture::sm_uNumDecodes = 0u;
+
+    std::shared_ptr<FakeTexture> pA = Load(cache, directory / "a.png");
+    CHECK(pA && pA->GetContent() == "brick");
+    CHECK(cache.GetNumMisses() == 1u && cache.GetNumHits() == 0u);
+
+    // The same path, another spelling of it, and a copy under another name
+    CHECK(Load(cache, directory / "a.png") == pA);
+    CHECK(Load(cache, directory / "." / "a.png") == pA);
+    CHECK(Load(cache, directory / "copy.png") == pA);
+    CHECK(cache.GetNumHits() == 3u);
+
+    std::shared_ptr<FakeTexture> pB = Load(cache, directory / "b.png");
+    CHECK(pB && pB != pA && pB->GetContent() == "stone");
+    CHECK(cache.GetNumMisses() == 2u);
+    CHECK(FakeTexture::sm_uNumDecodes == 2u);
+    CHECK(cache.GetMemoryUsage() == 10u);
+
+    std::shared_ptr<FakeTexture> pMissing;
+    CHECK(cache.GetOrLoad(nullptr, nullptr, directory / "missing.png", pMissing) == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+    CHECK(!pMissing);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(TextureCache_ComparesBytesOnHashHit)
+{
+    std::filesystem::path directory = GetDirectory();
+    WriteFile(directory / "a.png", "brick");
+    WriteFile(directory / "b.png", "brick");
+    WriteFile(directory / "c.png", "brick");
+
+    TextureCache<FakeTexture> cache;
+    std::shared_ptr<FakeTexture> pA = Load(cache, directory / "a.png");
+    CHECK(Load(cache, directory / "b.png") == pA);
+    CHECK(Load(cache, directory / "c.png") == pA);
+
+    // Rewritten without a new write time, the cache still has the hash of "brick" for both,
+    // as if their content collided with it
+    auto rewrite = [](const std::filesystem::path& filePath, const CHAR* pszContent)
+        {
+            std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(filePath);
+            WriteFile(filePath, pszContent);
+            std::filesystem::last_write_time(filePath, lastWriteTime);
+        };
+    rewrite(directory / "b.png", "stone");
+    rewrite(directory / "c.png", "cobblestone");
+
+    // Same size and different bytes, then a different size
+    std::shared_ptr<FakeTexture> pB = Load(cache, directory / "b.png");
+    CHECK(pB && pB != pA && pB->GetContent() == "stone");
+    std::shared_ptr<FakeTexture> pC = Load(cache, directory / "c.png");
+    CHECK(pC && pC != pA && pC != pB && pC->GetContent() == "cobblestone");
+
+    // Each of them keeps its own entry
+    CHECK(Load(cache, directory / "a.png") == pA);
+    CHECK(Load(cache, directory / "b.png") == pB);
+    CHECK(Load(cache, directory / "c.png") == pC);
+    CHECK(cache.GetMemoryUsage() == 5u + 5u + 11u);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(TextureCache_EvictsToBudgetAndKeepsWeakReferences)
+{
+    std::filesystem::path directory = GetDirectory();
+    WriteFile(directory / "a.png", "aaaaaaaa");
+    WriteFile(directory / "b.png", "bbbbbbbb");
+
+    TextureCache<FakeTexture> cache(12u);
+    FakeTexture::sm_uNumDecodes = 0u;
+
+    std::shared_ptr<FakeTexture> pA = Load(cache, directory / "a.png");
+    CHECK(cache.GetMemoryUsage() == 8u);
+
+    // Only one of them fits, the least recently used goes
+    CHECK(Load(cache, directory / "b.png"));
+    CHECK(cache.GetNumEvictions() == 1u);
+    CHECK(cache.GetMemoryUsage() == 8u);
+
+    // Still held, so it is found again without a load, and pushes out the other one
+    CHECK(Load(cache, directory / "a.png") == pA);
+    CHECK(cache.GetNumHits() == 1u);
+    CHECK(FakeTexture::sm_uNumDecodes == 2u);
+    CHECK(cache.GetNumEvictions() == 2u);
+    CHECK(cache.GetMemoryUsage() == 8u);
+
+    // Nothing held that one
+    CHECK(Load(cache, directory / "b.png"));
+    CHECK(cache.GetNumMisses() == 3u);
+    CHECK(FakeTexture::sm_uNumDecodes == 3u);
+
+    cache.SetMemoryBudget(0u);
+    CHECK(cache.GetMemoryUsage() == 0u);
+    CHECK(cache.GetNumEvictions() == 4u);
+    CHECK(Load(cache, directory / "a.png") == pA);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(TextureCache_CountsStreamedSizeOnUse)
+{
+    std::filesystem::path directory = GetDirectory();
+    WriteFile(directory / "a.png", "aaaaaaaa");
+    WriteFile(directory / "b.png", "bbbb");
+
+    TextureCache<FakeTexture> cache;
+    std::shared_ptr<FakeTexture> pA = Load(cache, directory / "a.png");
+    std::shared_ptr<FakeTexture> pB = Load(cache, directory / "b.png");
+    CHECK(cache.GetMemoryUsage() == 12u);
+
+    // Mips streamed in are counted the next time the texture is used
+    pA->SetMemorySize(1000u);
+    CHECK(cache.GetMemoryUsage() == 12u);
+    CHECK(Load(cache, directory / "a.png") == pA);
+    CHECK(cache.GetMemoryUsage() == 1004u);
+
+    pA->SetMemorySize(100u);
+    CHECK(Load(cache, directory / "a.png") == pA);
+    CHECK(Load(cache, directory / "b.png") == pB);
+    CHECK(cache.GetMemoryUsage() == 104u);
+
+    // Evicted with the size it was counted with
+    cache.SetMemoryBudget(50u);
+    CHECK(cache.GetMemoryUsage() == 4u);
+    CHECK(cache.GetNumEvictions() == 1u);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(TextureCache_LoadsBatchWithDuplicatesAndFailures)
+{
+    std::filesystem::path directory = GetDirectory();
+    WriteFile(directory / "a.png", "brick");
+    WriteFile(directory / "b.png", "stone");
+    WriteFile(directory / "copy.png", "stone");
+    WriteFile(directory / "bad.png", "bad data");
+
+    TextureCache<FakeTexture> cache;
+    FakeTexture::sm_uNumDecodes = 0u;
+
+    std::vector<std::filesystem::path> aFilePaths =
+    {
+        directory / "a.png", directory / "b.png", directory / "a.png", directory / "bad.png", directory / "copy.png",
+        directory / "missing.png",
+    };
+    std::vector<std::shared_ptr<FakeTexture>> apTextures;
+    CHECK(FAILED(cache.GetOrLoadBatch(nullptr, nullptr, aFilePaths, apTextures)));
+    CHECK(apTextures.size() == aFilePaths.size());
+
+    CHECK(apTextures[0] && apTextures[0]->GetContent() == "brick");
+    CHECK(apTextures[1] && apTextures[1]->GetContent() == "stone");
+    CHECK(apTextures[2] == apTextures[0]);
+    CHECK(!apTextures[3]);
+    CHECK(apTextures[4] == apTextures[1]);
+    CHECK(!apTextures[5]);
+
+    // Each content is decoded once, whichever file claimed it
+    CHECK(FakeTexture::sm_uNumDecodes == 3u);
+    CHECK(cache.GetNumMisses() == 3u);
+    CHECK(cache.GetNumHits() == 2u);
+    CHECK(cache.GetMemoryUsage() == 10u);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(TextureCache_DoesNotCacheFailedLoads)
+{
+    std::filesystem::path directory = GetDirectory();
+    WriteFile(directory / "a.png", "bad data");
+
+    TextureCache<FakeTexture> cache;
+    FakeTexture::sm_uNumDecodes = 0u;
+
+    CHECK(!Load(cache, directory / "a.png"));
+    CHECK(!Load(cache, directory / "a.png"));
+    CHECK(FakeTexture::sm_uNumDecodes == 2u);
+    CHECK(cache.GetNumMisses() == 2u);
+    CHECK(cache.GetMemoryUsage() == 0u);
+
+    // Fixed on disk, with a write time that differs on file systems with coarse timestamps too
+    WriteFile(directory / "a.png", "brick");
+    std::filesystem::last_write_time(directory / "a.png", std::filesystem::last_write_time(directory / "a.png") + std::chrono::seconds(1));
+    std::shared_ptr<FakeTexture> pA = Load(cache, directory / "a.png");
+    CHECK(pA && pA->GetContent() == "brick");
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE(TextureCache_ClearReleasesEverything)
+{
+    std::filesystem::path directory = GetDirectory();
+    WriteFile(directory / "a.png", "brick");
+
+    TextureCache<FakeTexture> cache;
+    std::weak_ptr<FakeTexture> pWeakA = Load(cache, directory / "a.png");
+    CHECK(!pWeakA.expired());
+
+    cache.Clear();
+    CHECK(pWeakA.expired());
+    CHECK(cache.GetMemoryUsage() == 0u);
+
+    // A texture still held is not shared with loads after the clear
+    std::shared_ptr<FakeTexture> pA = Load(cache, directory / "a.png");
+    cache.Clear();
+    std::shared_ptr<FakeTexture> pOtherA = Load(cache, directory / "a.png");
+    CHECK(pA && pOtherA && pOtherA != pA);
+    CHECK(cache.GetNumMisses() == 3u);
+
+    std::filesystem::remove_all(directory);
+}
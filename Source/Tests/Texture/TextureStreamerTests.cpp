@@ -0,0 +1,223 @@
+#include "Test.h"
+
+#include "Texture/TextureStreamer.h"
+
+using namespace library;
+
+namespace
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FakeTexture
+
+      Summary:  Square RGBA8 mip chain whose uploads only record what
+                the streamer asked for
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FakeTexture final : public StreamableTexture
+    {
+    public:
+        FakeTexture(_In_ UINT uTopMipSize, _In_ UINT uStartupMip)
+            : m_uTopMipSize(uTopMipSize)
+            , m_uNumMipLevels(0u)
+            , m_uStartupMip(uStartupMip)
+            , m_uResidentMip(uStartupMip)
+            , m_bFailUploads(FALSE)
+            , m_uNumUploads(0u)
+            , m_uUploadedBytes(0u)
+        {
+            for (UINT uSize = uTopMipSize; uSize > 0u; uSize >>= 1u)
+                ++m_uNumMipLevels;
+        }
+
+        BOOL IsStreamable() const override { return m_uNumMipLevels > 1u; }
+        UINT GetTopMipSize() const override { return m_uTopMipSize; }
+        UINT GetStartupMip() const override { return m_uStartupMip; }
+        UINT GetResidentMip() const override { return m_uResidentMip; }
+        size_t GetMemorySize() const override { return GetMipChainSize(m_uResidentMip); }
+
+        size_t GetMipChainSize(_In_ UINT uMostDetailedMip) const override
+        {
+            size_t uSize = 0u;
+            for (UINT i = uMostDetailedMip; i < m_uNumMipLevels; ++i)
+                uSize += static_cast<size_t>(std::max<UINT>(m_uTopMipSize >> i, 1u)) * std::max<UINT>(m_uTopMipSize >> i, 1u) * 4u;
+
+            return uSize;
+        }
+
+        HRESULT StreamMips(_In_ UINT uMostDetailedMip) override
+        {
+            if (m_bFailUploads)
+                return E_FAIL;
+
+            if (uMostDetailedMip < m_uResidentMip)
+                m_uUploadedBytes += GetMipChainSize(uMostDetailedMip) - GetMipChainSize(m_uResidentMip);
+
+            ++m_uNumUploads;
+            m_uResidentMip = std::min<UINT>(uMostDetailedMip, m_uNumMipLevels - 1u);
+            return S_OK;
+        }
+
+        void SetFailUploads(_In_ BOOL bFailUploads) { m_bFailUploads = bFailUploads; }
+        UINT GetNumUploads() const { return m_uNumUploads; }
+        size_t GetUploadedBytes() const { return m_uUploadedBytes; }
+
+    private:
+        UINT m_uTopMipSize;
+        UINT m_uNumMipLevels;
+        UINT m_uStartupMip;
+        UINT m_uResidentMip;
+        BOOL m_bFailUploads;
+        UINT m_uNumUploads;
+        size_t m_uUploadedBytes;
+    };
+}
+
+TEST_CASE(TextureStreamer_StreamsOneLevelPerFrame)
+{
+    // 1024x1024 texture starting at its 64x64 mip
+    std::shared_ptr<FakeTexture> pTexture = std::make_shared<FakeTexture>(1024u, 4u);
+    TextureStreamer streamer(64ull * 1024ull * 1024ull, 64ull * 1024ull * 1024ull);
+    streamer.Register(pTexture);
+    CHECK(streamer.GetMemoryUsage() == pTexture->GetMipChainSize(4u));
+
+    // 256 pixels on screen want mip 2, one level a frame
+    for (UINT uFrame = 0u; uFrame < 4u; ++uFrame)
+    {
+        streamer.Request(pTexture, 100.0f);
+        streamer.Request(pTexture, 256.0f);
+        CHECK(SUCCEEDED(streamer.Update()));
+        CHECK(pTexture->GetResidentMip() == std::max<UINT>(3u - uFrame, 2u));
+    }
+
+    CHECK(streamer.GetNumStreamedIn() == 2u);
+    CHECK(streamer.GetNumEvicted() == 0u);
+    CHECK(streamer.GetMemoryUsage() == pTexture->GetMipChainSize(2u));
+    CHECK(pTexture->GetUploadedBytes() == pTexture->GetMipChainSize(2u) - pTexture->GetMipChainSize(4u));
+
+    // Textures no longer requested keep their mips while the budget allows
+    CHECK(SUCCEEDED(streamer.Update()));
+    CHECK(pTexture->GetResidentMip() == 2u);
+
+    // Covering more pixels than texels asks for the whole chain
+    for (UINT uFrame = 0u; uFrame < 2u; ++uFrame)
+    {
+        streamer.Request(pTexture, 4096.0f);
+        CHECK(SUCCEEDED(streamer.Update()));
+    }
+
+    CHECK(pTexture->GetResidentMip() == 0u);
+}
+
+TEST_CASE(TextureStreamer_EvictsLeastWantedUnderBudget)
+{
+    std::shared_ptr<FakeTexture> pNear = std::make_shared<FakeTexture>(512u, 3u);
+    std::shared_ptr<FakeTexture> pFar = std::make_shared<FakeTexture>(512u, 3u);
+    std::shared_ptr<FakeTexture> pHidden = std::make_shared<FakeTexture>(512u, 3u);
+
+    // Room for two full chains and one startup mip
+    size_t uBudget = 2u * pNear->GetMipChainSize(0u) + pNear->GetMipChainSize(3u);
+    TextureStreamer streamer(uBudget, 64ull * 1024ull * 1024ull);
+    streamer.Register(pNear);
+    streamer.Register(pFar);
+    streamer.Register(pHidden);
+
+    for (UINT uFrame = 0u; uFrame < 4u; ++uFrame)
+    {
+        streamer.Request(pHidden, 300.0f);
+        streamer.Request(pFar, 500.0f);
+        CHECK(SUCCEEDED(streamer.Update()));
+        CHECK(streamer.GetMemoryUsage() <= uBudget);
+    }
+
+    CHECK(pHidden->GetResidentMip() == 0u);
+    CHECK(pFar->GetResidentMip() == 0u);
+    CHECK(streamer.GetNumEvicted() == 0u);
+
+    // The texture no longer requested goes first, down to its startup mip
+    for (UINT uFrame = 0u; uFrame < 4u; ++uFrame)
+    {
+        streamer.Request(pNear, 512.0f);
+        streamer.Request(pFar, 500.0f);
+        CHECK(SUCCEEDED(streamer.Update()));
+        CHECK(streamer.GetMemoryUsage() <= uBudget);
+    }
+
+    CHECK(pNear->GetResidentMip() == 0u);
+    CHECK(pFar->GetResidentMip() == 0u);
+    CHECK(pHidden->GetResidentMip() == 3u);
+    CHECK(streamer.GetNumEvicted() == 3u);
+
+    // Among textures of the same frame, the smallest on screen goes first
+    uBudget = pNear->GetMipChainSize(0u) + pNear->GetMipChainSize(2u) + pNear->GetMipChainSize(3u);
+    streamer.SetMemoryBudget(uBudget);
+    for (UINT uFrame = 0u; uFrame < 2u; ++uFrame)
+    {
+        streamer.Request(pNear, 512.0f);
+        streamer.Request(pFar, 500.0f);
+        CHECK(SUCCEEDED(streamer.Update()));
+        CHECK(streamer.GetMemoryUsage() <= uBudget);
+    }
+
+    CHECK(pNear->GetResidentMip() == 0u);
+    CHECK(pFar->GetResidentMip() == 2u);
+    CHECK(streamer.GetNumEvicted() == 5u);
+
+    // Shrinking the budget never drops a texture below its startup mip
+    streamer.SetMemoryBudget(0u);
+    streamer.Request(pNear, 512.0f);
+    CHECK(SUCCEEDED(streamer.Update()));
+    CHECK(pNear->GetResidentMip() == 3u);
+    CHECK(pFar->GetResidentMip() == 3u);
+    CHECK(pHidden->GetResidentMip() == 3u);
+    CHECK(streamer.GetMemoryUsage() == 3u * pNear->GetMipChainSize(3u));
+}
+
+TEST_CASE(TextureStreamer_RespectsUploadBudget)
+{
+    std::vector<std::shared_ptr<FakeTexture>> apTextures;
+    for (UINT i = 0u; i < 8u; ++i)
+        apTextures.push_back(std::make_shared<FakeTexture>(1024u, 4u));
+
+    // Mip 3 of a 1024 texture is 128x128, 64 KB: two uploads fit per frame
+    TextureStreamer streamer(256ull * 1024ull * 1024ull, 100u * 1024u);
+    for (const std::shared_ptr<FakeTexture>& pTexture : apTextures)
+        streamer.Register(pTexture);
+
+    for (const std::shared_ptr<FakeTexture>& pTexture : apTextures)
+        streamer.Request(pTexture, 1024.0f);
+    CHECK(SUCCEEDED(streamer.Update()));
+    CHECK(streamer.GetNumStreamedIn() == 2u);
+
+    // A single level larger than the budget still goes through
+    streamer.SetUploadBudget(1u);
+    for (const std::shared_ptr<FakeTexture>& pTexture : apTextures)
+        streamer.Request(pTexture, 1024.0f);
+    CHECK(SUCCEEDED(streamer.Update()));
+    CHECK(streamer.GetNumStreamedIn() == 3u);
+}
+
+TEST_CASE(TextureStreamer_HandlesFailuresAndReleasedTextures)
+{
+    std::shared_ptr<FakeTexture> pTexture = std::make_shared<FakeTexture>(256u, 2u);
+    std::shared_ptr<FakeTexture> pReleased = std::make_shared<FakeTexture>(256u, 2u);
+    std::shared_ptr<FakeTexture> pFlat = std::make_shared<FakeTexture>(1u, 0u);
+
+    TextureStreamer streamer;
+    streamer.Register(pTexture);
+    streamer.Register(pTexture);
+    streamer.Register(pReleased);
+    streamer.Register(pFlat);
+    CHECK(streamer.GetMemoryUsage() == 2u * pTexture->GetMipChainSize(2u));
+
+    pTexture->SetFailUploads(TRUE);
+    streamer.Request(pTexture, 256.0f);
+    CHECK(streamer.Update() == E_FAIL);
+    CHECK(pTexture->GetResidentMip() == 2u);
+    CHECK(streamer.GetNumStreamedIn() == 0u);
+
+    pReleased.reset();
+    pTexture->SetFailUploads(FALSE);
+    streamer.Request(pTexture, 256.0f);
+    CHECK(SUCCEEDED(streamer.Update()));
+    CHECK(pTexture->GetResidentMip() == 1u);
+    CHECK(streamer.GetMemoryUsage() == pTexture->GetMipChainSize(1u));
+}